@@ -0,0 +1,460 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : batch.cpp
+// Date : October 17, 2026
+// Description : Parallel batch runner
+//
+// Runs many ROMs headless in one process, spread across work-stealing worker threads
+// Configuration is thread_local (GBE_THREAD_CONFIG), so each instance runs on a fresh thread to start from defaults
+// Reports frames/sec plus CRC32s of the last frame and final save state for regression testing
+
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <fstream>
+#include <sstream>
+
+#include "gba/core.h"
+#include "dmg/core.h"
+#include "sgb/core.h"
+#include "nds/core.h"
+#include "min/core.h"
+#include "common/config.h"
+#include "common/util.h"
+
+#include <SDL2/SDL_main.h>
+
+#ifndef GBE_THREAD_CONFIG
+#error "gbe_batch requires per-thread configuration, build with GBE_THREAD_CONFIG defined"
+#endif
+
+namespace batch
+{
+	struct job
+	{
+		std::string rom_file;
+		std::vector <std::string> args;
+
+		//Results
+		bool success;
+		std::string error;
+		u32 frames;
+		double host_seconds;
+		u32 frame_crc;
+		u32 state_crc;
+	};
+
+	struct work_queue
+	{
+		std::mutex lock;
+		std::deque <u32> jobs;
+	};
+
+	std::vector <job> jobs;
+	std::vector <std::string> shared_args;
+	u32 total_frames = 3600;
+	u32 thread_count = 0;
+
+	//SDL setup and teardown (audio devices, subsystems) is not thread-safe
+	std::mutex sdl_lock;
+
+	//Frame output of the instance running on this thread
+	thread_local u32 frame_count = 0;
+	thread_local std::vector<u32>* frame_buffer = NULL;
+}
+
+/****** Counts frames presented by the core instead of drawing them ******/
+//With turbo frameskip, each presented frame stands for N+1 emulated ones
+void batch_render_sw(std::vector<u32>& image)
+{
+	batch::frame_count += (config::turbo_frameskip + 1);
+	batch::frame_buffer = &image;
+}
+
+/****** Discards hardware rendered frames ******/
+void batch_render_hw(SDL_Surface* image) { batch::frame_count += (config::turbo_frameskip + 1); }
+
+/****** Reads jobs from a list file - One ROM per line, followed by options for that instance only ******/
+bool parse_job_list(std::string filename)
+{
+	std::ifstream file(filename.c_str(), std::ios::in);
+
+	if(!file.is_open())
+	{
+		std::cout<<"BATCH::Error - Could not open job list " << filename << "\n";
+		return false;
+	}
+
+	std::string input_line = "";
+
+	while(std::getline(file, input_line))
+	{
+		std::istringstream line_stream(input_line);
+		std::string item = "";
+		batch::job new_job;
+
+		while(line_stream >> item)
+		{
+			//Comments run to the end of the line
+			if(item[0] == '#') { break; }
+
+			if(new_job.rom_file.empty()) { new_job.rom_file = item; }
+			else { new_job.args.push_back(item); }
+		}
+
+		if(!new_job.rom_file.empty()) { batch::jobs.push_back(new_job); }
+	}
+
+	file.close();
+	return true;
+}
+
+/****** Sorts command-line arguments into ROMs, batch settings, and core options shared by all instances ******/
+bool parse_batch_args(std::vector <std::string> &args)
+{
+	for(u32 x = 0; x < args.size(); x++)
+	{
+		//Number of frames each instance runs
+		if(args[x] == "--frames")
+		{
+			if((++x) == args.size()) { std::cout<<"BATCH::Error - No frame count specified\n"; return false; }
+			if(!util::from_str(args[x], batch::total_frames)) { std::cout<<"BATCH::Error - Invalid frame count\n"; return false; }
+		}
+
+		//Number of worker threads
+		else if(args[x] == "--threads")
+		{
+			if((++x) == args.size()) { std::cout<<"BATCH::Error - No thread count specified\n"; return false; }
+			if(!util::from_str(args[x], batch::thread_count)) { std::cout<<"BATCH::Error - Invalid thread count\n"; return false; }
+		}
+
+		//File listing ROMs and per-instance options
+		else if(args[x] == "--list")
+		{
+			if((++x) == args.size()) { std::cout<<"BATCH::Error - No job list specified\n"; return false; }
+			if(!parse_job_list(args[x])) { return false; }
+		}
+
+		//Everything after -- goes to every core
+		else if(args[x] == "--")
+		{
+			batch::shared_args.assign(args.begin() + x + 1, args.end());
+			break;
+		}
+
+		//Anything else is a ROM
+		else
+		{
+			batch::job new_job;
+			new_job.rom_file = args[x];
+			batch::jobs.push_back(new_job);
+		}
+	}
+
+	if(batch::total_frames == 0)
+	{
+		std::cout<<"BATCH::Error - Frame count must be greater than 0\n";
+		return false;
+	}
+
+	if(batch::thread_count == 0) { batch::thread_count = std::thread::hardware_concurrency(); }
+	if(batch::thread_count == 0) { batch::thread_count = 1; }
+
+	return true;
+}
+
+/****** Steps the core until the requested number of frames finish ******/
+bool run_frames(core_emu* gbe_plus, u32 frames)
+{
+	//Abort if the core stops producing frames (e.g. stuck in sleep mode)
+	const u64 stall_limit = 100000000;
+
+	u32 target = batch::frame_count + frames;
+	u64 steps = 0;
+	u64 last_frame_step = 0;
+	u32 last_frame = batch::frame_count;
+
+	while((batch::frame_count < target) && (gbe_plus->running))
+	{
+		gbe_plus->step();
+		steps++;
+
+		if(batch::frame_count != last_frame)
+		{
+			last_frame = batch::frame_count;
+			last_frame_step = steps;
+		}
+
+		else if((steps - last_frame_step) >= stall_limit) { return false; }
+	}
+
+	return gbe_plus->running;
+}
+
+/****** Loads and runs one instance - Called on a fresh thread, so configuration starts from defaults ******/
+void run_instance(batch::job &current_job)
+{
+	core_emu* gbe_plus = NULL;
+
+	//Per-instance options override shared ones
+	config::cli_args.clear();
+	config::cli_args.push_back(current_job.rom_file);
+	config::cli_args.insert(config::cli_args.end(), batch::shared_args.begin(), batch::shared_args.end());
+	config::cli_args.insert(config::cli_args.end(), current_job.args.begin(), current_job.args.end());
+
+	parse_filenames();
+	parse_ini_file();
+
+	if(config::use_cheats) { parse_cheats_file(false); }
+
+	if(!parse_cli_args())
+	{
+		current_job.error = "Invalid core options";
+		return;
+	}
+
+	//Force headless, unthrottled operation regardless of .ini options
+	config::sdl_render = false;
+	config::use_opengl = false;
+	config::render_external_sw = batch_render_sw;
+	config::render_external_hw = batch_render_hw;
+	config::turbo = true;
+	config::use_debugger = false;
+	config::use_netplay = false;
+	config::volume = 0;
+
+	if(config::override_audio_driver.empty()) { config::override_audio_driver = "dummy"; }
+
+	//Get emulated system type from file
+	config::gb_type = get_system_type_from_file(config::rom_file);
+
+	batch::sdl_lock.lock();
+
+	switch(config::gb_type)
+	{
+		case 0x3: gbe_plus = new AGB_core(); break;
+		case 0x4: gbe_plus = new NTR_core(); break;
+		case 0x5:
+		case 0x6: gbe_plus = new SGB_core(); break;
+		case 0x7: gbe_plus = new MIN_core(); break;
+		default: gbe_plus = new DMG_core();
+	}
+
+	batch::sdl_lock.unlock();
+
+	bool loaded = true;
+
+	//Read BIOS file optionally
+	if(config::use_bios)
+	{
+		if(config::bios_file == "")
+		{
+			switch(config::gb_type)
+			{
+				case 0x1: config::bios_file = config::dmg_bios_path; break;
+				case 0x2: config::bios_file = config::gbc_bios_path; break;
+				case 0x3: config::bios_file = config::agb_bios_path; break;
+				case 0x7: config::bios_file = config::min_bios_path; break;
+			}
+		}
+
+		if(!gbe_plus->read_bios(config::bios_file)) { current_job.error = "Could not read BIOS"; loaded = false; }
+	}
+
+	//Read specified ROM file
+	if((loaded) && (!gbe_plus->read_file(config::rom_file))) { current_job.error = "Could not read ROM"; loaded = false; }
+
+	//Read firmware optionally (NDS)
+	if((loaded) && (config::use_firmware) && (config::gb_type == 4))
+	{
+		if(!gbe_plus->read_firmware(config::nds_firmware_path)) { current_job.error = "Could not read firmware"; loaded = false; }
+	}
+
+	//Engage the core, then drop the audio device so the next instance can open one
+	if(loaded)
+	{
+		batch::sdl_lock.lock();
+
+		gbe_plus->start();
+		gbe_plus->db_unit.debug_mode = false;
+		SDL_CloseAudio();
+
+		batch::sdl_lock.unlock();
+
+		if(!gbe_plus->running) { current_job.error = "Core failed to start"; loaded = false; }
+	}
+
+	if(loaded)
+	{
+		//Same CPU setup the DMG core performs at the top of run_core()
+		if(config::gb_type == 2)
+		{
+			DMG_core* dmg_core = dynamic_cast<DMG_core*>(gbe_plus);
+			if(dmg_core != NULL) { dmg_core->core_cpu.reg.a = 0x11; }
+		}
+
+		//Same direct boot the NDS core performs at the top of run_core()
+		else if((config::gb_type == 4) && ((!config::use_bios) || (!config::use_firmware)))
+		{
+			NTR_core* nds_core = dynamic_cast<NTR_core*>(gbe_plus);
+
+			if(nds_core != NULL)
+			{
+				nds_core->core_cpu_nds9.reg.r15 = nds_core->core_mmu.header.arm9_entry_addr;
+				nds_core->core_cpu_nds7.reg.r15 = nds_core->core_mmu.header.arm7_entry_addr;
+			}
+		}
+
+		auto start_time = std::chrono::steady_clock::now();
+
+		current_job.success = run_frames(gbe_plus, batch::total_frames);
+
+		auto end_time = std::chrono::steady_clock::now();
+
+		current_job.frames = batch::frame_count;
+		current_job.host_seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count() / 1000000000.0;
+
+		if(!current_job.success) { current_job.error = "Core stopped producing frames"; }
+
+		//Fingerprint the final frame and machine state
+		if(batch::frame_buffer != NULL)
+		{
+			current_job.frame_crc = util::get_crc32((u8*)batch::frame_buffer->data(), batch::frame_buffer->size() * 4);
+		}
+
+		std::vector<u8> state;
+		if(gbe_plus->serialize(state)) { current_job.state_crc = util::get_crc32(state.data(), state.size()); }
+	}
+
+	//Tear down under the lock, the core closes its SDL audio and windows on the way out
+	batch::sdl_lock.lock();
+	gbe_plus->shutdown();
+	delete gbe_plus;
+	batch::sdl_lock.unlock();
+}
+
+/****** Grabs the next job, stealing from the back of other workers' queues once this one runs dry ******/
+bool get_job(std::vector <batch::work_queue> &queues, u32 worker_id, u32 &job_id)
+{
+	for(u32 x = 0; x < queues.size(); x++)
+	{
+		u32 queue_id = (worker_id + x) % queues.size();
+		std::lock_guard<std::mutex> guard(queues[queue_id].lock);
+
+		if(queues[queue_id].jobs.empty()) { continue; }
+
+		if(x == 0)
+		{
+			job_id = queues[queue_id].jobs.front();
+			queues[queue_id].jobs.pop_front();
+		}
+
+		else
+		{
+			job_id = queues[queue_id].jobs.back();
+			queues[queue_id].jobs.pop_back();
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+/****** Worker thread - Runs jobs until every queue is empty ******/
+void worker(std::vector <batch::work_queue> &queues, u32 worker_id)
+{
+	u32 job_id = 0;
+
+	while(get_job(queues, worker_id, job_id))
+	{
+		//Thread-local configuration can't be reset in place, so every instance gets a brand new thread
+		std::thread instance(run_instance, std::ref(batch::jobs[job_id]));
+		instance.join();
+	}
+}
+
+int main(int argc, char* args[])
+{
+	std::cout<<"GBE+ 1.8 [Batch]\n";
+
+	std::vector <std::string> batch_args;
+
+	//Grab command-line arguments
+	for(int x = 0; x++ < argc - 1;)
+	{
+		std::string temp_arg = args[x];
+		batch_args.push_back(temp_arg);
+	}
+
+	if(!parse_batch_args(batch_args)) { return 1; }
+
+	if(batch::jobs.empty())
+	{
+		std::cout<<"\ngbe_batch [file ...] [--list FILE] [--frames N] [--threads N] [-- options ...]\n";
+		return 1;
+	}
+
+	for(u32 x = 0; x < batch::jobs.size(); x++)
+	{
+		batch::jobs[x].success = false;
+		batch::jobs[x].frames = 0;
+		batch::jobs[x].host_seconds = 0.0;
+		batch::jobs[x].frame_crc = 0;
+		batch::jobs[x].state_crc = 0;
+	}
+
+	if(batch::thread_count > batch::jobs.size()) { batch::thread_count = batch::jobs.size(); }
+
+	//Deal jobs out round-robin, idle workers steal the rest
+	std::vector <batch::work_queue> queues(batch::thread_count);
+	for(u32 x = 0; x < batch::jobs.size(); x++) { queues[x % batch::thread_count].jobs.push_back(x); }
+
+	std::cout<<std::dec<<"BATCH::Running " << batch::jobs.size() << " instances on " << batch::thread_count << " threads\n";
+
+	auto start_time = std::chrono::steady_clock::now();
+
+	std::vector <std::thread> workers;
+	for(u32 x = 0; x < batch::thread_count; x++) { workers.push_back(std::thread(worker, std::ref(queues), x)); }
+	for(u32 x = 0; x < workers.size(); x++) { workers[x].join(); }
+
+	auto end_time = std::chrono::steady_clock::now();
+	double elapsed_s = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count() / 1000000000.0;
+
+	u32 failed = 0;
+	u64 frames = 0;
+
+	std::cout<<std::dec<<std::fixed<<std::setprecision(2);
+	std::cout<<"BATCH::Results\n";
+
+	for(u32 x = 0; x < batch::jobs.size(); x++)
+	{
+		batch::job &current_job = batch::jobs[x];
+		frames += current_job.frames;
+
+		std::cout<<std::dec<<"[" << x << "] " << current_job.rom_file << " : ";
+
+		if(!current_job.success)
+		{
+			failed++;
+			std::cout<<"FAILED - " << current_job.error << "\n";
+			continue;
+		}
+
+		double fps = (current_job.host_seconds > 0.0) ? (current_job.frames / current_job.host_seconds) : 0.0;
+
+		std::cout<<current_job.frames << " frames, " << current_job.host_seconds << " s, " << fps << " FPS";
+		std::cout<<" | Frame CRC32 : " << std::hex << std::setw(8) << std::setfill('0') << current_job.frame_crc;
+		std::cout<<" | State CRC32 : " << std::setw(8) << current_job.state_crc << std::setfill(' ') << std::dec << "\n";
+	}
+
+	std::cout<<"BATCH::Host Time : " << elapsed_s << " s\n";
+	std::cout<<"BATCH::Total Frames/sec : " << ((elapsed_s > 0.0) ? (frames / elapsed_s) : 0.0) << "\n";
+	std::cout<<"BATCH::Failed : " << failed << "\n";
+
+	return (failed) ? 1 : 0;
+}
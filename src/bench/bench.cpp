@@ -0,0 +1,257 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : bench.cpp
+// Date : October 17, 2026
+// Description : Headless benchmark
+//
+// Runs any core without a window, audio device, or frame limiter
+// Reports emulated frames/sec, guest instructions/sec, and host time per frame
+
+#include <chrono>
+#include <iomanip>
+
+#include "gba/core.h"
+#include "dmg/core.h"
+#include "sgb/core.h"
+#include "nds/core.h"
+#include "min/core.h"
+#include "common/config.h"
+#include "common/util.h"
+
+#include <SDL2/SDL_main.h>
+
+namespace bench
+{
+	u32 frame_count = 0;
+}
+
+/****** Counts frames presented by the core instead of drawing them ******/
+//With turbo frameskip, each presented frame stands for N+1 emulated ones
+void bench_render_sw(std::vector<u32>& image) { bench::frame_count += (config::turbo_frameskip + 1); }
+
+/****** Discards hardware rendered frames ******/
+void bench_render_hw(SDL_Surface* image) { bench::frame_count += (config::turbo_frameskip + 1); }
+
+/****** Pulls benchmark-only arguments out of the command-line ******/
+bool parse_bench_args(u32 &total_frames, u32 &warmup_frames)
+{
+	std::vector <std::string> core_args;
+
+	for(u32 x = 0; x < config::cli_args.size(); x++)
+	{
+		//Number of frames to measure
+		if(config::cli_args[x] == "--frames")
+		{
+			if((++x) == config::cli_args.size()) { std::cout<<"BENCH::Error - No frame count specified\n"; return false; }
+			if(!util::from_str(config::cli_args[x], total_frames)) { std::cout<<"BENCH::Error - Invalid frame count\n"; return false; }
+		}
+
+		//Number of frames to run before measuring
+		else if(config::cli_args[x] == "--warmup")
+		{
+			if((++x) == config::cli_args.size()) { std::cout<<"BENCH::Error - No warmup count specified\n"; return false; }
+			if(!util::from_str(config::cli_args[x], warmup_frames)) { std::cout<<"BENCH::Error - Invalid warmup count\n"; return false; }
+		}
+
+		//Everything else goes to the normal GBE+ parser
+		else { core_args.push_back(config::cli_args[x]); }
+	}
+
+	config::cli_args = core_args;
+
+	if(total_frames == 0)
+	{
+		std::cout<<"BENCH::Error - Frame count must be greater than 0\n";
+		return false;
+	}
+
+	return true;
+}
+
+/****** Steps the core until the requested number of frames finish ******/
+bool run_frames(core_emu* gbe_plus, u32 frames, u64 &steps)
+{
+	//Abort if the core stops producing frames (e.g. stuck in sleep mode)
+	const u64 stall_limit = 100000000;
+
+	u32 target = bench::frame_count + frames;
+	u64 last_frame_step = steps;
+	u32 last_frame = bench::frame_count;
+
+	while((bench::frame_count < target) && (gbe_plus->running))
+	{
+		gbe_plus->step();
+		steps++;
+
+		if(bench::frame_count != last_frame)
+		{
+			last_frame = bench::frame_count;
+			last_frame_step = steps;
+		}
+
+		else if((steps - last_frame_step) >= stall_limit)
+		{
+			std::cout<<"BENCH::Error - Core stopped producing frames\n";
+			return false;
+		}
+	}
+
+	return gbe_plus->running;
+}
+
+int main(int argc, char* args[])
+{
+	std::cout<<"GBE+ 1.8 [Benchmark]\n";
+
+	core_emu* gbe_plus = NULL;
+
+	u32 total_frames = 3600;
+	u32 warmup_frames = 60;
+
+	//Grab command-line arguments
+	for(int x = 0; x++ < argc - 1;)
+	{
+		std::string temp_arg = args[x];
+		config::cli_args.push_back(temp_arg);
+	}
+
+	if(!parse_bench_args(total_frames, warmup_frames)) { return 1; }
+
+	if(config::cli_args.empty())
+	{
+		std::cout<<"\ngbe_bench file [--frames N] [--warmup N] [options ...]\n";
+		return 1;
+	}
+
+	parse_filenames();
+
+	//Parse .ini options
+	parse_ini_file();
+
+	//Parse cheat file
+	if(config::use_cheats) { parse_cheats_file(false); }
+
+	//Parse command-line arguments
+	//These will override .ini options!
+	if(!parse_cli_args()) { return 1; }
+
+	//Force headless, unthrottled operation regardless of .ini options
+	config::sdl_render = false;
+	config::use_opengl = false;
+	config::render_external_sw = bench_render_sw;
+	config::render_external_hw = bench_render_hw;
+	config::turbo = true;
+	config::use_debugger = false;
+	config::use_netplay = false;
+	config::volume = 0;
+
+	//Let the APU initialize without a real audio device
+	if(config::override_audio_driver.empty()) { config::override_audio_driver = "dummy"; }
+
+	//Get emulated system type from file
+	config::gb_type = get_system_type_from_file(config::rom_file);
+
+	switch(config::gb_type)
+	{
+		case 0x3: gbe_plus = new AGB_core(); break;
+		case 0x4: gbe_plus = new NTR_core(); break;
+		case 0x5:
+		case 0x6: gbe_plus = new SGB_core(); break;
+		case 0x7: gbe_plus = new MIN_core(); break;
+		default: gbe_plus = new DMG_core();
+	}
+
+	//Read BIOS file optionally
+	if(config::use_bios)
+	{
+		//If no bios file was passed from the command-line arguments, defer to .ini options
+		if(config::bios_file == "")
+		{
+			switch(config::gb_type)
+			{
+				case 0x1: config::bios_file = config::dmg_bios_path; break;
+				case 0x2: config::bios_file = config::gbc_bios_path; break;
+				case 0x3: config::bios_file = config::agb_bios_path; break;
+				case 0x7: config::bios_file = config::min_bios_path; break;
+			}
+		}
+
+		if(!gbe_plus->read_bios(config::bios_file)) { return 1; }
+	}
+
+	//Read specified ROM file
+	if(!gbe_plus->read_file(config::rom_file)) { return 1; }
+
+	//Read firmware optionally (NDS)
+	if((config::use_firmware) && (config::gb_type == 4))
+	{
+		if(!gbe_plus->read_firmware(config::nds_firmware_path)) { return 1; }
+	}
+
+	//Engage the core, then drop the audio device so no callback competes with emulation
+	gbe_plus->start();
+	gbe_plus->db_unit.debug_mode = false;
+	SDL_CloseAudio();
+
+	if(!gbe_plus->running)
+	{
+		std::cout<<"BENCH::Error - Core failed to start\n";
+		return 1;
+	}
+
+	//Same CPU setup the DMG core performs at the top of run_core()
+	if(config::gb_type == 2)
+	{
+		DMG_core* dmg_core = dynamic_cast<DMG_core*>(gbe_plus);
+		if(dmg_core != NULL) { dmg_core->core_cpu.reg.a = 0x11; }
+	}
+
+	//Same direct boot the NDS core performs at the top of run_core()
+	else if((config::gb_type == 4) && ((!config::use_bios) || (!config::use_firmware)))
+	{
+		NTR_core* nds_core = dynamic_cast<NTR_core*>(gbe_plus);
+
+		if(nds_core != NULL)
+		{
+			nds_core->core_cpu_nds9.reg.r15 = nds_core->core_mmu.header.arm9_entry_addr;
+			nds_core->core_cpu_nds7.reg.r15 = nds_core->core_mmu.header.arm7_entry_addr;
+		}
+	}
+
+	u64 steps = 0;
+
+	//Warm up caches and let the game get past its boot sequence
+	if(!run_frames(gbe_plus, warmup_frames, steps)) { return 1; }
+
+	std::cout<<std::dec<<"BENCH::Running " << total_frames << " frames\n";
+
+	//Measure
+	steps = 0;
+	u32 start_frame = bench::frame_count;
+	auto start_time = std::chrono::steady_clock::now();
+
+	bool result = run_frames(gbe_plus, total_frames, steps);
+
+	auto end_time = std::chrono::steady_clock::now();
+	u32 frames = bench::frame_count - start_frame;
+
+	double elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+	double elapsed_s = elapsed_ns / 1000000000.0;
+
+	if((frames == 0) || (elapsed_s <= 0.0))
+	{
+		std::cout<<"BENCH::Error - No frames completed\n";
+		return 1;
+	}
+
+	std::cout<<std::dec<<std::fixed<<std::setprecision(2);
+	std::cout<<"BENCH::Frames : " << frames << "\n";
+	std::cout<<"BENCH::Host Time : " << elapsed_s << " s\n";
+	std::cout<<"BENCH::Frames/sec : " << (frames / elapsed_s) << "\n";
+	std::cout<<"BENCH::Instructions/sec : " << (steps / elapsed_s) << "\n";
+	std::cout<<"BENCH::Host ns/frame : " << (elapsed_ns / frames) << "\n";
+
+	return result ? 0 : 1;
+}
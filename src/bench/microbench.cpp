@@ -0,0 +1,620 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : microbench.cpp
+// Date : October 17, 2026
+// Description : Component microbenchmarks
+//
+// Times isolated hot kernels (memory reads, CPU ops, LCD and APU kernels) against synthetic inputs
+// Each kernel runs several timed trials, reporting the fastest and median nanoseconds per operation
+// Whole-ROM benchmarks are too noisy to show small wins in a single kernel
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#include "gba/core.h"
+#include "nds/core.h"
+#include "common/config.h"
+#include "common/gx_util.h"
+#include "common/lz_codec.h"
+#include "common/util.h"
+
+#include <SDL2/SDL_main.h>
+
+namespace micro
+{
+	std::string filter = "";
+	u32 time_ms = 500;
+	u32 trials = 5;
+
+	//Results are folded into this so no kernel gets optimized away
+	volatile u32 sink = 0;
+
+	//Fixed seed, every run sees the same inputs
+	u32 seed = 0x12345678;
+}
+
+/****** Returns the next pseudo-random number (xorshift) ******/
+u32 next_random()
+{
+	micro::seed ^= (micro::seed << 13);
+	micro::seed ^= (micro::seed >> 17);
+	micro::seed ^= (micro::seed << 5);
+	return micro::seed;
+}
+
+/****** Fills a block of emulated memory with pseudo-random bytes ******/
+void fill_random(u8* memory, u32 length)
+{
+	for(u32 x = 0; x < length; x++) { memory[x] = next_random(); }
+}
+
+/****** Generates random, aligned addresses inside a region ******/
+std::vector<u32> gen_addresses(u32 base, u32 length, u32 align)
+{
+	std::vector<u32> result(4096);
+	for(u32 x = 0; x < result.size(); x++) { result[x] = base + ((next_random() % length) & ~(align - 1)); }
+	return result;
+}
+
+/****** Times a number of calls to a kernel in nanoseconds ******/
+template <typename T> u64 time_calls(T &kernel, u64 calls)
+{
+	auto start_time = std::chrono::steady_clock::now();
+	for(u64 x = 0; x < calls; x++) { kernel(); }
+	auto end_time = std::chrono::steady_clock::now();
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+}
+
+/****** Runs and reports a single kernel - Each call to the kernel performs a given number of operations ******/
+template <typename T> void run_kernel(std::string name, u32 ops, T kernel)
+{
+	if((!micro::filter.empty()) && (name.find(micro::filter) == std::string::npos)) { return; }
+
+	u64 trial_ns = (u64(micro::time_ms) * 1000000) / micro::trials;
+	u64 calls = 1;
+
+	//Warm up while finding how many calls fill one trial
+	while(true)
+	{
+		u64 elapsed = time_calls(kernel, calls);
+
+		if(elapsed >= (trial_ns / 8))
+		{
+			calls = std::max<u64>(1, (calls * trial_ns) / std::max<u64>(1, elapsed));
+			break;
+		}
+
+		calls *= 2;
+	}
+
+	std::vector<double> results;
+
+	for(u32 x = 0; x < micro::trials; x++)
+	{
+		u64 elapsed = time_calls(kernel, calls);
+		results.push_back(double(elapsed) / double(calls * ops));
+	}
+
+	std::sort(results.begin(), results.end());
+
+	std::cout<<std::fixed<<std::setprecision(2);
+	std::cout<<"MICRO::" << std::left << std::setw(44) << name << std::right;
+	std::cout<<" : " << std::setw(10) << results[0] << " ns/op (best) :: " << std::setw(10) << results[results.size() / 2] << " ns/op (median)\n";
+}
+
+/****** Discards frames the LCD finishes while kernels run ******/
+void micro_render_sw(std::vector<u32>& image) { }
+
+/****** Discards hardware rendered frames ******/
+void micro_render_hw(SDL_Surface* image) { }
+
+//Kernels that live in private parts of the cores are driven from here
+class micro_bench
+{
+	public:
+
+	static void agb_mmu(AGB_core* core);
+	static void agb_cpu(AGB_core* core);
+	static void agb_lcd(AGB_core* core);
+	static void agb_apu(AGB_core* core);
+	static void ntr_mmu(NTR_core* core);
+	static void ntr_lcd(NTR_core* core);
+	static void common_kernels();
+};
+
+/****** GBA memory reads across every region ******/
+void micro_bench::agb_mmu(AGB_core* core)
+{
+	AGB_MMU* mem = &core->core_mmu;
+
+	struct region
+	{
+		std::string name;
+		u32 base;
+		u32 length;
+	};
+
+	const region regions[] =
+	{
+		{ "BIOS", 0x0000000, 0x4000 },
+		{ "EWRAM", 0x2000000, 0x40000 },
+		{ "IWRAM", 0x3000000, 0x8000 },
+		{ "I/O", 0x4000000, 0x60 },
+		{ "Palette", 0x5000000, 0x400 },
+		{ "VRAM", 0x6000000, 0x18000 },
+		{ "OAM", 0x7000000, 0x400 },
+		{ "ROM", 0x8000000, 0x100000 },
+		{ "SRAM", 0xE000000, 0x8000 },
+	};
+
+	for(const region &area : regions)
+	{
+		if(area.base != 0x4000000) { fill_random(&mem->memory_map[area.base], area.length); }
+
+		std::vector<u32> addr_8 = gen_addresses(area.base, area.length, 1);
+		std::vector<u32> addr_32 = gen_addresses(area.base, area.length, 4);
+
+		run_kernel("AGB_MMU::read_u8 " + area.name, addr_8.size(), [&]()
+		{
+			u32 result = 0;
+			for(u32 x = 0; x < addr_8.size(); x++) { result += mem->read_u8(addr_8[x]); }
+			micro::sink = result;
+		});
+
+		run_kernel("AGB_MMU::read_u32 " + area.name, addr_32.size(), [&]()
+		{
+			u32 result = 0;
+			for(u32 x = 0; x < addr_32.size(); x++) { result += mem->read_u32(addr_32[x]); }
+			micro::sink = result;
+		});
+	}
+}
+
+/****** ARM data processing and the THUMB decoder ******/
+void micro_bench::agb_cpu(AGB_core* core)
+{
+	ARM7* cpu = &core->core_cpu;
+
+	//ADD, SUBS, MOV LSL #imm, MOV ASR reg, CMP #imm, AND #imm, ORR, EORS
+	const u32 arm_ops[8] = { 0xE0810002, 0xE0530004, 0xE1A05186, 0xE1A07358, 0xE3590010, 0xE20AA0FF, 0xE18BB00C, 0xE0300001 };
+
+	for(u32 x = 0; x < 13; x++) { cpu->set_reg(x, next_random()); }
+
+	run_kernel("ARM7::data_processing", 8, [&]()
+	{
+		for(u32 x = 0; x < 8; x++) { cpu->data_processing(arm_ops[x]); }
+	});
+
+	//Random halfwords land on every THUMB format
+	std::vector<u16> thumb_ops(4096);
+	for(u32 x = 0; x < thumb_ops.size(); x++) { thumb_ops[x] = next_random(); }
+
+	ARM7::instr_modes old_mode = cpu->arm_mode;
+	u8 pipeline_id = (cpu->pipeline_pointer + 2) % 3;
+	cpu->arm_mode = ARM7::THUMB;
+
+	run_kernel("ARM7::decode THUMB", thumb_ops.size(), [&]()
+	{
+		u32 result = 0;
+
+		for(u32 x = 0; x < thumb_ops.size(); x++)
+		{
+			cpu->instruction_pipeline[pipeline_id] = thumb_ops[x];
+			cpu->instruction_operation[pipeline_id] = ARM7::UNDEFINED;
+			cpu->decode();
+			result += cpu->instruction_operation[pipeline_id];
+		}
+
+		micro::sink = result;
+	});
+
+	cpu->arm_mode = old_mode;
+}
+
+/****** GBA BG, sprite, and blending kernels over a full synthetic frame ******/
+void micro_bench::agb_lcd(AGB_core* core)
+{
+	AGB_MMU* mem = &core->core_mmu;
+	AGB_LCD* lcd = &core->core_cpu.controllers.video;
+
+	//Mode 0, BG0 + OBJ, 4bpp tiles, map at 0x600F800
+	mem->write_u16(DISPCNT, 0x1100);
+	mem->write_u16(BG0CNT, 0x1F00);
+	mem->write_u16(BG0HOFS, 0x13);
+	mem->write_u16(BG0VOFS, 0x07);
+
+	//Alpha blend OBJ over BG0
+	mem->write_u16(BLDCNT, 0x0150);
+	mem->write_u16(BLDALPHA, 0x0808);
+
+	fill_random(&mem->memory_map[0x6000000], 0x10000);
+
+	for(u32 x = 0; x < 0x400; x += 2) { mem->write_u16(0x5000000 + x, next_random() & 0x7FFF); }
+
+	//Scatter 64 regular 16x16 sprites, the rest stay hidden
+	for(u32 x = 0; x < 128; x++)
+	{
+		u32 oam_addr = 0x7000000 + (x * 8);
+
+		if(x < 64)
+		{
+			mem->write_u16(oam_addr, (next_random() % 160));
+			mem->write_u16(oam_addr + 2, 0x4000 | (next_random() % 240));
+			mem->write_u16(oam_addr + 4, (next_random() & 0x3FF) | 0x400);
+		}
+
+		else { mem->write_u16(oam_addr, 0x200); }
+	}
+
+	lcd->update_oam();
+	lcd->update_palettes();
+
+	run_kernel("AGB_LCD::render_bg_mode_0", 240 * 160, [&]()
+	{
+		u32 result = 0;
+
+		for(u32 y = 0; y < 160; y++)
+		{
+			lcd->current_scanline = y;
+
+			for(u32 x = 0; x < 240; x++)
+			{
+				lcd->scanline_pixel_counter = x;
+				result += lcd->render_bg_mode_0(BG0CNT);
+			}
+		}
+
+		micro::sink = result;
+	});
+
+	run_kernel("AGB_LCD::render_sprite_pixel", 240 * 160, [&]()
+	{
+		u32 result = 0;
+
+		for(u32 y = 0; y < 160; y++)
+		{
+			lcd->current_scanline = y;
+			lcd->update_obj_render_list();
+
+			for(u32 x = 0; x < 240; x++)
+			{
+				lcd->scanline_pixel_counter = x;
+				result += lcd->render_sprite_pixel();
+			}
+		}
+
+		micro::sink = result;
+	});
+
+	run_kernel("AGB_LCD::alpha_blend", 240 * 160, [&]()
+	{
+		u32 result = 0;
+
+		for(u32 y = 0; y < 160; y++)
+		{
+			lcd->current_scanline = y;
+			lcd->update_obj_render_list();
+
+			for(u32 x = 0; x < 240; x++)
+			{
+				lcd->scanline_pixel_counter = x;
+
+				//OBJ is the 1st target, blend with whatever is behind it
+				lcd->obj_win_pixel = false;
+				lcd->last_obj_priority = 0;
+				lcd->last_bg_priority = 4;
+				lcd->last_raw_color = lcd->raw_pal[x & 0xFF][1];
+				result += lcd->alpha_blend();
+			}
+		}
+
+		micro::sink = result;
+	});
+
+	run_kernel("AGB_LCD::render_scanline", 240 * 160, [&]()
+	{
+		for(u32 y = 0; y < 160; y++)
+		{
+			lcd->current_scanline = y;
+			lcd->update_obj_render_list();
+
+			for(u32 x = 0; x < 240; x++)
+			{
+				lcd->scanline_pixel_counter = x;
+				lcd->render_scanline();
+			}
+		}
+
+		micro::sink = lcd->scanline_buffer[0];
+	});
+}
+
+/****** GBA sample generation for one VBlank's worth of audio ******/
+void micro_bench::agb_apu(AGB_core* core)
+{
+	AGB_MMU* mem = &core->core_mmu;
+	AGB_APU* apu = &core->core_cpu.controllers.audio;
+
+	apu->apu_stat.psg_fill_rate = apu->apu_stat.sample_rate / 60;
+	int length = apu->apu_stat.psg_fill_rate;
+
+	std::vector<s16> stream(length);
+
+	//All PSG channels on both sides, DMA A on both sides
+	mem->write_u8(SNDCNT_X, 0x80);
+	mem->write_u8(SNDCNT_L, 0x77);
+	mem->write_u8(SNDCNT_L+1, 0xFF);
+	mem->write_u16(SNDCNT_H, 0x0306);
+
+	//Square waves with sweep and envelope, playing continuously
+	mem->write_u8(SND1CNT_L, 0x12);
+	mem->write_u16(SND1CNT_H, 0xF780);
+	mem->write_u16(SND1CNT_X, 0x8600);
+	mem->write_u16(SND2CNT_L, 0xA740);
+	mem->write_u16(SND2CNT_H, 0x8500);
+
+	//Wave channel
+	for(u32 x = 0; x < 16; x++) { mem->write_u8(WAVERAM0_L + x, next_random()); }
+	mem->write_u8(SND3CNT_L, 0x80);
+	mem->write_u16(SND3CNT_H, 0x2000);
+	mem->write_u16(SND3CNT_X, 0x8700);
+
+	//Noise channel
+	mem->write_u16(SND4CNT_L, 0xF000);
+	mem->write_u16(SND4CNT_H, 0x8021);
+
+	for(u32 x = 0; x < 0x10000; x++) { apu->apu_stat.dma[0].buffer[x] = next_random(); }
+	apu->apu_stat.dma[0].output_frequency = 32768;
+
+	run_kernel("AGB_APU::generate_channel_1_samples", length, [&]() { apu->generate_channel_1_samples(&stream[0], length); micro::sink = stream[0]; });
+	run_kernel("AGB_APU::generate_channel_2_samples", length, [&]() { apu->generate_channel_2_samples(&stream[0], length); micro::sink = stream[0]; });
+	run_kernel("AGB_APU::generate_channel_3_samples", length, [&]() { apu->generate_channel_3_samples(&stream[0], length); micro::sink = stream[0]; });
+	run_kernel("AGB_APU::generate_channel_4_samples", length, [&]() { apu->generate_channel_4_samples(&stream[0], length); micro::sink = stream[0]; });
+
+	run_kernel("AGB_APU::generate_dma_a_samples", length, [&]()
+	{
+		//Keep the FIFO from running dry
+		apu->apu_stat.dma[0].length = 0x8000;
+		apu->apu_stat.dma[0].last_position = 0;
+
+		apu->generate_dma_a_samples(&stream[0], length);
+		micro::sink = stream[0];
+	});
+}
+
+/****** NDS memory reads with different DTCM and WRAM setups ******/
+void micro_bench::ntr_mmu(NTR_core* core)
+{
+	NTR_MMU* mem = &core->core_mmu;
+
+	fill_random(&mem->memory_map[0x2000000], 0x40000);
+	fill_random(&mem->memory_map[0x3000000], 0x8000);
+	fill_random(&mem->memory_map[0x3800000], 0x10000);
+	fill_random(mem->dtcm.data(), mem->dtcm.size());
+
+	mem->fetch_request = false;
+	mem->dtcm_addr = 0x27C0000;
+	mem->dtcm_end = 0x27C3FFF;
+	mem->dtcm_load_mode = false;
+
+	struct setup
+	{
+		std::string name;
+		u8 access_mode;
+		u8 wram_mode;
+		u32 base;
+		u32 length;
+	};
+
+	const setup setups[] =
+	{
+		{ "ARM9 DTCM", 1, 0, 0x27C0000, 0x4000 },
+		{ "ARM9 Main RAM", 1, 0, 0x2000000, 0x40000 },
+		{ "ARM9 WRAM Mode 0", 1, 0, 0x3000000, 0x8000 },
+		{ "ARM9 WRAM Mode 1", 1, 1, 0x3000000, 0x8000 },
+		{ "ARM9 WRAM Mode 2", 1, 2, 0x3000000, 0x8000 },
+		{ "ARM7 Main RAM", 0, 0, 0x2000000, 0x40000 },
+		{ "ARM7 WRAM Mode 0", 0, 0, 0x3000000, 0x8000 },
+		{ "ARM7 WRAM Mode 3", 0, 3, 0x3000000, 0x8000 },
+		{ "ARM7 Private WRAM", 0, 0, 0x3800000, 0x10000 },
+	};
+
+	u8 old_access = mem->access_mode;
+	u8 old_wram = mem->wram_mode;
+
+	for(const setup &test : setups)
+	{
+		std::vector<u32> addr_8 = gen_addresses(test.base, test.length, 1);
+
+		mem->access_mode = test.access_mode;
+		mem->wram_mode = test.wram_mode;
+
+		run_kernel("NTR_MMU::read_u8 " + test.name, addr_8.size(), [&]()
+		{
+			u32 result = 0;
+			for(u32 x = 0; x < addr_8.size(); x++) { result += mem->read_u8(addr_8[x]); }
+			micro::sink = result;
+		});
+	}
+
+	mem->access_mode = old_access;
+	mem->wram_mode = old_wram;
+}
+
+/****** NDS texture generation and textured polygon fills ******/
+void micro_bench::ntr_lcd(NTR_core* core)
+{
+	NTR_MMU* mem = &core->core_mmu;
+	NTR_LCD* lcd = &core->core_cpu_nds9.controllers.video;
+
+	//Textures and palettes in LCDC VRAM
+	mem->vram_tex_slot[0] = 0x6800000;
+	fill_random(&mem->memory_map[0x6800000], 0x20000);
+	fill_random(&mem->memory_map[0x6880000], 0x2000);
+
+	lcd->lcd_3D_stat.tex_offset = 0;
+	lcd->lcd_3D_stat.pal_bank_addr = 0x6880000;
+	lcd->lcd_3D_stat.pal_base = 0;
+	lcd->lcd_3D_stat.tex_src_width = 64;
+	lcd->lcd_3D_stat.tex_src_height = 64;
+	lcd->lcd_3D_stat.tex_color_zero = true;
+
+	const std::string tex_names[7] = { "A3I5", "4-Color", "16-Color", "256-Color", "Compressed", "A5I3", "Direct" };
+
+	for(u32 format = 1; format <= 7; format++)
+	{
+		run_kernel("NTR_LCD::gen_tex_" + util::to_str(format) + " " + tex_names[format - 1] + " 64x64", 64 * 64, [&]()
+		{
+			switch(format)
+			{
+				case 0x1: lcd->gen_tex_1(0x6800000); break;
+				case 0x2: lcd->gen_tex_2(0x6800000); break;
+				case 0x3: lcd->gen_tex_3(0x6800000); break;
+				case 0x4: lcd->gen_tex_4(0x6800000); break;
+				case 0x5: lcd->gen_tex_5(0x6800000); break;
+				case 0x6: lcd->gen_tex_6(0x6800000); break;
+				case 0x7: lcd->gen_tex_7(0x6800000); break;
+			}
+
+			micro::sink = lcd->lcd_3D_stat.tex_data.size();
+		});
+	}
+
+	//A 128x128 opaque, modulated quad with a repeating 16-color texture
+	lcd->lcd_3D_stat.tex_format = 3;
+	lcd->lcd_3D_stat.repeat_tex_x = true;
+	lcd->lcd_3D_stat.repeat_tex_y = true;
+	lcd->lcd_3D_stat.flip_tex_x = false;
+	lcd->lcd_3D_stat.flip_tex_y = false;
+	lcd->lcd_3D_stat.poly_alpha = 31;
+	lcd->lcd_3D_stat.poly_mode = 0;
+	lcd->lcd_3D_stat.poly_id = 0;
+	lcd->lcd_3D_stat.poly_new_depth = false;
+	lcd->lcd_3D_stat.poly_depth_test = true;
+	lcd->lcd_3D_stat.vertex_color = 0xFFC08040;
+	lcd->lcd_3D_stat.edge_marking = false;
+	lcd->lcd_3D_stat.poly_min_x = 64;
+	lcd->lcd_3D_stat.poly_max_x = 191;
+
+	for(u32 x = 0; x < 256; x++)
+	{
+		lcd->lcd_3D_stat.hi_fill[x] = 32;
+		lcd->lcd_3D_stat.lo_fill[x] = 160;
+		lcd->lcd_3D_stat.hi_overflow[x] = 0;
+		lcd->lcd_3D_stat.lo_overflow[x] = 0;
+		lcd->lcd_3D_stat.hi_line_z[x] = 0.25;
+		lcd->lcd_3D_stat.lo_line_z[x] = 0.75;
+		lcd->lcd_3D_stat.hi_tx[x] = float(x) - 64.0;
+		lcd->lcd_3D_stat.lo_tx[x] = float(x) - 64.0;
+		lcd->lcd_3D_stat.hi_ty[x] = 0.0;
+		lcd->lcd_3D_stat.lo_ty[x] = 128.0;
+	}
+
+	for(u32 x = 0; x < lcd->gx_z_buffer.size(); x++) { lcd->gx_z_buffer[x] = 1.0; }
+
+	run_kernel("NTR_LCD::fill_poly_textured 128x128", 128 * 128, [&]()
+	{
+		lcd->fill_poly_textured();
+		micro::sink = lcd->gx_screen_buffer[0][0x4040];
+	});
+}
+
+/****** Shared math and hashing kernels ******/
+void micro_bench::common_kernels()
+{
+	gx_matrix matrix_a(4, 4);
+	gx_matrix matrix_b(4, 4);
+
+	for(u32 x = 0; x < 16; x++)
+	{
+		matrix_a.data[x] = float(s32(next_random() % 2001) - 1000) / 1000.0;
+		matrix_b.data[x] = float(s32(next_random() % 2001) - 1000) / 1000.0;
+	}
+
+	run_kernel("gx_matrix::operator* 4x4", 1, [&]()
+	{
+		gx_matrix result = matrix_a * matrix_b;
+		micro::sink = result.data[5];
+	});
+
+	std::vector<u8> data(0x10000);
+	for(u32 x = 0; x < data.size(); x++) { data[x] = next_random(); }
+
+	run_kernel("util::get_crc32 (per byte)", data.size(), [&]()
+	{
+		micro::sink = util::get_crc32(data.data(), data.size());
+	});
+
+	//Save states are mostly zeros with scattered live data
+	std::vector<u8> state_data(0x10000, 0);
+	for(u32 x = 0; x < state_data.size(); x += 64) { state_data[x + (next_random() % 64)] = next_random(); }
+
+	std::vector<u8> packed_data;
+	std::vector<u8> unpacked_data(state_data.size());
+
+	run_kernel("lz_compress (per byte)", state_data.size(), [&]()
+	{
+		micro::sink = lz_compress(state_data.data(), state_data.size(), packed_data);
+	});
+
+	run_kernel("lz_decompress (per byte)", state_data.size(), [&]()
+	{
+		micro::sink = lz_decompress(packed_data.data(), packed_data.size(), unpacked_data.data(), unpacked_data.size());
+	});
+}
+
+int main(int argc, char* args[])
+{
+	std::cout<<"GBE+ 1.8 [Microbenchmark]\n";
+
+	for(int x = 1; x < argc; x++)
+	{
+		std::string arg = args[x];
+
+		//Only run kernels whose names contain this text
+		if((arg == "--filter") && ((x + 1) < argc)) { micro::filter = args[++x]; }
+
+		//Approximate time spent measuring each kernel
+		else if((arg == "--time") && ((x + 1) < argc))
+		{
+			if(!util::from_str(args[++x], micro::time_ms) || (micro::time_ms == 0)) { std::cout<<"MICRO::Error - Invalid time\n"; return 1; }
+		}
+
+		//Number of timed trials per kernel
+		else if((arg == "--trials") && ((x + 1) < argc))
+		{
+			if(!util::from_str(args[++x], micro::trials) || (micro::trials == 0)) { std::cout<<"MICRO::Error - Invalid trial count\n"; return 1; }
+		}
+
+		else
+		{
+			std::cout<<"\ngbe_microbench [--filter text] [--time ms] [--trials N]\n";
+			return 1;
+		}
+	}
+
+	//Kernels that finish frames or touch audio must never reach a window or device
+	config::sdl_render = false;
+	config::use_opengl = false;
+	config::render_external_sw = micro_render_sw;
+	config::render_external_hw = micro_render_hw;
+	config::turbo = true;
+	config::volume = 0;
+
+	AGB_core* agb_core = new AGB_core();
+	NTR_core* ntr_core = new NTR_core();
+
+	micro_bench::agb_mmu(agb_core);
+	micro_bench::agb_cpu(agb_core);
+	micro_bench::agb_lcd(agb_core);
+	micro_bench::agb_apu(agb_core);
+	micro_bench::ntr_mmu(ntr_core);
+	micro_bench::ntr_lcd(ntr_core);
+	micro_bench::common_kernels();
+
+	return 0;
+}
@@ -0,0 +1,358 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : check.cpp
+// Date : October 17, 2026
+// Description : Lockstep differential checker
+//
+// Runs two GBA cores side by side without a window, audio device, or frame limiter
+// The reference core uses the plain interpreter and memory paths, the other uses every fast path enabled in this build
+// Compares registers, memory regions, machine state, and framebuffers, then reports the first divergence
+
+#include <iomanip>
+
+#include "gba/core.h"
+#include "common/config.h"
+#include "common/util.h"
+
+#include <SDL2/SDL_main.h>
+
+namespace check
+{
+	u32 frame_interval = 1;
+	u32 step_interval = 1;
+	u64 steps = 0;
+	u64 cycles = 0;
+
+	//Last frame each core rendered, and which core is stepping right now (0 = reference, 1 = fast)
+	std::vector<u32>* frame_buffer[2] = { NULL, NULL };
+	u32 current_core = 0;
+
+	//Memory regions compared at each frame check
+	struct region
+	{
+		std::string name;
+		u32 start;
+		u32 length;
+	};
+
+	const region regions[] =
+	{
+		{ "EWRAM", 0x2000000, 0x40000 },
+		{ "IWRAM", 0x3000000, 0x8000 },
+		{ "I/O", 0x4000000, 0x400 },
+		{ "Palette", 0x5000000, 0x400 },
+		{ "VRAM", 0x6000000, 0x18000 },
+		{ "OAM", 0x7000000, 0x400 },
+		{ "SRAM", 0xE000000, 0x10000 },
+	};
+
+	const std::string reg_names[] =
+	{
+		"R0", "R1", "R2", "R3", "R4", "R5", "R6", "R7", "R8", "R9", "R10", "R11", "R12", "R13", "R14", "R15", "CPSR",
+		"R8_FIQ", "R9_FIQ", "R10_FIQ", "R11_FIQ", "R12_FIQ", "R13_FIQ", "R14_FIQ", "SPSR_FIQ",
+		"R13_SVC", "R14_SVC", "SPSR_SVC",
+		"R13_ABT", "R14_ABT", "SPSR_ABT",
+		"R13_IRQ", "R14_IRQ", "SPSR_IRQ",
+		"R13_UND", "R14_UND", "SPSR_UND",
+	};
+}
+
+/****** Remembers the frame rendered by whichever core is stepping ******/
+void check_render_sw(std::vector<u32>& image) { check::frame_buffer[check::current_core] = &image; }
+
+/****** Discards hardware rendered frames ******/
+void check_render_hw(SDL_Surface* image) { }
+
+/****** Pulls checker-only arguments out of the command-line ******/
+bool parse_check_args(u32 &total_frames)
+{
+	std::vector <std::string> core_args;
+
+	for(u32 x = 0; x < config::cli_args.size(); x++)
+	{
+		//Number of frames to check
+		if(config::cli_args[x] == "--frames")
+		{
+			if((++x) == config::cli_args.size()) { std::cout<<"CHECK::Error - No frame count specified\n"; return false; }
+			if(!util::from_str(config::cli_args[x], total_frames)) { std::cout<<"CHECK::Error - Invalid frame count\n"; return false; }
+		}
+
+		//Compare memory, machine state, and framebuffers every N frames
+		else if(config::cli_args[x] == "--frame-interval")
+		{
+			if((++x) == config::cli_args.size()) { std::cout<<"CHECK::Error - No frame interval specified\n"; return false; }
+			if(!util::from_str(config::cli_args[x], check::frame_interval)) { std::cout<<"CHECK::Error - Invalid frame interval\n"; return false; }
+		}
+
+		//Compare registers every N instructions (0 = only at frame checks)
+		else if(config::cli_args[x] == "--step-interval")
+		{
+			if((++x) == config::cli_args.size()) { std::cout<<"CHECK::Error - No step interval specified\n"; return false; }
+			if(!util::from_str(config::cli_args[x], check::step_interval)) { std::cout<<"CHECK::Error - Invalid step interval\n"; return false; }
+		}
+
+		//Everything else goes to the normal GBE+ parser
+		else { core_args.push_back(config::cli_args[x]); }
+	}
+
+	config::cli_args = core_args;
+
+	if((total_frames == 0) || (check::frame_interval == 0))
+	{
+		std::cout<<"CHECK::Error - Frame count and frame interval must be greater than 0\n";
+		return false;
+	}
+
+	return true;
+}
+
+/****** Prints where the cores stand when they diverge ******/
+void report_divergence(AGB_core* reference, AGB_core* fast, std::string reason)
+{
+	std::cout<<std::hex<<std::setfill('0');
+	std::cout<<"CHECK::Divergence - " << reason << "\n";
+	std::cout<<"CHECK::Frame " << std::dec << reference->core_cpu.controllers.video.frame_count;
+	std::cout<<" :: Instruction " << check::steps << " :: Cycle " << check::cycles << "\n";
+	std::cout<<std::hex;
+	std::cout<<"CHECK::Reference PC 0x" << std::setw(8) << reference->core_cpu.reg.r15;
+	std::cout<<" :: Fast PC 0x" << std::setw(8) << fast->core_cpu.reg.r15 << "\n";
+	std::cout<<std::dec<<std::setfill(' ');
+}
+
+/****** Compares the register files, returns false on the first mismatch ******/
+bool compare_registers(AGB_core* reference, AGB_core* fast)
+{
+	const u32* ref_regs = (const u32*)&reference->core_cpu.reg;
+	const u32* fast_regs = (const u32*)&fast->core_cpu.reg;
+	u32 count = sizeof(reference->core_cpu.reg) / 4;
+
+	for(u32 x = 0; x < count; x++)
+	{
+		if(ref_regs[x] != fast_regs[x])
+		{
+			std::stringstream reason;
+			reason << check::reg_names[x] << " - Reference 0x" << std::hex << ref_regs[x] << " :: Fast 0x" << fast_regs[x];
+
+			report_divergence(reference, fast, reason.str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/****** Compares memory regions, machine state, and framebuffers, returns false on the first mismatch ******/
+bool compare_frame(AGB_core* reference, AGB_core* fast)
+{
+	if(!compare_registers(reference, fast)) { return false; }
+
+	if(reference->core_cpu.controllers.video.frame_count != fast->core_cpu.controllers.video.frame_count)
+	{
+		report_divergence(reference, fast, "Frame count");
+		return false;
+	}
+
+	for(const check::region &area : check::regions)
+	{
+		u32 ref_crc = util::get_crc32(&reference->core_mmu.memory_map[area.start], area.length);
+		u32 fast_crc = util::get_crc32(&fast->core_mmu.memory_map[area.start], area.length);
+
+		if(ref_crc != fast_crc)
+		{
+			//Pinpoint the first differing byte
+			u32 addr = area.start;
+			while(reference->core_mmu.memory_map[addr] == fast->core_mmu.memory_map[addr]) { addr++; }
+
+			std::stringstream reason;
+			reason << area.name << " @ 0x" << std::hex << addr << " - Reference 0x" << (u32)reference->core_mmu.memory_map[addr];
+			reason << " :: Fast 0x" << (u32)fast->core_mmu.memory_map[addr];
+
+			report_divergence(reference, fast, reason.str());
+			return false;
+		}
+	}
+
+	std::vector<u32>* ref_screen = check::frame_buffer[0];
+	std::vector<u32>* fast_screen = check::frame_buffer[1];
+
+	if((ref_screen == NULL) != (fast_screen == NULL))
+	{
+		report_divergence(reference, fast, "Framebuffer");
+		return false;
+	}
+
+	if((ref_screen != NULL) && ((ref_screen->size() != fast_screen->size())
+	|| (util::get_crc32((u8*)ref_screen->data(), ref_screen->size() * 4) != util::get_crc32((u8*)fast_screen->data(), fast_screen->size() * 4))))
+	{
+		report_divergence(reference, fast, "Framebuffer");
+		return false;
+	}
+
+	//Catch everything else (timers, DMA, APU, LCD internals) through the full save state
+	std::vector<u8> ref_state;
+	std::vector<u8> fast_state;
+
+	if((reference->serialize(ref_state)) && (fast->serialize(fast_state)) && (ref_state != fast_state))
+	{
+		u32 offset = 0;
+		while((offset < ref_state.size()) && (offset < fast_state.size()) && (ref_state[offset] == fast_state[offset])) { offset++; }
+
+		std::stringstream reason;
+		reason << "Machine state @ offset 0x" << std::hex << offset;
+
+		report_divergence(reference, fast, reason.str());
+		return false;
+	}
+
+	return true;
+}
+
+/****** Loads the ROM and starts a core ******/
+bool start_core(AGB_core* core, u32 index)
+{
+	check::current_core = index;
+
+	if((config::use_bios) && (!core->read_bios(config::bios_file))) { return false; }
+	if(!core->read_file(config::rom_file)) { return false; }
+
+	//Engage the core, then drop the audio device so the second core can open it too
+	core->start();
+	core->db_unit.debug_mode = false;
+	SDL_CloseAudio();
+
+	return core->running;
+}
+
+int main(int argc, char* args[])
+{
+	std::cout<<"GBE+ 1.8 [Lockstep Checker]\n";
+
+	u32 total_frames = 600;
+
+	//Grab command-line arguments
+	for(int x = 0; x++ < argc - 1;)
+	{
+		std::string temp_arg = args[x];
+		config::cli_args.push_back(temp_arg);
+	}
+
+	if(!parse_check_args(total_frames)) { return 1; }
+
+	if(config::cli_args.empty())
+	{
+		std::cout<<"\ngbe_check file [--frames N] [--frame-interval N] [--step-interval N] [options ...]\n";
+		return 1;
+	}
+
+	parse_filenames();
+
+	//Parse .ini options
+	parse_ini_file();
+
+	//Parse command-line arguments
+	//These will override .ini options!
+	if(!parse_cli_args()) { return 1; }
+
+	//Force headless, unthrottled operation regardless of .ini options
+	config::sdl_render = false;
+	config::use_opengl = false;
+	config::render_external_sw = check_render_sw;
+	config::render_external_hw = check_render_hw;
+	config::turbo = true;
+	config::turbo_frameskip = 0;
+	config::use_debugger = false;
+	config::use_netplay = false;
+	config::use_cheats = false;
+	config::volume = 0;
+
+	//Both cores must see exactly the same input, so only playback is allowed
+	config::movie_record_file = "";
+
+	//Both cores would record to the same files
+	config::av_record_file = "";
+	config::health_log_file = "";
+
+	//Both cores share one save file, leave writing it to the usual save on exit
+	config::save_flush_interval = 0;
+
+	//Let the APU initialize without a real audio device
+	if(config::override_audio_driver.empty()) { config::override_audio_driver = "dummy"; }
+
+	config::gb_type = get_system_type_from_file(config::rom_file);
+
+	if(config::gb_type != 0x3)
+	{
+		std::cout<<"CHECK::Error - Only the GBA core has fast paths to check\n";
+		return 1;
+	}
+
+	if((config::use_bios) && (config::bios_file == "")) { config::bios_file = config::agb_bios_path; }
+
+	AGB_core* reference = new AGB_core();
+	AGB_core* fast = new AGB_core();
+
+	//Reference core sticks to the plain interpreter and memory paths
+	reference->core_cpu.fast_fetch = false;
+
+	#ifndef GBE_FAST_FETCH
+	std::cout<<"CHECK::Warning - Built without FAST_FETCH, both cores take the same paths\n";
+	#endif
+
+	if((!start_core(reference, 0)) || (!start_core(fast, 1)))
+	{
+		std::cout<<"CHECK::Error - Core failed to start\n";
+		return 1;
+	}
+
+	std::cout<<"CHECK::Checking " << std::dec << total_frames << " frames\n";
+
+	u32 last_frame = reference->core_cpu.controllers.video.frame_count;
+	u32 checked_frames = 0;
+	bool result = true;
+
+	while((checked_frames < total_frames) && (reference->running) && (fast->running))
+	{
+		check::current_core = 0;
+		reference->step();
+
+		check::current_core = 1;
+		fast->step();
+
+		check::steps++;
+		check::cycles += reference->core_cpu.system_cycles;
+
+		if((check::step_interval) && ((check::steps % check::step_interval) == 0) && (!compare_registers(reference, fast)))
+		{
+			result = false;
+			break;
+		}
+
+		//Check everything else on frame boundaries
+		if(reference->core_cpu.controllers.video.frame_count != last_frame)
+		{
+			last_frame = reference->core_cpu.controllers.video.frame_count;
+			checked_frames++;
+
+			if(((checked_frames % check::frame_interval) == 0) && (!compare_frame(reference, fast)))
+			{
+				result = false;
+				break;
+			}
+		}
+	}
+
+	if(result)
+	{
+		std::cout<<"CHECK::Passed - " << std::dec << checked_frames << " frames :: " << check::steps << " instructions :: " << check::cycles << " cycles\n";
+	}
+
+	reference->shutdown();
+	delete reference;
+
+	fast->shutdown();
+	delete fast;
+
+	return result ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : audio_buffer.cpp
+// Date : October 17, 2026
+// Description : Audio ring buffer
+//
+// Lock-free single producer, single consumer ring between the emulation thread and the SDL audio callback
+// The core mixes samples as it emulates, the callback only copies them out
+// Samples are interleaved, reads and writes always cover whole frames (one sample per channel)
+// When syncing to audio, the device's clock paces emulation and a small resampling ratio holds the buffer at its target
+
+#include <chrono>
+
+#include <SDL2/SDL.h>
+
+#include "audio_buffer.h"
+#include "av_recorder.h"
+#include "config.h"
+
+//Dynamic rate control never strays more than 0.5% from the nominal rate
+const double MAX_RATE_DELTA = 0.005;
+
+//Stop pacing on the device if its callback has not run for this long (nanoseconds), e.g. while audio is paused
+const u64 SYNC_TIMEOUT = 250000000;
+
+/****** Returns a monotonic timestamp in nanoseconds ******/
+static u64 get_timestamp()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/****** Audio Buffer Constructor ******/
+audio_buffer::audio_buffer()
+{
+	mask = 0;
+	channels = 1;
+	sample_rate = 0;
+	target = 0;
+	recorder = NULL;
+	clear();
+}
+
+/****** Audio Buffer Destructor ******/
+audio_buffer::~audio_buffer() { }
+
+/****** Allocates room for at least the given number of samples - Never call while the callback runs ******/
+void audio_buffer::resize(u32 samples, u8 channel_count, u32 frequency)
+{
+	channels = (channel_count == 2) ? 2 : 1;
+	sample_rate = frequency;
+
+	//Aim for about 2 frames of samples waiting beyond what the device already holds
+	target = (sample_rate / 30) * channels;
+
+	//Always leave plenty of headroom above the target
+	u32 capacity = 1;
+	while((capacity < samples) || (capacity < (target * 4))) { capacity <<= 1; }
+
+	buffer.assign(capacity, 0);
+	mask = capacity - 1;
+
+	clear();
+}
+
+/****** Empties the buffer and resets the counters - Never call while the callback runs ******/
+void audio_buffer::clear()
+{
+	read_pos = 0;
+	write_pos = 0;
+
+	underruns = 0;
+	overruns = 0;
+
+	last_frame[0] = 0;
+	last_frame[1] = 0;
+
+	ratio = 1.0;
+	position = 0.0;
+	average_fill = target;
+	last_input[0] = 0;
+	last_input[1] = 0;
+
+	last_read_time = 0;
+}
+
+/****** Adds samples to the buffer, drops whatever does not fit - Emulation thread only ******/
+void audio_buffer::write(const s16* samples, u32 count)
+{
+	if(recorder != NULL) { recorder->push_audio(samples, count, channels, sample_rate); }
+
+	if(buffer.empty()) { return; }
+
+	u32 current_write = write_pos.load(std::memory_order_relaxed);
+	u32 space = buffer.size() - (current_write - read_pos.load(std::memory_order_acquire));
+	u32 length = 0;
+
+	update_ratio();
+
+	//Copy straight through at the nominal rate
+	if(ratio == 1.0)
+	{
+		length = count;
+
+		if(length > space)
+		{
+			length = space - (space % channels);
+			overruns++;
+		}
+
+		for(u32 x = 0; x < length; x++) { buffer[(current_write + x) & mask] = samples[x]; }
+
+		if(count >= channels)
+		{
+			last_input[0] = samples[count - channels];
+			last_input[1] = samples[count - 1];
+		}
+
+		//Resampling picks up right after the last frame copied
+		position = 1.0;
+	}
+
+	//Otherwise resample with linear interpolation, starting between the last input frame and the first new one
+	else
+	{
+		u32 frames = count / channels;
+		double step = 1.0 / ratio;
+
+		while(position < frames)
+		{
+			if((length + channels) > space)
+			{
+				overruns++;
+				break;
+			}
+
+			u32 index = position;
+			double weight = position - index;
+
+			for(u32 y = 0; y < channels; y++)
+			{
+				s16 start = (index == 0) ? last_input[y] : samples[((index - 1) * channels) + y];
+				s16 end = samples[(index * channels) + y];
+
+				buffer[(current_write + length) & mask] = start + ((end - start) * weight);
+				length++;
+			}
+
+			position += step;
+		}
+
+		position -= frames;
+		if(position < 0.0) { position = 0.0; }
+
+		if(frames)
+		{
+			last_input[0] = samples[(frames - 1) * channels];
+			last_input[1] = samples[(frames * channels) - 1];
+		}
+	}
+
+	write_pos.store((current_write + length), std::memory_order_release);
+}
+
+/****** Copies samples out of the buffer, pads with the last frame if it runs dry - SDL audio callback only ******/
+void audio_buffer::read(s16* samples, u32 count)
+{
+	u32 current_read = read_pos.load(std::memory_order_relaxed);
+	u32 ready = write_pos.load(std::memory_order_acquire) - current_read;
+	u32 length = count;
+
+	if(ready < count)
+	{
+		length = ready - (ready % channels);
+		underruns++;
+	}
+
+	for(u32 x = 0; x < length; x++) { samples[x] = buffer[(current_read + x) & mask]; }
+
+	last_read_time.store(get_timestamp(), std::memory_order_relaxed);
+	read_pos.store((current_read + length), std::memory_order_release);
+
+	//Remember the last frame played
+	if(length >= channels)
+	{
+		last_frame[0] = samples[length - channels];
+		last_frame[1] = samples[length - 1];
+	}
+
+	for(u32 x = length; x < count; x++) { samples[x] = last_frame[(x - length) % channels]; }
+}
+
+/****** Returns the number of samples waiting in the buffer ******/
+u32 audio_buffer::available()
+{
+	return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_acquire);
+}
+
+/****** Estimates the fill level as if the device drained the buffer continuously instead of once per callback ******/
+u32 audio_buffer::estimate_fill()
+{
+	u32 fill = available();
+	u64 last_read = last_read_time.load(std::memory_order_relaxed);
+
+	//Nothing drains the buffer until the first callback
+	if(last_read == 0) { return fill; }
+
+	u64 elapsed = get_timestamp() - last_read;
+	u64 consumed = (elapsed * sample_rate / 1000000000) * channels;
+
+	return (consumed >= fill) ? 0 : (fill - consumed);
+}
+
+/****** Adjusts the resampling ratio to hold the buffer at its target when syncing to audio ******/
+void audio_buffer::update_ratio()
+{
+	if((!config::audio_sync) || (target == 0))
+	{
+		ratio = 1.0;
+		return;
+	}
+
+	//Smooth out the jumps from each callback before steering
+	average_fill += (estimate_fill() - average_fill) / 8.0;
+
+	double error = (double(target) - average_fill) / target;
+	if(error > 1.0) { error = 1.0; }
+	else if(error < -1.0) { error = -1.0; }
+
+	ratio = 1.0 + (error * MAX_RATE_DELTA);
+}
+
+/****** Waits until the device drains the buffer to its target, returns false if not syncing to audio - Emulation thread only ******/
+bool audio_buffer::sync()
+{
+	if((!config::audio_sync) || (target == 0)) { return false; }
+
+	//Only pace on a device that is actually running
+	u64 last_read = last_read_time.load(std::memory_order_relaxed);
+	if((last_read == 0) || ((get_timestamp() - last_read) >= SYNC_TIMEOUT)) { return false; }
+
+	while(estimate_fill() > target) { SDL_Delay(1); }
+
+	return true;
+}
@@ -0,0 +1,76 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : audio_buffer.h
+// Date : October 17, 2026
+// Description : Audio ring buffer
+//
+// Lock-free single producer, single consumer ring between the emulation thread and the SDL audio callback
+// The core mixes samples as it emulates, the callback only copies them out
+// When syncing to audio, the device's clock paces emulation and a small resampling ratio holds the buffer at its target
+
+#ifndef GBE_AUDIO_BUFFER
+#define GBE_AUDIO_BUFFER
+
+#include <atomic>
+#include <vector>
+
+#include "common.h"
+
+class av_recorder;
+
+class audio_buffer
+{
+	public:
+
+	audio_buffer();
+	~audio_buffer();
+
+	void resize(u32 samples, u8 channel_count, u32 frequency);
+	void clear();
+
+	void write(const s16* samples, u32 count);
+	void read(s16* samples, u32 count);
+	u32 available();
+
+	bool sync();
+
+	//Times the callback ran dry and times the core had to drop samples
+	std::atomic<u32> underruns;
+	std::atomic<u32> overruns;
+
+	//Also receives every mixed sample while recording audio/video
+	av_recorder* recorder;
+
+	private:
+
+	std::vector<s16> buffer;
+	u32 mask;
+	u8 channels;
+	u32 sample_rate;
+
+	//Fill level audio sync aims for, in samples
+	u32 target;
+
+	//Output frames per input frame, plus resampler position and the last input frame for interpolation
+	double ratio;
+	double position;
+	double average_fill;
+	s16 last_input[2];
+
+	//Host time of the last callback in nanoseconds
+	std::atomic<u64> last_read_time;
+
+	//Monotonic positions, only the producer moves write_pos and only the consumer moves read_pos
+	std::atomic<u32> read_pos;
+	std::atomic<u32> write_pos;
+
+	//Last frame handed to the callback, repeated on underruns instead of clicking to silence
+	s16 last_frame[2];
+
+	u32 estimate_fill();
+	void update_ratio();
+};
+
+#endif // GBE_AUDIO_BUFFER
@@ -0,0 +1,367 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : av_recorder.cpp
+// Date : October 17, 2026
+// Description : Audio/video recorder
+//
+// Records presented frames to a Y4M file and mixed audio to a WAV file for encoding later (e.g. with ffmpeg)
+// The emulation thread copies each frame and its audio into a bounded queue, the write thread converts to YUV and writes
+// When the queue is full, a frame's picture is dropped and counted, its audio is kept and the last picture is repeated
+// That way the video never stalls emulation and audio and video stay the same length
+
+#include <cstring>
+#include <iostream>
+
+#include "av_recorder.h"
+#include "config.h"
+
+/****** A/V Recorder Constructor ******/
+av_recorder::av_recorder()
+{
+	rate_numerator = 60;
+	rate_denominator = 1;
+	quit = false;
+	reset();
+}
+
+/****** A/V Recorder Destructor ******/
+av_recorder::~av_recorder()
+{
+	stop();
+}
+
+/****** Finishes any recording, then arms a new one based on the current configuration ******/
+void av_recorder::reset()
+{
+	stop();
+
+	frames.clear();
+	spare_pixels.clear();
+	capture_audio.clear();
+
+	audio_channels = 0;
+	audio_frequency = 0;
+	queued_pictures = 0;
+	dropped_frames = 0;
+	lost_frames = 0;
+	started = false;
+	hold_audio = false;
+	quit = false;
+
+	//Start on the very first frame
+	last_frame = 0xFFFFFFFF;
+
+	filename = config::av_record_file;
+	active = !filename.empty();
+}
+
+/****** Sets the frame rate written to the video file, e.g. 4194304/70224 for ~59.73 FPS ******/
+void av_recorder::set_frame_rate(u32 numerator, u32 denominator)
+{
+	rate_numerator = numerator;
+	rate_denominator = (denominator) ? denominator : 1;
+}
+
+/****** Called once per emulated frame - Queues the presented frame along with the audio mixed since the last one ******/
+void av_recorder::update(const std::vector<u32> &pixels, u32 width, u32 frame)
+{
+	last_frame = frame;
+
+	if((!active) || (!width) || (pixels.size() < width)) { return; }
+
+	u32 height = pixels.size() / width;
+	u32 queue_limit = (config::av_record_queue) ? config::av_record_queue : 1;
+
+	std::vector<u32> picture;
+	bool keep_picture = false;
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		//Even audio-only frames pile up if the disk can't keep up at all, lose whole frames at that point
+		if(frames.size() >= (queue_limit * 4))
+		{
+			lost_frames++;
+			capture_audio.clear();
+			return;
+		}
+
+		//Queue full - Drop this picture and repeat the last one instead
+		if(queued_pictures >= queue_limit) { dropped_frames++; }
+
+		else
+		{
+			keep_picture = true;
+			queued_pictures++;
+
+			//Reuse buffers the write thread has finished with
+			if(!spare_pixels.empty())
+			{
+				picture.swap(spare_pixels.back());
+				spare_pixels.pop_back();
+			}
+		}
+	}
+
+	if(keep_picture) { picture.assign(pixels.begin(), (pixels.begin() + (width * height))); }
+
+	av_frame next;
+	next.pixels.swap(picture);
+	next.audio.swap(capture_audio);
+	next.width = width;
+	next.height = height;
+	next.channels = audio_channels;
+	next.frequency = audio_frequency;
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		frames.push_back(std::move(next));
+	}
+
+	if(!started)
+	{
+		started = true;
+		worker = std::thread(&av_recorder::write_thread, this);
+	}
+
+	signal.notify_one();
+}
+
+/****** Collects mixed audio samples (interleaved) for the current frame ******/
+void av_recorder::push_audio(const s16* samples, u32 count, u8 channel_count, u32 frequency)
+{
+	if((!active) || (hold_audio) || (!frequency)) { return; }
+
+	audio_channels = channel_count;
+	audio_frequency = frequency;
+
+	capture_audio.insert(capture_audio.end(), samples, (samples + count));
+}
+
+/****** Writes everything queued, finishes both files, and stops the write thread ******/
+void av_recorder::stop()
+{
+	if(!worker.joinable()) { return; }
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		quit = true;
+	}
+
+	signal.notify_one();
+	worker.join();
+
+	quit = false;
+	active = false;
+}
+
+/****** Converts 32-bit ARGB pixels to planar YUV 4:2:0 (BT.601, limited range) ******/
+static void convert_yuv420(const u32* pixels, u32 width, u32 height, u8* y_plane, u8* u_plane, u8* v_plane)
+{
+	//Luma for every pixel - Straight-line fixed-point math over the whole frame, so compilers turn it into SIMD
+	for(u32 x = 0; x < (width * height); x++)
+	{
+		s32 r = (pixels[x] >> 16) & 0xFF;
+		s32 g = (pixels[x] >> 8) & 0xFF;
+		s32 b = pixels[x] & 0xFF;
+
+		y_plane[x] = (((66 * r) + (129 * g) + (25 * b) + 128) >> 8) + 16;
+	}
+
+	//Chroma from the average of each 2x2 block of pixels
+	u32 chroma_width = (width + 1) / 2;
+
+	for(u32 y = 0; y < height; y += 2)
+	{
+		const u32* row_a = pixels + (y * width);
+		const u32* row_b = ((y + 1) < height) ? (row_a + width) : row_a;
+
+		u8* u_row = u_plane + ((y / 2) * chroma_width);
+		u8* v_row = v_plane + ((y / 2) * chroma_width);
+
+		for(u32 x = 0; x < width; x += 2)
+		{
+			u32 next = ((x + 1) < width) ? (x + 1) : x;
+
+			u32 block[4] = { row_a[x], row_a[next], row_b[x], row_b[next] };
+			s32 r = 2;
+			s32 g = 2;
+			s32 b = 2;
+
+			for(u32 z = 0; z < 4; z++)
+			{
+				r += (block[z] >> 16) & 0xFF;
+				g += (block[z] >> 8) & 0xFF;
+				b += block[z] & 0xFF;
+			}
+
+			r >>= 2;
+			g >>= 2;
+			b >>= 2;
+
+			u_row[x / 2] = (((-38 * r) - (74 * g) + (112 * b) + 128) >> 8) + 128;
+			v_row[x / 2] = (((112 * r) - (94 * g) - (18 * b) + 128) >> 8) + 128;
+		}
+	}
+}
+
+/****** Write thread - Opens both files, then writes queued frames until stopped ******/
+void av_recorder::write_thread()
+{
+	video_width = 0;
+	video_height = 0;
+	wav_channels = 0;
+	wav_frequency = 0;
+	audio_bytes = 0;
+	written_frames = 0;
+	size_mismatches = 0;
+
+	video_file.open((filename + ".y4m").c_str(), std::ios::binary | std::ios::trunc);
+	audio_file.open((filename + ".wav").c_str(), std::ios::binary | std::ios::trunc);
+
+	if((!video_file.is_open()) || (!audio_file.is_open()))
+	{
+		std::cout<<"AV::Error - Could not open " << filename << ".y4m or " << filename << ".wav for recording\n";
+	}
+
+	//Room for the WAV header, filled in once the final size is known
+	u8 wav_header[44];
+	memset(wav_header, 0, sizeof(wav_header));
+	audio_file.write((char*)wav_header, sizeof(wav_header));
+
+	av_frame current;
+
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			signal.wait(guard, [this]() { return ((!frames.empty()) || quit); });
+
+			//Always write everything queued before quitting
+			if(frames.empty()) { break; }
+
+			current = std::move(frames.front());
+			frames.pop_front();
+		}
+
+		write_frame(current);
+
+		if(!current.pixels.empty())
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			queued_pictures--;
+			spare_pixels.push_back(std::move(current.pixels));
+		}
+	}
+
+	finish_files();
+}
+
+/****** Writes one frame of video and its audio ******/
+void av_recorder::write_frame(av_frame &current)
+{
+	if(!current.pixels.empty())
+	{
+		//The first picture decides the video size, Y4M can't change it later
+		if(!video_width)
+		{
+			video_width = current.width;
+			video_height = current.height;
+
+			u32 chroma_size = ((video_width + 1) / 2) * ((video_height + 1) / 2);
+			yuv_frame.resize((video_width * video_height) + (chroma_size * 2));
+
+			video_file << "YUV4MPEG2 W" << video_width << " H" << video_height << " F" << rate_numerator << ":" << rate_denominator;
+			video_file << " Ip A1:1 C420jpeg\n";
+		}
+
+		//Pictures of any other size (e.g. SGB borders turning on) are left out and the last one is repeated
+		if((current.width == video_width) && (current.height == video_height))
+		{
+			u8* y_plane = yuv_frame.data();
+			u8* u_plane = y_plane + (video_width * video_height);
+			u8* v_plane = u_plane + (((video_width + 1) / 2) * ((video_height + 1) / 2));
+
+			convert_yuv420(current.pixels.data(), video_width, video_height, y_plane, u_plane, v_plane);
+		}
+
+		else { size_mismatches++; }
+	}
+
+	//Every frame gets a picture, dropped ones repeat the last picture so audio and video stay in step
+	if(video_width)
+	{
+		video_file << "FRAME\n";
+		video_file.write((char*)yuv_frame.data(), yuv_frame.size());
+		written_frames++;
+	}
+
+	if(!current.audio.empty())
+	{
+		if(!wav_frequency)
+		{
+			wav_channels = current.channels;
+			wav_frequency = current.frequency;
+		}
+
+		audio_file.write((char*)current.audio.data(), (current.audio.size() * 2));
+		audio_bytes += (current.audio.size() * 2);
+	}
+}
+
+/****** Fills in the WAV header and closes both files ******/
+void av_recorder::finish_files()
+{
+	if(!wav_channels) { wav_channels = 2; }
+	if(!wav_frequency) { wav_frequency = 44100; }
+
+	//WAV sizes are only 32-bit
+	u32 data_size = (audio_bytes > 0xFFFFFFD0) ? 0xFFFFFFD0 : audio_bytes;
+	u32 riff_size = data_size + 36;
+	u32 byte_rate = wav_frequency * wav_channels * 2;
+	u16 block_align = wav_channels * 2;
+	u16 format = 1;
+	u16 channels = wav_channels;
+	u16 bits = 16;
+	u32 fmt_size = 16;
+
+	u8 wav_header[44];
+
+	memcpy(wav_header, "RIFF", 4);
+	memcpy((wav_header + 4), &riff_size, 4);
+	memcpy((wav_header + 8), "WAVEfmt ", 8);
+	memcpy((wav_header + 16), &fmt_size, 4);
+	memcpy((wav_header + 20), &format, 2);
+	memcpy((wav_header + 22), &channels, 2);
+	memcpy((wav_header + 24), &wav_frequency, 4);
+	memcpy((wav_header + 28), &byte_rate, 4);
+	memcpy((wav_header + 32), &block_align, 2);
+	memcpy((wav_header + 34), &bits, 2);
+	memcpy((wav_header + 36), "data", 4);
+	memcpy((wav_header + 40), &data_size, 4);
+
+	audio_file.seekp(0);
+	audio_file.write((char*)wav_header, sizeof(wav_header));
+
+	video_file.close();
+	audio_file.close();
+
+	u32 dropped = 0;
+	u32 lost = 0;
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		dropped = dropped_frames;
+		lost = lost_frames;
+	}
+
+	std::cout<<"AV::Recorded " << written_frames << " frames to " << filename << ".y4m and " << filename << ".wav\n";
+
+	if(dropped || lost || size_mismatches)
+	{
+		std::cout<<"AV::Dropped pictures - " << dropped << " :: Lost frames - " << lost << " :: Wrong size - " << size_mismatches << "\n";
+	}
+}
@@ -0,0 +1,96 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : av_recorder.h
+// Date : October 17, 2026
+// Description : Audio/video recorder
+//
+// Records presented frames to a Y4M file and mixed audio to a WAV file for encoding later (e.g. with ffmpeg)
+// A background thread converts and writes everything, the emulation thread never waits on the disk
+
+#ifndef GBE_AV_RECORDER
+#define GBE_AV_RECORDER
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+
+class av_recorder
+{
+	public:
+
+	av_recorder();
+	~av_recorder();
+
+	void reset();
+	void set_frame_rate(u32 numerator, u32 denominator);
+	void update(const std::vector<u32> &pixels, u32 width, u32 frame);
+	void push_audio(const s16* samples, u32 count, u8 channel_count, u32 frequency);
+	void stop();
+
+	bool active;
+	u32 last_frame;
+
+	//Holds back audio from frames that are never recorded, e.g. frames emulated for run-ahead
+	bool hold_audio;
+
+	private:
+
+	//One frame's pixels and the audio mixed during it - Frames dropped from a full queue carry only audio and repeat the last picture
+	struct av_frame
+	{
+		std::vector<u32> pixels;
+		std::vector<s16> audio;
+		u32 width;
+		u32 height;
+		u8 channels;
+		u32 frequency;
+	};
+
+	void write_thread();
+	void write_frame(av_frame &current);
+	void finish_files();
+
+	std::string filename;
+	u32 rate_numerator;
+	u32 rate_denominator;
+
+	//Emulation thread only
+	std::vector<s16> capture_audio;
+	u8 audio_channels;
+	u32 audio_frequency;
+	bool started;
+
+	//Shared with the write thread
+	std::deque<av_frame> frames;
+	std::vector< std::vector<u32> > spare_pixels;
+	u32 queued_pictures;
+	u32 dropped_frames;
+	u32 lost_frames;
+	bool quit;
+
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable signal;
+
+	//Write thread only
+	std::ofstream video_file;
+	std::ofstream audio_file;
+	std::vector<u8> yuv_frame;
+	u32 video_width;
+	u32 video_height;
+	u32 wav_channels;
+	u32 wav_frequency;
+	u64 audio_bytes;
+	u32 written_frames;
+	u32 size_mismatches;
+};
+
+#endif // GBE_AV_RECORDER
@@ -23,6 +23,13 @@ typedef signed short s16;
 typedef signed int s32;
 typedef signed long long int s64;
 
+/* Per-thread globals - Each thread gets its own copy when several cores run in parallel (gbe_batch) */
+#ifdef GBE_THREAD_CONFIG
+#define GBE_THREAD_LOCAL thread_local
+#else
+#define GBE_THREAD_LOCAL
+#endif
+
 /* ARM CPSR Flags */
 const u32 CPSR_N_FLAG = 0x80000000;
 const u32 CPSR_Z_FLAG = 0x40000000;
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <unordered_map>
 
 #include <cstdlib>
 
@@ -19,203 +20,205 @@
 
 namespace config
 {
-	std::string rom_file = "";
-	std::string bios_file = "";
-	std::string save_file = "";
-	std::string save_import_path = "";
-	std::string save_export_path = "";
-	std::string dmg_bios_path = "";
-	std::string gbc_bios_path = "";
-	std::string agb_bios_path = "";
-	std::string nds7_bios_path = "";
-	std::string nds9_bios_path = "";
-	std::string nds_firmware_path = "";
-	std::string min_bios_path = "";
-	std::string save_path = "";
-	std::string ss_path = "";
-	std::string cfg_path = "";
-	std::string data_path = "";
-	std::string cheats_path = "";
-	std::string external_camera_file = "";
-	std::string external_card_file = "";
-	std::string external_image_file = "";
-	std::string external_data_file = "";
-	std::vector <std::string> recent_files;
-	std::vector <std::string> cli_args;
-	std::vector <std::string> bin_files;
-	std::vector <u32> bin_hashes;
-	bool use_debugger = false;
+	GBE_THREAD_LOCAL std::string rom_file = "";
+	GBE_THREAD_LOCAL std::string bios_file = "";
+	GBE_THREAD_LOCAL std::string save_file = "";
+	GBE_THREAD_LOCAL std::string save_import_path = "";
+	GBE_THREAD_LOCAL std::string save_export_path = "";
+	GBE_THREAD_LOCAL std::string dmg_bios_path = "";
+	GBE_THREAD_LOCAL std::string gbc_bios_path = "";
+	GBE_THREAD_LOCAL std::string agb_bios_path = "";
+	GBE_THREAD_LOCAL std::string nds7_bios_path = "";
+	GBE_THREAD_LOCAL std::string nds9_bios_path = "";
+	GBE_THREAD_LOCAL std::string nds_firmware_path = "";
+	GBE_THREAD_LOCAL std::string min_bios_path = "";
+	GBE_THREAD_LOCAL std::string save_path = "";
+	GBE_THREAD_LOCAL std::string ss_path = "";
+	GBE_THREAD_LOCAL std::string cfg_path = "";
+	GBE_THREAD_LOCAL std::string data_path = "";
+	GBE_THREAD_LOCAL std::string cheats_path = "";
+	GBE_THREAD_LOCAL std::string external_camera_file = "";
+	GBE_THREAD_LOCAL std::string external_card_file = "";
+	GBE_THREAD_LOCAL std::string external_image_file = "";
+	GBE_THREAD_LOCAL std::string external_data_file = "";
+	GBE_THREAD_LOCAL std::vector <std::string> recent_files;
+	GBE_THREAD_LOCAL std::vector <std::string> cli_args;
+	GBE_THREAD_LOCAL std::vector <std::string> bin_files;
+	GBE_THREAD_LOCAL std::vector <u32> bin_hashes;
+	GBE_THREAD_LOCAL bool use_debugger = false;
 
 	//Default keyboard bindings
 	//Arrow Z = A button, X = B button, START = Return, Select = Space
 	//UP, LEFT, DOWN, RIGHT = Arrow keys
 	//A key = Left Shoulder, S key = Right Shoulder
-	u32 gbe_key_a = SDLK_z; u32 gbe_key_b = SDLK_x; u32 gbe_key_x = SDLK_d; u32 gbe_key_y = SDLK_c; u32 gbe_key_start = SDLK_RETURN; u32 gbe_key_select = SDLK_SPACE;
-	u32 gbe_key_l_trigger = SDLK_a; u32 gbe_key_r_trigger = SDLK_s;
-	u32 gbe_key_left = SDLK_LEFT; u32 gbe_key_right = SDLK_RIGHT; u32 gbe_key_down = SDLK_DOWN; u32 gbe_key_up = SDLK_UP;
+	GBE_THREAD_LOCAL u32 gbe_key_a = SDLK_z; GBE_THREAD_LOCAL u32 gbe_key_b = SDLK_x; GBE_THREAD_LOCAL u32 gbe_key_x = SDLK_d; GBE_THREAD_LOCAL u32 gbe_key_y = SDLK_c; GBE_THREAD_LOCAL u32 gbe_key_start = SDLK_RETURN; GBE_THREAD_LOCAL u32 gbe_key_select = SDLK_SPACE;
+	GBE_THREAD_LOCAL u32 gbe_key_l_trigger = SDLK_a; GBE_THREAD_LOCAL u32 gbe_key_r_trigger = SDLK_s;
+	GBE_THREAD_LOCAL u32 gbe_key_left = SDLK_LEFT; GBE_THREAD_LOCAL u32 gbe_key_right = SDLK_RIGHT; GBE_THREAD_LOCAL u32 gbe_key_down = SDLK_DOWN; GBE_THREAD_LOCAL u32 gbe_key_up = SDLK_UP;
 
 	//Default joystick bindings
-	u32 gbe_joy_a = 100; u32 gbe_joy_b = 101; u32 gbe_joy_x = 102; u32 gbe_joy_y = 103; u32 gbe_joy_start = 107; u32 gbe_joy_select = 106;
-	u32 gbe_joy_r_trigger = 105; u32 gbe_joy_l_trigger = 104;
-	u32 gbe_joy_left = 200; u32 gbe_joy_right = 201; u32 gbe_joy_up = 202; u32 gbe_joy_down = 203;
+	GBE_THREAD_LOCAL u32 gbe_joy_a = 100; GBE_THREAD_LOCAL u32 gbe_joy_b = 101; GBE_THREAD_LOCAL u32 gbe_joy_x = 102; GBE_THREAD_LOCAL u32 gbe_joy_y = 103; GBE_THREAD_LOCAL u32 gbe_joy_start = 107; GBE_THREAD_LOCAL u32 gbe_joy_select = 106;
+	GBE_THREAD_LOCAL u32 gbe_joy_r_trigger = 105; GBE_THREAD_LOCAL u32 gbe_joy_l_trigger = 104;
+	GBE_THREAD_LOCAL u32 gbe_joy_left = 200; GBE_THREAD_LOCAL u32 gbe_joy_right = 201; GBE_THREAD_LOCAL u32 gbe_joy_up = 202; GBE_THREAD_LOCAL u32 gbe_joy_down = 203;
 
 	//Default keyboard bindings - Context
 	//Left = 4 (numpad), Right = 6 (numpad), Up = 8 (numpad), Down = 2 (numpad)
 	//Con1 = 7 (numpad), Con2 = 9 (numpad)
-	u32 con_key_left = 260; u32 con_key_right = 262; u32 con_key_up = 264; u32 con_key_down = 258; u32 con_key_1 = 263; u32 con_key_2 = 265;
+	GBE_THREAD_LOCAL u32 con_key_left = 260; GBE_THREAD_LOCAL u32 con_key_right = 262; GBE_THREAD_LOCAL u32 con_key_up = 264; GBE_THREAD_LOCAL u32 con_key_down = 258; GBE_THREAD_LOCAL u32 con_key_1 = 263; GBE_THREAD_LOCAL u32 con_key_2 = 265;
 
 	//Default joystick bindings - Context
-	u32 con_joy_left = 204; u32 con_joy_right = 205; u32 con_joy_up = 206; u32 con_joy_down = 207; u32 con_joy_1 = 109; u32 con_joy_2 = 110;
+	GBE_THREAD_LOCAL u32 con_joy_left = 204; GBE_THREAD_LOCAL u32 con_joy_right = 205; GBE_THREAD_LOCAL u32 con_joy_up = 206; GBE_THREAD_LOCAL u32 con_joy_down = 207; GBE_THREAD_LOCAL u32 con_joy_1 = 109; GBE_THREAD_LOCAL u32 con_joy_2 = 110;
 
 	//Default turbo button timings
-	u32 gbe_turbo_button[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+	GBE_THREAD_LOCAL u32 gbe_turbo_button[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 
 	//Default NDS touch zone mappings
-	int touch_zone_x[10] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
-	int touch_zone_y[10] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
-	int touch_zone_pad[10] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+	GBE_THREAD_LOCAL int touch_zone_x[10] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
+	GBE_THREAD_LOCAL int touch_zone_y[10] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
+	GBE_THREAD_LOCAL int touch_zone_pad[10] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 
 	//Default NDS touch mode (light pressure)
-	u8 touch_mode = 0;
+	GBE_THREAD_LOCAL u8 touch_mode = 0;
 
 	//Hotkey bindings
 	//Turbo = TAB
-	u32 hotkey_turbo = SDLK_TAB;
-	u32 hotkey_mute = SDLK_m;
-	u32 hotkey_camera = SDLK_p;
-	u32 hotkey_swap_screen = SDLK_F4;
-	u32 hotkey_shift_screen = SDLK_F3;
+	GBE_THREAD_LOCAL u32 hotkey_turbo = SDLK_TAB;
+	GBE_THREAD_LOCAL u32 hotkey_mute = SDLK_m;
+	GBE_THREAD_LOCAL u32 hotkey_camera = SDLK_p;
+	GBE_THREAD_LOCAL u32 hotkey_swap_screen = SDLK_F4;
+	GBE_THREAD_LOCAL u32 hotkey_shift_screen = SDLK_F3;
+	GBE_THREAD_LOCAL u32 hotkey_rewind = SDLK_BACKSPACE;
 
 	//Default joystick dead-zone
-	u32 dead_zone = 16000;
+	GBE_THREAD_LOCAL u32 dead_zone = 16000;
 
 	//Default joystick ID
-	int joy_id = 0;
-	int joy_sdl_id = 0;
+	GBE_THREAD_LOCAL int joy_id = 0;
+	GBE_THREAD_LOCAL int joy_sdl_id = 0;
 
 	//Default Haptic and Gyro setting
 	//Default DDR mapping setting
-	bool use_haptics = false;
-	bool use_motion = false;
-	bool use_ddr_mapping = false;
+	GBE_THREAD_LOCAL bool use_haptics = false;
+	GBE_THREAD_LOCAL bool use_motion = false;
+	GBE_THREAD_LOCAL bool use_ddr_mapping = false;
 
-	float motion_dead_zone = 1.0;
-	float motion_scaler = 10.0;
+	GBE_THREAD_LOCAL float motion_dead_zone = 1.0;
+	GBE_THREAD_LOCAL float motion_scaler = 10.0;
 
-	u32 flags = 0x4;
-	bool pause_emu = false;
-	bool use_bios = false;
-	bool use_firmware = false;
-	bool no_cart = false;
-	bool ignore_illegal_opcodes = true;
+	GBE_THREAD_LOCAL u32 flags = 0x4;
+	GBE_THREAD_LOCAL bool pause_emu = false;
+	GBE_THREAD_LOCAL bool use_bios = false;
+	GBE_THREAD_LOCAL bool use_firmware = false;
+	GBE_THREAD_LOCAL bool no_cart = false;
+	GBE_THREAD_LOCAL bool ignore_illegal_opcodes = true;
 
-	special_cart_types cart_type = NORMAL_CART;
-	gba_save_types agb_save_type = AGB_AUTO_DETECT;
+	GBE_THREAD_LOCAL special_cart_types cart_type = NORMAL_CART;
+	GBE_THREAD_LOCAL gba_save_types agb_save_type = AGB_AUTO_DETECT;
 
-	u32 sio_device = 0;
-	u32 ir_device = 0;
-	u16 mpos_id = 0;
-	u32 utp_steps = 0;
-	u32 magic_reader_id = 0x500000;
-	bool use_opengl = false;
-	bool turbo = false;
+	GBE_THREAD_LOCAL u32 sio_device = 0;
+	GBE_THREAD_LOCAL u32 ir_device = 0;
+	GBE_THREAD_LOCAL u16 mpos_id = 0;
+	GBE_THREAD_LOCAL u32 utp_steps = 0;
+	GBE_THREAD_LOCAL u32 magic_reader_id = 0x500000;
+	GBE_THREAD_LOCAL bool use_opengl = false;
+	GBE_THREAD_LOCAL bool turbo = false;
 
-	std::string vertex_shader = "vertex.vs";
-	std::string fragment_shader = "fragment.fs";
+	GBE_THREAD_LOCAL std::string vertex_shader = "vertex.vs";
+	GBE_THREAD_LOCAL std::string fragment_shader = "fragment.fs";
 
-	u8 scaling_factor = 1;
-	u8 old_scaling_factor = 1;
+	GBE_THREAD_LOCAL u8 scaling_factor = 1;
+	GBE_THREAD_LOCAL u8 old_scaling_factor = 1;
 
-	std::stringstream title;
+	GBE_THREAD_LOCAL std::stringstream title;
 
 	//Cheats - Gameshark and Game Genie (DMG-GBC), Gameshark - GBA
-	bool use_cheats = false;
-	std::vector <u32> gs_cheats;
-	std::vector <std::string> gg_cheats;
-	std::vector <std::string> gsa_cheats;
-	std::vector <std::string> cheats_info;
+	GBE_THREAD_LOCAL bool use_cheats = false;
+	GBE_THREAD_LOCAL std::vector <u32> gs_cheats;
+	GBE_THREAD_LOCAL std::vector <std::string> gg_cheats;
+	GBE_THREAD_LOCAL std::vector <std::string> gsa_cheats;
+	GBE_THREAD_LOCAL std::vector <std::string> cheats_info;
 
 	//Patches
-	bool use_patches = false;
+	GBE_THREAD_LOCAL bool use_patches = false;
 
 	//Netplay settings
-	bool use_netplay = true;
-	bool netplay_hard_sync = true;
-	bool use_net_gate = false;
-	u32 netplay_sync_threshold = 32;
-	u16 netplay_server_port = 2000;
-	u16 netplay_client_port = 2001;
-	u8 netplay_id = 0;
-	std::string netplay_client_ip = "127.0.0.1";
+	GBE_THREAD_LOCAL bool use_netplay = true;
+	GBE_THREAD_LOCAL bool netplay_hard_sync = true;
+	GBE_THREAD_LOCAL bool use_net_gate = false;
+	GBE_THREAD_LOCAL u32 netplay_sync_threshold = 32;
+	GBE_THREAD_LOCAL u16 netplay_server_port = 2000;
+	GBE_THREAD_LOCAL u16 netplay_client_port = 2001;
+	GBE_THREAD_LOCAL u8 netplay_id = 0;
+	GBE_THREAD_LOCAL std::string netplay_client_ip = "127.0.0.1";
 
-	bool use_real_gbma_server = false;
-	std::string gbma_server = "127.0.0.1";
-	u16 gbma_server_http_port = 8000;
+	GBE_THREAD_LOCAL bool use_real_gbma_server = false;
+	GBE_THREAD_LOCAL std::string gbma_server = "127.0.0.1";
+	GBE_THREAD_LOCAL u16 gbma_server_http_port = 8000;
 
-	u8 dmg_gbc_pal = 0;
+	GBE_THREAD_LOCAL u8 dmg_gbc_pal = 0;
 
 	//Emulated Gameboy type
 	//TODO - Make this an enum
 	//0 - DMG, 1 - DMG on GBC, 2 - GBC, 3 - GBA, 4 - NDS????
-	u8 gb_type = 0;
+	GBE_THREAD_LOCAL u8 gb_type = 0;
 
 	//Boolean dictating whether this is a DMG/GBC game on a GBA
-	bool gba_enhance = false;
+	GBE_THREAD_LOCAL bool gba_enhance = false;
 
 	//Variables dictating whether or not to stretch DMG/GBC games when playing on a GBA
-	bool request_resize = false;
-	s8 resize_mode = 0;
+	GBE_THREAD_LOCAL bool request_resize = false;
+	GBE_THREAD_LOCAL s8 resize_mode = 0;
 
 	//Aspect ratio
-	bool maintain_aspect_ratio = false;
+	GBE_THREAD_LOCAL bool maintain_aspect_ratio = false;
 
 	//LCD configuration (NDS primarily)
-	u8 lcd_config = 0;
+	GBE_THREAD_LOCAL u8 lcd_config = 0;
 
 	//Max FPS
-	u16 max_fps = 0;
+	GBE_THREAD_LOCAL u16 max_fps = 0;
 
 	//Legacy save size
-	bool use_legacy_save_size = false;
+	GBE_THREAD_LOCAL bool use_legacy_save_size = false;
 
 	//Sound parameters
-	u8 volume = 128;
-	u8 old_volume = 0;
-	u32 sample_size = 0;
-	double sample_rate = 44100.0;
-	bool mute = false;
-	bool use_stereo = false;
-	bool use_microphone = false;
-	std::string override_audio_driver = "";
+	GBE_THREAD_LOCAL u8 volume = 128;
+	GBE_THREAD_LOCAL u8 old_volume = 0;
+	GBE_THREAD_LOCAL u32 sample_size = 0;
+	GBE_THREAD_LOCAL double sample_rate = 44100.0;
+	GBE_THREAD_LOCAL bool mute = false;
+	GBE_THREAD_LOCAL bool use_stereo = false;
+	GBE_THREAD_LOCAL bool use_microphone = false;
+	GBE_THREAD_LOCAL std::string override_audio_driver = "";
+	GBE_THREAD_LOCAL bool audio_sync = false;
 
 	//Virtual Cursor parameters for NDS
-	bool vc_enable = false;
-	std::string vc_file = "";
-	std::vector <u32> vc_data;
-	u32 vc_wait = 1;
-	u32 vc_timeout = 180;
-	u8 vc_opacity = 31;
+	GBE_THREAD_LOCAL bool vc_enable = false;
+	GBE_THREAD_LOCAL std::string vc_file = "";
+	GBE_THREAD_LOCAL std::vector <u32> vc_data;
+	GBE_THREAD_LOCAL u32 vc_wait = 1;
+	GBE_THREAD_LOCAL u32 vc_timeout = 180;
+	GBE_THREAD_LOCAL u8 vc_opacity = 31;
 
 	//System screen sizes
-	u32 sys_width = 0;
-	u32 sys_height = 0;
+	GBE_THREAD_LOCAL u32 sys_width = 0;
+	GBE_THREAD_LOCAL u32 sys_height = 0;
 
 	//Window screen sizes
-	s32 win_width = 0;
-	s32 win_height = 0;
+	GBE_THREAD_LOCAL s32 win_width = 0;
+	GBE_THREAD_LOCAL s32 win_height = 0;
 
-	bool sdl_render = true;
+	GBE_THREAD_LOCAL bool sdl_render = true;
 
-	bool use_external_interfaces = false;
+	GBE_THREAD_LOCAL bool use_external_interfaces = false;
 
-	void (*render_external_sw)(std::vector<u32>&);
-	void (*render_external_hw)(SDL_Surface*);
-	void (*debug_external)();
+	GBE_THREAD_LOCAL void (*render_external_sw)(std::vector<u32>&);
+	GBE_THREAD_LOCAL void (*render_external_hw)(SDL_Surface*);
+	GBE_THREAD_LOCAL void (*debug_external)();
 
 	//Default Gameboy BG palettes
-	u32 DMG_BG_PAL[4] = { 0xFFFFFFFF, 0xFFC0C0C0, 0xFF606060, 0xFF000000 };
+	GBE_THREAD_LOCAL u32 DMG_BG_PAL[4] = { 0xFFFFFFFF, 0xFFC0C0C0, 0xFF606060, 0xFF000000 };
 
-	u32 DMG_OBJ_PAL[4][2] = 
+	GBE_THREAD_LOCAL u32 DMG_OBJ_PAL[4][2] = 
 	{ 
 		{ 0xFFFFFFFF, 0xFFFFFFFF },
 		{ 0xFFC0C0C0, 0xFFC0C0C0 },
@@ -224,71 +227,110 @@ namespace config
 	};
 
 	//NDS Slot-2 device and file
-	u8 nds_slot1_device = 0;
-	u8 nds_slot2_device = 0;
-	std::string nds_slot2_file = "";
+	GBE_THREAD_LOCAL u8 nds_slot1_device = 0;
+	GBE_THREAD_LOCAL u8 nds_slot2_device = 0;
+	GBE_THREAD_LOCAL std::string nds_slot2_file = "";
 
 	//Pokemon Mini flags + color
-	u32 min_custom_color = 0xFF000000;
-	u8 min_config = 0x7;
+	GBE_THREAD_LOCAL u32 min_custom_color = 0xFF000000;
+	GBE_THREAD_LOCAL u8 min_config = 0x7;
 
 	//Real-time clock offsets
-	u16 rtc_offset[6] = { 0, 0, 0, 0, 0, 0 };
+	GBE_THREAD_LOCAL u16 rtc_offset[6] = { 0, 0, 0, 0, 0, 0 };
+
+	//Real-time clock time in seconds since epoch, overrides the host clock when non-zero (e.g. for input movies)
+	GBE_THREAD_LOCAL u64 fixed_rtc_time = 0;
 
 	//CPU overclocking flags
-	u32 oc_flags = 0;
+	GBE_THREAD_LOCAL u32 oc_flags = 0;
 
 	//IR database index
-	u32 ir_db_index = 0;
+	GBE_THREAD_LOCAL u32 ir_db_index = 0;
 
 	//Battle Chip ID for Megaman Battle Network games + Chip Gates
-	u16 battle_chip_id = 0;
+	GBE_THREAD_LOCAL u16 battle_chip_id = 0;
 
 	//Default Battle Chip IDs
-	u16 chip_list[6] = { 0, 0, 0, 0, 0, 0 };
+	GBE_THREAD_LOCAL u16 chip_list[6] = { 0, 0, 0, 0, 0, 0 };
 
 	//Turbo File options flags
-	u8 turbo_file_options = 0;
+	GBE_THREAD_LOCAL u8 turbo_file_options = 0;
 
 	//Magical Watch Data
-	u8 mw_data[6] = { 0, 0, 0, 0, 0, 0 };
+	GBE_THREAD_LOCAL u8 mw_data[6] = { 0, 0, 0, 0, 0, 0 };
 
 	//AM3 SmartMedia ID Auto Generate Flag
-	bool auto_gen_am3_id = false;
+	GBE_THREAD_LOCAL bool auto_gen_am3_id = false;
 
 	//AM3 Folder flag
-	bool use_am3_folder = false;
+	GBE_THREAD_LOCAL bool use_am3_folder = false;
 
 	//Total time (in seconds) for Jukebox recording
-	u32 jukebox_total_time = 0;
+	GBE_THREAD_LOCAL u32 jukebox_total_time = 0;
 
 	//Temporary media file used by GBE+ when converting something to another file format via an external program
-	std::string temp_media_file = "";
+	GBE_THREAD_LOCAL std::string temp_media_file = "";
 
 	//Temporary media file used by GBE+ when removing vocals from a karaoke track
-	std::string temp_karaoke_file = "";
+	GBE_THREAD_LOCAL std::string temp_karaoke_file = "";
 
 	//Audio conversion command
-	std::string audio_conversion_cmd = "";
+	GBE_THREAD_LOCAL std::string audio_conversion_cmd = "";
 
 	//Remove vocals command
-	std::string remove_vocals_cmd = "";
+	GBE_THREAD_LOCAL std::string remove_vocals_cmd = "";
 
 	//Glucoboy GRP data
-	u32 glucoboy_daily_grps = 0;
-	u32 glucoboy_bonus_grps = 0;
-	u32 glucoboy_good_days = 0;
-	u32 glucoboy_days_until_bonus = 0;
+	GBE_THREAD_LOCAL u32 glucoboy_daily_grps = 0;
+	GBE_THREAD_LOCAL u32 glucoboy_bonus_grps = 0;
+	GBE_THREAD_LOCAL u32 glucoboy_good_days = 0;
+	GBE_THREAD_LOCAL u32 glucoboy_days_until_bonus = 0;
 
-	u16 campho_ringer_port = 1980;
-	u16 campho_input_port = 1981;
+	GBE_THREAD_LOCAL u16 campho_ringer_port = 1980;
+	GBE_THREAD_LOCAL u16 campho_input_port = 1981;
 
 	//On-screen display settings
-	bool use_osd = false;
-	std::vector <u32> osd_font;
-	std::string osd_message = "";
-	u32 osd_count = 0;
-	u8 osd_alpha = 0xFF;
+	GBE_THREAD_LOCAL bool use_osd = false;
+	GBE_THREAD_LOCAL std::vector <u32> osd_font;
+	GBE_THREAD_LOCAL std::string osd_message = "";
+	GBE_THREAD_LOCAL u32 osd_count = 0;
+	GBE_THREAD_LOCAL u8 osd_alpha = 0xFF;
+
+	//Profiler settings
+	GBE_THREAD_LOCAL bool profiler_osd = false;
+	GBE_THREAD_LOCAL std::string profiler_csv_file = "";
+
+	//Frame time statistics
+	GBE_THREAD_LOCAL bool frame_stats_osd = false;
+
+	//Runtime health - Speed, missed deadlines, idle time and audio underruns/overruns each second
+	GBE_THREAD_LOCAL bool health_osd = false;
+	GBE_THREAD_LOCAL std::string health_log_file = "";
+
+	//Input movies - Files to record to or play back, optional save state slot to record from (-1 = power-on)
+	GBE_THREAD_LOCAL std::string movie_record_file = "";
+	GBE_THREAD_LOCAL std::string movie_play_file = "";
+	GBE_THREAD_LOCAL s32 movie_state_slot = -1;
+
+	//Verbose output - Prints extra diagnostics such as startup timings
+	GBE_THREAD_LOCAL bool verbose = false;
+
+	//Rewind settings - Buffer size in MB (0 = disabled), snapshot interval in frames
+	GBE_THREAD_LOCAL u32 rewind_buffer_size = 0;
+	GBE_THREAD_LOCAL u32 rewind_interval = 6;
+
+	//Run-ahead - Number of frames to emulate ahead of the presented one (0 = disabled)
+	GBE_THREAD_LOCAL u32 run_ahead_frames = 0;
+
+	//Turbo frameskip - Number of frames left unrendered after each presented one while in turbo (0 = render all)
+	GBE_THREAD_LOCAL u32 turbo_frameskip = 0;
+
+	//Battery saves - Seconds between background writes of changed save data (0 = only write on exit)
+	GBE_THREAD_LOCAL u32 save_flush_interval = 5;
+
+	//Audio/video recording - Base name of the .y4m and .wav files, frames allowed to wait for the disk before pictures are dropped
+	GBE_THREAD_LOCAL std::string av_record_file = "";
+	GBE_THREAD_LOCAL u32 av_record_queue = 120;
 }
 
 /****** Reset DMG default colors ******/
@@ -977,6 +1019,171 @@ bool parse_cli_args()
 			//Use legacy save size for DMG/GBC games if necessary
 			else if(config::cli_args[x] == "--use-legacy-save-size") { config::use_legacy_save_size = true; }
 
+			//Draw per-frame profiler counters via the OSD
+			else if(config::cli_args[x] == "--profile-osd")
+			{
+				config::profiler_osd = true;
+				config::use_osd = true;
+
+				#ifndef GBE_PROFILER
+				std::cout<<"GBE::Warning - Profiler support not built. Enable the PROFILER CMake option\n";
+				#endif
+			}
+
+			//Draw frame time statistics via the OSD
+			else if(config::cli_args[x] == "--frame-stats")
+			{
+				config::frame_stats_osd = true;
+				config::use_osd = true;
+			}
+
+			//Draw runtime health via the OSD
+			else if(config::cli_args[x] == "--health-osd")
+			{
+				config::health_osd = true;
+				config::use_osd = true;
+			}
+
+			//Log runtime health to a CSV file once a second
+			else if(config::cli_args[x] == "--health-log")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No file specified for health log\n"; }
+				else { config::health_log_file = config::cli_args[x]; }
+			}
+
+			//Dump per-frame profiler counters to a CSV file
+			else if(config::cli_args[x] == "--profile-csv")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No CSV file specified for profiler\n"; }
+
+				else
+				{
+					config::profiler_csv_file = config::cli_args[x];
+
+					#ifndef GBE_PROFILER
+					std::cout<<"GBE::Warning - Profiler support not built. Enable the PROFILER CMake option\n";
+					#endif
+				}
+			}
+
+			//Set rewind buffer size
+			else if(config::cli_args[x] == "--rewind")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No rewind buffer size specified\n"; }
+
+				else
+				{
+					u32 output = 0;
+					util::from_str(config::cli_args[x], output);
+					config::rewind_buffer_size = (output > 1024) ? 1024 : output;
+				}
+			}
+
+			//Set rewind snapshot interval
+			else if(config::cli_args[x] == "--rewind-interval")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No rewind interval specified\n"; }
+
+				else
+				{
+					u32 output = 0;
+					util::from_str(config::cli_args[x], output);
+					config::rewind_interval = (output == 0) ? 1 : output;
+				}
+			}
+
+			//Set number of run-ahead frames
+			else if(config::cli_args[x] == "--run-ahead")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No run-ahead frame count specified\n"; }
+
+				else
+				{
+					u32 output = 0;
+					util::from_str(config::cli_args[x], output);
+					config::run_ahead_frames = (output > 4) ? 4 : output;
+				}
+			}
+
+			//Pace emulation on the audio device's clock
+			else if(config::cli_args[x] == "--audio-sync") { config::audio_sync = true; }
+
+			//Record input to a movie file
+			else if(config::cli_args[x] == "--record-movie")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No movie file specified for recording\n"; }
+				else { config::movie_record_file = config::cli_args[x]; }
+			}
+
+			//Play back input from a movie file
+			else if(config::cli_args[x] == "--play-movie")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No movie file specified for playback\n"; }
+				else { config::movie_play_file = config::cli_args[x]; }
+			}
+
+			//Record a movie starting from a save state
+			else if(config::cli_args[x] == "--movie-state")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No save state slot specified for movie\n"; }
+
+				else
+				{
+					u32 output = 0;
+					util::from_str(config::cli_args[x], output);
+					config::movie_state_slot = (output > 9) ? 9 : output;
+				}
+			}
+
+			//Set how often changed save data is written in the background
+			else if(config::cli_args[x] == "--save-flush")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No save flush interval specified\n"; }
+
+				else
+				{
+					u32 output = 0;
+					util::from_str(config::cli_args[x], output);
+					config::save_flush_interval = (output > 3600) ? 3600 : output;
+				}
+			}
+
+			//Record presented frames and audio
+			else if(config::cli_args[x] == "--record-av")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No file specified for audio/video recording\n"; }
+				else { config::av_record_file = config::cli_args[x]; }
+			}
+
+			//Set how many frames may wait to be written before pictures are dropped
+			else if(config::cli_args[x] == "--record-av-queue")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No audio/video queue size specified\n"; }
+
+				else
+				{
+					u32 output = 0;
+					util::from_str(config::cli_args[x], output);
+					config::av_record_queue = (output < 1) ? 1 : (output > 3600) ? 3600 : output;
+				}
+			}
+
+			//Print extra diagnostics
+			else if(config::cli_args[x] == "--verbose") { config::verbose = true; }
+
+			//Set number of frames to skip during turbo
+			else if(config::cli_args[x] == "--turbo-frameskip")
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No turbo frameskip specified\n"; }
+
+				else
+				{
+					u32 output = 0;
+					util::from_str(config::cli_args[x], output);
+					config::turbo_frameskip = (output > 59) ? 59 : output;
+				}
+			}
+
 			//Print Help
 			else if((config::cli_args[x] == "-h") || (config::cli_args[x] == "--help")) 
 			{
@@ -1026,6 +1233,23 @@ bool parse_cli_args()
 				std::cout<<"--use-am3-folder \t\t\t\t Use folder of AM3 files instead of SmartMedia image\n";
 				std::cout<<"--save-import \t\t\t\t Import save from specified file\n";
 				std::cout<<"--save-export \t\t\t\t Export save to specified file\n";
+				std::cout<<"--profile-osd \t\t\t\t Draw per-frame subsystem timings (microseconds) via the OSD\n";
+				std::cout<<"--profile-csv [FILE] \t\t\t Dump per-frame subsystem timings and cycles to a CSV file\n";
+				std::cout<<"--frame-stats \t\t\t\t Draw recent frame times (p50, p99, max in microseconds) via the OSD\n";
+				std::cout<<"--health-osd \t\t\t\t Draw speed, host load, missed deadlines and audio underruns/overruns via the OSD\n";
+				std::cout<<"--health-log [FILE] \t\t\t Log runtime health to a CSV file once a second\n";
+				std::cout<<"--rewind [MB] \t\t\t\t Keep up to MB megabytes of rewind history (0 disables)\n";
+				std::cout<<"--rewind-interval [N] \t\t\t Take a rewind snapshot every N frames\n";
+				std::cout<<"--run-ahead [N] \t\t\t Emulate N frames ahead to hide input lag (0 disables)\n";
+				std::cout<<"--turbo-frameskip [N] \t\t Only render 1 out of every N+1 frames while in turbo\n";
+				std::cout<<"--audio-sync \t\t\t\t Pace emulation on the audio device's clock instead of a timer\n";
+				std::cout<<"--record-movie [FILE] \t\t\t Record per-frame input to a movie file\n";
+				std::cout<<"--play-movie [FILE] \t\t\t Play back input from a movie file\n";
+				std::cout<<"--movie-state [SLOT] \t\t\t Record the movie from a save state slot instead of power-on\n";
+				std::cout<<"--save-flush [SECONDS] \t\t Write changed save data every N seconds (0 only writes on exit)\n";
+				std::cout<<"--record-av [FILE] \t\t\t Record video to FILE.y4m and audio to FILE.wav\n";
+				std::cout<<"--record-av-queue [N] \t\t\t Let N frames wait for the disk before dropping pictures\n";
+				std::cout<<"--verbose \t\t\t\t Print extra diagnostics such as startup timings\n";
 				std::cout<<"-h, --help \t\t\t\t Print these help messages\n";
 				return false;
 			}
@@ -1051,6 +1275,301 @@ void parse_filenames()
 	validate_system_type();
 }
 
+//Value types for plain .ini options
+enum ini_setting_type
+{
+	INI_SETTING_BOOL,
+	INI_SETTING_STR,
+	INI_SETTING_U32,
+	INI_SETTING_U16,
+	INI_SETTING_U8,
+	INI_SETTING_DOUBLE,
+	INI_SETTING_FLOAT,
+};
+
+//Plain .ini option - Where its value is stored and the range it accepts
+struct ini_setting
+{
+	ini_setting_type type;
+	void* value;
+	u32 min;
+	u32 max;
+};
+
+typedef std::unordered_map<std::string, ini_setting> ini_setting_map;
+
+//Firmware folder last hashed by get_firmware_hashes()
+static GBE_THREAD_LOCAL std::string firmware_hash_path = "";
+
+/****** Adds a plain .ini option to the lookup table ******/
+static void add_ini_setting(ini_setting_map &settings, std::string name, ini_setting_type type, void* value, u32 min, u32 max)
+{
+	ini_setting setting = { type, value, min, max };
+	settings[name] = setting;
+}
+
+static void add_ini_setting(ini_setting_map &settings, std::string name, bool &value) { add_ini_setting(settings, name, INI_SETTING_BOOL, &value, 0, 0); }
+static void add_ini_setting(ini_setting_map &settings, std::string name, std::string &value) { add_ini_setting(settings, name, INI_SETTING_STR, &value, 0, 0); }
+static void add_ini_setting(ini_setting_map &settings, std::string name, float &value) { add_ini_setting(settings, name, INI_SETTING_FLOAT, &value, 0, 0); }
+static void add_ini_setting(ini_setting_map &settings, std::string name, u32 &value, u32 min, u32 max) { add_ini_setting(settings, name, INI_SETTING_U32, &value, min, max); }
+static void add_ini_setting(ini_setting_map &settings, std::string name, u16 &value, u32 min, u32 max) { add_ini_setting(settings, name, INI_SETTING_U16, &value, min, max); }
+static void add_ini_setting(ini_setting_map &settings, std::string name, u8 &value, u32 min, u32 max) { add_ini_setting(settings, name, INI_SETTING_U8, &value, min, max); }
+static void add_ini_setting(ini_setting_map &settings, std::string name, double &value, u32 min, u32 max) { add_ini_setting(settings, name, INI_SETTING_DOUBLE, &value, min, max); }
+
+/****** Builds the lookup table for all .ini options that map directly onto a single config value ******/
+static void build_ini_settings(ini_setting_map &settings)
+{
+	settings.reserve(128);
+
+	//Use BIOS
+	add_ini_setting(settings, "#use_bios", config::use_bios);
+
+	//Use firmware
+	add_ini_setting(settings, "#use_firmware", config::use_firmware);
+
+	//Emulated SIO device
+	add_ini_setting(settings, "#sio_device", config::sio_device, 0, 20);
+
+	//Emulated IR device
+	add_ini_setting(settings, "#ir_device", config::ir_device, 0, 7);
+
+	//Emulated Slot1 device
+	add_ini_setting(settings, "#slot1_device", config::nds_slot1_device, 0, 1);
+
+	//Emulated Slot2 device
+	add_ini_setting(settings, "#slot2_device", config::nds_slot2_device, 0, 7);
+
+	//Set emulated system type
+	add_ini_setting(settings, "#system_type", config::gb_type, 0, 7);
+
+	//Use cheats
+	add_ini_setting(settings, "#use_cheats", config::use_cheats);
+
+	//Use patches
+	add_ini_setting(settings, "#use_patches", config::use_patches);
+
+	//Use OSD
+	add_ini_setting(settings, "#use_osd", config::use_osd);
+
+	//OSD alpha transparency
+	add_ini_setting(settings, "#osd_alpha", config::osd_alpha, 0, 255);
+
+	//DMG BIOS path
+	add_ini_setting(settings, "#dmg_bios_path", config::dmg_bios_path);
+
+	//GBC BIOS path
+	add_ini_setting(settings, "#gbc_bios_path", config::gbc_bios_path);
+
+	//GBA BIOS path
+	add_ini_setting(settings, "#agb_bios_path", config::agb_bios_path);
+
+	//NDS9 BIOS path
+	add_ini_setting(settings, "#nds9_bios_path", config::nds9_bios_path);
+
+	//NDS7 BIOS path
+	add_ini_setting(settings, "#nds7_bios_path", config::nds7_bios_path);
+
+	//NDS firmware path
+	add_ini_setting(settings, "#nds_firmware_path", config::nds_firmware_path);
+
+	//MIN BIOS path
+	add_ini_setting(settings, "#min_bios_path", config::min_bios_path);
+
+	//Game save path
+	add_ini_setting(settings, "#save_path", config::save_path);
+
+	//Screenshots path
+	add_ini_setting(settings, "#screenshot_path", config::ss_path);
+
+	//Cheats path
+	add_ini_setting(settings, "#cheats_path", config::cheats_path);
+
+	//External camera file
+	add_ini_setting(settings, "#camera_file", config::external_camera_file);
+
+	//External card file
+	add_ini_setting(settings, "#card_file", config::external_card_file);
+
+	//External image file
+	add_ini_setting(settings, "#image_file", config::external_image_file);
+
+	//External data file
+	add_ini_setting(settings, "#data_file", config::external_data_file);
+
+	//Use OpenGL
+	add_ini_setting(settings, "#use_opengl", config::use_opengl);
+
+	//Max FPS
+	add_ini_setting(settings, "#max_fps", config::max_fps, 0, 65535);
+
+	//Rewind buffer size
+	add_ini_setting(settings, "#rewind_buffer_size", config::rewind_buffer_size, 0, 1024);
+
+	//Rewind snapshot interval
+	add_ini_setting(settings, "#rewind_interval", config::rewind_interval, 1, 600);
+
+	//Run-ahead frames
+	add_ini_setting(settings, "#run_ahead_frames", config::run_ahead_frames, 0, 4);
+
+	//Turbo frameskip
+	add_ini_setting(settings, "#turbo_frameskip", config::turbo_frameskip, 0, 59);
+
+	//Battery save flush interval
+	add_ini_setting(settings, "#save_flush_interval", config::save_flush_interval, 0, 3600);
+
+	//Use gamepad dead zone
+	add_ini_setting(settings, "#dead_zone", config::dead_zone, 0, 32767);
+
+	//Use haptics
+	add_ini_setting(settings, "#use_haptics", config::use_haptics);
+
+	//Use controller gyroscopes
+	add_ini_setting(settings, "#use_motion", config::use_motion);
+
+	//Motion deadzone
+	add_ini_setting(settings, "#motion_dead_zone", config::motion_dead_zone);
+
+	//Motion scaler
+	add_ini_setting(settings, "#motion_scaler", config::motion_scaler);
+
+	//Use DDR mapping
+	add_ini_setting(settings, "#use_ddr_mapping", config::use_ddr_mapping);
+
+	//Volume settings
+	add_ini_setting(settings, "#volume", config::volume, 0, 128);
+
+	//Mute settings
+	add_ini_setting(settings, "#mute", config::mute);
+
+	//Stereo settings
+	add_ini_setting(settings, "#use_stereo", config::use_stereo);
+
+	//Enable microphone
+	add_ini_setting(settings, "#use_microphone", config::use_microphone);
+
+	//Sync to audio
+	add_ini_setting(settings, "#audio_sync", config::audio_sync);
+
+	//Override default audio driver
+	add_ini_setting(settings, "#override_audio_driver", config::override_audio_driver);
+
+	//Sample rate
+	add_ini_setting(settings, "#sample_rate", config::sample_rate, 1, 48000);
+
+	//Sample size
+	add_ini_setting(settings, "#sample_size", config::sample_size, 0, 4096);
+
+	//Scaling factor
+	add_ini_setting(settings, "#scaling_factor", config::scaling_factor, 1, 10);
+
+	//Maintain aspect ratio
+	add_ini_setting(settings, "#maintain_aspect_ratio", config::maintain_aspect_ratio);
+
+	//CPU overclocking flags
+	add_ini_setting(settings, "#oc_flags", config::oc_flags, 0, 3);
+
+	//Emulated DMG-on-GBC palette
+	add_ini_setting(settings, "#dmg_on_gbc_pal", config::dmg_gbc_pal, 1, 16);
+
+	//NDS touch mode
+	add_ini_setting(settings, "#nds_touch_mode", config::touch_mode, 0, 0xFFFFFFFF);
+
+	//NDS virtual cursor enable
+	add_ini_setting(settings, "#virtual_cursor_enable", config::vc_enable);
+
+	//NDS virtual cursor file
+	add_ini_setting(settings, "#virtual_cursor_file", config::vc_file);
+
+	//NDS virtual cursor opacity
+	add_ini_setting(settings, "#virtual_cursor_opacity", config::vc_opacity, 0, 31);
+
+	//NDS virtual cursor timeout
+	add_ini_setting(settings, "#virtual_cursor_timeout", config::vc_timeout, 0, 0xFFFFFFFF);
+
+	//Use netplay
+	add_ini_setting(settings, "#use_netplay", config::use_netplay);
+
+	//Use netplay hard sync
+	add_ini_setting(settings, "#use_netplay_hard_sync", config::netplay_hard_sync);
+
+	//Use Net Gate
+	add_ini_setting(settings, "#use_net_gate", config::use_net_gate);
+
+	//Use real server for Mobile Adapter GB
+	add_ini_setting(settings, "#use_real_gbma_server", config::use_real_gbma_server);
+
+	//Real server Mobile Adapter GB HTTP port
+	add_ini_setting(settings, "#gbma_server_http_port", config::gbma_server_http_port, 0, 65535);
+
+	//Netplay sync threshold
+	add_ini_setting(settings, "#netplay_sync_threshold", config::netplay_sync_threshold, 0, 0xFFFFFFFF);
+
+	//Netplay server port
+	add_ini_setting(settings, "#netplay_server_port", config::netplay_server_port, 0, 65535);
+
+	//Netplay client port
+	add_ini_setting(settings, "#netplay_client_port", config::netplay_client_port, 0, 65535);
+
+	//Netplay client IP address
+	add_ini_setting(settings, "#netplay_client_ip", config::netplay_client_ip);
+
+	//Real Mobile Adapter GB IP address
+	add_ini_setting(settings, "#gbma_server_ip", config::gbma_server);
+
+	//Netplay Player ID
+	add_ini_setting(settings, "#netplay_id", config::netplay_id, 0, 255);
+
+	//Campho Ringer Port
+	add_ini_setting(settings, "#campho_ringer_port", config::campho_ringer_port, 0, 65535);
+
+	//Campho Input Port
+	add_ini_setting(settings, "#campho_input_port", config::campho_input_port, 0, 65535);
+
+	//IR database index
+	add_ini_setting(settings, "#id_db_index", config::ir_db_index, 0, 0xFFFFFFFF);
+
+	//Total time for GBA Jukebox recording
+	add_ini_setting(settings, "#jukebox_total_time", config::jukebox_total_time, 0, 0xFFFFFFFF);
+
+	//Audio Conversion Command
+	add_ini_setting(settings, "#audio_conversion_command", config::audio_conversion_cmd);
+
+	//Remove Vocals Command
+	add_ini_setting(settings, "#remove_vocals_command", config::remove_vocals_cmd);
+
+	//Glucoboy - Daily GRPs
+	add_ini_setting(settings, "#glucoboy_daily_grps", config::glucoboy_daily_grps, 0, 0x7FFFFFFF);
+
+	//Glucoboy - Bonus GRPs
+	add_ini_setting(settings, "#glucoboy_bonus_grps", config::glucoboy_bonus_grps, 0, 0x7FFFFFFF);
+
+	//Glucoboy - Good Days
+	add_ini_setting(settings, "#glucoboy_good_days", config::glucoboy_good_days, 0, 0x7FFFFFFF);
+
+	//Glucoboy - Days Until Bonus
+	add_ini_setting(settings, "#glucoboy_days_until_bonus", config::glucoboy_days_until_bonus, 0, 0x7FFFFFFF);
+}
+
+/****** Parses a plain .ini option from the lookup table ******/
+static bool parse_ini_setting(const ini_setting &setting, std::string ini_item, std::vector <std::string> &ini_opts, u32 &ini_pos)
+{
+	switch(setting.type)
+	{
+		case INI_SETTING_BOOL: return parse_ini_bool(ini_item, ini_item, *(bool*)setting.value, ini_opts, ini_pos);
+		case INI_SETTING_U32: return parse_ini_number(ini_item, ini_item, *(u32*)setting.value, ini_opts, ini_pos, setting.min, setting.max);
+		case INI_SETTING_U16: return parse_ini_number(ini_item, ini_item, *(u16*)setting.value, ini_opts, ini_pos, setting.min, setting.max);
+		case INI_SETTING_U8: return parse_ini_number(ini_item, ini_item, *(u8*)setting.value, ini_opts, ini_pos, setting.min, setting.max);
+		case INI_SETTING_DOUBLE: return parse_ini_number(ini_item, ini_item, *(double*)setting.value, ini_opts, ini_pos, setting.min, setting.max);
+		case INI_SETTING_FLOAT: return parse_ini_number(ini_item, ini_item, *(float*)setting.value, ini_opts, ini_pos);
+
+		case INI_SETTING_STR:
+			parse_ini_str(ini_item, ini_item, *(std::string*)setting.value, ini_opts, ini_pos);
+			return true;
+	}
+
+	return true;
+}
+
 /****** Parse options from the .ini file ******/
 bool parse_ini_file()
 {
@@ -1060,7 +1579,7 @@ bool parse_ini_file()
 	config::data_path = "./data/";
 
 	std::string input_line = "";
-	std::string line_char = "";
+	char line_char = 0;
 
 	//Clear recent files
 	config::recent_files.clear();
@@ -1071,6 +1590,9 @@ bool parse_ini_file()
 
 	bool result = true;
 
+	//Firmware hashes are grabbed again on first use, in case the data folder changed
+	firmware_hash_path = "";
+
 	if(!file.is_open())
 	{
 		const char* unix_chr = getenv("HOME");
@@ -1146,7 +1668,7 @@ bool parse_ini_file()
 		bool ignore = false;
 	
 		//Check if line starts with [ - if not, skip line
-		if(line_char == "[")
+		if(line_char == '[')
 		{
 			std::string line_item = "";
 
@@ -1156,11 +1678,11 @@ bool parse_ini_file()
 				line_char = input_line[x];
 
 				//Check for single-quotes, don't parse ":" or "]" within them
-				if((line_char == "'") && (!ignore)) { ignore = true; }
-				else if((line_char == "'") && (ignore)) { ignore = false; }
+				if((line_char == '\'') && (!ignore)) { ignore = true; }
+				else if((line_char == '\'') && (ignore)) { ignore = false; }
 
 				//Check the character for item limiter : or ] - Push to Vector
-				else if(((line_char == ":") || (line_char == "]")) && (!ignore)) 
+				else if(((line_char == ':') || (line_char == ']')) && (!ignore)) 
 				{
 					//Find and replace sequence for single quotes
 					bool parse_quotes = true;
@@ -1189,88 +1711,28 @@ bool parse_ini_file()
 	u32 output = 0;
 	std::string ini_item = "";
 
+	//Most options map directly onto a single value, look those up by name
+	//Anything else falls through to the special cases below
+	ini_setting_map ini_settings;
+	build_ini_settings(ini_settings);
+
 	for(u32 x = 0; x < size; x++)
 	{
 		ini_item = ini_opts[x];
 
-		//Use BIOS
-		if(!parse_ini_bool(ini_item, "#use_bios", config::use_bios, ini_opts, x)) { return false; }
-
-		//Use firmware
-		if(!parse_ini_bool(ini_item, "#use_firmware", config::use_firmware, ini_opts, x)) { return false; }
-
-		//Emulated SIO device
-		if(!parse_ini_number(ini_item, "#sio_device", config::sio_device, ini_opts, x, 0, 20)) { return false; }
-
-		//Emulated IR device
-		if(!parse_ini_number(ini_item, "#ir_device", config::ir_device, ini_opts, x, 0, 7)) { return false; }
-
-		//Emulated Slot1 device
-		if(!parse_ini_number(ini_item, "#slot1_device", config::nds_slot1_device, ini_opts, x, 0, 1)) { return false; }
-
-		//Emulated Slot2 device
-		if(!parse_ini_number(ini_item, "#slot2_device", config::nds_slot2_device, ini_opts, x, 0, 7)) { return false; }
-
-		//Set emulated system type
-		if(!parse_ini_number(ini_item, "#system_type", config::gb_type, ini_opts, x, 0, 7)) { return false; }
-		if(ini_item == "#system_type") { validate_system_type(); }
-
-		//Use cheats
-		if(!parse_ini_bool(ini_item, "#use_cheats", config::use_cheats, ini_opts, x)) { return false; }
-
-		//Use patches
-		if(!parse_ini_bool(ini_item, "#use_patches", config::use_patches, ini_opts, x)) { return false; }
-
-		//Use OSD
-		if(!parse_ini_bool(ini_item, "#use_osd", config::use_osd, ini_opts, x)) { return false; }
-
-		//OSD alpha transparency
-		if(!parse_ini_number(ini_item, "#osd_alpha", config::osd_alpha, ini_opts, x, 0, 255)) { return false; }
-
-		//DMG BIOS path
-		parse_ini_str(ini_item, "#dmg_bios_path", config::dmg_bios_path, ini_opts, x);
-
-		//GBC BIOS path
-		parse_ini_str(ini_item, "#gbc_bios_path", config::gbc_bios_path, ini_opts, x);
-
-		//GBA BIOS path
-		parse_ini_str(ini_item, "#agb_bios_path", config::agb_bios_path, ini_opts, x);
-
-		//NDS9 BIOS path
-		parse_ini_str(ini_item, "#nds9_bios_path", config::nds9_bios_path, ini_opts, x);
-
-		//NDS7 BIOS path
-		parse_ini_str(ini_item, "#nds7_bios_path", config::nds7_bios_path, ini_opts, x);
-
-		//NDS firmware path
-		parse_ini_str(ini_item, "#nds_firmware_path", config::nds_firmware_path, ini_opts, x);
-
-		//MIN BIOS path
-		parse_ini_str(ini_item, "#min_bios_path", config::min_bios_path, ini_opts, x);
-
-		//Game save path
-		parse_ini_str(ini_item, "#save_path", config::save_path, ini_opts, x);
-
-		//Screenshots path
-		parse_ini_str(ini_item, "#screenshot_path", config::ss_path, ini_opts, x);
-
-		//Cheats path
-		parse_ini_str(ini_item, "#cheats_path", config::cheats_path, ini_opts, x);
-
-		//External camera file
-		parse_ini_str(ini_item, "#camera_file", config::external_camera_file, ini_opts, x);
-
-		//External card file
-		parse_ini_str(ini_item, "#card_file", config::external_card_file, ini_opts, x);
+		ini_setting_map::const_iterator setting = ini_settings.find(ini_item);
 
-		//External image file
-		parse_ini_str(ini_item, "#image_file", config::external_image_file, ini_opts, x);
+		if(setting != ini_settings.end())
+		{
+			if(!parse_ini_setting(setting->second, ini_item, ini_opts, x)) { return false; }
 
-		//External data file
-		parse_ini_str(ini_item, "#data_file", config::external_data_file, ini_opts, x);
+			//Some options need more work once set
+			if(ini_item == "#system_type") { validate_system_type(); }
+			else if(ini_item == "#scaling_factor") { config::old_scaling_factor = config::scaling_factor; }
+			else if(ini_item == "#dmg_on_gbc_pal") { set_dmg_colors(config::dmg_gbc_pal); }
 
-		//Use OpenGL
-		if(!parse_ini_bool(ini_item, "#use_opengl", config::use_opengl, ini_opts, x)) { return false; }
+			continue;
+		}
 
 		//Fragment shader
 		if(ini_item == "#fragment_shader")
@@ -1308,55 +1770,6 @@ bool parse_ini_file()
 			else { config::vertex_shader = config::data_path + "shaders/vertex.vs"; }
 		}
 
-		//Max FPS
-		if(!parse_ini_number(ini_item, "#max_fps", config::max_fps, ini_opts, x, 0, 65535)) { return false; }
-
-		//Use gamepad dead zone
-		if(!parse_ini_number(ini_item, "#dead_zone", config::dead_zone, ini_opts, x, 0, 32767)) { return false; }
-
-		//Use haptics
-		if(!parse_ini_bool(ini_item, "#use_haptics", config::use_haptics, ini_opts, x)) { return false; }
-
-		//Use controller gyroscopes
-		if(!parse_ini_bool(ini_item, "#use_motion", config::use_motion, ini_opts, x)) { return false; }
-
-		//Motion deadzone
-		if(!parse_ini_number(ini_item, "#motion_dead_zone", config::motion_dead_zone, ini_opts, x)) { return false; }
-
-		//Motion scaler
-		if(!parse_ini_number(ini_item, "#motion_scaler", config::motion_scaler, ini_opts, x)) { return false; }
-
-		//Use DDR mapping
-		if(!parse_ini_bool(ini_item, "#use_ddr_mapping", config::use_ddr_mapping, ini_opts, x)) { return false; }
-
-		//Volume settings
-		if(!parse_ini_number(ini_item, "#volume", config::volume, ini_opts, x, 0, 128)) { return false; }
-
-		//Mute settings
-		if(!parse_ini_bool(ini_item, "#mute", config::mute, ini_opts, x)) { return false; }
-
-		//Stereo settings
-		if(!parse_ini_bool(ini_item, "#use_stereo", config::use_stereo, ini_opts, x)) { return false; }
-
-		//Enable microphone
-		if(!parse_ini_bool(ini_item, "#use_microphone", config::use_microphone, ini_opts, x)) { return false; }
-
-		//Override default audio driver
-		parse_ini_str(ini_item, "#override_audio_driver", config::override_audio_driver, ini_opts, x);
-
-		//Sample rate
-		if(!parse_ini_number(ini_item, "#sample_rate", config::sample_rate, ini_opts, x, 1, 48000)) { return false; }
-
-		//Sample size
-		if(!parse_ini_number(ini_item, "#sample_size", config::sample_size, ini_opts, x, 0, 4096)) { return false; }
-
-		//Scaling factor
-		if(!parse_ini_number(ini_item, "#scaling_factor", config::scaling_factor, ini_opts, x, 1, 10)) { return false; }
-		if(ini_item == "#scaling_factor") { config::old_scaling_factor = config::scaling_factor; }
-
-		//Maintain aspect ratio
-		if(!parse_ini_bool(ini_item, "#maintain_aspect_ratio", config::maintain_aspect_ratio, ini_opts, x)) { return false; }
-
 		//Real-time clock offsets
 		if(ini_item == "#rtc_offset")
 		{
@@ -1393,12 +1806,7 @@ bool parse_ini_file()
 			}
 		}
 
-		//CPU overclocking flags
-		if(!parse_ini_number(ini_item, "#oc_flags", config::oc_flags, ini_opts, x, 0, 3)) { return false; }
 			
-		//Emulated DMG-on-GBC palette
-		if(!parse_ini_number(ini_item, "#dmg_on_gbc_pal", config::dmg_gbc_pal, ini_opts, x, 1, 16)) { return false; }
-		if(ini_item == "#dmg_on_gbc_pal") { set_dmg_colors(config::dmg_gbc_pal); }
 
 		//Custom DMG palette (BG)
 		if(ini_item == "#dmg_custom_bg_pal")
@@ -1689,6 +2097,9 @@ bool parse_ini_file()
 
 				//NDS vertical and landscape mode
 				util::from_str(ini_opts[++x], config::hotkey_shift_screen);
+
+				//Rewind - Optional, older .ini files do not have it
+				if(((x + 1) < size) && (ini_opts[x + 1][0] != '#')) { util::from_str(ini_opts[++x], config::hotkey_rewind); }
 			}
 
 			else 
@@ -1737,63 +2148,6 @@ bool parse_ini_file()
 			}
 		}
 
-		//NDS touch mode
-		if(!parse_ini_number(ini_item, "#nds_touch_mode", config::touch_mode, ini_opts, x, 0, 0xFFFFFFFF)) { return false; }
-
-		//NDS virtual cursor enable
-		if(!parse_ini_bool(ini_item, "#virtual_cursor_enable", config::vc_enable, ini_opts, x)) { return false; }
-
-		//NDS virtual cursor file
-		parse_ini_str(ini_item, "#virtual_cursor_file", config::vc_file, ini_opts, x);
-
-		//NDS virtual cursor opacity
-		if(!parse_ini_number(ini_item, "#virtual_cursor_opacity", config::vc_opacity, ini_opts, x, 0, 31)) { return false; }
-
-		//NDS virtual cursor timeout
-		if(!parse_ini_number(ini_item, "#virtual_cursor_timeout", config::vc_timeout, ini_opts, x, 0, 0xFFFFFFFF)) { return false; }
-
-		//Use netplay
-		if(!parse_ini_bool(ini_item, "#use_netplay", config::use_netplay, ini_opts, x)) { return false; }
-
-		//Use netplay hard sync
-		if(!parse_ini_bool(ini_item, "#use_netplay_hard_sync", config::netplay_hard_sync, ini_opts, x)) { return false; }
-
-		//Use Net Gate
-		if(!parse_ini_bool(ini_item, "#use_net_gate", config::use_net_gate, ini_opts, x)) { return false; }
-
-		//Use real server for Mobile Adapter GB
-		if(!parse_ini_bool(ini_item, "#use_real_gbma_server", config::use_real_gbma_server, ini_opts, x)) { return false; }
-
-		//Real server Mobile Adapter GB HTTP port
-		if(!parse_ini_number(ini_item, "#gbma_server_http_port", config::gbma_server_http_port, ini_opts, x, 0, 65535)) { return false; }
-
-		//Netplay sync threshold
-		if(!parse_ini_number(ini_item, "#netplay_sync_threshold", config::netplay_sync_threshold, ini_opts, x, 0, 0xFFFFFFFF)) { return false; }
-
-		//Netplay server port
-		if(!parse_ini_number(ini_item, "#netplay_server_port", config::netplay_server_port, ini_opts, x, 0, 65535)) { return false; }
-
-		//Netplay client port
-		if(!parse_ini_number(ini_item, "#netplay_client_port", config::netplay_client_port, ini_opts, x, 0, 65535)) { return false; }
-
-		//Netplay client IP address
-		parse_ini_str(ini_item, "#netplay_client_ip", config::netplay_client_ip, ini_opts, x);
-
-		//Real Mobile Adapter GB IP address
-		parse_ini_str(ini_item, "#gbma_server_ip", config::gbma_server, ini_opts, x);
-
-		//Netplay Player ID
-		if(!parse_ini_number(ini_item, "#netplay_id", config::netplay_id, ini_opts, x, 0, 255)) { return false; }
-
-		//Campho Ringer Port
-		if(!parse_ini_number(ini_item, "#campho_ringer_port", config::campho_ringer_port, ini_opts, x, 0, 65535)) { return false; }
-
-		//Campho Input Port
-		if(!parse_ini_number(ini_item, "#campho_input_port", config::campho_input_port, ini_opts, x, 0, 65535)) { return false; }
-
-		//IR database index
-		if(!parse_ini_number(ini_item, "#id_db_index", config::ir_db_index, ini_opts, x, 0, 0xFFFFFFFF)) { return false; }
-
 		//Multi Plust On System ID
 		if(ini_item == "#mpos_id")
 		{
@@ -1867,27 +2221,6 @@ bool parse_ini_file()
 			}
 		}
 
-		//Total time for GBA Jukebox recording
-		if(!parse_ini_number(ini_item, "#jukebox_total_time", config::jukebox_total_time, ini_opts, x, 0, 0xFFFFFFFF)) { return false; }
-
-		//Audio Conversion Command
-		parse_ini_str(ini_item, "#audio_conversion_command", config::audio_conversion_cmd, ini_opts, x);
-
-		//Remove Vocals Command
-		parse_ini_str(ini_item, "#remove_vocals_command", config::remove_vocals_cmd, ini_opts, x);
-
-		//Glucoboy - Daily GRPs
-		if(!parse_ini_number(ini_item, "#glucoboy_daily_grps", config::glucoboy_daily_grps, ini_opts, x, 0, 0x7FFFFFFF)) { return false; }
-
-		//Glucoboy - Bonus GRPs
-		if(!parse_ini_number(ini_item, "#glucoboy_bonus_grps", config::glucoboy_bonus_grps, ini_opts, x, 0, 0x7FFFFFFF)) { return false; }
-
-		//Glucoboy - Good Days
-		if(!parse_ini_number(ini_item, "#glucoboy_good_days", config::glucoboy_good_days, ini_opts, x, 0, 0x7FFFFFFF)) { return false; }
-
-		//Glucoboy - Days Until Bonus
-		if(!parse_ini_number(ini_item, "#glucoboy_days_until_bonus", config::glucoboy_days_until_bonus, ini_opts, x, 0, 0x7FFFFFFF)) { return false; }
-
 		//Recent files
 		if(ini_item == "#recent_files")
 		{
@@ -1909,9 +2242,6 @@ bool parse_ini_file()
 		}
 	}
 
-	//Grab firmware hashes - Must be done AFTER a valid data folder is obtained
-	get_firmware_hashes();
-
 	return true;
 }
 
@@ -2309,6 +2639,15 @@ bool save_ini_file()
 			output_lines[line_pos] = "[#use_microphone:" + val + "]";
 		}
 
+		//Sync to audio
+		else if(ini_item == "#audio_sync")
+		{
+			line_pos = output_count[x];
+			std::string val = (config::audio_sync) ? "1" : "0";
+
+			output_lines[line_pos] = "[#audio_sync:" + val + "]";
+		}
+
 		//Override default audio driver
 		else if(ini_item == "#override_audio_driver")
 		{
@@ -2428,6 +2767,46 @@ bool save_ini_file()
 			output_lines[line_pos] = "[#max_fps:" + util::to_str(config::max_fps) + "]";
 		}
 
+		//Rewind buffer size
+		else if(ini_item == "#rewind_buffer_size")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#rewind_buffer_size:" + util::to_str(config::rewind_buffer_size) + "]";
+		}
+
+		//Rewind snapshot interval
+		else if(ini_item == "#rewind_interval")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#rewind_interval:" + util::to_str(config::rewind_interval) + "]";
+		}
+
+		//Run-ahead frames
+		else if(ini_item == "#run_ahead_frames")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#run_ahead_frames:" + util::to_str(config::run_ahead_frames) + "]";
+		}
+
+		//Turbo frameskip
+		else if(ini_item == "#turbo_frameskip")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#turbo_frameskip:" + util::to_str(config::turbo_frameskip) + "]";
+		}
+
+		//Battery save flush interval
+		else if(ini_item == "#save_flush_interval")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#save_flush_interval:" + util::to_str(config::save_flush_interval) + "]";
+		}
+
 		//Keyboard controls
 		else if(ini_item == "#gbe_key_controls")
 		{
@@ -2549,8 +2928,9 @@ bool save_ini_file()
 			std::string val_3 = util::to_str(config::hotkey_camera);
 			std::string val_4 = util::to_str(config::hotkey_swap_screen);
 			std::string val_5 = util::to_str(config::hotkey_shift_screen);
+			std::string val_6 = util::to_str(config::hotkey_rewind);
 
-			output_lines[line_pos] = "[#hotkeys:" + val_1 + ":" + val_2 + ":" + val_3 + ":" + val_4 + ":" + val_5 + "]";
+			output_lines[line_pos] = "[#hotkeys:" + val_1 + ":" + val_2 + ":" + val_3 + ":" + val_4 + ":" + val_5 + ":" + val_6 + "]";
 		}
 
 		//Use netplay
@@ -3038,6 +3418,11 @@ bool generate_ini_file()
 	ini_contents += "[#scaling_factor]\n\n";
 	ini_contents += "[#maintain_aspect_ratio]\n\n";
 	ini_contents += "[#max_fps]\n\n";
+	ini_contents += "[#rewind_buffer_size]\n\n";
+	ini_contents += "[#rewind_interval]\n\n";
+	ini_contents += "[#run_ahead_frames]\n\n";
+	ini_contents += "[#turbo_frameskip]\n\n";
+	ini_contents += "[#save_flush_interval]\n\n";
 	ini_contents += "[#rtc_offset]\n\n";
 	ini_contents += "[#oc_flags]\n\n";
 	ini_contents += "[#dead_zone]\n\n";
@@ -3045,6 +3430,7 @@ bool generate_ini_file()
 	ini_contents += "[#mute]\n\n";
 	ini_contents += "[#use_stereo]\n\n";
 	ini_contents += "[#use_microphone]\n\n";
+	ini_contents += "[#audio_sync]\n\n";
 	ini_contents += "[#override_audio_driver]\n\n";
 	ini_contents += "[#use_osd]\n\n";
 	ini_contents += "[#sample_rate]\n\n";
@@ -3212,6 +3598,10 @@ void get_firmware_hashes()
 
 	std::string firmware_folder = config::data_path + "bin/firmware/";
 
+	//Hashing is deferred until something needs it, then done once per folder
+	if(firmware_folder == firmware_hash_path) { return; }
+	firmware_hash_path = firmware_folder;
+
 	//Check to see if folder exists, then grab all files there (non-recursive)
 	std::filesystem::path fs_path { firmware_folder };
 
@@ -3239,9 +3629,9 @@ void get_firmware_hashes()
 	{
 		//Hash and store data
 		std::string f_name = fs_files->path().string();
-		u32 crc = util::get_file_crc32(f_name);
+		u32 crc = 0;
 
-		if(crc)
+		if(util::get_file_crc32(f_name, crc))
 		{
 			config::bin_files.push_back(f_name);
 			config::bin_hashes.push_back(crc);
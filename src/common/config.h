@@ -84,195 +84,222 @@ enum gba_save_types
 
 namespace config
 { 
-	extern std::string rom_file;
-	extern std::string bios_file;
-	extern std::string save_file;
-	extern std::string save_import_path;
-	extern std::string save_export_path;
-	extern std::string dmg_bios_path;
-	extern std::string gbc_bios_path;
-	extern std::string agb_bios_path;
-	extern std::string nds7_bios_path;
-	extern std::string nds9_bios_path;
-	extern std::string nds_firmware_path;
-	extern std::string min_bios_path;
-	extern std::string save_path;
-	extern std::string ss_path;
-	extern std::string cfg_path;
-	extern std::string data_path;
-	extern std::string cheats_path;
-	extern std::string external_camera_file;
-	extern std::string external_card_file;
-	extern std::string external_image_file;
-	extern std::string external_data_file;
-	extern std::vector <std::string> recent_files;
-	extern std::vector <std::string> cli_args;
-	extern std::vector <std::string> bin_files;
-	extern std::vector <u32> bin_hashes;
-
-	extern u32 gbe_key_a, gbe_key_b, gbe_key_x, gbe_key_y, gbe_key_start, gbe_key_select, gbe_key_up, gbe_key_down, gbe_key_left, gbe_key_right, gbe_key_r_trigger, gbe_key_l_trigger;
-	extern u32 gbe_joy_a, gbe_joy_b, gbe_joy_x, gbe_joy_y, gbe_joy_start, gbe_joy_select, gbe_joy_up, gbe_joy_down, gbe_joy_left, gbe_joy_right, gbe_joy_r_trigger, gbe_joy_l_trigger;
-
-	extern u32 con_key_up, con_key_down, con_key_left, con_key_right, con_key_1, con_key_2;
-	extern u32 con_joy_up, con_joy_down, con_joy_left, con_joy_right, con_joy_1, con_joy_2;
-
-	extern u32 gbe_turbo_button[12];
-
-	extern int touch_zone_x[10];
-	extern int touch_zone_y[10];
-	extern int touch_zone_pad[10];
-	extern u8 touch_mode;
-
-	extern u32 hotkey_turbo;
-	extern u32 hotkey_mute;
-	extern u32 hotkey_camera;
-	extern u32 hotkey_swap_screen;
-	extern u32 hotkey_shift_screen;
-	extern u32 dead_zone;
-	extern int joy_id;
-	extern int joy_sdl_id;
-	extern bool use_haptics;
-	extern bool use_ddr_mapping;
-
-	extern bool use_motion;
-	extern float motion_dead_zone;
-	extern float motion_scaler;
-
-	extern u32 flags;
-	extern bool pause_emu;
-	extern bool use_bios;
-	extern bool use_firmware;
-	extern bool no_cart;
-	extern bool ignore_illegal_opcodes;
-
-	extern special_cart_types cart_type;
-	extern gba_save_types agb_save_type;
-	extern bool use_legacy_save_size;
-
-	extern u32 sio_device;
-	extern u32 ir_device;	
-	extern bool use_opengl;
-	extern bool use_debugger;
-	extern bool turbo;
-	extern u8 scaling_factor;
-	extern u8 old_scaling_factor;
-	extern std::stringstream title;
-	extern u8 gb_type;
-	extern bool gba_enhance;
-	extern bool sdl_render;
-	extern u8 dmg_gbc_pal;
-	extern u16 mpos_id;
-	extern u32 utp_steps;
-	extern u32 magic_reader_id;
-
-	extern u8 nds_slot1_device;
-	extern u8 nds_slot2_device;
-	extern std::string nds_slot2_file;
-
-	extern u32 min_custom_color;
-	extern u8 min_config;
-
-	extern bool use_cheats;
-	extern std::vector <u32> gs_cheats;
-	extern std::vector <std::string> gg_cheats;
-	extern std::vector <std::string> gsa_cheats;
-	extern std::vector <std::string> cheats_info;
-	extern bool use_patches;
-
-	extern bool use_netplay;
-	extern bool netplay_hard_sync;
-	extern bool use_net_gate;
-	extern bool use_real_gbma_server;
-	extern u32 netplay_sync_threshold;
-	extern u16 netplay_server_port;
-	extern u16 netplay_client_port;
-	extern u8 netplay_id;
-	extern std::string netplay_client_ip;
-
-	extern std::string gbma_server;
-	extern bool use_real_gbma_server;
-	extern u16 gbma_server_http_port;
-
-	extern u8 volume;
-	extern u8 old_volume;
-	extern u32 sample_size;
-	extern double sample_rate;
-	extern bool mute;
-	extern bool use_stereo;
-	extern bool use_microphone;
-	extern std::string override_audio_driver;
+	extern GBE_THREAD_LOCAL std::string rom_file;
+	extern GBE_THREAD_LOCAL std::string bios_file;
+	extern GBE_THREAD_LOCAL std::string save_file;
+	extern GBE_THREAD_LOCAL std::string save_import_path;
+	extern GBE_THREAD_LOCAL std::string save_export_path;
+	extern GBE_THREAD_LOCAL std::string dmg_bios_path;
+	extern GBE_THREAD_LOCAL std::string gbc_bios_path;
+	extern GBE_THREAD_LOCAL std::string agb_bios_path;
+	extern GBE_THREAD_LOCAL std::string nds7_bios_path;
+	extern GBE_THREAD_LOCAL std::string nds9_bios_path;
+	extern GBE_THREAD_LOCAL std::string nds_firmware_path;
+	extern GBE_THREAD_LOCAL std::string min_bios_path;
+	extern GBE_THREAD_LOCAL std::string save_path;
+	extern GBE_THREAD_LOCAL std::string ss_path;
+	extern GBE_THREAD_LOCAL std::string cfg_path;
+	extern GBE_THREAD_LOCAL std::string data_path;
+	extern GBE_THREAD_LOCAL std::string cheats_path;
+	extern GBE_THREAD_LOCAL std::string external_camera_file;
+	extern GBE_THREAD_LOCAL std::string external_card_file;
+	extern GBE_THREAD_LOCAL std::string external_image_file;
+	extern GBE_THREAD_LOCAL std::string external_data_file;
+	extern GBE_THREAD_LOCAL std::vector <std::string> recent_files;
+	extern GBE_THREAD_LOCAL std::vector <std::string> cli_args;
+	extern GBE_THREAD_LOCAL std::vector <std::string> bin_files;
+	extern GBE_THREAD_LOCAL std::vector <u32> bin_hashes;
+
+	extern GBE_THREAD_LOCAL u32 gbe_key_a, gbe_key_b, gbe_key_x, gbe_key_y, gbe_key_start, gbe_key_select, gbe_key_up, gbe_key_down, gbe_key_left, gbe_key_right, gbe_key_r_trigger, gbe_key_l_trigger;
+	extern GBE_THREAD_LOCAL u32 gbe_joy_a, gbe_joy_b, gbe_joy_x, gbe_joy_y, gbe_joy_start, gbe_joy_select, gbe_joy_up, gbe_joy_down, gbe_joy_left, gbe_joy_right, gbe_joy_r_trigger, gbe_joy_l_trigger;
+
+	extern GBE_THREAD_LOCAL u32 con_key_up, con_key_down, con_key_left, con_key_right, con_key_1, con_key_2;
+	extern GBE_THREAD_LOCAL u32 con_joy_up, con_joy_down, con_joy_left, con_joy_right, con_joy_1, con_joy_2;
+
+	extern GBE_THREAD_LOCAL u32 gbe_turbo_button[12];
+
+	extern GBE_THREAD_LOCAL int touch_zone_x[10];
+	extern GBE_THREAD_LOCAL int touch_zone_y[10];
+	extern GBE_THREAD_LOCAL int touch_zone_pad[10];
+	extern GBE_THREAD_LOCAL u8 touch_mode;
+
+	extern GBE_THREAD_LOCAL u32 hotkey_turbo;
+	extern GBE_THREAD_LOCAL u32 hotkey_mute;
+	extern GBE_THREAD_LOCAL u32 hotkey_camera;
+	extern GBE_THREAD_LOCAL u32 hotkey_swap_screen;
+	extern GBE_THREAD_LOCAL u32 hotkey_shift_screen;
+	extern GBE_THREAD_LOCAL u32 hotkey_rewind;
+	extern GBE_THREAD_LOCAL u32 dead_zone;
+	extern GBE_THREAD_LOCAL int joy_id;
+	extern GBE_THREAD_LOCAL int joy_sdl_id;
+	extern GBE_THREAD_LOCAL bool use_haptics;
+	extern GBE_THREAD_LOCAL bool use_ddr_mapping;
+
+	extern GBE_THREAD_LOCAL bool use_motion;
+	extern GBE_THREAD_LOCAL float motion_dead_zone;
+	extern GBE_THREAD_LOCAL float motion_scaler;
+
+	extern GBE_THREAD_LOCAL u32 flags;
+	extern GBE_THREAD_LOCAL bool pause_emu;
+	extern GBE_THREAD_LOCAL bool use_bios;
+	extern GBE_THREAD_LOCAL bool use_firmware;
+	extern GBE_THREAD_LOCAL bool no_cart;
+	extern GBE_THREAD_LOCAL bool ignore_illegal_opcodes;
+
+	extern GBE_THREAD_LOCAL special_cart_types cart_type;
+	extern GBE_THREAD_LOCAL gba_save_types agb_save_type;
+	extern GBE_THREAD_LOCAL bool use_legacy_save_size;
+
+	extern GBE_THREAD_LOCAL u32 sio_device;
+	extern GBE_THREAD_LOCAL u32 ir_device;	
+	extern GBE_THREAD_LOCAL bool use_opengl;
+	extern GBE_THREAD_LOCAL bool use_debugger;
+	extern GBE_THREAD_LOCAL bool turbo;
+	extern GBE_THREAD_LOCAL u8 scaling_factor;
+	extern GBE_THREAD_LOCAL u8 old_scaling_factor;
+	extern GBE_THREAD_LOCAL std::stringstream title;
+	extern GBE_THREAD_LOCAL u8 gb_type;
+	extern GBE_THREAD_LOCAL bool gba_enhance;
+	extern GBE_THREAD_LOCAL bool sdl_render;
+	extern GBE_THREAD_LOCAL u8 dmg_gbc_pal;
+	extern GBE_THREAD_LOCAL u16 mpos_id;
+	extern GBE_THREAD_LOCAL u32 utp_steps;
+	extern GBE_THREAD_LOCAL u32 magic_reader_id;
+
+	extern GBE_THREAD_LOCAL u8 nds_slot1_device;
+	extern GBE_THREAD_LOCAL u8 nds_slot2_device;
+	extern GBE_THREAD_LOCAL std::string nds_slot2_file;
+
+	extern GBE_THREAD_LOCAL u32 min_custom_color;
+	extern GBE_THREAD_LOCAL u8 min_config;
+
+	extern GBE_THREAD_LOCAL bool use_cheats;
+	extern GBE_THREAD_LOCAL std::vector <u32> gs_cheats;
+	extern GBE_THREAD_LOCAL std::vector <std::string> gg_cheats;
+	extern GBE_THREAD_LOCAL std::vector <std::string> gsa_cheats;
+	extern GBE_THREAD_LOCAL std::vector <std::string> cheats_info;
+	extern GBE_THREAD_LOCAL bool use_patches;
+
+	extern GBE_THREAD_LOCAL bool use_netplay;
+	extern GBE_THREAD_LOCAL bool netplay_hard_sync;
+	extern GBE_THREAD_LOCAL bool use_net_gate;
+	extern GBE_THREAD_LOCAL bool use_real_gbma_server;
+	extern GBE_THREAD_LOCAL u32 netplay_sync_threshold;
+	extern GBE_THREAD_LOCAL u16 netplay_server_port;
+	extern GBE_THREAD_LOCAL u16 netplay_client_port;
+	extern GBE_THREAD_LOCAL u8 netplay_id;
+	extern GBE_THREAD_LOCAL std::string netplay_client_ip;
+
+	extern GBE_THREAD_LOCAL std::string gbma_server;
+	extern GBE_THREAD_LOCAL bool use_real_gbma_server;
+	extern GBE_THREAD_LOCAL u16 gbma_server_http_port;
+
+	extern GBE_THREAD_LOCAL u8 volume;
+	extern GBE_THREAD_LOCAL u8 old_volume;
+	extern GBE_THREAD_LOCAL u32 sample_size;
+	extern GBE_THREAD_LOCAL double sample_rate;
+	extern GBE_THREAD_LOCAL bool mute;
+	extern GBE_THREAD_LOCAL bool use_stereo;
+	extern GBE_THREAD_LOCAL bool use_microphone;
+	extern GBE_THREAD_LOCAL std::string override_audio_driver;
+	extern GBE_THREAD_LOCAL bool audio_sync;
 	
-	extern u32 sys_width;
-	extern u32 sys_height;
-	extern s32 win_width;
-	extern s32 win_height;
+	extern GBE_THREAD_LOCAL u32 sys_width;
+	extern GBE_THREAD_LOCAL u32 sys_height;
+	extern GBE_THREAD_LOCAL s32 win_width;
+	extern GBE_THREAD_LOCAL s32 win_height;
 
-	extern std::string vertex_shader;
-	extern std::string fragment_shader;
+	extern GBE_THREAD_LOCAL std::string vertex_shader;
+	extern GBE_THREAD_LOCAL std::string fragment_shader;
 
-	extern bool request_resize;
-	extern s8 resize_mode;
-	extern bool maintain_aspect_ratio;
-	extern u8 lcd_config;
-	extern u16 max_fps;
+	extern GBE_THREAD_LOCAL bool request_resize;
+	extern GBE_THREAD_LOCAL s8 resize_mode;
+	extern GBE_THREAD_LOCAL bool maintain_aspect_ratio;
+	extern GBE_THREAD_LOCAL u8 lcd_config;
+	extern GBE_THREAD_LOCAL u16 max_fps;
 
-	extern u32 DMG_BG_PAL[4];
-	extern u32 DMG_OBJ_PAL[4][2];
+	extern GBE_THREAD_LOCAL u32 DMG_BG_PAL[4];
+	extern GBE_THREAD_LOCAL u32 DMG_OBJ_PAL[4][2];
 
-	extern u16 rtc_offset[6];
-	extern u32 oc_flags;
-	extern u32 ir_db_index;
+	extern GBE_THREAD_LOCAL u16 rtc_offset[6];
+	extern GBE_THREAD_LOCAL u64 fixed_rtc_time;
+	extern GBE_THREAD_LOCAL u32 oc_flags;
+	extern GBE_THREAD_LOCAL u32 ir_db_index;
 
-	extern u16 battle_chip_id;
-	extern u16 chip_list[6];
+	extern GBE_THREAD_LOCAL u16 battle_chip_id;
+	extern GBE_THREAD_LOCAL u16 chip_list[6];
 
-	extern u8 turbo_file_options;
+	extern GBE_THREAD_LOCAL u8 turbo_file_options;
 
-	extern u8 mw_data[6];
+	extern GBE_THREAD_LOCAL u8 mw_data[6];
 
-	extern bool auto_gen_am3_id;
-	extern bool use_am3_folder;
+	extern GBE_THREAD_LOCAL bool auto_gen_am3_id;
+	extern GBE_THREAD_LOCAL bool use_am3_folder;
 
-	extern u32 jukebox_total_time;
-	extern std::string temp_media_file;
-	extern std::string temp_karaoke_file;
-	extern std::string audio_conversion_cmd;
-	extern std::string remove_vocals_cmd;
+	extern GBE_THREAD_LOCAL u32 jukebox_total_time;
+	extern GBE_THREAD_LOCAL std::string temp_media_file;
+	extern GBE_THREAD_LOCAL std::string temp_karaoke_file;
+	extern GBE_THREAD_LOCAL std::string audio_conversion_cmd;
+	extern GBE_THREAD_LOCAL std::string remove_vocals_cmd;
 
-	extern u32 glucoboy_daily_grps;
-	extern u32 glucoboy_bonus_grps;
-	extern u32 glucoboy_good_days;
-	extern u32 glucoboy_days_until_bonus;
+	extern GBE_THREAD_LOCAL u32 glucoboy_daily_grps;
+	extern GBE_THREAD_LOCAL u32 glucoboy_bonus_grps;
+	extern GBE_THREAD_LOCAL u32 glucoboy_good_days;
+	extern GBE_THREAD_LOCAL u32 glucoboy_days_until_bonus;
 
-	extern u16 campho_ringer_port;
-	extern u16 campho_input_port;
+	extern GBE_THREAD_LOCAL u16 campho_ringer_port;
+	extern GBE_THREAD_LOCAL u16 campho_input_port;
 
-	extern bool use_osd;
-	extern std::vector <u32> osd_font;
-	extern std::string osd_message;
-	extern u32 osd_count;
-	extern u8 osd_alpha;
+	extern GBE_THREAD_LOCAL bool use_osd;
+	extern GBE_THREAD_LOCAL std::vector <u32> osd_font;
+	extern GBE_THREAD_LOCAL std::string osd_message;
+	extern GBE_THREAD_LOCAL u32 osd_count;
+	extern GBE_THREAD_LOCAL u8 osd_alpha;
 
-	extern bool use_external_interfaces;
+	extern GBE_THREAD_LOCAL bool profiler_osd;
+	extern GBE_THREAD_LOCAL std::string profiler_csv_file;
 
-	extern bool vc_enable;
-	extern std::string vc_file;
-	extern std::vector <u32> vc_data;
-	extern u32 vc_wait;
-	extern u32 vc_timeout;
-	extern u8 vc_opacity;
+	extern GBE_THREAD_LOCAL bool frame_stats_osd;
+	extern GBE_THREAD_LOCAL bool health_osd;
+	extern GBE_THREAD_LOCAL std::string health_log_file;
+
+	extern GBE_THREAD_LOCAL std::string movie_record_file;
+	extern GBE_THREAD_LOCAL std::string movie_play_file;
+	extern GBE_THREAD_LOCAL s32 movie_state_slot;
+
+	extern GBE_THREAD_LOCAL bool verbose;
+
+	extern GBE_THREAD_LOCAL u32 rewind_buffer_size;
+	extern GBE_THREAD_LOCAL u32 rewind_interval;
+
+	extern GBE_THREAD_LOCAL u32 run_ahead_frames;
+	extern GBE_THREAD_LOCAL u32 turbo_frameskip;
+
+	extern GBE_THREAD_LOCAL u32 save_flush_interval;
+
+	extern GBE_THREAD_LOCAL std::string av_record_file;
+	extern GBE_THREAD_LOCAL u32 av_record_queue;
+
+	extern GBE_THREAD_LOCAL bool use_external_interfaces;
+
+	extern GBE_THREAD_LOCAL bool vc_enable;
+	extern GBE_THREAD_LOCAL std::string vc_file;
+	extern GBE_THREAD_LOCAL std::vector <u32> vc_data;
+	extern GBE_THREAD_LOCAL u32 vc_wait;
+	extern GBE_THREAD_LOCAL u32 vc_timeout;
+	extern GBE_THREAD_LOCAL u8 vc_opacity;
 
 	//Function pointer for external software rendering
 	//This function is provided by frontends that will not rely on SDL
-	extern void (*render_external_sw)(std::vector<u32>&);
+	extern GBE_THREAD_LOCAL void (*render_external_sw)(std::vector<u32>&);
 
 	//Function pointer for external rendering
 	//This function is provided by frontends that will not rely on SDL+OGL
-	extern void (*render_external_hw)(SDL_Surface*);
+	extern GBE_THREAD_LOCAL void (*render_external_hw)(SDL_Surface*);
 
 	//Function pointer for external debugging
 	//This function is provided by frontends that will not rely on the CLI
-	extern void (*debug_external)();
+	extern GBE_THREAD_LOCAL void (*debug_external)();
 }
 
 #endif // EMU_CONFIG
@@ -13,17 +13,21 @@
 #define CORE_EMU
 
 #include <SDL2/SDL.h>
+#include <atomic>
 #include <string>
 #include <vector>
 
 #include "common/common.h"
 
+struct movie_input;
+struct state_section;
+
 class core_emu
 {
 	public:
 
 	core_emu() {};
-	~core_emu() {};
+	virtual ~core_emu() {};
 
 	//Core control
 	virtual void start() = 0;
@@ -38,6 +42,9 @@ class core_emu
 	virtual void feed_key_input(int sdl_key, bool pressed) = 0;
 	virtual	void save_state(u8 slot) = 0;
 	virtual	void load_state(u8 slot) = 0;
+	virtual bool serialize(std::vector<u8> &buffer) = 0;
+	virtual bool deserialize(const u8* buffer, u32 length) = 0;
+	virtual u32 get_state_sections(std::vector<state_section> &sections) = 0;
 
 	//Core debugging
 	virtual	void debug_step() = 0;
@@ -59,10 +66,18 @@ class core_emu
 	virtual void start_netplay() = 0;
 	virtual void stop_netplay() = 0;
 
+	//Input movies
+	virtual void get_movie_input(movie_input &input) = 0;
+	virtual void set_movie_input(const movie_input &input, bool new_frame) = 0;
+
+	//Battery saves
+	virtual bool get_save_image(std::vector<u8> &image) = 0;
+
 	//Misc
 	virtual u32 get_core_data(u32 core_index) = 0;
 
-	bool running;
+	//Atomic since a GUI can stop a core running on another thread
+	std::atomic<bool> running;
 	SDL_Event event;
 	
 	struct debugging
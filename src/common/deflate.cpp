@@ -0,0 +1,515 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : deflate.cpp
+// Date : October 17, 2026
+// Description : DEFLATE compression
+//
+// Compresses data into zlib streams (RFC 1950/1951), e.g. for PNG image data
+// Matches are found with hash chains over a 32KB window, then coded with dynamic Huffman blocks
+// Blocks that wouldn't get any smaller are stored instead
+
+#include <algorithm>
+#include <cstring>
+
+#include "deflate.h"
+#include "util.h"
+
+const u32 DEFLATE_WINDOW = 0x8000;
+const u32 DEFLATE_MIN_MATCH = 3;
+const u32 DEFLATE_MAX_MATCH = 258;
+const u32 DEFLATE_HASH_BITS = 15;
+
+//How many earlier positions are compared before settling for the best match so far
+const u32 DEFLATE_MAX_CHAIN = 64;
+
+//Symbols collected before a block is written
+const u32 DEFLATE_BLOCK_SYMBOLS = 0x10000;
+
+//Literal/length and distance alphabets
+const u32 LITLEN_CODES = 288;
+const u32 DIST_CODES = 30;
+const u32 CODELEN_CODES = 19;
+
+const u16 length_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const u8 length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+const u16 dist_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const u8 dist_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+//Order code length code lengths are sent in
+const u8 codelen_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+//DEFLATE packs bits starting from the least significant bit of each byte
+struct deflate_bits
+{
+	std::vector<u8>* dest;
+	u64 bit_buffer;
+	u32 bit_count;
+
+	/****** Appends bits to the output ******/
+	void put(u32 bits, u32 count)
+	{
+		bit_buffer |= (u64(bits) << bit_count);
+		bit_count += count;
+
+		while(bit_count >= 8)
+		{
+			dest->push_back(bit_buffer & 0xFF);
+			bit_buffer >>= 8;
+			bit_count -= 8;
+		}
+	}
+
+	/****** Pads the output to a whole byte ******/
+	void align()
+	{
+		if(bit_count) { put(0, (8 - bit_count)); }
+	}
+};
+
+//Literals are stored as-is, matches as (distance << 16) | length
+struct deflate_block
+{
+	std::vector<u32> symbols;
+	u32 litlen_freq[LITLEN_CODES];
+	u32 dist_freq[DIST_CODES];
+	u32 start;
+	u32 end;
+};
+
+/****** Returns the length code (0-28) for a match length ******/
+static u32 get_length_code(u32 length)
+{
+	u32 code = 28;
+	while(length_base[code] > length) { code--; }
+	return code;
+}
+
+/****** Returns the distance code (0-29) for a match distance ******/
+static u32 get_dist_code(u32 dist)
+{
+	u32 code = 29;
+	while(dist_base[code] > dist) { code--; }
+	return code;
+}
+
+/****** Reverses the lowest bits of a Huffman code, DEFLATE sends codes most significant bit first ******/
+static u16 reverse_code(u16 code, u32 length)
+{
+	u16 result = 0;
+
+	for(u32 x = 0; x < length; x++)
+	{
+		result = (result << 1) | (code & 0x1);
+		code >>= 1;
+	}
+
+	return result;
+}
+
+/****** Builds Huffman code lengths no longer than max_length for a set of symbol frequencies ******/
+static void build_lengths(const u32* freq, u32 count, u32 max_length, u8* lengths)
+{
+	memset(lengths, 0, count);
+
+	std::vector<u32> symbols;
+	for(u32 x = 0; x < count; x++) { if(freq[x]) { symbols.push_back(x); } }
+
+	//Decoders reject a code with only one symbol, so always use at least two
+	while(symbols.size() < 2)
+	{
+		u32 extra = (symbols.empty() || (symbols[0] != 0)) ? 0 : 1;
+		symbols.push_back(extra);
+	}
+
+	std::stable_sort(symbols.begin(), symbols.end(), [&](u32 a, u32 b) { return freq[a] < freq[b]; });
+
+	//Build the tree with two queues, leaves are already sorted and new nodes come out sorted
+	u32 leaf_count = symbols.size();
+	std::vector<u64> node_freq(leaf_count * 2);
+	std::vector<u32> parent(leaf_count * 2);
+	std::vector<u32> depth(leaf_count * 2);
+
+	for(u32 x = 0; x < leaf_count; x++) { node_freq[x] = freq[symbols[x]]; }
+
+	u32 next_leaf = 0;
+	u32 next_node = leaf_count;
+
+	for(u32 x = leaf_count; x < ((leaf_count * 2) - 1); x++)
+	{
+		u32 pick[2];
+
+		for(u32 y = 0; y < 2; y++)
+		{
+			if((next_leaf < leaf_count) && ((next_node >= x) || (node_freq[next_leaf] <= node_freq[next_node]))) { pick[y] = next_leaf++; }
+			else { pick[y] = next_node++; }
+		}
+
+		node_freq[x] = node_freq[pick[0]] + node_freq[pick[1]];
+		parent[pick[0]] = x;
+		parent[pick[1]] = x;
+	}
+
+	//Parents always come after their children, so walk down from the root
+	u32 root = (leaf_count * 2) - 2;
+	depth[root] = 0;
+
+	for(s32 x = (root - 1); x >= 0; x--) { depth[x] = depth[parent[x]] + 1; }
+
+	//Count codes of each length, anything too long is cut down to the limit for now
+	u32 length_count[32];
+	memset(length_count, 0, sizeof(length_count));
+
+	for(u32 x = 0; x < leaf_count; x++) { length_count[std::min(depth[x], max_length)]++; }
+
+	//Shortening codes breaks the Kraft inequality, lengthen shorter codes until it holds exactly again
+	u32 total = 0;
+	for(u32 x = 1; x <= max_length; x++) { total += (length_count[x] << (max_length - x)); }
+
+	while(total != (1u << max_length))
+	{
+		length_count[max_length]--;
+
+		for(u32 x = (max_length - 1); x > 0; x--)
+		{
+			if(length_count[x])
+			{
+				length_count[x]--;
+				length_count[x + 1] += 2;
+				break;
+			}
+		}
+
+		total--;
+	}
+
+	//Least frequent symbols get the longest codes
+	u32 index = 0;
+
+	for(u32 x = max_length; x > 0; x--)
+	{
+		for(u32 y = 0; y < length_count[x]; y++) { lengths[symbols[index++]] = x; }
+	}
+}
+
+/****** Assigns canonical Huffman codes from code lengths ******/
+static void build_codes(const u8* lengths, u32 count, u16* codes)
+{
+	u32 length_count[16];
+	u32 next_code[16];
+	memset(length_count, 0, sizeof(length_count));
+
+	for(u32 x = 0; x < count; x++) { length_count[lengths[x]]++; }
+
+	length_count[0] = 0;
+	u32 code = 0;
+
+	for(u32 x = 1; x < 16; x++)
+	{
+		code = (code + length_count[x - 1]) << 1;
+		next_code[x] = code;
+	}
+
+	for(u32 x = 0; x < count; x++)
+	{
+		codes[x] = (lengths[x]) ? reverse_code(next_code[lengths[x]]++, lengths[x]) : 0;
+	}
+}
+
+/****** Writes a range of input as stored blocks ******/
+static void write_stored(deflate_bits &bits, const u8* src, u32 start, u32 end, bool final)
+{
+	do
+	{
+		u32 length = std::min((end - start), 0xFFFFu);
+		bool last = final && ((start + length) == end);
+
+		bits.put(last, 1);
+		bits.put(0, 2);
+		bits.align();
+
+		bits.put(length, 16);
+		bits.put((~length & 0xFFFF), 16);
+		bits.dest->insert(bits.dest->end(), (src + start), (src + start + length));
+
+		start += length;
+	}
+	while(start < end);
+}
+
+/****** Writes a block of symbols with its own Huffman codes, or stores it if that's smaller ******/
+static void write_block(deflate_bits &bits, const u8* src, deflate_block &block, bool final)
+{
+	u8 litlen_lengths[LITLEN_CODES];
+	u8 dist_lengths[DIST_CODES];
+	u16 litlen_codes[LITLEN_CODES];
+	u16 dist_codes[DIST_CODES];
+
+	block.litlen_freq[256]++;
+
+	build_lengths(block.litlen_freq, 286, 15, litlen_lengths);
+	build_lengths(block.dist_freq, DIST_CODES, 15, dist_lengths);
+	litlen_lengths[286] = litlen_lengths[287] = 0;
+
+	build_codes(litlen_lengths, LITLEN_CODES, litlen_codes);
+	build_codes(dist_lengths, DIST_CODES, dist_codes);
+
+	//Trim unused codes off the end of both alphabets
+	u32 hlit = 286;
+	while((hlit > 257) && (!litlen_lengths[hlit - 1])) { hlit--; }
+
+	u32 hdist = DIST_CODES;
+	while((hdist > 1) && (!dist_lengths[hdist - 1])) { hdist--; }
+
+	//Run-length encode both sets of code lengths together - 16 repeats the last length, 17 and 18 repeat zeros
+	std::vector<u8> all_lengths(litlen_lengths, (litlen_lengths + hlit));
+	all_lengths.insert(all_lengths.end(), dist_lengths, (dist_lengths + hdist));
+
+	std::vector<u16> codelen_symbols;
+	u32 codelen_freq[CODELEN_CODES];
+	memset(codelen_freq, 0, sizeof(codelen_freq));
+
+	for(u32 x = 0; x < all_lengths.size();)
+	{
+		u8 current = all_lengths[x];
+		u32 run = 1;
+
+		while(((x + run) < all_lengths.size()) && (all_lengths[x + run] == current)) { run++; }
+		x += run;
+
+		if(!current)
+		{
+			while(run >= 11)
+			{
+				u32 repeat = std::min(run, 138u);
+				codelen_symbols.push_back(18 | ((repeat - 11) << 8));
+				run -= repeat;
+			}
+
+			if(run >= 3)
+			{
+				codelen_symbols.push_back(17 | ((run - 3) << 8));
+				run = 0;
+			}
+		}
+
+		else
+		{
+			codelen_symbols.push_back(current);
+			run--;
+
+			while(run >= 3)
+			{
+				u32 repeat = std::min(run, 6u);
+				codelen_symbols.push_back(16 | ((repeat - 3) << 8));
+				run -= repeat;
+			}
+		}
+
+		while(run--) { codelen_symbols.push_back(current); }
+	}
+
+	for(u32 x = 0; x < codelen_symbols.size(); x++) { codelen_freq[codelen_symbols[x] & 0xFF]++; }
+
+	u8 codelen_lengths[CODELEN_CODES];
+	u16 codelen_codes[CODELEN_CODES];
+
+	build_lengths(codelen_freq, CODELEN_CODES, 7, codelen_lengths);
+	build_codes(codelen_lengths, CODELEN_CODES, codelen_codes);
+
+	u32 hclen = CODELEN_CODES;
+	while((hclen > 4) && (!codelen_lengths[codelen_order[hclen - 1]])) { hclen--; }
+
+	//Compare against storing the block
+	u64 block_bits = 17 + (hclen * 3);
+
+	for(u32 x = 0; x < CODELEN_CODES; x++)
+	{
+		u32 extra = (x == 16) ? 2 : (x == 17) ? 3 : (x == 18) ? 7 : 0;
+		block_bits += u64(codelen_freq[x]) * (codelen_lengths[x] + extra);
+	}
+
+	for(u32 x = 0; x < 286; x++)
+	{
+		u32 extra = (x > 256) ? length_extra[x - 257] : 0;
+		block_bits += u64(block.litlen_freq[x]) * (litlen_lengths[x] + extra);
+	}
+
+	for(u32 x = 0; x < DIST_CODES; x++) { block_bits += u64(block.dist_freq[x]) * (dist_lengths[x] + dist_extra[x]); }
+
+	u64 stored_bits = (u64(block.end - block.start) * 8) + ((((block.end - block.start) / 0xFFFF) + 1) * 48);
+
+	if(block_bits >= stored_bits)
+	{
+		write_stored(bits, src, block.start, block.end, final);
+		return;
+	}
+
+	//Block header
+	bits.put(final, 1);
+	bits.put(2, 2);
+	bits.put((hlit - 257), 5);
+	bits.put((hdist - 1), 5);
+	bits.put((hclen - 4), 4);
+
+	for(u32 x = 0; x < hclen; x++) { bits.put(codelen_lengths[codelen_order[x]], 3); }
+
+	for(u32 x = 0; x < codelen_symbols.size(); x++)
+	{
+		u32 symbol = codelen_symbols[x] & 0xFF;
+		u32 repeat = codelen_symbols[x] >> 8;
+
+		bits.put(codelen_codes[symbol], codelen_lengths[symbol]);
+
+		if(symbol == 16) { bits.put(repeat, 2); }
+		else if(symbol == 17) { bits.put(repeat, 3); }
+		else if(symbol == 18) { bits.put(repeat, 7); }
+	}
+
+	//Block data
+	for(u32 x = 0; x < block.symbols.size(); x++)
+	{
+		u32 symbol = block.symbols[x];
+		u32 dist = (symbol >> 16);
+
+		if(!dist)
+		{
+			bits.put(litlen_codes[symbol], litlen_lengths[symbol]);
+			continue;
+		}
+
+		u32 length = (symbol & 0xFFFF);
+		u32 length_code = get_length_code(length);
+		u32 dist_code = get_dist_code(dist);
+
+		bits.put(litlen_codes[257 + length_code], litlen_lengths[257 + length_code]);
+		bits.put((length - length_base[length_code]), length_extra[length_code]);
+
+		bits.put(dist_codes[dist_code], dist_lengths[dist_code]);
+		bits.put((dist - dist_base[dist_code]), dist_extra[dist_code]);
+	}
+
+	//End of block
+	bits.put(litlen_codes[256], litlen_lengths[256]);
+}
+
+/****** Hashes the next 3 bytes ******/
+static u32 deflate_hash(const u8* src)
+{
+	u32 sequence = (src[0] << 16) | (src[1] << 8) | src[2];
+	return (sequence * 2654435761U) >> (32 - DEFLATE_HASH_BITS);
+}
+
+/****** Compresses data into a zlib stream ******/
+void zlib_compress(const u8* src, u32 length, std::vector<u8> &dest)
+{
+	dest.clear();
+	dest.reserve((length / 2) + 64);
+
+	//zlib header - DEFLATE with a 32KB window, default compression level
+	dest.push_back(0x78);
+	dest.push_back(0x9C);
+
+	deflate_bits bits;
+	bits.dest = &dest;
+	bits.bit_buffer = 0;
+	bits.bit_count = 0;
+
+	//Most recent position for each hash, and the previous position with the same hash for each window position
+	std::vector<s32> head((1 << DEFLATE_HASH_BITS), -1);
+	std::vector<s32> prev(DEFLATE_WINDOW, -1);
+
+	deflate_block block;
+	block.symbols.reserve(DEFLATE_BLOCK_SYMBOLS);
+
+	u32 pos = 0;
+
+	do
+	{
+		block.symbols.clear();
+		memset(block.litlen_freq, 0, sizeof(block.litlen_freq));
+		memset(block.dist_freq, 0, sizeof(block.dist_freq));
+		block.start = pos;
+
+		while((pos < length) && (block.symbols.size() < DEFLATE_BLOCK_SYMBOLS))
+		{
+			u32 best_length = 0;
+			u32 best_dist = 0;
+
+			if((pos + DEFLATE_MIN_MATCH) <= length)
+			{
+				u32 hash = deflate_hash(src + pos);
+				u32 max_length = std::min((length - pos), DEFLATE_MAX_MATCH);
+				s32 candidate = head[hash];
+
+				for(u32 chain = 0; (chain < DEFLATE_MAX_CHAIN) && (candidate >= 0) && ((pos - candidate) <= DEFLATE_WINDOW); chain++)
+				{
+					const u8* a = src + candidate;
+					const u8* b = src + pos;
+
+					//Only a longer match is any use, so check the byte that would make it longer first
+					if(a[best_length] == b[best_length])
+					{
+						u32 match_length = 0;
+						while((match_length < max_length) && (a[match_length] == b[match_length])) { match_length++; }
+
+						if(match_length > best_length)
+						{
+							best_length = match_length;
+							best_dist = pos - candidate;
+							if(best_length == max_length) { break; }
+						}
+					}
+
+					//Stale entries from positions that left the window can point forward, stop there
+					s32 next = prev[candidate & (DEFLATE_WINDOW - 1)];
+					if(next >= candidate) { break; }
+					candidate = next;
+				}
+
+				prev[pos & (DEFLATE_WINDOW - 1)] = head[hash];
+				head[hash] = pos;
+			}
+
+			if(best_length >= DEFLATE_MIN_MATCH)
+			{
+				block.symbols.push_back((best_dist << 16) | best_length);
+				block.litlen_freq[257 + get_length_code(best_length)]++;
+				block.dist_freq[get_dist_code(best_dist)]++;
+
+				//Remember every position the match covers
+				for(u32 x = 1; x < best_length; x++)
+				{
+					u32 next_pos = pos + x;
+					if((next_pos + DEFLATE_MIN_MATCH) > length) { break; }
+
+					u32 hash = deflate_hash(src + next_pos);
+					prev[next_pos & (DEFLATE_WINDOW - 1)] = head[hash];
+					head[hash] = next_pos;
+				}
+
+				pos += best_length;
+			}
+
+			else
+			{
+				block.symbols.push_back(src[pos]);
+				block.litlen_freq[src[pos]]++;
+				pos++;
+			}
+		}
+
+		block.end = pos;
+		write_block(bits, src, block, (pos == length));
+	}
+	while(pos < length);
+
+	bits.align();
+
+	//zlib trailer - Adler32 of the uncompressed data, big-endian
+	u32 checksum = util::get_addler32(src, length);
+
+	for(int x = 24; x >= 0; x -= 8) { dest.push_back((checksum >> x) & 0xFF); }
+}
@@ -0,0 +1,21 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : deflate.h
+// Date : October 17, 2026
+// Description : DEFLATE compression
+//
+// Compresses data into zlib streams (RFC 1950/1951), e.g. for PNG image data
+// Only compression is needed, nothing in GBE+ reads DEFLATE data back
+
+#ifndef GBE_DEFLATE
+#define GBE_DEFLATE
+
+#include <vector>
+
+#include "common.h"
+
+void zlib_compress(const u8* src, u32 length, std::vector<u8> &dest);
+
+#endif // GBE_DEFLATE
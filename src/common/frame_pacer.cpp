@@ -0,0 +1,370 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : frame_pacer.cpp
+// Date : October 17, 2026
+// Description : Frame pacer
+//
+// Limits framerate against a monotonic nanosecond clock, sleeping coarsely then spinning to each deadline
+// Keeps a rolling histogram of frame times that can be queried or drawn via the OSD
+// Deadlines are absolute, so a frame that runs late is made up by the next instead of drifting
+// Health counters are closed out once per second, so short stalls and audio starvation show up instead of being averaged away
+// Frames that span a pause are dropped from pacing and health instead of counting as one long, late frame
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "frame_pacer.h"
+#include "audio_buffer.h"
+#include "config.h"
+#include "util.h"
+
+//Stop sleeping this far from the deadline (nanoseconds) and spin the rest, OS sleeps routinely overshoot by a millisecond or so
+const u64 SPIN_MARGIN = 2000000;
+
+//Length of each health period (nanoseconds)
+const u64 HEALTH_PERIOD = 1000000000;
+
+GBE_THREAD_LOCAL u32 frame_pacer::resume_count = 0;
+
+/****** Returns a monotonic timestamp in nanoseconds ******/
+static u64 get_timestamp()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/****** Frame Pacer Constructor ******/
+frame_pacer::frame_pacer()
+{
+	health_log_failed = false;
+	health_log_time = 0;
+	log_quit = false;
+	reset(60);
+}
+
+/****** Frame Pacer Destructor ******/
+frame_pacer::~frame_pacer()
+{
+	//Finish writing any queued health data
+	if(log_worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> guard(log_lock);
+			log_quit = true;
+		}
+
+		log_signal.notify_one();
+		log_worker.join();
+	}
+}
+
+/****** Sets the target framerate and clears all statistics ******/
+void frame_pacer::reset(u32 fps)
+{
+	rate = (fps) ? fps : 60;
+
+	base_time = get_timestamp();
+	frame_index = 0;
+
+	last_record = 0;
+	window_pos = 0;
+	window_count = 0;
+
+	for(u32 x = 0; x < WINDOW_SIZE; x++) { frame_times[x] = 0; }
+	for(u32 x = 0; x < BUCKET_COUNT; x++) { buckets[x] = 0; }
+
+	current_health = pacer_health();
+	last_health = pacer_health();
+	period_start = 0;
+	frame_idle = 0;
+	frame_limited = false;
+	last_underruns = 0;
+	last_overruns = 0;
+	resume_seen = resume_count;
+}
+
+/****** Returns the deadline for a given frame since the base time ******/
+u64 frame_pacer::get_deadline(u64 index)
+{
+	return base_time + ((index * 1000000000ULL) / rate);
+}
+
+/****** Waits until the next frame is due ******/
+void frame_pacer::wait()
+{
+	u64 now = get_timestamp();
+	u64 deadline = get_deadline(++frame_index);
+
+	//More than a frame behind (e.g. after a pause or turbo), start over instead of rushing to catch up
+	if(now >= get_deadline(frame_index + 1))
+	{
+		resync();
+		return;
+	}
+
+	//Sleep off most of the wait, then spin for precision
+	if((now + SPIN_MARGIN) < deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - now - SPIN_MARGIN));
+	}
+
+	while(get_timestamp() < deadline) { std::this_thread::yield(); }
+}
+
+/****** Tells every pacer on this thread that emulation is resuming after a pause ******/
+void frame_pacer::notify_resume() { resume_count++; }
+
+/****** Starts pacing and health tracking over if emulation was paused since the last frame ******/
+void frame_pacer::check_resume()
+{
+	if(resume_seen == resume_count) { return; }
+	resume_seen = resume_count;
+
+	//The paused frame would count as a missed deadline and drag the speed down, so drop it and the unfinished period
+	resync();
+	last_record = 0;
+	current_health = pacer_health();
+}
+
+/****** Starts counting deadlines from now, used when something else paced the last frame ******/
+void frame_pacer::resync()
+{
+	base_time = get_timestamp();
+	frame_index = 0;
+}
+
+/****** Waits for the next frame, pacing on the audio device's clock when syncing to audio ******/
+void frame_pacer::limit(audio_buffer* audio)
+{
+	check_resume();
+
+	u64 start = get_timestamp();
+
+	if((audio != NULL) && (audio->sync())) { resync(); }
+	else { wait(); }
+
+	frame_idle += (get_timestamp() - start);
+	frame_limited = true;
+}
+
+/****** Records the time since the last recorded frame ******/
+void frame_pacer::record(audio_buffer* audio)
+{
+	check_resume();
+
+	u64 now = get_timestamp();
+
+	if(last_record == 0)
+	{
+		last_record = period_start = now;
+		frame_idle = 0;
+		frame_limited = false;
+		return;
+	}
+
+	u64 frame_time = now - last_record;
+	last_record = now;
+
+	//Evict the oldest frame once the window is full
+	if(window_count == WINDOW_SIZE)
+	{
+		u32 old_bucket = frame_times[window_pos] / BUCKET_WIDTH;
+		if(old_bucket >= BUCKET_COUNT) { old_bucket = BUCKET_COUNT - 1; }
+		buckets[old_bucket]--;
+	}
+
+	else { window_count++; }
+
+	u32 bucket = frame_time / BUCKET_WIDTH;
+	if(bucket >= BUCKET_COUNT) { bucket = BUCKET_COUNT - 1; }
+	buckets[bucket]++;
+
+	frame_times[window_pos] = frame_time;
+	window_pos = (window_pos + 1) % WINDOW_SIZE;
+
+	update_health(now, frame_time, audio);
+}
+
+/****** Adds a frame to the current health period, closing it out once it is long enough ******/
+void frame_pacer::update_health(u64 now, u64 frame_time, audio_buffer* audio)
+{
+	current_health.frames++;
+	current_health.idle_ns += frame_idle;
+
+	//Only paced frames have a deadline, e.g. not while in turbo
+	if((frame_limited) && ((frame_time - frame_idle) > (1000000000ULL / rate))) { current_health.missed_deadlines++; }
+
+	frame_idle = 0;
+	frame_limited = false;
+
+	u64 period = now - period_start;
+	if(period < HEALTH_PERIOD) { return; }
+
+	//Audio counters start over whenever the buffer is cleared
+	if(audio != NULL)
+	{
+		u32 underruns = audio->underruns;
+		u32 overruns = audio->overruns;
+
+		current_health.audio_underruns = (underruns >= last_underruns) ? (underruns - last_underruns) : underruns;
+		current_health.audio_overruns = (overruns >= last_overruns) ? (overruns - last_overruns) : overruns;
+
+		last_underruns = underruns;
+		last_overruns = overruns;
+	}
+
+	current_health.period_ns = period;
+	current_health.emulation_ns = (period > current_health.idle_ns) ? (period - current_health.idle_ns) : 0;
+	current_health.speed = (current_health.frames * 1000000000.0) / (double(rate) * period);
+
+	current_health.total_missed_deadlines = last_health.total_missed_deadlines + current_health.missed_deadlines;
+	current_health.total_audio_underruns = last_health.total_audio_underruns + current_health.audio_underruns;
+	current_health.total_audio_overruns = last_health.total_audio_overruns + current_health.audio_overruns;
+
+	last_health = current_health;
+	current_health = pacer_health();
+	period_start = now;
+
+	write_health_log();
+}
+
+/****** Queues the last health period for the log file, if one was requested ******/
+void frame_pacer::write_health_log()
+{
+	if(config::health_log_file.empty()) { return; }
+
+	//Open log file on the first period
+	if((!health_log.is_open()) && (!health_log_failed))
+	{
+		health_log.open(config::health_log_file.c_str(), std::ios::out | std::ios::trunc);
+
+		if(!health_log.is_open())
+		{
+			std::cout<<"GBE::Error - Could not open health log file " << config::health_log_file << "\n";
+			health_log_failed = true;
+			return;
+		}
+
+		std::cout<<"GBE::Writing health data to " << config::health_log_file << "\n";
+
+		log_lines.push_back("time_ms,frames,speed,missed_deadlines,emulation_us,idle_us,audio_underruns,audio_overruns\n");
+		log_worker = std::thread(&frame_pacer::log_thread, this);
+	}
+
+	if(!health_log.is_open()) { return; }
+
+	health_log_time += last_health.period_ns;
+
+	std::ostringstream line;
+	line << (health_log_time / 1000000) << "," << last_health.frames << "," << last_health.speed << ",";
+	line << last_health.missed_deadlines << "," << (last_health.emulation_ns / 1000) << "," << (last_health.idle_ns / 1000) << ",";
+	line << last_health.audio_underruns << "," << last_health.audio_overruns << "\n";
+
+	{
+		std::lock_guard<std::mutex> guard(log_lock);
+		log_lines.push_back(line.str());
+	}
+
+	log_signal.notify_one();
+}
+
+/****** Log thread - Waits for queued health data and writes it ******/
+void frame_pacer::log_thread()
+{
+	std::string line;
+
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> guard(log_lock);
+			log_signal.wait(guard, [this]() { return ((!log_lines.empty()) || log_quit); });
+
+			//Always write everything queued before quitting
+			if(log_lines.empty()) { return; }
+
+			line = std::move(log_lines.front());
+			log_lines.pop_front();
+		}
+
+		//Keep the log readable while running, it only grows once a second
+		health_log << line;
+		health_log.flush();
+	}
+}
+
+/****** Returns the given percentile of recent frame times in nanoseconds, to the histogram's resolution ******/
+u64 frame_pacer::get_percentile(u32 percent)
+{
+	if(window_count == 0) { return 0; }
+	if(percent > 100) { percent = 100; }
+
+	u32 rank = ((window_count * percent) + 99) / 100;
+	if(rank == 0) { rank = 1; }
+
+	u32 total = 0;
+
+	for(u32 x = 0; x < BUCKET_COUNT; x++)
+	{
+		total += buckets[x];
+
+		//Report the middle of the bucket
+		if(total >= rank) { return (x * BUCKET_WIDTH) + (BUCKET_WIDTH / 2); }
+	}
+
+	return get_max();
+}
+
+/****** Returns the longest recent frame time in nanoseconds ******/
+u64 frame_pacer::get_max()
+{
+	u64 result = 0;
+
+	for(u32 x = 0; x < window_count; x++)
+	{
+		if(frame_times[x] > result) { result = frame_times[x]; }
+	}
+
+	return result;
+}
+
+/****** Returns the number of frames in the rolling window ******/
+u32 frame_pacer::get_count() { return window_count; }
+
+/****** Returns runtime health for the last complete period ******/
+pacer_health frame_pacer::get_health() { return last_health; }
+
+/****** Draws recent frame times (microseconds) and runtime health via the OSD ******/
+void frame_pacer::draw_osd(std::vector <u32> &osd_surface)
+{
+	//Stay below the profiler's lines and within the OSD's 20 character limit
+	if(config::frame_stats_osd)
+	{
+		std::string line_1 = "P50 " + util::to_str(get_percentile(50) / 1000) + " P99 " + util::to_str(get_percentile(99) / 1000);
+		std::string line_2 = "MAX " + util::to_str(get_max() / 1000);
+
+		draw_osd_msg(line_1, osd_surface, 0, 4);
+		draw_osd_msg(line_2, osd_surface, 0, 5);
+	}
+
+	//Health page below the frame times - Speed and host load in percent, deadlines and audio counts for the last second
+	if(config::health_osd)
+	{
+		u64 period = (last_health.period_ns) ? last_health.period_ns : 1;
+		u32 speed = (last_health.speed * 100.0) + 0.5;
+		u32 emulation = (last_health.emulation_ns * 100) / period;
+		u32 idle = (last_health.idle_ns * 100) / period;
+
+		std::string line_1 = "SPD " + util::to_str(speed) + " FPS " + util::to_str(last_health.frames);
+		std::string line_2 = "EMU " + util::to_str(emulation) + " IDLE " + util::to_str(idle);
+		std::string line_3 = "LATE " + util::to_str(last_health.missed_deadlines) + " ALL " + util::to_str(last_health.total_missed_deadlines);
+		std::string line_4 = "UNDER " + util::to_str(last_health.audio_underruns) + " OVER " + util::to_str(last_health.audio_overruns);
+
+		draw_osd_msg(line_1, osd_surface, 0, 6);
+		draw_osd_msg(line_2, osd_surface, 0, 7);
+		draw_osd_msg(line_3, osd_surface, 0, 8);
+		draw_osd_msg(line_4, osd_surface, 0, 9);
+	}
+}
@@ -0,0 +1,123 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : frame_pacer.h
+// Date : October 17, 2026
+// Description : Frame pacer
+//
+// Limits framerate against a monotonic nanosecond clock, sleeping coarsely then spinning to each deadline
+// Keeps a rolling histogram of frame times that can be queried or drawn via the OSD
+// Also tracks runtime health each second (speed, missed deadlines, idle time, audio underruns/overruns) for the OSD or a log file
+// The health log is written on a background thread so disk access never holds up a frame
+
+#ifndef GBE_FRAME_PACER
+#define GBE_FRAME_PACER
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+
+class audio_buffer;
+
+//Runtime health over the last complete period
+struct pacer_health
+{
+	u64 period_ns;
+	u64 emulation_ns;
+	u64 idle_ns;
+	u32 frames;
+
+	//Emulated time over real time, 1.0 = full speed
+	double speed;
+
+	//Frames whose emulation alone took longer than a frame, and audio callbacks that ran dry or samples dropped
+	u32 missed_deadlines;
+	u32 audio_underruns;
+	u32 audio_overruns;
+
+	//Same counters since the last reset
+	u64 total_missed_deadlines;
+	u64 total_audio_underruns;
+	u64 total_audio_overruns;
+};
+
+class frame_pacer
+{
+	public:
+
+	frame_pacer();
+	~frame_pacer();
+
+	void reset(u32 fps);
+	void wait();
+	void resync();
+	void limit(audio_buffer* audio);
+	void record(audio_buffer* audio);
+
+	u64 get_percentile(u32 percent);
+	u64 get_max();
+	u32 get_count();
+	pacer_health get_health();
+
+	void draw_osd(std::vector <u32> &osd_surface);
+
+	static void notify_resume();
+
+	private:
+
+	//Frames kept in the rolling window and width of each histogram bucket (nanoseconds)
+	static const u32 WINDOW_SIZE = 600;
+	static const u32 BUCKET_WIDTH = 50000;
+	static const u32 BUCKET_COUNT = 2000;
+
+	u32 rate;
+
+	//Deadlines are counted from a base time so rounding never accumulates
+	u64 base_time;
+	u64 frame_index;
+
+	u64 last_record;
+	u64 frame_times[WINDOW_SIZE];
+	u32 window_pos;
+	u32 window_count;
+	u16 buckets[BUCKET_COUNT];
+
+	//Health counters for the current period, the last complete period, and the last audio counters seen
+	pacer_health current_health;
+	pacer_health last_health;
+	u64 period_start;
+	u64 frame_idle;
+	bool frame_limited;
+	u32 last_underruns;
+	u32 last_overruns;
+
+	//Bumped whenever emulation resumes after a pause, each pacer compares it against the last value it saw
+	static GBE_THREAD_LOCAL u32 resume_count;
+	u32 resume_seen;
+
+	std::ofstream health_log;
+	bool health_log_failed;
+	u64 health_log_time;
+
+	//Shared with the log thread
+	std::deque<std::string> log_lines;
+	bool log_quit;
+	std::thread log_worker;
+	std::mutex log_lock;
+	std::condition_variable log_signal;
+
+	u64 get_deadline(u64 index);
+	void check_resume();
+	void update_health(u64 now, u64 frame_time, audio_buffer* audio);
+	void write_health_log();
+	void log_thread();
+};
+
+#endif // GBE_FRAME_PACER
@@ -0,0 +1,364 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : input_movie.cpp
+// Date : October 17, 2026
+// Description : Input movies
+//
+// Records per-frame input state to a compact movie file, or plays one back frame-exactly
+// Movies start from power-on or from an embedded save state
+// Input only ever changes at frame boundaries, live input is held back until the next frame while recording
+// The RTC runs from a seed stored in the movie and advances with emulated frames instead of the host clock
+
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+#include "input_movie.h"
+#include "state_file.h"
+#include "config.h"
+#include "util.h"
+
+//Movie file header
+const u32 MOVIE_MAGIC = 0x4D454247;
+const u8 MOVIE_VERSION = 1;
+const u8 MOVIE_FROM_STATE = 0x1;
+
+//Longest run of identical input stored in one record, longer runs are split
+const u32 MOVIE_MAX_RUN = 0x10000;
+
+/****** Input Movie Constructor ******/
+input_movie::input_movie()
+{
+	reset();
+}
+
+/****** Input Movie Destructor ******/
+input_movie::~input_movie()
+{
+	stop();
+}
+
+/****** Arms recording or playback based on the current configuration ******/
+void input_movie::reset()
+{
+	frames.clear();
+	start_state.clear();
+
+	memset(&current, 0, sizeof(current));
+	memset(&pending, 0, sizeof(pending));
+
+	frame_index = 0;
+	rom_crc = 0;
+	rtc_seed = 0;
+	started = false;
+
+	//Start on the very first frame
+	last_frame = 0xFFFFFFFF;
+
+	recording = !config::movie_record_file.empty();
+	playing = (!recording) && (!config::movie_play_file.empty());
+	active = (recording || playing);
+
+	filename = (recording) ? config::movie_record_file : config::movie_play_file;
+}
+
+/****** Called once per emulated frame - Records or applies the next frame's input ******/
+void input_movie::update(core_emu* core, u32 frame)
+{
+	last_frame = frame;
+
+	if(!active) { return; }
+
+	if(!started)
+	{
+		started = true;
+
+		if(!begin(core))
+		{
+			recording = false;
+			playing = false;
+			active = false;
+			return;
+		}
+	}
+
+	//Commit whatever live input arrived during the last frame
+	if(recording)
+	{
+		//Sensors keep moving on their own during a frame, take their latest readings
+		movie_input live;
+		core->get_movie_input(live);
+
+		pending.sensor_x = live.sensor_x;
+		pending.sensor_y = live.sensor_y;
+		pending.gyro_value = live.gyro_value;
+
+		current = pending;
+		frames.push_back(current);
+
+		//One-shot events only last a single frame
+		pending.keys &= ~MOVIE_EVENT_MASK;
+	}
+
+	else if(frame_index < frames.size()) { current = frames[frame_index]; }
+
+	//Out of input, hand control back to the user
+	else
+	{
+		std::cout<<"MOVIE::Playback finished after " << std::dec << frames.size() << " frames\n";
+
+		//OSD
+		config::osd_message = "MOVIE FINISHED";
+		config::osd_count = 180;
+
+		playing = false;
+		active = false;
+		config::fixed_rtc_time = 0;
+		return;
+	}
+
+	frame_index++;
+
+	//Emulated seconds elapse every 60 frames
+	config::fixed_rtc_time = rtc_seed + (frame_index / 60);
+
+	core->set_movie_input(current, true);
+}
+
+/****** Sets up the movie on its first frame, returns false if the movie can't be used ******/
+bool input_movie::begin(core_emu* core)
+{
+	rom_crc = 0;
+	util::get_file_crc32(config::rom_file, rom_crc);
+
+	if(recording)
+	{
+		//Optionally start from a save state, otherwise from power-on
+		if(config::movie_state_slot >= 0)
+		{
+			std::string id = (config::movie_state_slot > 0) ? util::to_str(config::movie_state_slot) : "";
+
+			if(!load_state_file(core, (config::rom_file + ".ss" + id)))
+			{
+				std::cout<<"MOVIE::Error - Could not load save state for recording\n";
+				return false;
+			}
+
+			if(!core->serialize(start_state)) { return false; }
+		}
+
+		rtc_seed = time(0);
+		core->get_movie_input(pending);
+
+		std::cout<<"MOVIE::Recording to " << filename << "\n";
+		return true;
+	}
+
+	if(!load_file()) { return false; }
+
+	if(!start_state.empty())
+	{
+		//Keep the current state so a movie state that doesn't fit can be undone
+		std::vector<u8> backup_data;
+		if(!core->serialize(backup_data)) { return false; }
+
+		if(!core->deserialize(start_state.data(), start_state.size()))
+		{
+			core->deserialize(backup_data.data(), backup_data.size());
+			std::cout<<"MOVIE::Error - Could not load the movie's save state\n";
+			return false;
+		}
+	}
+
+	std::cout<<"MOVIE::Playing " << filename << " (" << std::dec << frames.size() << " frames)\n";
+	return true;
+}
+
+/****** Ends recording or playback, writing the movie file if recording ******/
+void input_movie::stop()
+{
+	if((recording) && (started)) { save_file(); }
+
+	recording = false;
+	playing = false;
+	active = false;
+
+	if(started) { config::fixed_rtc_time = 0; }
+}
+
+/****** Makes the core's pad state live before applying user input - Call before handling input events ******/
+void input_movie::begin_live_input(core_emu* core)
+{
+	if((recording) && (started)) { core->set_movie_input(pending, false); }
+}
+
+/****** Holds user input back until the next frame, or discards it during playback - Call after handling input events ******/
+void input_movie::end_live_input(core_emu* core)
+{
+	if(!started) { return; }
+
+	if(recording)
+	{
+		//Keep one-shot events from earlier in the frame
+		u32 events = (pending.keys & MOVIE_EVENT_MASK);
+
+		core->get_movie_input(pending);
+		pending.keys |= events;
+
+		core->set_movie_input(current, false);
+	}
+
+	else if(playing) { core->set_movie_input(current, false); }
+}
+
+/****** Writes the movie file ******/
+bool input_movie::save_file()
+{
+	std::vector<u8> buffer;
+
+	u32 state_size = start_state.size();
+	u32 frame_count = frames.size();
+
+	u8 header[28];
+	u8 flags = (state_size) ? MOVIE_FROM_STATE : 0;
+
+	memcpy(&header[0], &MOVIE_MAGIC, 4);
+	header[4] = MOVIE_VERSION;
+	header[5] = config::gb_type;
+	header[6] = flags;
+	header[7] = 0;
+	memcpy(&header[8], &rom_crc, 4);
+	memcpy(&header[12], &rtc_seed, 8);
+	memcpy(&header[20], &frame_count, 4);
+	memcpy(&header[24], &state_size, 4);
+
+	buffer.insert(buffer.end(), header, (header + 28));
+	buffer.insert(buffer.end(), start_state.begin(), start_state.end());
+
+	//Store frames as runs of identical input, most frames repeat the last one
+	for(u32 x = 0; x < frame_count;)
+	{
+		u32 run = 1;
+		while(((x + run) < frame_count) && (run < MOVIE_MAX_RUN) && (memcmp(&frames[x], &frames[x + run], sizeof(movie_input)) == 0)) { run++; }
+
+		u8* run_data = (u8*)&run;
+		u8* frame_data = (u8*)&frames[x];
+
+		buffer.insert(buffer.end(), run_data, (run_data + 4));
+		buffer.insert(buffer.end(), frame_data, (frame_data + sizeof(movie_input)));
+
+		x += run;
+	}
+
+	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+
+	if(!file.is_open())
+	{
+		std::cout<<"MOVIE::Error - Could not write movie " << filename << "\n";
+		return false;
+	}
+
+	file.write((char*)buffer.data(), buffer.size());
+	file.close();
+
+	std::cout<<"MOVIE::Saved " << filename << " (" << std::dec << frame_count << " frames)\n";
+	return true;
+}
+
+/****** Reads the movie file ******/
+bool input_movie::load_file()
+{
+	std::vector<u8> buffer;
+
+	std::ifstream file(filename.c_str(), std::ios::binary);
+
+	if(!file.is_open())
+	{
+		std::cout<<"MOVIE::Error - Could not read movie " << filename << "\n";
+		return false;
+	}
+
+	//Get the file size
+	file.seekg(0, file.end);
+	u32 file_size = file.tellg();
+	file.seekg(0, file.beg);
+
+	buffer.resize(file_size);
+	file.read((char*)buffer.data(), file_size);
+	file.close();
+
+	u32 magic = 0;
+	u32 movie_crc = 0;
+	u32 frame_count = 0;
+	u32 state_size = 0;
+
+	if(file_size >= 28)
+	{
+		memcpy(&magic, &buffer[0], 4);
+		memcpy(&movie_crc, &buffer[8], 4);
+		memcpy(&rtc_seed, &buffer[12], 8);
+		memcpy(&frame_count, &buffer[20], 4);
+		memcpy(&state_size, &buffer[24], 4);
+	}
+
+	if((magic != MOVIE_MAGIC) || (buffer[4] != MOVIE_VERSION) || (state_size > (file_size - 28)))
+	{
+		std::cout<<"MOVIE::Error - " << filename << " is not a valid movie file\n";
+		return false;
+	}
+
+	if(buffer[5] != config::gb_type)
+	{
+		std::cout<<"MOVIE::Error - Movie was recorded on a different system\n";
+		return false;
+	}
+
+	//Different ROMs can still be played (e.g. a patched version of the same game), but will likely desync
+	if(movie_crc != rom_crc) { std::cout<<"MOVIE::Warning - Movie was recorded with a different ROM\n"; }
+
+	u32 offset = 28;
+
+	start_state.assign((buffer.begin() + offset), (buffer.begin() + offset + state_size));
+	offset += state_size;
+
+	//Each record expands to at most MOVIE_MAX_RUN frames, so the header can't claim more than that
+	u64 record_count = (file_size - offset) / (4 + sizeof(movie_input));
+
+	if(frame_count > (record_count * MOVIE_MAX_RUN))
+	{
+		std::cout<<"MOVIE::Error - " << filename << " is corrupted\n";
+		return false;
+	}
+
+	frames.clear();
+	frames.reserve(frame_count);
+
+	while((offset + 4 + sizeof(movie_input)) <= file_size)
+	{
+		u32 run = 0;
+		movie_input input;
+
+		memcpy(&run, &buffer[offset], 4);
+		memcpy(&input, &buffer[offset + 4], sizeof(movie_input));
+		offset += (4 + sizeof(movie_input));
+
+		if((run == 0) || (run > MOVIE_MAX_RUN) || ((frames.size() + run) > frame_count))
+		{
+			std::cout<<"MOVIE::Error - " << filename << " is corrupted\n";
+			return false;
+		}
+
+		frames.insert(frames.end(), run, input);
+	}
+
+	if(frames.size() != frame_count)
+	{
+		std::cout<<"MOVIE::Error - " << filename << " is truncated\n";
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,75 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : input_movie.h
+// Date : October 17, 2026
+// Description : Input movies
+//
+// Records per-frame input state to a compact movie file, or plays one back frame-exactly
+// Movies start from power-on or from an embedded save state
+
+#ifndef GBE_INPUT_MOVIE
+#define GBE_INPUT_MOVIE
+
+#include <string>
+#include <vector>
+
+#include "core_emu.h"
+
+//Key bits from here up are one-shot events (e.g. the Pokemon Mini's shock sensor) rather than held buttons
+const u32 MOVIE_EVENT_MASK = 0xFF000000;
+
+//Input state for one frame, the same layout for every core
+struct movie_input
+{
+	u32 keys;
+	u16 touch_x;
+	u16 touch_y;
+	u16 sensor_x;
+	u16 sensor_y;
+	u16 gyro_value;
+	u8 gyro_flags;
+	u8 solar_value;
+};
+
+class input_movie
+{
+	public:
+
+	input_movie();
+	~input_movie();
+
+	void reset();
+	void update(core_emu* core, u32 frame);
+	void stop();
+
+	void begin_live_input(core_emu* core);
+	void end_live_input(core_emu* core);
+
+	bool active;
+	bool recording;
+	bool playing;
+	u32 last_frame;
+
+	private:
+
+	bool begin(core_emu* core);
+	bool save_file();
+	bool load_file();
+
+	std::string filename;
+	std::vector<movie_input> frames;
+	std::vector<u8> start_state;
+
+	//Input applied to the core this frame, and live input held back until the next frame when recording
+	movie_input current;
+	movie_input pending;
+
+	u32 frame_index;
+	u32 rom_crc;
+	u64 rtc_seed;
+	bool started;
+};
+
+#endif // GBE_INPUT_MOVIE
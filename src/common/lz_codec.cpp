@@ -0,0 +1,210 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : lz_codec.cpp
+// Date : October 17, 2026
+// Description : LZ compression
+//
+// Fast byte-oriented LZ77 compression using the LZ4 block layout
+// Each sequence is a token (literal length, match length), literals, then a 16-bit match offset
+// Matches are found through a single hash table of 4-byte sequences, no entropy coding is done
+
+#include <cstring>
+
+#include "lz_codec.h"
+
+//Matches are at least 4 bytes long
+const u32 LZ_MIN_MATCH = 4;
+
+//The last 5 bytes are always literals, and no match starts within the last 12 bytes
+const u32 LZ_LAST_LITERALS = 5;
+const u32 LZ_MATCH_LIMIT = 12;
+
+const u32 LZ_MAX_OFFSET = 0xFFFF;
+const u32 LZ_HASH_BITS = 12;
+
+/****** Reads 4 bytes at any alignment ******/
+static u32 lz_read_u32(const u8* src)
+{
+	u32 result;
+	memcpy(&result, src, 4);
+	return result;
+}
+
+/****** Hashes a 4-byte sequence ******/
+static u32 lz_hash(u32 sequence)
+{
+	return (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+/****** Writes the part of a length that doesn't fit in a token ******/
+static void lz_write_length(std::vector<u8> &dest, u32 length)
+{
+	while(length >= 255)
+	{
+		dest.push_back(255);
+		length -= 255;
+	}
+
+	dest.push_back(length);
+}
+
+/****** Reads the part of a length that doesn't fit in a token, returns false if the data ends first ******/
+static bool lz_read_length(const u8* src, u32 length, u32 &pos, u32 &result)
+{
+	u8 next = 255;
+
+	while(next == 255)
+	{
+		if(pos >= length) { return false; }
+
+		next = src[pos++];
+		result += next;
+	}
+
+	return true;
+}
+
+/****** Writes one sequence of literals followed by a match ******/
+static void lz_write_sequence(std::vector<u8> &dest, const u8* literals, u32 literal_length, u32 offset, u32 match_length)
+{
+	u32 match_code = match_length - LZ_MIN_MATCH;
+	u8 token = ((literal_length < 15) ? literal_length : 15) << 4;
+	token |= (match_code < 15) ? match_code : 15;
+
+	dest.push_back(token);
+	if(literal_length >= 15) { lz_write_length(dest, (literal_length - 15)); }
+
+	dest.insert(dest.end(), literals, (literals + literal_length));
+
+	dest.push_back(offset & 0xFF);
+	dest.push_back(offset >> 8);
+
+	if(match_code >= 15) { lz_write_length(dest, (match_code - 15)); }
+}
+
+/****** Compresses a block of data, returns the compressed size ******/
+u32 lz_compress(const u8* src, u32 length, std::vector<u8> &dest)
+{
+	dest.clear();
+	dest.reserve(length + (length / 255) + 16);
+
+	u32 anchor = 0;
+
+	if(length > LZ_MATCH_LIMIT)
+	{
+		u32 hash_table[1 << LZ_HASH_BITS];
+		memset(hash_table, 0, sizeof(hash_table));
+
+		u32 pos = 0;
+		u32 match_start_limit = length - LZ_MATCH_LIMIT;
+		u32 match_end_limit = length - LZ_LAST_LITERALS;
+
+		//Step further ahead the longer nothing matches, so incompressible data goes by quickly
+		u32 miss_count = 64;
+
+		while(pos < match_start_limit)
+		{
+			u32 sequence = lz_read_u32(src + pos);
+			u32 hash = lz_hash(sequence);
+			u32 candidate = hash_table[hash];
+			hash_table[hash] = pos;
+
+			if((candidate >= pos) || ((pos - candidate) > LZ_MAX_OFFSET) || (lz_read_u32(src + candidate) != sequence))
+			{
+				pos += (miss_count++ >> 6);
+				continue;
+			}
+
+			//Extend the match backwards into pending literals, then forwards
+			while((pos > anchor) && (candidate > 0) && (src[pos - 1] == src[candidate - 1]))
+			{
+				pos--;
+				candidate--;
+			}
+
+			u32 match_end = pos + LZ_MIN_MATCH;
+			u32 ref = candidate + LZ_MIN_MATCH;
+
+			while((match_end < match_end_limit) && (src[match_end] == src[ref]))
+			{
+				match_end++;
+				ref++;
+			}
+
+			lz_write_sequence(dest, (src + anchor), (pos - anchor), (pos - candidate), (match_end - pos));
+
+			pos = match_end;
+			anchor = pos;
+			miss_count = 64;
+
+			//Remember a position inside the match too, helps with short repeating patterns
+			if(pos < match_start_limit) { hash_table[lz_hash(lz_read_u32(src + pos - 2))] = (pos - 2); }
+		}
+	}
+
+	//Finish with the remaining literals
+	u32 literal_length = length - anchor;
+
+	dest.push_back(((literal_length < 15) ? literal_length : 15) << 4);
+	if(literal_length >= 15) { lz_write_length(dest, (literal_length - 15)); }
+
+	dest.insert(dest.end(), (src + anchor), (src + length));
+
+	return dest.size();
+}
+
+/****** Decompresses a block of data, returns false unless it decompresses to exactly dest_length bytes ******/
+bool lz_decompress(const u8* src, u32 length, u8* dest, u32 dest_length)
+{
+	u32 in = 0;
+	u32 out = 0;
+
+	while(in < length)
+	{
+		u8 token = src[in++];
+
+		//Copy literals
+		u32 literal_length = (token >> 4);
+		if((literal_length == 15) && (!lz_read_length(src, length, in, literal_length))) { return false; }
+
+		if((literal_length > (length - in)) || (literal_length > (dest_length - out))) { return false; }
+
+		memcpy((dest + out), (src + in), literal_length);
+		in += literal_length;
+		out += literal_length;
+
+		//The last sequence has no match
+		if(in == length) { break; }
+
+		if((in + 2) > length) { return false; }
+
+		u32 offset = src[in] | (src[in + 1] << 8);
+		in += 2;
+
+		u32 match_length = (token & 0xF);
+		if((match_length == 15) && (!lz_read_length(src, length, in, match_length))) { return false; }
+
+		match_length += LZ_MIN_MATCH;
+
+		if((offset == 0) || (offset > out) || (match_length > (dest_length - out))) { return false; }
+
+		//Copy the match, overlapping matches repeat their first offset bytes, so copy those in doubling chunks
+		u8* match_dest = dest + out;
+		u32 copied = (offset < match_length) ? offset : match_length;
+
+		memcpy(match_dest, (match_dest - offset), copied);
+
+		while(copied < match_length)
+		{
+			u32 chunk = ((match_length - copied) < copied) ? (match_length - copied) : copied;
+			memcpy((match_dest + copied), match_dest, chunk);
+			copied += chunk;
+		}
+
+		out += match_length;
+	}
+
+	return (out == dest_length);
+}
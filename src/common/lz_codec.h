@@ -0,0 +1,22 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : lz_codec.h
+// Date : October 17, 2026
+// Description : LZ compression
+//
+// Fast byte-oriented LZ77 compression using the LZ4 block layout
+// Meant for data that is mostly runs and repeats, such as save states
+
+#ifndef GBE_LZ_CODEC
+#define GBE_LZ_CODEC
+
+#include <vector>
+
+#include "common.h"
+
+u32 lz_compress(const u8* src, u32 length, std::vector<u8> &dest);
+bool lz_decompress(const u8* src, u32 length, u8* dest, u32 dest_length);
+
+#endif // GBE_LZ_CODEC
@@ -14,6 +14,9 @@
 
 #include "config.h"
 
+//Set once loading the OSD font has been tried, so a missing font file isn't reopened every frame
+static GBE_THREAD_LOCAL bool osd_font_attempted = false;
+
 /****** Loads a font into a buffer to be drawn by a core for OSD ******/
 bool load_osd_font()
 {
@@ -64,12 +67,24 @@ bool load_osd_font()
 	return true;
 } 
 
+/****** Loads the OSD font the first time a message is drawn, returns true if the font is available ******/
+static bool get_osd_font()
+{
+	if(!osd_font_attempted)
+	{
+		osd_font_attempted = true;
+		if(config::osd_font.empty()) { load_osd_font(); }
+	}
+
+	return !config::osd_font.empty();
+}
+
 /****** Draws an OSD message onto a given buffer ******/
 void draw_osd_msg(std::string osd_text, std::vector <u32> &osd_surface, u8 x_offset, u8 y_offset)
 {
 	//Abort OSD drawing if 1) OSD disabled, 2) message size is zero, 3) given buffer is less than 20 8x8 tiles, 4) X offset is >= 20
 	if(!config::use_osd) { return; }
-	if(config::osd_font.empty()) { return; }
+	if(!get_osd_font()) { return; }
 	if(osd_text.size() == 0) { return; }
 	if(osd_surface.size() < 1280) { return; }
 	if(x_offset > ((config::sys_width / 8) - 1)) { return; }
@@ -155,7 +170,7 @@ void draw_osd_msg(std::string osd_text, u32* osd_surface, u8 x_offset, u8 y_offs
 {
 	//Abort OSD drawing if 1) OSD disabled, 2) message size is zero, 3) given buffer is less than 20 8x8 tiles, 4) X offset is >= 20
 	if(!config::use_osd) { return; }
-	if(config::osd_font.empty()) { return; }
+	if(!get_osd_font()) { return; }
 	if(osd_text.size() == 0) { return; }
 	if(osd_surface_size < 1280) { return; }
 	if(x_offset > ((config::sys_width / 8) - 1)) { return; }
@@ -241,7 +256,7 @@ void draw_osd_msg(std::string osd_text, std::vector <u32> &osd_surface, u8 x_off
 {
 	//Abort OSD drawing if 1) OSD disabled, 2) message size is zero, 3) given buffer is less than 20 8x8 tiles, 4) X offset is >= 20
 	if(!config::use_osd) { return; }
-	if(config::osd_font.empty()) { return; }
+	if(!get_osd_font()) { return; }
 	if(osd_text.size() == 0) { return; }
 	if(osd_surface.size() < 1280) { return; }
 	if(x_offset > ((width / 8) - 1)) { return; }
@@ -0,0 +1,270 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : profiler.cpp
+// Date : October 17, 2026
+// Description : Per-frame subsystem profiler
+//
+// Attributes host time and emulated cycles to major subsystems (CPU, LCD, APU, DMA, etc) every frame
+// Entering or leaving a subsystem only marks which one is active, no clocks are read on the hot path
+// A sampling thread checks the mark at a fixed interval, each frame's host time is split by how often each subsystem was seen
+// Results can be queried, drawn via the OSD, or dumped to a CSV file
+
+#include <atomic>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+
+#include "profiler.h"
+#include "config.h"
+#include "util.h"
+
+namespace profiler
+{
+
+//Maximum depth of nested subsystems (e.g. LCD stepped during a CPU memory access)
+const u32 MAX_DEPTH = 16;
+
+//Time between samples (nanoseconds), gives a few hundred samples per frame
+const u64 SAMPLE_PERIOD = 50000;
+
+//Active subsystem and sample counts, shared with the sampling thread
+struct sampler_data
+{
+	std::atomic<u8> current;
+	std::atomic<u32> samples[PROF_TOTAL];
+	std::atomic<bool> quit;
+	std::thread worker;
+
+	/****** Sampler Destructor - Stops the sampling thread ******/
+	~sampler_data()
+	{
+		if(!worker.joinable()) { return; }
+
+		quit = true;
+		worker.join();
+	}
+};
+
+GBE_THREAD_LOCAL subsystems current_id = PROF_IDLE;
+GBE_THREAD_LOCAL subsystems id_stack[MAX_DEPTH];
+GBE_THREAD_LOCAL u32 depth = 0;
+
+GBE_THREAD_LOCAL u64 frame_start = 0;
+
+GBE_THREAD_LOCAL frame_data current_frame;
+GBE_THREAD_LOCAL frame_data last_frame;
+
+GBE_THREAD_LOCAL sampler_data sampler;
+
+GBE_THREAD_LOCAL std::ofstream csv_file;
+GBE_THREAD_LOCAL bool csv_failed = false;
+
+std::string names[PROF_TOTAL] = { "IDLE", "CPU", "LCD", "APU", "DMA", "TMR", "SIO" };
+
+/****** Returns a monotonic timestamp in nanoseconds ******/
+u64 get_timestamp()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/****** Sampling thread - Counts which subsystem is active at regular intervals ******/
+void sample_thread(sampler_data* data)
+{
+	while(!data->quit.load(std::memory_order_relaxed))
+	{
+		std::this_thread::sleep_for(std::chrono::nanoseconds(SAMPLE_PERIOD));
+
+		u8 id = data->current.load(std::memory_order_relaxed);
+		data->samples[id].fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+/****** Starts the sampling thread if it is not running yet ******/
+void start_sampler()
+{
+	if(sampler.worker.joinable()) { return; }
+
+	sampler.current = current_id;
+	sampler.quit = false;
+	for(u32 x = 0; x < PROF_TOTAL; x++) { sampler.samples[x] = 0; }
+
+	sampler.worker = std::thread(sample_thread, &sampler);
+}
+
+/****** Clears all counters ******/
+void reset()
+{
+	current_id = PROF_IDLE;
+	depth = 0;
+
+	sampler.current.store(current_id, std::memory_order_relaxed);
+	for(u32 x = 0; x < PROF_TOTAL; x++) { sampler.samples[x] = 0; }
+
+	frame_start = get_timestamp();
+
+	for(u32 x = 0; x < PROF_TOTAL; x++)
+	{
+		current_frame.host_ns[x] = 0;
+		current_frame.cycles[x] = 0;
+		last_frame.host_ns[x] = 0;
+		last_frame.cycles[x] = 0;
+	}
+
+	current_frame.frame_number = 0;
+	current_frame.frame_ns = 0;
+	last_frame.frame_number = 0;
+	last_frame.frame_ns = 0;
+}
+
+/****** Starts attributing time to a subsystem ******/
+void enter(subsystems id)
+{
+	if(depth < MAX_DEPTH) { id_stack[depth] = current_id; }
+	depth++;
+
+	current_id = id;
+	sampler.current.store(id, std::memory_order_relaxed);
+}
+
+/****** Stops attributing time to a subsystem, resumes the previous one ******/
+void leave()
+{
+	if(depth == 0) { return; }
+
+	depth--;
+	current_id = (depth < MAX_DEPTH) ? id_stack[depth] : PROF_IDLE;
+	sampler.current.store(current_id, std::memory_order_relaxed);
+}
+
+/****** Adds emulated cycles to a subsystem ******/
+void add_cycles(subsystems id, u32 cycles) { current_frame.cycles[id] += cycles; }
+
+/****** Closes out the current frame's counters ******/
+void end_frame()
+{
+	u64 now = get_timestamp();
+
+	//Sampling starts with the first frame
+	if(frame_start == 0) { frame_start = now; }
+	start_sampler();
+
+	current_frame.frame_ns = now - frame_start;
+	frame_start = now;
+
+	//Split the frame's time by how often each subsystem was sampled
+	u32 counts[PROF_TOTAL];
+	u64 total = 0;
+
+	for(u32 x = 0; x < PROF_TOTAL; x++)
+	{
+		counts[x] = sampler.samples[x].exchange(0, std::memory_order_relaxed);
+		total += counts[x];
+	}
+
+	for(u32 x = 0; x < PROF_TOTAL; x++)
+	{
+		current_frame.host_ns[x] = (total) ? ((current_frame.frame_ns * counts[x]) / total) : 0;
+	}
+
+	last_frame = current_frame;
+
+	//Open CSV file on first frame if requested
+	if((!config::profiler_csv_file.empty()) && (!csv_file.is_open()) && (!csv_failed))
+	{
+		csv_failed = !start_csv(config::profiler_csv_file);
+	}
+
+	if(csv_file.is_open())
+	{
+		csv_file << last_frame.frame_number << "," << last_frame.frame_ns;
+		for(u32 x = 0; x < PROF_TOTAL; x++) { csv_file << "," << last_frame.host_ns[x]; }
+		for(u32 x = 0; x < PROF_TOTAL; x++) { csv_file << "," << last_frame.cycles[x]; }
+		csv_file << "\n";
+	}
+
+	current_frame.frame_number++;
+	current_frame.frame_ns = 0;
+
+	for(u32 x = 0; x < PROF_TOTAL; x++)
+	{
+		current_frame.host_ns[x] = 0;
+		current_frame.cycles[x] = 0;
+	}
+}
+
+/****** Returns counters for the last completed frame ******/
+frame_data get_last_frame() { return last_frame; }
+
+/****** Returns host time spent in a subsystem during the last frame ******/
+u64 get_host_ns(u8 id)
+{
+	if(id >= PROF_TOTAL) { return 0; }
+	return last_frame.host_ns[id];
+}
+
+/****** Returns emulated cycles run by a subsystem during the last frame ******/
+u64 get_cycles(u8 id)
+{
+	if(id >= PROF_TOTAL) { return 0; }
+	return last_frame.cycles[id];
+}
+
+/****** Returns a short name for a subsystem ******/
+std::string get_name(u8 id)
+{
+	if(id >= PROF_TOTAL) { return ""; }
+	return names[id];
+}
+
+/****** Begins dumping per-frame counters to a CSV file ******/
+bool start_csv(std::string filename)
+{
+	if(csv_file.is_open()) { csv_file.close(); }
+
+	csv_file.open(filename.c_str(), std::ios::out | std::ios::trunc);
+
+	if(!csv_file.is_open())
+	{
+		std::cout<<"GBE::Error - Could not open profiler CSV file " << filename << "\n";
+		return false;
+	}
+
+	csv_file << "frame,frame_ns";
+	for(u32 x = 0; x < PROF_TOTAL; x++) { csv_file << "," << names[x] << "_ns"; }
+	for(u32 x = 0; x < PROF_TOTAL; x++) { csv_file << "," << names[x] << "_cycles"; }
+	csv_file << "\n";
+
+	std::cout<<"GBE::Writing profiler data to " << filename << "\n";
+	return true;
+}
+
+/****** Stops dumping counters to a CSV file ******/
+void stop_csv()
+{
+	if(csv_file.is_open()) { csv_file.close(); }
+}
+
+/****** Draws last frame's counters (microseconds) via the OSD ******/
+void draw_osd(std::vector <u32> &osd_surface)
+{
+	if(!config::profiler_osd) { return; }
+
+	//Two subsystems per line to stay within the OSD's 20 character limit
+	for(u32 x = 1, y = 0; x < PROF_TOTAL; x += 2, y++)
+	{
+		std::string line = names[x] + " " + util::to_str(last_frame.host_ns[x] / 1000);
+
+		if((x + 1) < PROF_TOTAL)
+		{
+			while(line.size() < 10) { line += " "; }
+			line += names[x + 1] + " " + util::to_str(last_frame.host_ns[x + 1] / 1000);
+		}
+
+		draw_osd_msg(line, osd_surface, 0, (y + 1));
+	}
+}
+
+}
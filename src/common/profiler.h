@@ -0,0 +1,90 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : profiler.h
+// Date : October 17, 2026
+// Description : Per-frame subsystem profiler
+//
+// Attributes host time and emulated cycles to major subsystems (CPU, LCD, APU, DMA, etc) every frame
+// Emulated cycles are counted exactly, host time is statistical
+//
+// Host time is sampled, not timed per transition
+// Entering or leaving a subsystem is a relaxed atomic store of the innermost active ID, no clock is read
+// A sampling thread wakes every 50us and counts which ID it sees, each frame's wall time is split by those counts
+// Attribution is exclusive: only the innermost subsystem is credited while nested subsystems run
+//
+// Resolution - Sleeps are stretched by the OS timer, on Linux the real period is closer to 100us
+// That leaves roughly 150-330 samples per 60Hz frame, so shares are only good to 50-100us (about 0.5% of a frame)
+// Subsystems that run for less than that per frame may read as 0 or jump around between frames
+//
+// Cost - One extra host thread per emulation thread that reaches end_frame(), started on the first frame
+// It sleeps between samples but still wakes around 10000-20000 times a second, roughly 5-10% of one host core
+// Hooks in the cores only compile when GBE_PROFILER is defined, otherwise they cost nothing and no thread runs
+
+#ifndef GBE_PROFILER_H
+#define GBE_PROFILER_H
+
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+namespace profiler
+{
+	enum subsystems
+	{
+		PROF_IDLE,
+		PROF_CPU,
+		PROF_LCD,
+		PROF_APU,
+		PROF_DMA,
+		PROF_TIMERS,
+		PROF_SIO,
+		PROF_TOTAL
+	};
+
+	struct frame_data
+	{
+		u64 frame_number;
+		u64 frame_ns;
+		u64 host_ns[PROF_TOTAL];
+		u64 cycles[PROF_TOTAL];
+	};
+
+	void reset();
+	void enter(subsystems id);
+	void leave();
+	void add_cycles(subsystems id, u32 cycles);
+	void end_frame();
+
+	frame_data get_last_frame();
+	u64 get_host_ns(u8 id);
+	u64 get_cycles(u8 id);
+	std::string get_name(u8 id);
+
+	bool start_csv(std::string filename);
+	void stop_csv();
+
+	void draw_osd(std::vector <u32> &osd_surface);
+}
+
+#ifdef GBE_PROFILER
+
+#define PROFILER_ENTER(id) profiler::enter(profiler::id)
+#define PROFILER_LEAVE() profiler::leave()
+#define PROFILER_CYCLES(id, cycles) profiler::add_cycles(profiler::id, cycles)
+#define PROFILER_END_FRAME() profiler::end_frame()
+#define PROFILER_DRAW_OSD(buffer) profiler::draw_osd(buffer)
+
+#else
+
+#define PROFILER_ENTER(id)
+#define PROFILER_LEAVE()
+#define PROFILER_CYCLES(id, cycles)
+#define PROFILER_END_FRAME()
+#define PROFILER_DRAW_OSD(buffer)
+
+#endif // GBE_PROFILER
+
+#endif // GBE_PROFILER_H
@@ -0,0 +1,234 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : rewind.cpp
+// Date : October 17, 2026
+// Description : Rewind buffer
+//
+// Keeps a bounded ring of save states captured every few frames
+// Only the newest state is stored whole, older ones are XOR/RLE deltas against their successor
+// Most of a system's memory changes very little between snapshots, so deltas are usually tiny
+
+#include <cstring>
+
+#include "rewind.h"
+#include "config.h"
+
+/****** Rewind buffer Constructor ******/
+rewind_buffer::rewind_buffer()
+{
+	reset();
+}
+
+/****** Rewind buffer Destructor ******/
+rewind_buffer::~rewind_buffer() { }
+
+/****** Discards all snapshots ******/
+void rewind_buffer::reset()
+{
+	//Release the memory too, the history can run to many megabytes
+	std::deque< std::vector<u8> >().swap(deltas);
+	std::vector<u8>().swap(current_state);
+	std::vector<u8>().swap(next_state);
+
+	delta_size = 0;
+	frame_counter = 0;
+	last_frame = 0;
+	has_state = false;
+	rewinding = false;
+}
+
+/****** Called once per emulated frame - Captures or restores snapshots ******/
+void rewind_buffer::update(core_emu* core, u32 frame)
+{
+	last_frame = frame;
+
+	//Step back one snapshot each frame while rewinding
+	if(rewinding)
+	{
+		rewind(core);
+		return;
+	}
+
+	frame_counter++;
+
+	if(frame_counter >= config::rewind_interval)
+	{
+		frame_counter = 0;
+		capture(core);
+	}
+}
+
+/****** Takes a new snapshot of the core ******/
+bool rewind_buffer::capture(core_emu* core)
+{
+	if(!core->serialize(next_state)) { return false; }
+
+	//Keep the previous snapshot as a delta against the new one
+	if(has_state)
+	{
+		deltas.push_back(std::vector<u8>());
+		encode_delta(current_state, next_state, deltas.back());
+		delta_size += deltas.back().size();
+	}
+
+	current_state.swap(next_state);
+	has_state = true;
+
+	trim(config::rewind_buffer_size * 0x100000);
+	return true;
+}
+
+/****** Restores the newest snapshot, then makes the one before it current ******/
+bool rewind_buffer::rewind(core_emu* core)
+{
+	if(!has_state) { return false; }
+
+	if(!core->deserialize(current_state.data(), current_state.size()))
+	{
+		reset();
+		return false;
+	}
+
+	frame_counter = 0;
+
+	//Stay on the oldest snapshot once history runs out
+	if(deltas.empty()) { return true; }
+
+	apply_delta(current_state, deltas.back());
+	delta_size -= deltas.back().size();
+	deltas.pop_back();
+
+	return true;
+}
+
+/****** Returns the number of snapshots available ******/
+u32 rewind_buffer::get_count()
+{
+	if(!has_state) { return 0; }
+	return deltas.size() + 1;
+}
+
+/****** Returns the number of bytes used by all snapshots ******/
+u32 rewind_buffer::get_size() { return current_state.size() + delta_size; }
+
+/****** Drops the oldest snapshots until the buffer fits within the given size ******/
+void rewind_buffer::trim(u32 max_size)
+{
+	while((!deltas.empty()) && ((current_state.size() + delta_size) > max_size))
+	{
+		delta_size -= deltas.front().size();
+		deltas.pop_front();
+	}
+}
+
+/****** Builds a delta that turns new_state back into old_state ******/
+void rewind_buffer::encode_delta(std::vector<u8> &old_state, std::vector<u8> &new_state, std::vector<u8> &delta)
+{
+	//Delta format
+	//Header - Size of old state (4 bytes)
+	//Records - Bytes to skip (4 bytes), Bytes to XOR (4 bytes), XOR data (N bytes)
+	//States are treated as zero-padded if their sizes differ
+	u32 old_size = old_state.size();
+	u32 new_size = new_state.size();
+	u32 length = (old_size > new_size) ? old_size : new_size;
+	u32 common = (old_size < new_size) ? old_size : new_size;
+
+	const u8* old_data = old_state.data();
+	const u8* new_data = new_state.data();
+
+	delta.clear();
+	delta.insert(delta.end(), (u8*)&old_size, (u8*)&old_size + 4);
+
+	u32 pos = 0;
+
+	while(pos < length)
+	{
+		u32 start = pos;
+
+		//Skip matching data, 64 bytes then 8 bytes at a time when possible
+		while(((pos + 64) <= common) && (memcmp((old_data + pos), (new_data + pos), 64) == 0)) { pos += 64; }
+		while(((pos + 8) <= common) && (memcmp((old_data + pos), (new_data + pos), 8) == 0)) { pos += 8; }
+
+		while(pos < length)
+		{
+			u8 old_byte = (pos < old_size) ? old_data[pos] : 0;
+			u8 new_byte = (pos < new_size) ? new_data[pos] : 0;
+			if(old_byte != new_byte) { break; }
+			pos++;
+		}
+
+		if(pos >= length) { break; }
+
+		u32 skip = pos - start;
+		u32 run_start = pos;
+		u32 same = 0;
+
+		//Find the end of the changed data, folding short matching gaps into one record
+		while(pos < length)
+		{
+			u8 old_byte = (pos < old_size) ? old_data[pos] : 0;
+			u8 new_byte = (pos < new_size) ? new_data[pos] : 0;
+
+			if(old_byte == new_byte)
+			{
+				same++;
+				if(same == 8) { pos -= 7; same = 0; break; }
+			}
+
+			else { same = 0; }
+
+			pos++;
+		}
+
+		pos -= same;
+		u32 run_length = pos - run_start;
+
+		delta.insert(delta.end(), (u8*)&skip, (u8*)&skip + 4);
+		delta.insert(delta.end(), (u8*)&run_length, (u8*)&run_length + 4);
+
+		for(u32 x = run_start; x < pos; x++)
+		{
+			u8 old_byte = (x < old_size) ? old_data[x] : 0;
+			u8 new_byte = (x < new_size) ? new_data[x] : 0;
+			delta.push_back(old_byte ^ new_byte);
+		}
+	}
+}
+
+/****** Applies a delta to a state, producing the state it was built from ******/
+void rewind_buffer::apply_delta(std::vector<u8> &state, std::vector<u8> &delta)
+{
+	if(delta.size() < 4) { return; }
+
+	u32 old_size = 0;
+	memcpy(&old_size, delta.data(), 4);
+
+	if(old_size > state.size()) { state.resize(old_size, 0); }
+
+	u32 offset = 4;
+	u32 pos = 0;
+
+	while((offset + 8) <= delta.size())
+	{
+		u32 skip = 0;
+		u32 run_length = 0;
+
+		memcpy(&skip, (delta.data() + offset), 4);
+		memcpy(&run_length, (delta.data() + offset + 4), 4);
+		offset += 8;
+
+		pos += skip;
+
+		//Stop on malformed records
+		if(((offset + run_length) > delta.size()) || ((pos + run_length) > state.size())) { break; }
+
+		for(u32 x = 0; x < run_length; x++) { state[pos + x] ^= delta[offset + x]; }
+
+		pos += run_length;
+		offset += run_length;
+	}
+
+	state.resize(old_size);
+}
@@ -0,0 +1,54 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : rewind.h
+// Date : October 17, 2026
+// Description : Rewind buffer
+//
+// Keeps a bounded ring of save states captured every few frames
+// Only the newest state is stored whole, older ones are XOR/RLE deltas against their successor
+
+#ifndef GBE_REWIND
+#define GBE_REWIND
+
+#include <vector>
+#include <deque>
+
+#include "core_emu.h"
+
+class rewind_buffer
+{
+	public:
+
+	rewind_buffer();
+	~rewind_buffer();
+
+	void reset();
+	void update(core_emu* core, u32 frame);
+
+	bool capture(core_emu* core);
+	bool rewind(core_emu* core);
+
+	u32 get_count();
+	u32 get_size();
+
+	bool rewinding;
+	u32 last_frame;
+
+	private:
+
+	void encode_delta(std::vector<u8> &old_state, std::vector<u8> &new_state, std::vector<u8> &delta);
+	void apply_delta(std::vector<u8> &state, std::vector<u8> &delta);
+	void trim(u32 max_size);
+
+	std::deque< std::vector<u8> > deltas;
+	std::vector<u8> current_state;
+	std::vector<u8> next_state;
+
+	u32 delta_size;
+	u32 frame_counter;
+	bool has_state;
+};
+
+#endif // GBE_REWIND
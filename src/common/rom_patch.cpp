@@ -0,0 +1,402 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : rom_patch.cpp
+// Date : October 17, 2026
+// Description : ROM patching
+//
+// Applies IPS and UPS patches to a ROM image and caches the patched result on disk
+// Cached ROMs are keyed by the CRC32 of both the ROM and the patch
+// ROMs and patches are read through memory maps, patches are applied in a single pass over the patch data
+// Only the most recently used patched ROMs are kept in the cache, older ones are deleted as new ones are added
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "rom_patch.h"
+#include "config.h"
+#include "util.h"
+
+/****** Makes sure the ROM buffer covers the given offset, returns false if that would go beyond the max ROM size ******/
+static bool grow_rom(std::vector<u8> &rom_data, u32 offset, u32 max_size)
+{
+	if(offset >= max_size) { return false; }
+	if(offset >= rom_data.size()) { rom_data.resize(offset + 1, 0); }
+	return true;
+}
+
+/****** Reads a UPS variable width integer, returns false if the patch ends first ******/
+static bool read_ups_number(const u8* patch_data, u32 patch_size, u32 &patch_pos, u32 &result)
+{
+	u8 var_shift = 0;
+	result = 0;
+
+	while((patch_pos < patch_size) && (var_shift < 32))
+	{
+		u8 var_byte = patch_data[patch_pos++];
+
+		if(var_byte & 0x80)
+		{
+			result += ((var_byte & 0x7F) << var_shift);
+			return true;
+		}
+
+		result += ((var_byte | 0x80) << var_shift);
+		var_shift += 7;
+	}
+
+	return false;
+}
+
+/****** Applies an IPS patch to a ROM buffer ******/
+bool apply_ips_patch(const u8* patch_data, u32 patch_size, std::vector<u8> &rom_data, u32 max_size)
+{
+	//Check header for PATCH string
+	if((patch_size < 5) || (memcmp(patch_data, "PATCH", 5) != 0))
+	{
+		std::cout<<"PATCH::IPS patch file has invalid header\n";
+		return false;
+	}
+
+	u32 patch_pos = 5;
+
+	while(patch_pos < patch_size)
+	{
+		//Grab a record offset - 3 bytes
+		if((patch_pos + 3) > patch_size)
+		{
+			std::cout<<"PATCH::IPS file ends unexpectedly (OFFSET)\n";
+			return false;
+		}
+
+		u32 offset = (patch_data[patch_pos] << 16) | (patch_data[patch_pos + 1] << 8) | patch_data[patch_pos + 2];
+		patch_pos += 3;
+
+		//Quit if EOF marker is reached
+		if(offset == 0x454F46) { return true; }
+
+		//Grab record size - 2 bytes
+		if((patch_pos + 2) > patch_size)
+		{
+			std::cout<<"PATCH::IPS file ends unexpectedly (DATA_SIZE)\n";
+			return false;
+		}
+
+		u16 data_size = (patch_data[patch_pos] << 8) | patch_data[patch_pos + 1];
+		patch_pos += 2;
+
+		//Perform regular patching if size is non-zero
+		if(data_size)
+		{
+			if((patch_pos + data_size) > patch_size)
+			{
+				std::cout<<"PATCH::IPS file ends unexpectedly (DATA)\n";
+				return false;
+			}
+
+			if(!grow_rom(rom_data, (offset + data_size - 1), max_size))
+			{
+				std::cout<<"PATCH::IPS file patches beyond max ROM size (DATA)\n";
+				return false;
+			}
+
+			memcpy(&rom_data[offset], &patch_data[patch_pos], data_size);
+			patch_pos += data_size;
+		}
+
+		//Patch with RLE
+		else
+		{
+			//Grab Run-length size and value - 3 bytes
+			if((patch_pos + 3) > patch_size)
+			{
+				std::cout<<"PATCH::IPS file ends unexpectedly (RLE)\n";
+				return false;
+			}
+
+			u16 rle_size = (patch_data[patch_pos] << 8) | patch_data[patch_pos + 1];
+			u8 patch_byte = patch_data[patch_pos + 2];
+			patch_pos += 3;
+
+			if(!rle_size) { continue; }
+
+			if(!grow_rom(rom_data, (offset + rle_size - 1), max_size))
+			{
+				std::cout<<"PATCH::IPS file patches beyond max ROM size (RLE DATA)\n";
+				return false;
+			}
+
+			memset(&rom_data[offset], patch_byte, rle_size);
+		}
+	}
+
+	//Some patches leave out the EOF marker, everything was still applied
+	return true;
+}
+
+/****** Applies a UPS patch to a ROM buffer ******/
+bool apply_ups_patch(const u8* patch_data, u32 patch_size, std::vector<u8> &rom_data, u32 max_size)
+{
+	//Check header for UPS1 string, the last 12 bytes are CRC32s for the input, output, and patch
+	if((patch_size < 16) || (memcmp(patch_data, "UPS1", 4) != 0))
+	{
+		std::cout<<"PATCH::UPS patch file has invalid header\n";
+		return false;
+	}
+
+	u32 patch_pos = 4;
+	u32 patch_end = patch_size - 12;
+	u32 input_size = 0;
+	u32 output_size = 0;
+
+	if((!read_ups_number(patch_data, patch_end, patch_pos, input_size)) || (!read_ups_number(patch_data, patch_end, patch_pos, output_size)))
+	{
+		std::cout<<"PATCH::UPS file ends unexpectedly (FILE_SIZE)\n";
+		return false;
+	}
+
+	if(output_size > max_size)
+	{
+		std::cout<<"PATCH::UPS file patches beyond max ROM size\n";
+		return false;
+	}
+
+	if(output_size > rom_data.size()) { rom_data.resize(output_size, 0); }
+
+	u32 file_pos = 0;
+
+	//Begin patching the source file
+	while(patch_pos < patch_end)
+	{
+		u32 skip = 0;
+
+		if(!read_ups_number(patch_data, patch_end, patch_pos, skip))
+		{
+			std::cout<<"PATCH::UPS file ends unexpectedly (OFFSET)\n";
+			return false;
+		}
+
+		file_pos += skip;
+
+		//XOR data at offset with patch until a zero byte ends this chunk
+		while(true)
+		{
+			if(patch_pos >= patch_end)
+			{
+				std::cout<<"PATCH::UPS file ends unexpectedly (DATA)\n";
+				return false;
+			}
+
+			u8 patch_byte = patch_data[patch_pos++];
+
+			if(patch_byte == 0)
+			{
+				file_pos++;
+				break;
+			}
+
+			if(!grow_rom(rom_data, file_pos, max_size))
+			{
+				std::cout<<"PATCH::UPS file patches beyond max ROM size\n";
+				return false;
+			}
+
+			rom_data[file_pos++] ^= patch_byte;
+		}
+	}
+
+	//Output CRC32 is stored little-endian, a mismatch usually means the patch was made for a different ROM
+	u32 output_crc = (patch_data[patch_end + 4] | (patch_data[patch_end + 5] << 8) | (patch_data[patch_end + 6] << 16) | (patch_data[patch_end + 7] << 24));
+	u32 check_size = (output_size) ? output_size : rom_data.size();
+
+	if(util::get_crc32(rom_data.data(), check_size) != output_crc) { std::cout<<"PATCH::Warning - UPS patched ROM does not match the expected CRC32\n"; }
+
+	return true;
+}
+
+/****** Finds the IPS or UPS patch that goes with a ROM, returns false if there is none ******/
+static bool find_patch(std::string rom_file, std::string &patch_file, bool &use_ips)
+{
+	std::size_t dot = rom_file.find_last_of(".");
+	if(dot == std::string::npos) { dot = rom_file.size(); }
+
+	std::string patch_base = rom_file.substr(0, dot);
+
+	//Try an IPS patch first, then UPS
+	patch_file = patch_base + ".ips";
+	use_ips = true;
+
+	if(std::filesystem::exists(std::filesystem::path(patch_file))) { return true; }
+
+	patch_file = patch_base + ".ups";
+	use_ips = false;
+
+	return std::filesystem::exists(std::filesystem::path(patch_file));
+}
+
+/****** Deletes the least recently used patched ROMs once the cache holds too many ******/
+static void prune_patch_cache(std::string cache_folder)
+{
+	std::vector<std::filesystem::directory_entry> entries;
+	std::error_code error;
+
+	for(const auto &entry : std::filesystem::directory_iterator(std::filesystem::path(cache_folder), error))
+	{
+		if((entry.is_regular_file(error)) && (entry.path().extension() == ".bin")) { entries.push_back(entry); }
+	}
+
+	if(entries.size() <= PATCH_CACHE_LIMIT) { return; }
+
+	//Newest first, cache hits refresh the write time so this keeps the most recently used ROMs
+	std::sort(entries.begin(), entries.end(), [&error](const std::filesystem::directory_entry &a, const std::filesystem::directory_entry &b)
+	{
+		return a.last_write_time(error) > b.last_write_time(error);
+	});
+
+	for(u32 x = PATCH_CACHE_LIMIT; x < entries.size(); x++) { std::filesystem::remove(entries[x].path(), error); }
+}
+
+/****** Finds the patch for a ROM and points rom_source at a cached, patched copy of it ******/
+bool get_patched_rom(std::string rom_file, std::string &rom_source, u32 max_size)
+{
+	//Returns false only when the patched ROM could not be cached and patches must be applied in memory instead
+	rom_source = rom_file;
+
+	std::string patch_file = "";
+	bool use_ips = true;
+
+	if(!find_patch(rom_file, patch_file, use_ips)) { return true; }
+
+	//Resets reuse the cache entry found earlier in the session as long as neither file changed, skipping the CRCs
+	static GBE_THREAD_LOCAL patch_session last_patch;
+	std::error_code error;
+
+	patch_session current;
+	current.rom_file = rom_file;
+	current.patch_file = patch_file;
+	current.rom_time = std::filesystem::last_write_time(std::filesystem::path(rom_file), error);
+	current.patch_time = std::filesystem::last_write_time(std::filesystem::path(patch_file), error);
+	current.cache_file = "";
+
+	if((!error) && (!last_patch.cache_file.empty()) && (current.rom_file == last_patch.rom_file) && (current.patch_file == last_patch.patch_file)
+	&& (current.rom_time == last_patch.rom_time) && (current.patch_time == last_patch.patch_time)
+	&& (std::filesystem::exists(std::filesystem::path(last_patch.cache_file), error)))
+	{
+		rom_source = last_patch.cache_file;
+		return true;
+	}
+
+	util::mapped_file rom;
+	util::mapped_file patch;
+
+	if((!rom.open(rom_file)) || (!patch.open(patch_file)) || (rom.size > max_size) || (patch.size > 0xFFFFFFFF))
+	{
+		return false;
+	}
+
+	u32 rom_crc = util::update_crc32(0, rom.data, rom.size);
+	u32 patch_crc = util::update_crc32(0, patch.data, patch.size);
+
+	std::string cache_folder = config::data_path + "patch_cache/";
+	std::string cache_file = cache_folder + util::to_hex_str(rom_crc).substr(2) + "_" + util::to_hex_str(patch_crc).substr(2) + ".bin";
+
+	//Patched on an earlier run
+	if(std::filesystem::exists(std::filesystem::path(cache_file)))
+	{
+		rom_source = cache_file;
+		std::cout<<"PATCH::Using cached patched ROM " << cache_file << "\n";
+
+		//Mark the entry as recently used so pruning keeps it
+		std::filesystem::last_write_time(std::filesystem::path(cache_file), std::filesystem::file_time_type::clock::now(), error);
+
+		current.cache_file = cache_file;
+		last_patch = current;
+		return true;
+	}
+
+	std::vector<u8> rom_data(rom.data, (rom.data + rom.size));
+	rom.close();
+
+	bool result = (use_ips) ? apply_ips_patch(patch.data, patch.size, rom_data, max_size) : apply_ups_patch(patch.data, patch.size, rom_data, max_size);
+
+	//Bad patches are reported and skipped, there's no point retrying them in memory
+	if(!result)
+	{
+		std::cout<<"PATCH::" << patch_file << " could not be applied. Aborting further patching.\n";
+		return true;
+	}
+
+	std::cout<<"PATCH::Applied " << patch_file << "\n";
+
+	//Write to a temporary file first so an interrupted write never leaves a bad cache entry behind
+	std::filesystem::create_directories(std::filesystem::path(cache_folder), error);
+
+	std::string temp_file = cache_file + ".tmp";
+	std::ofstream file(temp_file.c_str(), std::ios::binary | std::ios::trunc);
+
+	if(!file.is_open())
+	{
+		std::cout<<"PATCH::Could not write patched ROM to the cache at " << cache_folder << "\n";
+		return false;
+	}
+
+	file.write((char*)rom_data.data(), rom_data.size());
+	file.close();
+
+	if(!file)
+	{
+		std::cout<<"PATCH::Could not write patched ROM to the cache at " << cache_folder << "\n";
+		std::filesystem::remove(std::filesystem::path(temp_file), error);
+		return false;
+	}
+
+	std::filesystem::rename(std::filesystem::path(temp_file), std::filesystem::path(cache_file), error);
+
+	if(error)
+	{
+		std::filesystem::remove(std::filesystem::path(temp_file), error);
+		return false;
+	}
+
+	prune_patch_cache(cache_folder);
+
+	rom_source = cache_file;
+	current.cache_file = cache_file;
+	last_patch = current;
+	return true;
+}
+
+/****** Applies the patch for a ROM to ROM data already in memory, used when the patched ROM can't be cached ******/
+bool patch_rom_data(std::string rom_file, std::vector<u8> &rom_data, u32 max_size)
+{
+	std::string patch_file = "";
+	bool use_ips = true;
+
+	if(!find_patch(rom_file, patch_file, use_ips)) { return false; }
+
+	util::mapped_file patch;
+
+	if((!patch.open(patch_file)) || (patch.size > 0xFFFFFFFF))
+	{
+		std::cout<<"PATCH::" << patch_file << " could not be opened. Check file path or permissions.\n";
+		return false;
+	}
+
+	//Patch a copy so a bad patch never leaves the ROM half-patched
+	std::vector<u8> patched_data(rom_data);
+	bool result = (use_ips) ? apply_ips_patch(patch.data, patch.size, patched_data, max_size) : apply_ups_patch(patch.data, patch.size, patched_data, max_size);
+
+	if(!result)
+	{
+		std::cout<<"PATCH::" << patch_file << " could not be applied. Aborting further patching.\n";
+		return false;
+	}
+
+	std::cout<<"PATCH::Applied " << patch_file << "\n";
+	rom_data.swap(patched_data);
+	return true;
+}
@@ -0,0 +1,41 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : rom_patch.h
+// Date : October 17, 2026
+// Description : ROM patching
+//
+// Applies IPS and UPS patches to a ROM image and caches the patched result on disk
+// Cached ROMs are keyed by the CRC32 of both the ROM and the patch
+// Only the most recently used PATCH_CACHE_LIMIT patched ROMs are kept
+
+#ifndef GBE_ROM_PATCH
+#define GBE_ROM_PATCH
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+//Number of patched ROMs kept in data/patch_cache
+#define PATCH_CACHE_LIMIT 8
+
+//Patch cache entry found during this session
+struct patch_session
+{
+	std::string rom_file;
+	std::string patch_file;
+	std::filesystem::file_time_type rom_time;
+	std::filesystem::file_time_type patch_time;
+	std::string cache_file;
+};
+
+bool get_patched_rom(std::string rom_file, std::string &rom_source, u32 max_size);
+bool patch_rom_data(std::string rom_file, std::vector<u8> &rom_data, u32 max_size);
+
+bool apply_ips_patch(const u8* patch_data, u32 patch_size, std::vector<u8> &rom_data, u32 max_size);
+bool apply_ups_patch(const u8* patch_data, u32 patch_size, std::vector<u8> &rom_data, u32 max_size);
+
+#endif // GBE_ROM_PATCH
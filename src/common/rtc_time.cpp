@@ -0,0 +1,267 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : rtc_time.cpp
+// Date : October 17, 2026
+// Description : Real-Time Clock time keeping
+//
+// Calendar arithmetic shared by emulated RTCs (MBC3, TAMA5, GBA and NDS)
+// Dates are converted to and from a day count, so offsets carry correctly into days, months, and years
+// Second counters (MBC3) are advanced with division rather than one second at a time
+
+#include <ctime>
+
+#include "rtc_time.h"
+#include "config.h"
+
+/****** Rounds a division down, even for negative numbers ******/
+static s64 floor_div(s64 value, s64 divisor)
+{
+	s64 result = value / divisor;
+	if(((value % divisor) != 0) && ((value < 0) != (divisor < 0))) { result--; }
+	return result;
+}
+
+/****** Converts a proleptic Gregorian date to days since January 1, 1970 ******/
+s64 days_from_civil(s64 year, u32 month, u32 day)
+{
+	//Count years from March, so leap days fall at the very end of a year
+	if(month <= 2) { year--; }
+
+	s64 era = floor_div(year, 400);
+	s64 year_of_era = year - (era * 400);
+	s64 day_of_year = (((153 * ((month > 2) ? (month - 3) : (month + 9))) + 2) / 5) + day - 1;
+	s64 day_of_era = (year_of_era * 365) + (year_of_era / 4) - (year_of_era / 100) + day_of_year;
+
+	return (era * 146097) + day_of_era - 719468;
+}
+
+/****** Converts days since January 1, 1970 to a proleptic Gregorian date ******/
+void civil_from_days(s64 days, s64 &year, u32 &month, u32 &day)
+{
+	days += 719468;
+
+	s64 era = floor_div(days, 146097);
+	s64 day_of_era = days - (era * 146097);
+	s64 year_of_era = (day_of_era - (day_of_era / 1460) + (day_of_era / 36524) - (day_of_era / 146096)) / 365;
+	s64 day_of_year = day_of_era - ((365 * year_of_era) + (year_of_era / 4) - (year_of_era / 100));
+	s64 march_month = ((5 * day_of_year) + 2) / 153;
+
+	day = day_of_year - (((153 * march_month) + 2) / 5) + 1;
+	month = (march_month < 10) ? (march_month + 3) : (march_month - 9);
+	year = year_of_era + (era * 400) + ((month <= 2) ? 1 : 0);
+}
+
+/****** Returns the number of days in a given month ******/
+u32 days_in_month(s64 year, u32 month)
+{
+	if(month == 2)
+	{
+		bool leap_year = ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+		return (leap_year) ? 29 : 28;
+	}
+
+	return ((month == 4) || (month == 6) || (month == 9) || (month == 11)) ? 30 : 31;
+}
+
+/****** Grabs local time with all RTC offsets applied ******/
+rtc_date get_rtc_date()
+{
+	//Grab local time
+	time_t system_time = (config::fixed_rtc_time) ? config::fixed_rtc_time : time(0);
+	tm* current_time = localtime(&system_time);
+
+	//Disregard tm_sec's 60 or 61 seconds
+	s64 second = (current_time->tm_sec > 59) ? 59 : current_time->tm_sec;
+
+	//Add second, minute, hour, and day offsets as a plain number of seconds so everything carries over
+	s64 local_time = days_from_civil((current_time->tm_year + 1900), (current_time->tm_mon + 1), current_time->tm_mday) * 86400;
+	local_time += (current_time->tm_hour * 3600) + (current_time->tm_min * 60) + second;
+	local_time += config::rtc_offset[0];
+	local_time += (config::rtc_offset[1] * 60);
+	local_time += (config::rtc_offset[2] * 3600);
+	local_time += (s64(config::rtc_offset[3]) * 86400);
+
+	s64 days = floor_div(local_time, 86400);
+	s64 time_of_day = local_time - (days * 86400);
+
+	s64 year = 0;
+	u32 month = 0;
+	u32 day = 0;
+
+	civil_from_days(days, year, month, day);
+
+	//Months and years vary in length, so add those offsets to the date itself and keep the day within the new month
+	if((config::rtc_offset[4]) || (config::rtc_offset[5]))
+	{
+		s64 total_months = (year * 12) + (month - 1) + config::rtc_offset[4] + (config::rtc_offset[5] * 12);
+
+		year = floor_div(total_months, 12);
+		month = (total_months - (year * 12)) + 1;
+
+		u32 last_day = days_in_month(year, month);
+		if(day > last_day) { day = last_day; }
+
+		days = days_from_civil(year, month, day);
+	}
+
+	rtc_date result;
+
+	result.year = year;
+	result.month = month;
+	result.day = day;
+
+	//January 1, 1970 was a Thursday
+	result.weekday = (days + 4) - (floor_div((days + 4), 7) * 7);
+
+	result.hour = (time_of_day / 3600);
+	result.minute = ((time_of_day / 60) % 60);
+	result.second = (time_of_day % 60);
+
+	return result;
+}
+
+/****** Moves MBC3-style RTC registers (seconds, minutes, hours, days LO, days HI) by one second ******/
+static void step_rtc_counter(u8* rtc_reg, bool forward)
+{
+	if(forward)
+	{
+		rtc_reg[0]++;
+
+		//Update seconds
+		if(rtc_reg[0] >= 60)
+		{
+			rtc_reg[0] = 0;
+			rtc_reg[1]++;
+		}
+
+		//Update minutes
+		if(rtc_reg[1] >= 60)
+		{
+			rtc_reg[1] = 0;
+			rtc_reg[2]++;
+		}
+
+		//Update hours
+		if(rtc_reg[2] >= 24)
+		{
+			rtc_reg[2] = 0;
+
+			u16 days = ((rtc_reg[4] << 8) | rtc_reg[3]) & 0x1FF;
+
+			//Set Days Overflow
+			if(days == 511) { rtc_reg[4] |= 0x80; }
+
+			days++;
+
+			rtc_reg[4] &= ~0x7F;
+			rtc_reg[4] |= ((days & 0x0100) >> 8);
+			rtc_reg[3] = (days & 0xFF);
+		}
+	}
+
+	else
+	{
+		rtc_reg[0]--;
+
+		//Update seconds
+		if(rtc_reg[0] == 0xFF)
+		{
+			rtc_reg[0] = 59;
+			rtc_reg[1]--;
+		}
+
+		//Update minutes
+		if(rtc_reg[1] == 0xFF)
+		{
+			rtc_reg[1] = 59;
+			rtc_reg[2]--;
+		}
+
+		//Update hours
+		if(rtc_reg[2] == 0xFF)
+		{
+			rtc_reg[2] = 23;
+
+			u16 days = ((rtc_reg[4] << 8) | rtc_reg[3]) & 0x1FF;
+
+			//Set Days Underflow
+			if((days == 0) && (rtc_reg[4] & 0x80)) { rtc_reg[4] &= ~0x80; }
+
+			days--;
+
+			rtc_reg[4] &= ~0x7F;
+			rtc_reg[4] |= ((days & 0x0100) >> 8);
+			rtc_reg[3] = (days & 0xFF);
+		}
+	}
+}
+
+/****** Counts a register down by a number of steps, returns how many times it wrapped ******/
+static u64 borrow_rtc_field(u8 &value, u64 steps, u32 wrap)
+{
+	//Registers set out of range by software just count down until they wrap
+	if(steps <= value)
+	{
+		value -= steps;
+		return 0;
+	}
+
+	u64 remaining = steps - value - 1;
+	value = (wrap - 1) - (remaining % wrap);
+
+	return 1 + (remaining / wrap);
+}
+
+/****** Moves MBC3-style RTC registers (seconds, minutes, hours, days LO, days HI) by any number of seconds ******/
+void advance_rtc_counter(u8* rtc_reg, s64 seconds)
+{
+	if(!seconds) { return; }
+
+	//Registers may hold out of range values written by software, a single step brings them back in range
+	bool forward = (seconds > 0);
+	u64 remaining = (forward) ? (seconds - 1) : (-(seconds + 1));
+
+	step_rtc_counter(rtc_reg, forward);
+	if(!remaining) { return; }
+
+	u16 days = ((rtc_reg[4] << 8) | rtc_reg[3]) & 0x1FF;
+	u64 day_change = 0;
+
+	if(forward)
+	{
+		u64 total = rtc_reg[0] + (rtc_reg[1] * 60) + (rtc_reg[2] * 3600) + remaining;
+		u64 time_of_day = total % 86400;
+
+		rtc_reg[0] = (time_of_day % 60);
+		rtc_reg[1] = ((time_of_day / 60) % 60);
+		rtc_reg[2] = (time_of_day / 3600);
+
+		day_change = total / 86400;
+		if(!day_change) { return; }
+
+		//Set Days Overflow
+		if((days + day_change) > 511) { rtc_reg[4] |= 0x80; }
+
+		days = (days + day_change) & 0x1FF;
+	}
+
+	else
+	{
+		u64 minute_change = borrow_rtc_field(rtc_reg[0], remaining, 60);
+		u64 hour_change = borrow_rtc_field(rtc_reg[1], minute_change, 60);
+
+		day_change = borrow_rtc_field(rtc_reg[2], hour_change, 24);
+		if(!day_change) { return; }
+
+		//Set Days Underflow
+		if(day_change > days) { rtc_reg[4] &= ~0x80; }
+
+		days = (days + 512 - (day_change & 0x1FF)) & 0x1FF;
+	}
+
+	rtc_reg[4] &= ~0x7F;
+	rtc_reg[4] |= ((days & 0x0100) >> 8);
+	rtc_reg[3] = (days & 0xFF);
+}
@@ -0,0 +1,36 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : rtc_time.h
+// Date : October 17, 2026
+// Description : Real-Time Clock time keeping
+//
+// Calendar arithmetic shared by emulated RTCs (MBC3, TAMA5, GBA and NDS)
+// Catching a clock up takes constant time, no matter how long it was left alone
+
+#ifndef GBE_RTC_TIME
+#define GBE_RTC_TIME
+
+#include "common.h"
+
+//Local date and time as reported by an RTC
+struct rtc_date
+{
+	u16 year;
+	u8 month;
+	u8 day;
+	u8 weekday;
+	u8 hour;
+	u8 minute;
+	u8 second;
+};
+
+s64 days_from_civil(s64 year, u32 month, u32 day);
+void civil_from_days(s64 days, s64 &year, u32 &month, u32 &day);
+u32 days_in_month(s64 year, u32 month);
+
+rtc_date get_rtc_date();
+void advance_rtc_counter(u8* rtc_reg, s64 seconds);
+
+#endif // GBE_RTC_TIME
@@ -0,0 +1,84 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : run_ahead.cpp
+// Date : October 17, 2026
+// Description : Run-ahead
+//
+// Hides a game's internal input lag by emulating a few frames ahead of the real one
+// Only the last frame ahead is presented, then the core is restored to the real frame
+// Real frames are still emulated and throttled, they are just never shown
+
+#include "run_ahead.h"
+#include "config.h"
+
+/****** Run-ahead Constructor ******/
+run_ahead::run_ahead()
+{
+	reset();
+}
+
+/****** Run-ahead Destructor ******/
+run_ahead::~run_ahead() { }
+
+/****** Discards the saved state ******/
+void run_ahead::reset()
+{
+	std::vector<u8>().swap(saved_state);
+	active = false;
+	last_frame = 0;
+}
+
+/****** Called once per emulated frame - Runs ahead and presents the future frame ******/
+bool run_ahead::update(core_emu* core, u32 &frame_count, bool &present_frame, bool &realtime_frame)
+{
+	//Give up on a frame if the core stops producing them (e.g. LCD disabled for a long time)
+	const u32 step_limit = 0x100000;
+
+	last_frame = frame_count;
+
+	//Present real frames normally when disabled or when frames can't be emulated twice (netplay)
+	if((!config::run_ahead_frames) || (config::use_netplay))
+	{
+		present_frame = true;
+		realtime_frame = true;
+		return false;
+	}
+
+	if(!core->serialize(saved_state))
+	{
+		present_frame = true;
+		return false;
+	}
+
+	u32 real_frame = frame_count;
+	bool result = true;
+
+	active = true;
+	realtime_frame = false;
+
+	for(u32 x = 0; (x < config::run_ahead_frames) && (result); x++)
+	{
+		u32 start_frame = frame_count;
+		u32 steps = 0;
+
+		present_frame = ((x + 1) == config::run_ahead_frames);
+
+		while((frame_count == start_frame) && (core->running))
+		{
+			core->step();
+			if(++steps >= step_limit) { result = false; break; }
+		}
+	}
+
+	//Restore the real frame, which stays hidden
+	core->deserialize(saved_state.data(), saved_state.size());
+	frame_count = real_frame;
+
+	active = false;
+	present_frame = false;
+	realtime_frame = true;
+
+	return result;
+}
@@ -0,0 +1,37 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : run_ahead.h
+// Date : October 17, 2026
+// Description : Run-ahead
+//
+// Hides a game's internal input lag by emulating a few frames ahead of the real one
+// Only the last frame ahead is presented, then the core is restored to the real frame
+
+#ifndef GBE_RUN_AHEAD
+#define GBE_RUN_AHEAD
+
+#include <vector>
+
+#include "core_emu.h"
+
+class run_ahead
+{
+	public:
+
+	run_ahead();
+	~run_ahead();
+
+	void reset();
+	bool update(core_emu* core, u32 &frame_count, bool &present_frame, bool &realtime_frame);
+
+	bool active;
+	u32 last_frame;
+
+	private:
+
+	std::vector<u8> saved_state;
+};
+
+#endif // GBE_RUN_AHEAD
@@ -0,0 +1,346 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : save_flusher.cpp
+// Date : October 17, 2026
+// Description : Battery save flusher
+//
+// Periodically writes changed pages of battery-backed save data on a background thread
+// The emulation thread only copies the save data, comparing and writing happens on the flush thread
+// Changed pages are written to a journal, then into the save file in place, then the journal is removed
+// An intact journal left over from a crash is replayed the next time the save is loaded
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "save_flusher.h"
+#include "config.h"
+#include "util.h"
+
+//Journal file header
+const u32 JOURNAL_MAGIC = 0x4A454247;
+
+//Granularity of in-place writes
+const u32 SAVE_PAGE_SIZE = 0x1000;
+
+/****** Save Flusher Constructor ******/
+save_flusher::save_flusher()
+{
+	has_pending = false;
+	quit = false;
+	reset();
+}
+
+/****** Save Flusher Destructor ******/
+save_flusher::~save_flusher()
+{
+	stop();
+}
+
+/****** Stops any background writes and forgets all save data seen so far ******/
+void save_flusher::reset()
+{
+	stop();
+
+	capture.clear();
+	pending.clear();
+	shadow.clear();
+	pending_file = "";
+	shadow_file = "";
+
+	frame_counter = 0;
+	has_pending = false;
+	quit = false;
+
+	//Start on the very first frame
+	last_frame = 0xFFFFFFFF;
+}
+
+/****** Called once per emulated frame - Hands the current save data to the flush thread every few seconds ******/
+void save_flusher::update(core_emu* core, u32 frame)
+{
+	last_frame = frame;
+
+	//Exported saves are only written once on exit
+	if((!config::save_flush_interval) || (!config::save_export_path.empty())) { return; }
+	if(++frame_counter < (config::save_flush_interval * 60)) { return; }
+
+	frame_counter = 0;
+
+	if(!core->get_save_image(capture)) { return; }
+
+	//Config is per thread, so work out where the save goes here rather than on the flush thread
+	std::string target = config::save_file;
+	if(!config::save_path.empty()) { target = config::save_path + util::get_filename_from_path(target); }
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		//Only the newest data matters if the last flush hasn't finished yet
+		pending.swap(capture);
+		pending_file = target;
+		has_pending = true;
+	}
+
+	if(!worker.joinable()) { worker = std::thread(&save_flusher::flush_thread, this); }
+	signal.notify_one();
+}
+
+/****** Finishes any pending write and stops the flush thread ******/
+void save_flusher::stop()
+{
+	if(!worker.joinable()) { return; }
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		quit = true;
+	}
+
+	signal.notify_one();
+	worker.join();
+
+	quit = false;
+}
+
+/****** Flush thread - Waits for new save data and writes it ******/
+void save_flusher::flush_thread()
+{
+	std::vector<u8> image;
+	std::string target;
+
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			signal.wait(guard, [this]() { return (has_pending || quit); });
+
+			//Always write the last data handed over before quitting
+			if(!has_pending) { return; }
+
+			image.swap(pending);
+			target = pending_file;
+			has_pending = false;
+		}
+
+		flush(image, target);
+	}
+}
+
+/****** Writes whatever changed since the last flush ******/
+void save_flusher::flush(std::vector<u8> &image, std::string &target)
+{
+	//Read back what's on disk the first time, or whenever the save changes size (e.g. EEPROM size detection)
+	if((target != shadow_file) || (image.size() != shadow.size()))
+	{
+		shadow.clear();
+		shadow_file = target;
+
+		std::ifstream file(target.c_str(), std::ios::binary);
+
+		if(file.is_open())
+		{
+			file.seekg(0, file.end);
+			u64 file_size = file.tellg();
+			file.seekg(0, file.beg);
+
+			//Files can be longer than the save data, e.g. DMG RTC data is appended on exit
+			if(file_size >= image.size())
+			{
+				shadow.resize(image.size());
+				file.read((char*)shadow.data(), image.size());
+				if(!file) { shadow.clear(); }
+			}
+		}
+
+		//No usable save file yet, write everything in one go
+		if(shadow.empty())
+		{
+			if(write_full(image, target)) { shadow = image; }
+			else { shadow_file = ""; }
+
+			return;
+		}
+	}
+
+	write_pages(image, target);
+}
+
+/****** Writes a whole save file, replacing the old one only once the new one is complete ******/
+bool save_flusher::write_full(std::vector<u8> &image, std::string &target)
+{
+	std::string temp_file = target + ".tmp";
+	std::ofstream file(temp_file.c_str(), std::ios::binary | std::ios::trunc);
+
+	if(!file.is_open())
+	{
+		std::cout<<"SAVE::Error - Could not write save data " << target << "\n";
+		return false;
+	}
+
+	file.write((char*)image.data(), image.size());
+	file.close();
+
+	std::error_code error;
+
+	if(!file)
+	{
+		std::cout<<"SAVE::Error - Could not write save data " << target << "\n";
+		std::filesystem::remove(std::filesystem::path(temp_file), error);
+		return false;
+	}
+
+	std::filesystem::rename(std::filesystem::path(temp_file), std::filesystem::path(target), error);
+
+	if(error)
+	{
+		std::cout<<"SAVE::Error - Could not replace save data " << target << "\n";
+		std::filesystem::remove(std::filesystem::path(temp_file), error);
+		return false;
+	}
+
+	return true;
+}
+
+/****** Writes only the pages that changed, journaling them first ******/
+bool save_flusher::write_pages(std::vector<u8> &image, std::string &target)
+{
+	std::vector<u32> dirty_pages;
+	u32 image_size = image.size();
+
+	for(u32 offset = 0; offset < image_size; offset += SAVE_PAGE_SIZE)
+	{
+		u32 length = ((image_size - offset) < SAVE_PAGE_SIZE) ? (image_size - offset) : SAVE_PAGE_SIZE;
+		if(memcmp(&image[offset], &shadow[offset], length) != 0) { dirty_pages.push_back(offset); }
+	}
+
+	if(dirty_pages.empty()) { return true; }
+
+	//Journal - Magic, page count, then the offset, length, and data of each page, then a CRC32 of everything before it
+	std::vector<u8> journal;
+	util::state_writer journal_out(journal);
+
+	u32 page_count = dirty_pages.size();
+
+	journal_out.write(&JOURNAL_MAGIC, 4);
+	journal_out.write(&page_count, 4);
+
+	for(u32 x = 0; x < page_count; x++)
+	{
+		u32 offset = dirty_pages[x];
+		u32 length = ((image_size - offset) < SAVE_PAGE_SIZE) ? (image_size - offset) : SAVE_PAGE_SIZE;
+
+		journal_out.write(&offset, 4);
+		journal_out.write(&length, 4);
+		journal_out.write(&image[offset], length);
+	}
+
+	u32 journal_crc = util::get_crc32(journal.data(), journal.size());
+	journal_out.write(&journal_crc, 4);
+
+	std::string journal_file = target + ".journal";
+	std::ofstream journal_stream(journal_file.c_str(), std::ios::binary | std::ios::trunc);
+
+	if(!journal_stream.is_open())
+	{
+		std::cout<<"SAVE::Error - Could not write save journal " << journal_file << "\n";
+		return false;
+	}
+
+	journal_stream.write((char*)journal.data(), journal.size());
+	journal_stream.close();
+
+	std::error_code error;
+
+	if(!journal_stream)
+	{
+		std::filesystem::remove(std::filesystem::path(journal_file), error);
+		return false;
+	}
+
+	//Journal is safe, now update the save file in place
+	std::fstream file(target.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+
+	if(!file.is_open())
+	{
+		std::cout<<"SAVE::Error - Could not update save data " << target << "\n";
+		return false;
+	}
+
+	for(u32 x = 0; x < page_count; x++)
+	{
+		u32 offset = dirty_pages[x];
+		u32 length = ((image_size - offset) < SAVE_PAGE_SIZE) ? (image_size - offset) : SAVE_PAGE_SIZE;
+
+		file.seekp(offset);
+		file.write((char*)&image[offset], length);
+
+		memcpy(&shadow[offset], &image[offset], length);
+	}
+
+	file.close();
+
+	//Leave the journal in place if anything went wrong, it gets replayed on the next load
+	if(!file) { return false; }
+
+	std::filesystem::remove(std::filesystem::path(journal_file), error);
+	return true;
+}
+
+/****** Replays a journal left behind by an interrupted write - Call before loading a save file ******/
+void save_flusher::recover(std::string filename)
+{
+	std::string journal_file = filename + ".journal";
+	std::error_code error;
+
+	if(!std::filesystem::exists(std::filesystem::path(journal_file), error)) { return; }
+
+	util::mapped_file journal;
+	bool valid = (journal.open(journal_file)) && (journal.size >= 12) && (journal.size < 0x10000000);
+
+	u32 magic = 0;
+	u32 page_count = 0;
+	u32 journal_crc = 0;
+
+	if(valid)
+	{
+		memcpy(&magic, &journal.data[0], 4);
+		memcpy(&page_count, &journal.data[4], 4);
+		memcpy(&journal_crc, &journal.data[journal.size - 4], 4);
+
+		valid = (magic == JOURNAL_MAGIC) && (journal_crc == util::get_crc32(journal.data, (journal.size - 4)));
+	}
+
+	//A journal that never finished writing means the save file itself was never touched
+	if(valid)
+	{
+		std::fstream file(filename.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+		util::state_reader journal_in((journal.data + 8), (journal.size - 12));
+
+		for(u32 x = 0; (x < page_count) && (file.is_open()); x++)
+		{
+			u32 offset = 0;
+			u32 length = 0;
+
+			journal_in.read(&offset, 4);
+			journal_in.read(&length, 4);
+
+			if((!journal_in.good()) || (length > SAVE_PAGE_SIZE) || ((journal_in.state_offset + length) > journal_in.state_length)) { break; }
+
+			file.seekp(offset);
+			file.write((char*)(journal_in.state_buffer + journal_in.state_offset), length);
+			journal_in.state_offset += length;
+		}
+
+		if(file.is_open())
+		{
+			file.close();
+			std::cout<<"SAVE::Recovered " << std::dec << page_count << " pages of save data from an interrupted write\n";
+		}
+	}
+
+	journal.close();
+	std::filesystem::remove(std::filesystem::path(journal_file), error);
+}
@@ -0,0 +1,64 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : save_flusher.h
+// Date : October 17, 2026
+// Description : Battery save flusher
+//
+// Periodically writes changed pages of battery-backed save data on a background thread
+// Pages go through a journal first, so a crash mid-write never leaves a torn save file
+
+#ifndef GBE_SAVE_FLUSHER
+#define GBE_SAVE_FLUSHER
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core_emu.h"
+
+class save_flusher
+{
+	public:
+
+	save_flusher();
+	~save_flusher();
+
+	void reset();
+	void update(core_emu* core, u32 frame);
+	void stop();
+
+	static void recover(std::string filename);
+
+	u32 last_frame;
+
+	private:
+
+	void flush_thread();
+	void flush(std::vector<u8> &image, std::string &target);
+	bool write_full(std::vector<u8> &image, std::string &target);
+	bool write_pages(std::vector<u8> &image, std::string &target);
+
+	//Emulation thread only
+	std::vector<u8> capture;
+	u32 frame_counter;
+
+	//Shared with the flush thread
+	std::vector<u8> pending;
+	std::string pending_file;
+	bool has_pending;
+	bool quit;
+
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable signal;
+
+	//Flush thread only - Save data as it currently is on disk
+	std::vector<u8> shadow;
+	std::string shadow_file;
+};
+
+#endif // GBE_SAVE_FLUSHER
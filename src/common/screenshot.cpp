@@ -0,0 +1,92 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : screenshot.cpp
+// Date : October 17, 2026
+// Description : Screenshot writer
+//
+// Encodes and writes PNG screenshots on a background thread
+// The emulation thread copies the frame and queues it, filtering, compression, and disk access happen on the write thread
+// Every queued screenshot is written before the thread stops
+
+#include "screenshot.h"
+#include "util.h"
+
+/****** Screenshot Writer Constructor ******/
+screenshot_writer::screenshot_writer()
+{
+	quit = false;
+}
+
+/****** Screenshot Writer Destructor ******/
+screenshot_writer::~screenshot_writer()
+{
+	stop();
+}
+
+/****** Copies an SDL Surface and queues it to be saved as a PNG ******/
+void screenshot_writer::save(SDL_Surface* source, std::string filename)
+{
+	if(source == NULL) { return; }
+
+	std::vector<u32> pixels;
+	util::copy_surface_pixels(source, pixels);
+
+	save(pixels, source->w, source->h, filename);
+}
+
+/****** Queues 32-bit ARGB pixels to be saved as a PNG - Takes the contents of pixels ******/
+void screenshot_writer::save(std::vector<u32> &pixels, u32 width, u32 height, std::string filename)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		jobs.push_back(screenshot_job());
+		jobs.back().pixels.swap(pixels);
+		jobs.back().width = width;
+		jobs.back().height = height;
+		jobs.back().filename = filename;
+	}
+
+	if(!worker.joinable()) { worker = std::thread(&screenshot_writer::write_thread, this); }
+	signal.notify_one();
+}
+
+/****** Finishes any queued screenshots and stops the write thread ******/
+void screenshot_writer::stop()
+{
+	if(!worker.joinable()) { return; }
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		quit = true;
+	}
+
+	signal.notify_one();
+	worker.join();
+
+	quit = false;
+}
+
+/****** Write thread - Waits for queued screenshots and writes them ******/
+void screenshot_writer::write_thread()
+{
+	screenshot_job job;
+
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			signal.wait(guard, [this]() { return ((!jobs.empty()) || quit); });
+
+			//Always write everything queued before quitting
+			if(jobs.empty()) { return; }
+
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		util::save_png(job.pixels.data(), job.width, job.height, job.filename);
+	}
+}
@@ -0,0 +1,58 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : screenshot.h
+// Date : October 17, 2026
+// Description : Screenshot writer
+//
+// Encodes and writes PNG screenshots on a background thread
+// The emulation thread only copies the frame, so taking a screenshot never holds up a frame
+
+#ifndef GBE_SCREENSHOT
+#define GBE_SCREENSHOT
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SDL2/SDL.h>
+
+#include "common.h"
+
+class screenshot_writer
+{
+	public:
+
+	screenshot_writer();
+	~screenshot_writer();
+
+	void save(SDL_Surface* source, std::string filename);
+	void save(std::vector<u32> &pixels, u32 width, u32 height, std::string filename);
+	void stop();
+
+	private:
+
+	struct screenshot_job
+	{
+		std::vector<u32> pixels;
+		u32 width;
+		u32 height;
+		std::string filename;
+	};
+
+	void write_thread();
+
+	//Shared with the write thread
+	std::deque<screenshot_job> jobs;
+	bool quit;
+
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable signal;
+};
+
+#endif // GBE_SCREENSHOT
@@ -0,0 +1,249 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : state_file.cpp
+// Date : October 17, 2026
+// Description : Save state files
+//
+// Writes and reads save states as a versioned container with one tagged, compressed section per component
+// Header - Magic, container version, section count, system tag
+// Sections - Tag, size, compressed size, CRC32 of the uncompressed data, then the data itself
+// A state is checked against the running core's layout, and the core is rolled back if it still doesn't fit once loaded
+// Older headerless states load only if they match the running core's layout exactly
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "state_file.h"
+#include "lz_codec.h"
+#include "util.h"
+
+const u32 STATE_MAGIC = GBE_STATE_TAG('G', 'B', 'E', 'S');
+const u16 STATE_VERSION = 1;
+
+//How far a section may outgrow the running core's idea of its size (FIFOs, save data detected later, etc)
+const u64 STATE_SECTION_SLACK = 0x1000000;
+
+/****** Serializes a core and writes it to a save state file ******/
+bool save_state_file(core_emu* core, std::string filename)
+{
+	std::vector<u8> state_data;
+	std::vector<state_section> sections;
+
+	if(!core->serialize(state_data)) { return false; }
+	u32 system = core->get_state_sections(sections);
+
+	//Sections must cover the serialized state exactly
+	u64 total_size = 0;
+	for(u32 x = 0; x < sections.size(); x++) { total_size += sections[x].size; }
+
+	if(total_size != state_data.size())
+	{
+		std::cout<<"GBE::Error - Save state sections do not match serialized data\n";
+		return false;
+	}
+
+	std::vector<u8> file_data;
+	std::vector<u8> packed_data;
+	util::state_writer state(file_data);
+
+	u16 section_count = sections.size();
+
+	state.write(&STATE_MAGIC, 4);
+	state.write(&STATE_VERSION, 2);
+	state.write(&section_count, 2);
+	state.write(&system, 4);
+
+	u32 offset = 0;
+
+	for(u32 x = 0; x < sections.size(); x++)
+	{
+		const u8* raw_data = state_data.data() + offset;
+		u32 raw_size = sections[x].size;
+		u32 packed_size = lz_compress(raw_data, raw_size, packed_data);
+		u32 crc = util::get_crc32(raw_data, raw_size);
+
+		//Sections that don't shrink are stored as-is
+		bool store_raw = (packed_size >= raw_size);
+		if(store_raw) { packed_size = raw_size; }
+
+		state.write(&sections[x].tag, 4);
+		state.write(&raw_size, 4);
+		state.write(&packed_size, 4);
+		state.write(&crc, 4);
+		state.write((store_raw ? raw_data : packed_data.data()), packed_size);
+
+		offset += raw_size;
+	}
+
+	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+
+	if(!file.is_open())
+	{
+		std::cout<<"GBE::Error - Could not write save state " << filename << "\n";
+		return false;
+	}
+
+	file.write((char*)file_data.data(), file_data.size());
+	file.close();
+
+	return true;
+}
+
+/****** Unpacks a save state container, returns false if it doesn't belong to this core ******/
+static bool unpack_state(const u8* file_data, u32 file_size, u32 system, std::vector<state_section> &expected, std::vector<u8> &state_data, std::vector<state_section> &sections)
+{
+	util::state_reader state(file_data, file_size);
+
+	u32 magic = 0;
+	u16 version = 0;
+	u16 section_count = 0;
+	u32 file_system = 0;
+
+	state.read(&magic, 4);
+	state.read(&version, 2);
+	state.read(&section_count, 2);
+	state.read(&file_system, 4);
+
+	if(!state.good()) { return false; }
+
+	if(version != STATE_VERSION)
+	{
+		std::cout<<"GBE::Error - Save state format version " << std::dec << version << " is not supported\n";
+		return false;
+	}
+
+	if(file_system != system)
+	{
+		std::cout<<"GBE::Error - Save state was made for a different system\n";
+		return false;
+	}
+
+	if(section_count != expected.size())
+	{
+		std::cout<<"GBE::Error - Save state has " << std::dec << section_count << " sections, expected " << expected.size() << "\n";
+		return false;
+	}
+
+	for(u32 x = 0; x < section_count; x++)
+	{
+		state_section current;
+		u32 packed_size = 0;
+		u32 crc = 0;
+
+		state.read(&current.tag, 4);
+		state.read(&current.size, 4);
+		state.read(&packed_size, 4);
+		state.read(&crc, 4);
+
+		if((!state.good()) || (packed_size > (state.state_length - state.state_offset)))
+		{
+			std::cout<<"GBE::Error - Save state is truncated\n";
+			return false;
+		}
+
+		if(current.tag != expected[x].tag)
+		{
+			std::cout<<"GBE::Error - Save state has unexpected section " << x << "\n";
+			return false;
+		}
+
+		//Never trust the stored size enough to allocate for it blindly
+		u64 unpacked_total = u64(state_data.size()) + current.size;
+
+		if((u64(current.size) > (u64(expected[x].size) + STATE_SECTION_SLACK)) || (unpacked_total > 0xFFFFFFFF))
+		{
+			std::cout<<"GBE::Error - Save state section " << x << " is too large\n";
+			return false;
+		}
+
+		u32 offset = state_data.size();
+		const u8* packed_data = state.state_buffer + state.state_offset;
+
+		state_data.resize(offset + current.size);
+
+		if(packed_size == current.size) { memcpy((state_data.data() + offset), packed_data, packed_size); }
+
+		else if(!lz_decompress(packed_data, packed_size, (state_data.data() + offset), current.size))
+		{
+			std::cout<<"GBE::Error - Save state section " << x << " could not be decompressed\n";
+			return false;
+		}
+
+		if(util::get_crc32((state_data.data() + offset), current.size) != crc)
+		{
+			std::cout<<"GBE::Error - Save state section " << x << " is damaged\n";
+			return false;
+		}
+
+		state.state_offset += packed_size;
+		sections.push_back(current);
+	}
+
+	return true;
+}
+
+/****** Reads a save state file and restores a core from it ******/
+bool load_state_file(core_emu* core, std::string filename)
+{
+	util::mapped_file file;
+
+	if((!file.open(filename)) || (file.size > 0xFFFFFFFF))
+	{
+		std::cout<<"GBE::Error - Could not read save state " << filename << "\n";
+		return false;
+	}
+
+	std::vector<state_section> expected;
+	std::vector<state_section> sections;
+	std::vector<u8> state_data;
+
+	u32 system = core->get_state_sections(expected);
+	u32 magic = 0;
+
+	if(file.size >= 4) { memcpy(&magic, file.data, 4); }
+
+	if(magic == STATE_MAGIC)
+	{
+		if(!unpack_state(file.data, file.size, system, expected, state_data, sections)) { return false; }
+	}
+
+	//Headerless states from older versions are loaded raw and only checked for their total size
+	else { state_data.assign(file.data, (file.data + file.size)); }
+
+	file.close();
+
+	//Keep the current state around so a state that turns out not to fit can be undone
+	std::vector<u8> backup_data;
+	if(!core->serialize(backup_data)) { return false; }
+
+	bool result = core->deserialize(state_data.data(), state_data.size());
+
+	//Every component must have used exactly its own section
+	if(result)
+	{
+		std::vector<state_section> loaded;
+		core->get_state_sections(loaded);
+
+		u64 total_size = 0;
+
+		for(u32 x = 0; x < loaded.size(); x++)
+		{
+			total_size += loaded[x].size;
+			if((!sections.empty()) && (loaded[x].size != sections[x].size)) { result = false; }
+		}
+
+		if(total_size != state_data.size()) { result = false; }
+	}
+
+	if(!result)
+	{
+		core->deserialize(backup_data.data(), backup_data.size());
+		std::cout<<"GBE::Error - Save state " << filename << " does not match this version of GBE+\n";
+		return false;
+	}
+
+	return true;
+}
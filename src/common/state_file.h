@@ -0,0 +1,33 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : state_file.h
+// Date : October 17, 2026
+// Description : Save state files
+//
+// Writes and reads save states as a versioned container with one tagged, compressed section per component
+// States that don't match the running core are refused without touching emulation
+
+#ifndef GBE_STATE_FILE
+#define GBE_STATE_FILE
+
+#include <string>
+#include <vector>
+
+#include "core_emu.h"
+
+//Four character tags for systems and sections
+#define GBE_STATE_TAG(a, b, c, d) (u32(a) | (u32(b) << 8) | (u32(c) << 16) | (u32(d) << 24))
+
+//One component's part of a serialized save state, e.g. the CPU or MMU
+struct state_section
+{
+	u32 tag;
+	u32 size;
+};
+
+bool save_state_file(core_emu* core, std::string filename);
+bool load_state_file(core_emu* core, std::string filename);
+
+#endif // GBE_STATE_FILE
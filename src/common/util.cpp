@@ -12,8 +12,22 @@
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #include "util.h"
+#include "deflate.h"
 
 namespace util
 {
@@ -21,8 +35,8 @@ namespace util
 //CRC32 Polynomial
 u32 poly32 = 0x04C11DB7;
 
-//CRC lookup table
-u32 crc32_table[256];
+//CRC lookup tables - Table 0 is the standard bytewise table, tables 1-7 advance it by 1-7 extra bytes for slice-by-8
+u32 crc32_table[8][256];
 
 //UTC format LUT strings
 std::string utc_day[7] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
@@ -43,147 +57,176 @@ std::string utc_mon[12] =
 	"Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
 };
 
-/****** Saves an SDL Surface to a PNG file ******/
-bool save_png(SDL_Surface* source, std::string filename)
+/****** Appends a PNG chunk - Length, type, data, then CRC32 of type and data ******/
+static void write_png_chunk(std::vector<u8> &png_bytes, const char* type, const u8* data, u32 length)
 {
-	if(source == NULL) 
+	for(int x = 24; x >= 0; x -= 8) { png_bytes.push_back((length >> x) & 0xFF); }
+
+	u32 chunk_start = png_bytes.size();
+
+	png_bytes.insert(png_bytes.end(), type, (type + 4));
+	png_bytes.insert(png_bytes.end(), data, (data + length));
+
+	u32 chunk_crc = get_crc32((png_bytes.data() + chunk_start), (length + 4));
+
+	for(int x = 24; x >= 0; x -= 8) { png_bytes.push_back((chunk_crc >> x) & 0xFF); }
+}
+
+/****** Predicts a byte from its left, up, and upper-left neighbors for PNG's Paeth filter ******/
+static u8 png_paeth(u8 left, u8 up, u8 up_left)
+{
+	s32 estimate = left + up - up_left;
+	s32 diff_left = abs(estimate - left);
+	s32 diff_up = abs(estimate - up);
+	s32 diff_up_left = abs(estimate - up_left);
+
+	if((diff_left <= diff_up) && (diff_left <= diff_up_left)) { return left; }
+	else if(diff_up <= diff_up_left) { return up; }
+	return up_left;
+}
+
+/****** Saves 32-bit ARGB pixels to a PNG file ******/
+bool save_png(const u32* pixels, u32 width, u32 height, std::string filename)
+{
+	if((pixels == NULL) || (!width) || (!height)) 
 	{
 		std::cout<<"GBE::Error - Source data for " << filename << " is null\n";
 		return false;
 	}
-	
-	//Lock SDL_Surface
-	if(SDL_MUSTLOCK(source)){ SDL_LockSurface(source); }
-	u32* src_pixels = (u32*)source->pixels;
 
-	std::vector<u8> png_bytes;
+	u32 stride = width * 3;
+	std::vector<u8> rgb_row[2];
+	rgb_row[0].resize(stride, 0);
+	rgb_row[1].resize(stride, 0);
 
-	//PNG Magic Number - 8 bytes
-	png_bytes.push_back(0x89);
-	png_bytes.push_back(0x50);
-	png_bytes.push_back(0x4E);
-	png_bytes.push_back(0x47);
-	png_bytes.push_back(0x0D);
-	png_bytes.push_back(0x0A);
-	png_bytes.push_back(0x1A);
-	png_bytes.push_back(0x0A);
-
-	//IHDR byte length (always 0x0D for us) - 4 bytes
-	png_bytes.push_back(0x00);
-	png_bytes.push_back(0x00);
-	png_bytes.push_back(0x00);
-	png_bytes.push_back(0x0D);
-
-	//"IHDR" ASCII string - 4 bytes
-	png_bytes.push_back(0x49);
-	png_bytes.push_back(0x48);
-	png_bytes.push_back(0x44);
-	png_bytes.push_back(0x52);
-
-	//Image width - 4 bytes
-	u32 width = source->w;
-
-	for(int x = 24; x >= 0; x-= 8)
+	//Each scanline starts with a filter type, followed by RGB values filtered against neighboring pixels
+	std::vector<u8> scanlines((stride + 1) * height);
+	std::vector<u8> filtered[5];
+	for(u32 x = 0; x < 5; x++) { filtered[x].resize(stride); }
+
+	for(u32 y = 0; y < height; y++)
 	{
-		png_bytes.push_back((width >> x) & 0xFF);
-	}
+		std::vector<u8> &current = rgb_row[y & 0x1];
+		std::vector<u8> &previous = rgb_row[(y + 1) & 0x1];
 
-	//Image height - 4 bytes
-	u32 height = source->h;
+		for(u32 x = 0; x < width; x++)
+		{
+			u32 color = pixels[(y * width) + x];
 
-	for(int x = 24; x >= 0; x-= 8)
-	{
-		png_bytes.push_back((height >> x) & 0xFF);
-	}
+			current[(x * 3)] = (color >> 16) & 0xFF;
+			current[(x * 3) + 1] = (color >> 8) & 0xFF;
+			current[(x * 3) + 2] = (color & 0xFF);
+		}
 
-	//Bit depth (always 0x08 for us) - 1 byte
-	png_bytes.push_back(0x08);
+		//Try every filter - None, Sub, Up, Average, Paeth - and keep whichever leaves the smallest values
+		u32 best_filter = 0;
+		u32 best_sum = 0xFFFFFFFF;
 
-	//Color type (always 0x02 for us) 1 byte
-	png_bytes.push_back(0x02);
+		for(u32 filter = 0; filter < 5; filter++)
+		{
+			u32 sum = 0;
 
-	//Compression method (always 0x00 for us, use DEFLATE) - 1 byte
-	//Filter method (always 0x00 for us) - 1 byte
-	//Interlace method (always 0x00 for us) - 1 byte
-	png_bytes.push_back(0x00);
-	png_bytes.push_back(0x00);
-	png_bytes.push_back(0x00);
+			for(u32 x = 0; x < stride; x++)
+			{
+				u8 left = (x >= 3) ? current[x - 3] : 0;
+				u8 up = previous[x];
+				u8 up_left = (x >= 3) ? previous[x - 3] : 0;
+				u8 value = current[x];
+
+				switch(filter)
+				{
+					case 1: value -= left; break;
+					case 2: value -= up; break;
+					case 3: value -= ((left + up) >> 1); break;
+					case 4: value -= png_paeth(left, up, up_left); break;
+				}
+
+				filtered[filter][x] = value;
+				sum += abs(s8(value));
+			}
 
-	//CRC32 of IHDR chunk - 4 bytes
-	u32 ihdr_crc = util::get_crc32((png_bytes.data() + 12), 17);
+			if(sum < best_sum)
+			{
+				best_sum = sum;
+				best_filter = filter;
+			}
+		}
 
-	for(int x = 24; x >= 0; x-= 8)
-	{
-		png_bytes.push_back((ihdr_crc >> x) & 0xFF);
+		u8* scanline = scanlines.data() + ((stride + 1) * y);
+		scanline[0] = best_filter;
+		memcpy((scanline + 1), filtered[best_filter].data(), stride);
 	}
 
-	//IDAT byte length - 4 bytes
-	u32 dat_length = (source->w * source->h) * 3;
-	dat_length = switch_endian32(dat_length);
+	std::vector<u8> image_data;
+	zlib_compress(scanlines.data(), scanlines.size(), image_data);
 
-	for(int x = 24; x >= 0; x-= 8)
+	//IHDR - Width, height, 8-bit depth, RGB color, DEFLATE, adaptive filtering, no interlacing
+	u8 header[13];
+
+	for(u32 x = 0; x < 4; x++)
 	{
-		png_bytes.push_back((dat_length >> x) & 0xFF);
+		header[x] = (width >> (24 - (x * 8))) & 0xFF;
+		header[x + 4] = (height >> (24 - (x * 8))) & 0xFF;
 	}
 
-	dat_length = switch_endian32(dat_length);
-
-	//"IDAT" ASCII string - 4 bytes
-	png_bytes.push_back(0x49);
-	png_bytes.push_back(0x44);
-	png_bytes.push_back(0x41);
-	png_bytes.push_back(0x54);
+	header[8] = 0x08;
+	header[9] = 0x02;
+	header[10] = 0x00;
+	header[11] = 0x00;
+	header[12] = 0x00;
 
-	//Grab RGB values, then store them
-	for(int x = 0; x < (source->w * source->h); x++)
-	{
-		//TODO - DEFLATE algo
+	//PNG Magic Number - 8 bytes
+	const u8 png_magic[8] = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+	std::vector<u8> png_bytes(png_magic, (png_magic + 8));
 
-		u32 color = src_pixels[x];
+	write_png_chunk(png_bytes, "IHDR", header, 13);
+	write_png_chunk(png_bytes, "IDAT", image_data.data(), image_data.size());
+	write_png_chunk(png_bytes, "IEND", NULL, 0);
 
-		u8 red = (color >> 16) & 0xFF;
-		u8 green = (color >> 8) & 0xFF;
-		u8 blue = (color & 0xFF);
+	std::ofstream file(filename.c_str(), std::ios::binary);
 
-		png_bytes.push_back(red);
-		png_bytes.push_back(blue);
-		png_bytes.push_back(green);
+	if(!file.is_open())
+	{
+		std::cout<<"GBE::Error - Could not write " << filename << "\n";
+		return false;
 	}
 
-	//CRC32 of IDAT chunk - 4 bytes
-	u32 idat_crc = util::get_crc32((png_bytes.data() + 37), (dat_length + 4));
+	file.write(reinterpret_cast<char*> (png_bytes.data()), png_bytes.size());
+	file.close();
+
+	return true;
+}
 
-	for(int x = 24; x >= 0; x-= 8)
+/****** Saves an SDL Surface to a PNG file ******/
+bool save_png(SDL_Surface* source, std::string filename)
+{
+	if(source == NULL) 
 	{
-		png_bytes.push_back((idat_crc >> x) & 0xFF);
+		std::cout<<"GBE::Error - Source data for " << filename << " is null\n";
+		return false;
 	}
 
-	//IEND byte length (always 0x00 for us) - 4 bytes
-	png_bytes.push_back(0x00);
-	png_bytes.push_back(0x00);
-	png_bytes.push_back(0x00);
-	png_bytes.push_back(0x00);
+	std::vector<u32> pixels;
+	copy_surface_pixels(source, pixels);
+
+	return save_png(pixels.data(), source->w, source->h, filename);
+}
 
-	//"IEND" ASCII string
-	png_bytes.push_back(0x49);
-	png_bytes.push_back(0x45);
-	png_bytes.push_back(0x4E);
-	png_bytes.push_back(0x44);
+/****** Copies the pixels of a 32-bit SDL Surface, rows may be padded in the surface but not in the copy ******/
+void copy_surface_pixels(SDL_Surface* source, std::vector<u32> &pixels)
+{
+	pixels.resize(source->w * source->h);
 
-	//CRC32 of IEND - Precalculated
-	png_bytes.push_back(0xAE);
-	png_bytes.push_back(0x42);
-	png_bytes.push_back(0x60);
-	png_bytes.push_back(0x82);
+	//Lock SDL_Surface
+	if(SDL_MUSTLOCK(source)){ SDL_LockSurface(source); }
 
-	std::ofstream file(filename.c_str(), std::ios::binary);
-	file.write(reinterpret_cast<char*> (&png_bytes[0]), png_bytes.size());
-	file.close();
+	for(int y = 0; y < source->h; y++)
+	{
+		memcpy((pixels.data() + (y * source->w)), ((u8*)source->pixels + (y * source->pitch)), (source->w * 4));
+	}
 
 	//Unlock SDL_Surface
 	if(SDL_MUSTLOCK(source)) { SDL_UnlockSurface(source); }
-
-	return true;
 }
 
 /****** Returns the minimum RGB component of a color ******/
@@ -542,81 +585,109 @@ u32 reflect(u32 src, u8 bit)
 	return out;
 }
 
-/****** Sets up the CRC lookup table ******/
+/****** Sets up the CRC lookup tables ******/
 void init_crc32_table()
 {
 	for(int x = 0; x < 256; x++)
 	{
-		crc32_table[x] = (reflect(x, 7) << 24);
+		crc32_table[0][x] = (reflect(x, 7) << 24);
 
 		for(int y = 0; y < 8; y++)
 		{
-			crc32_table[x] = (crc32_table[x] << 1) ^ (crc32_table[x] & (1 << 31) ? poly32 : 0);
+			crc32_table[0][x] = (crc32_table[0][x] << 1) ^ (crc32_table[0][x] & (1 << 31) ? poly32 : 0);
 		}
 
-		crc32_table[x] = reflect(crc32_table[x], 31);
+		crc32_table[0][x] = reflect(crc32_table[0][x], 31);
+	}
+
+	//Each slice is the previous one run through another zero byte
+	for(int slice = 1; slice < 8; slice++)
+	{
+		for(int x = 0; x < 256; x++)
+		{
+			u32 prev = crc32_table[slice - 1][x];
+			crc32_table[slice][x] = (prev >> 8) ^ crc32_table[0][prev & 0xFF];
+		}
 	}
 }
 
 /****** Return CRC32 for given data ******/
-u32 get_crc32(u8* data, u32 length)
+u32 get_crc32(const u8* data, u32 length)
+{
+	return update_crc32(0, data, length);
+}
+
+/****** Continues a CRC32 with more data - Start with 0, the result of each call can be fed into the next ******/
+u32 update_crc32(u32 crc32, const u8* data, u64 length)
 {
-	init_crc32_table();
+	//Build the tables only once, several cores may load ROMs at the same time
+	static std::once_flag table_init;
+	std::call_once(table_init, init_crc32_table);
+
+	crc32 ^= 0xFFFFFFFF;
+
+	//Slice-by-8 - Process 8 bytes per step with independent table lookups
+	while(length >= 8)
+	{
+		u32 low = crc32 ^ (data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+		u32 high = (data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24));
 
-	u32 crc32 = 0xFFFFFFFF;
+		crc32 = crc32_table[7][low & 0xFF] ^ crc32_table[6][(low >> 8) & 0xFF] ^ crc32_table[5][(low >> 16) & 0xFF] ^ crc32_table[4][low >> 24]
+		^ crc32_table[3][high & 0xFF] ^ crc32_table[2][(high >> 8) & 0xFF] ^ crc32_table[1][(high >> 16) & 0xFF] ^ crc32_table[0][high >> 24];
 
-	for(int x = 0; x < length; x++)
+		data += 8;
+		length -= 8;
+	}
+
+	//Finish any leftover bytes one at a time
+	while(length--)
 	{
-		crc32 = (crc32 >> 8) ^ crc32_table[(crc32 & 0xFF) ^ (*data)];
+		crc32 = (crc32 >> 8) ^ crc32_table[0][(crc32 & 0xFF) ^ (*data)];
 		data++;
 	}
 
 	return (crc32 ^ 0xFFFFFFFF);
 }
 
-/****** Returns the CRC32 of a given file ******/
-u32 get_file_crc32(std::string filename)
+/****** Gets the CRC32 of a given file, returns false if the file can't be read ******/
+bool get_file_crc32(std::string filename, u32 &result)
 {
-	u32 result = 0;
-	std::vector<u8> file_data;
-	std::ifstream file(filename.c_str(), std::ios::binary);
+	mapped_file file;
 
-	if(!file.is_open()) 
+	if(!file.open(filename))
 	{
 		std::cout<<"Could not get the CRC32 of the file " << filename << "\n";
 		return false;
 	}
 
-	//Get the file size
-	file.seekg(0, file.end);
-	u32 file_size = file.tellg();
-	file.seekg(0, file.beg);
-
-	file_data.resize(file_size);
-	u8* ex_mem = &file_data[0];
-	file.read((char*)ex_mem, file_size);
-
-	result = get_crc32(ex_mem, file_size);
-	return result;
+	result = update_crc32(0, file.data, file.size);
+	return true;
 }
 
 /****** Return Addler32 for given data ******/
-u32 get_addler32(u8* data, u32 length)
+u32 get_addler32(const u8* data, u32 length)
 {
-	u16 a = 1;
-	u16 b = 0;
+	u32 a = 1;
+	u32 b = 0;
 
-	for(int x = 0; x < length; x++)
+	while(length)
 	{
-		a += (*data);
-		b += a;
-	}
+		//Largest number of bytes that can be summed before b might overflow
+		u32 block_length = (length < 5552) ? length : 5552;
+		length -= block_length;
 
-	a = a % 65521;
-	b = b % 65521;
+		for(u32 x = 0; x < block_length; x++)
+		{
+			a += data[x];
+			b += a;
+		}
 
-	u32 result = (b *= 65536) + a;
-	return result;
+		data += block_length;
+		a = a % 65521;
+		b = b % 65521;
+	}
+
+	return (b << 16) | a;
 }
 
 /****** Switches endianness of a 32-bit integer ******/
@@ -1101,4 +1172,183 @@ u32 bswap(u32 input)
 	return result;
 }
 
+/****** State writer Constructor ******/
+state_writer::state_writer(std::vector<u8> &buffer) : state_buffer(buffer) { }
+
+/****** Appends data to a save state buffer ******/
+void state_writer::write(const void* data, u32 length)
+{
+	const u8* src = (const u8*)data;
+	state_buffer.insert(state_buffer.end(), src, src + length);
+}
+
+/****** State reader Constructor ******/
+state_reader::state_reader(const u8* buffer, u32 length)
+{
+	state_buffer = buffer;
+	state_length = length;
+	state_offset = 0;
+	state_error = (buffer == NULL);
+}
+
+/****** Reads data from a save state buffer ******/
+void state_reader::read(void* data, u32 length)
+{
+	//Stop reading once the buffer is exhausted, leave remaining data untouched
+	if((state_error) || (length > (state_length - state_offset)))
+	{
+		state_error = true;
+		return;
+	}
+
+	memcpy(data, (state_buffer + state_offset), length);
+	state_offset += length;
+}
+
+/****** Returns true if all reads from a save state buffer were in bounds ******/
+bool state_reader::good() { return !state_error; }
+
+/****** Mapped File Constructor ******/
+mapped_file::mapped_file()
+{
+	data = NULL;
+	size = 0;
+	map_handle = NULL;
+}
+
+/****** Mapped File Destructor ******/
+mapped_file::~mapped_file()
+{
+	close();
+}
+
+/****** Maps a file into memory - Contents stay valid until close() ******/
+bool mapped_file::open(std::string filename)
+{
+	close();
+
+	//Directories and other special files can't be mapped or read
+	std::error_code error;
+	if(!std::filesystem::is_regular_file(std::filesystem::path(filename), error)) { return false; }
+
+	#ifdef _WIN32
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if(file != INVALID_HANDLE_VALUE)
+	{
+		LARGE_INTEGER file_size;
+
+		if(GetFileSizeEx(file, &file_size))
+		{
+			size = file_size.QuadPart;
+
+			//Empty files can't be mapped, but there's nothing to read anyway
+			if(size == 0)
+			{
+				CloseHandle(file);
+				return true;
+			}
+
+			HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+			if(mapping != NULL)
+			{
+				data = (const u8*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+				if(data != NULL)
+				{
+					map_handle = mapping;
+					CloseHandle(file);
+					return true;
+				}
+
+				CloseHandle(mapping);
+			}
+		}
+
+		CloseHandle(file);
+	}
+
+	#else
+
+	int file = ::open(filename.c_str(), O_RDONLY);
+
+	if(file != -1)
+	{
+		struct stat file_info;
+
+		if(fstat(file, &file_info) == 0)
+		{
+			size = file_info.st_size;
+
+			//Empty files can't be mapped, but there's nothing to read anyway
+			if(size == 0)
+			{
+				::close(file);
+				return true;
+			}
+
+			void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+			if(mapping != MAP_FAILED)
+			{
+				data = (const u8*)mapping;
+				map_handle = mapping;
+				::close(file);
+				return true;
+			}
+		}
+
+		::close(file);
+	}
+
+	#endif
+
+	//Could not map the file, read it normally instead
+	data = NULL;
+	size = 0;
+
+	std::ifstream file_stream(filename.c_str(), std::ios::binary);
+	if(!file_stream.is_open()) { return false; }
+
+	file_stream.seekg(0, file_stream.end);
+	u64 file_size = file_stream.tellg();
+	file_stream.seekg(0, file_stream.beg);
+
+	fallback_buffer.resize(file_size);
+	file_stream.read((char*)fallback_buffer.data(), file_size);
+
+	if(!file_stream)
+	{
+		fallback_buffer.clear();
+		return false;
+	}
+
+	data = fallback_buffer.data();
+	size = file_size;
+
+	return true;
+}
+
+/****** Unmaps the file ******/
+void mapped_file::close()
+{
+	if(map_handle != NULL)
+	{
+		#ifdef _WIN32
+		UnmapViewOfFile(data);
+		CloseHandle((HANDLE)map_handle);
+		#else
+		munmap(map_handle, size);
+		#endif
+	}
+
+	std::vector<u8>().swap(fallback_buffer);
+
+	data = NULL;
+	size = 0;
+	map_handle = NULL;
+}
+
 } //Namespace
@@ -13,6 +13,8 @@
 
 #include <string>
 #include <vector>
+#include <cstdlib>
+#include <new>
 
 #include <SDL2/SDL.h>
 
@@ -47,7 +49,76 @@ namespace util
 		u32 color;
 	};
 
+	//Appends save state data to a contiguous buffer in memory
+	struct state_writer
+	{
+		state_writer(std::vector<u8> &buffer);
+		void write(const void* data, u32 length);
+
+		std::vector<u8> &state_buffer;
+	};
+
+	//Reads save state data sequentially from a contiguous buffer in memory
+	struct state_reader
+	{
+		state_reader(const u8* buffer, u32 length);
+		void read(void* data, u32 length);
+		bool good();
+
+		const u8* state_buffer;
+		u32 state_length;
+		u32 state_offset;
+		bool state_error;
+	};
+
+	//Maps a whole file read-only into memory, falling back to an ordinary read if the OS can't map it
+	struct mapped_file
+	{
+		mapped_file();
+		~mapped_file();
+
+		mapped_file(const mapped_file &other) = delete;
+		mapped_file& operator=(const mapped_file &other) = delete;
+
+		bool open(std::string filename);
+		void close();
+
+		const u8* data;
+		u64 size;
+
+		void* map_handle;
+		std::vector<u8> fallback_buffer;
+	};
+
+	//Allocates large, mostly unused buffers (e.g. 256MB memory maps) as zeroed memory from calloc
+	//Default construction leaves that memory untouched, so the OS only commits pages that are actually used
+	template <typename T>
+	struct zero_page_allocator
+	{
+		typedef T value_type;
+
+		zero_page_allocator() { }
+		template <typename U> zero_page_allocator(const zero_page_allocator<U> &other) { }
+
+		T* allocate(size_t count)
+		{
+			T* data = (T*)calloc(count, sizeof(T));
+			if(data == NULL) { throw std::bad_alloc(); }
+			return data;
+		}
+
+		void deallocate(T* data, size_t count) { free(data); }
+
+		template <typename U> void construct(U* data) { }
+		template <typename U, typename... Args> void construct(U* data, Args&&... args) { new((void*)data) U(args...); }
+
+		template <typename U> bool operator==(const zero_page_allocator<U> &other) const { return true; }
+		template <typename U> bool operator!=(const zero_page_allocator<U> &other) const { return false; }
+	};
+
+	bool save_png(const u32* pixels, u32 width, u32 height, std::string filename);
 	bool save_png(SDL_Surface* source, std::string filename);
+	void copy_surface_pixels(SDL_Surface* source, std::vector<u32> &pixels);
 
 	u8 rgb_min(u32 color);
 	u8 rgb_max(u32 color);
@@ -69,10 +140,11 @@ namespace util
 
 	u32 reflect(u32 src, u8 bit);
 	void init_crc32_table();
-	u32 get_crc32(u8* data, u32 length);
-	u32 get_file_crc32(std::string filename);
+	u32 get_crc32(const u8* data, u32 length);
+	u32 update_crc32(u32 crc32, const u8* data, u64 length);
+	bool get_file_crc32(std::string filename, u32 &result);
 
-	u32 get_addler32(u8* data, u32 length);
+	u32 get_addler32(const u8* data, u32 length);
 
 	u32 switch_endian32(u32 input);
 
@@ -106,7 +178,7 @@ namespace util
 
 	SDL_Surface* load_icon(std::string filename);
 
-	extern u32 crc32_table[256];
+	extern u32 crc32_table[8][256];
 	extern u32 poly32;
 
 	extern std::string utc_day[7];
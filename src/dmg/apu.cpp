@@ -10,12 +10,17 @@
 // Generates and mixes samples for the GB's 4 sound channels 
 
 #include <cmath>
+#include <cstring>
 
 #include "apu.h"
+#include "common/util.h"
 
 /****** APU Constructor ******/
 DMG_APU::DMG_APU()
 {
+	//Written to save states as one block, padding and all
+	memset(&apu_stat, 0, sizeof(apu_stat));
+
 	reset();
 }
 
@@ -23,6 +28,12 @@ DMG_APU::DMG_APU()
 DMG_APU::~DMG_APU()
 {
 	SDL_CloseAudio();
+
+	if((output.underruns) || (output.overruns))
+	{
+		std::cout<<"APU::Audio buffer underruns - " << std::dec << output.underruns << " :: overruns - " << output.overruns << "\n";
+	}
+
 	std::cout<<"APU::Shutdown\n";
 }
 
@@ -31,6 +42,9 @@ void DMG_APU::reset()
 {
 	SDL_CloseAudio();
 
+	last_frame = 0;
+	frame_samples = 0;
+
 	apu_stat.sound_on = false;
 	apu_stat.stereo = false;
 
@@ -121,6 +135,10 @@ bool DMG_APU::init()
 		apu_stat.channel_master_volume = (config::volume >> 2);
 		apu_stat.sample_rate *= 4;
 
+		//Mix once per frame, keep room for a few callbacks' worth of samples
+		frame_samples = config::sample_rate / 60;
+		output.resize((desired_spec.samples * desired_spec.channels * 4), desired_spec.channels, desired_spec.freq);
+
 		SDL_PauseAudio(0);
 		std::cout<<"APU::Initialized\n";
 		return true;
@@ -128,19 +146,12 @@ bool DMG_APU::init()
 }
 
 /****** Read APU data from save state ******/
-bool DMG_APU::apu_read(u32 offset, std::string filename)
+bool DMG_APU::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize APU data from file stream
-	file.read((char*)&apu_stat, sizeof(apu_stat));
-
-	file.close();
+	state.read(&apu_stat, sizeof(apu_stat));
 
 	//Sanitize APU data
 	if(apu_stat.noise_prescalar == 0) { apu_stat.noise_prescalar = 1; }
@@ -161,20 +172,17 @@ bool DMG_APU::apu_read(u32 offset, std::string filename)
 	apu_stat.channel[2].raw_frequency &= 0x7FF;
 	apu_stat.channel[3].raw_frequency &= 0x7FF;
 
-	return true;
+	return state.good();
 }
 
 /****** Write APU data to save state ******/
-bool DMG_APU::apu_write(std::string filename)
+bool DMG_APU::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize APU data to file stream
-	file.write((char*)&apu_stat, sizeof(apu_stat));
+	state.write(&apu_stat, sizeof(apu_stat));
 
-	file.close();
 	return true;
 }
 
@@ -581,28 +589,28 @@ void DMG_APU::generate_channel_4_samples(s16* stream, int length)
 	}
 }
 
-/****** SDL Audio Callback ******/ 
-void dmg_audio_callback(void* _apu, u8 *_stream, int _length)
+/****** Mixes one frame's worth of samples for the SDL callback ******/
+void DMG_APU::buffer_frame()
 {
-	s16* stream = (s16*) _stream;
-	int length = _length/2;
-	length *= 4;
+	if(frame_samples == 0) { return; }
 
-	//Set correct length for stereo
-	if(config::use_stereo) { length /= 2; }
+	//Channels run at 4x the output rate
+	u32 length = frame_samples * 4;
+	u32 out_length = (config::use_stereo) ? (frame_samples * 2) : frame_samples;
 
-	std::vector<s16> channel_1_stream(length);
-	std::vector<s16> channel_2_stream(length);
-	std::vector<s16> channel_3_stream(length);
-	std::vector<s16> channel_4_stream(length);
+	//Streams only grow if the sample rate changes
+	if(mix_stream.size() != out_length)
+	{
+		for(u32 x = 0; x < 4; x++) { channel_stream[x].resize(length); }
+		mix_stream.resize(out_length);
+	}
 
-	DMG_APU* apu_link = (DMG_APU*) _apu;
-	apu_link->generate_channel_1_samples(&channel_1_stream[0], length);
-	apu_link->generate_channel_2_samples(&channel_2_stream[0], length);
-	apu_link->generate_channel_3_samples(&channel_3_stream[0], length);
-	apu_link->generate_channel_4_samples(&channel_4_stream[0], length);
+	generate_channel_1_samples(&channel_stream[0][0], length);
+	generate_channel_2_samples(&channel_stream[1][0], length);
+	generate_channel_3_samples(&channel_stream[2][0], length);
+	generate_channel_4_samples(&channel_stream[3][0], length);
 
-	double volume_ratio = apu_link->apu_stat.channel_master_volume / 128.0;
+	double volume_ratio = apu_stat.channel_master_volume / 128.0;
 
 	//Custom software mixing
 	for(u32 x = 0; x < length; x++)
@@ -610,12 +618,12 @@ void dmg_audio_callback(void* _apu, u8 *_stream, int _length)
 		//Mono audio
 		if(!config::use_stereo)
 		{
-			s32 out_sample = channel_1_stream[x] + channel_2_stream[x] + channel_3_stream[x] + channel_4_stream[x];
+			s32 out_sample = channel_stream[0][x] + channel_stream[1][x] + channel_stream[2][x] + channel_stream[3][x];
 			out_sample *= volume_ratio;
-			out_sample *= apu_link->apu_stat.channel_left_volume;
+			out_sample *= apu_stat.channel_left_volume;
 			out_sample /= 4;
 
-			stream[x / 4] = out_sample;
+			mix_stream[x / 4] = out_sample;
 		}
 
 		//Stereo audio
@@ -624,30 +632,39 @@ void dmg_audio_callback(void* _apu, u8 *_stream, int _length)
 			u32 index = (x / 4) * 2;
 
 			//Left sample
-			s32 ch1 = apu_link->apu_stat.channel[0].so1_output ? channel_1_stream[x] : -32768;
-			s32 ch2 = apu_link->apu_stat.channel[1].so1_output ? channel_2_stream[x] : -32768;
-			s32 ch3 = apu_link->apu_stat.channel[2].so1_output ? channel_3_stream[x] : -32768;
-			s32 ch4 = apu_link->apu_stat.channel[3].so1_output ? channel_4_stream[x] : -32768;
+			s32 ch1 = apu_stat.channel[0].so1_output ? channel_stream[0][x] : -32768;
+			s32 ch2 = apu_stat.channel[1].so1_output ? channel_stream[1][x] : -32768;
+			s32 ch3 = apu_stat.channel[2].so1_output ? channel_stream[2][x] : -32768;
+			s32 ch4 = apu_stat.channel[3].so1_output ? channel_stream[3][x] : -32768;
 
 			s32 out_sample = ch1 + ch2 + ch3 + ch4;
 			out_sample *= volume_ratio;
-			out_sample *= apu_link->apu_stat.channel_left_volume;
+			out_sample *= apu_stat.channel_left_volume;
 			out_sample /= 4;
 
-			stream[index] = out_sample;
+			mix_stream[index] = out_sample;
 
 			//Right sample
-			ch1 = apu_link->apu_stat.channel[0].so2_output ? channel_1_stream[x] : -32768;
-			ch2 = apu_link->apu_stat.channel[1].so2_output ? channel_2_stream[x] : -32768;
-			ch3 = apu_link->apu_stat.channel[2].so2_output ? channel_3_stream[x] : -32768;
-			ch4 = apu_link->apu_stat.channel[3].so2_output ? channel_4_stream[x] : -32768;
+			ch1 = apu_stat.channel[0].so2_output ? channel_stream[0][x] : -32768;
+			ch2 = apu_stat.channel[1].so2_output ? channel_stream[1][x] : -32768;
+			ch3 = apu_stat.channel[2].so2_output ? channel_stream[2][x] : -32768;
+			ch4 = apu_stat.channel[3].so2_output ? channel_stream[3][x] : -32768;
 
 			out_sample = ch1 + ch2 + ch3 + ch4;
 			out_sample *= volume_ratio;
-			out_sample *= apu_link->apu_stat.channel_right_volume;
+			out_sample *= apu_stat.channel_right_volume;
 			out_sample /= 4;
 
-			stream[index + 1] = out_sample;
+			mix_stream[index + 1] = out_sample;
 		}
-	} 
+	}
+
+	output.write(&mix_stream[0], out_length);
+}
+
+/****** SDL Audio Callback ******/ 
+void dmg_audio_callback(void* _apu, u8 *_stream, int _length)
+{
+	DMG_APU* apu_link = (DMG_APU*) _apu;
+	apu_link->output.read((s16*) _stream, (_length / 2));
 }
@@ -15,6 +15,7 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_audio.h>
 #include "mmu.h"
+#include "common/audio_buffer.h"
 
 class DMG_APU
 {
@@ -27,6 +28,13 @@ class DMG_APU
 
 	SDL_AudioSpec desired_spec;
 
+	//Mixed samples waiting for the SDL callback
+	audio_buffer output;
+
+	//Last frame mixed and how many output frames each one produces
+	u32 last_frame;
+	u32 frame_samples;
+
 	DMG_APU();
 	~DMG_APU();
 
@@ -34,14 +42,20 @@ class DMG_APU
 	void reset();
 
 	//Serialize data for save state loading/saving
-	bool apu_read(u32 offset, std::string filename);
-	bool apu_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
 	u32 size();
 
 	void generate_channel_1_samples(s16* stream, int length);
 	void generate_channel_2_samples(s16* stream, int length);
 	void generate_channel_3_samples(s16* stream, int length);
 	void generate_channel_4_samples(s16* stream, int length);
+
+	void buffer_frame();
+
+	//Preallocated per-channel streams for mixing
+	std::vector<s16> channel_stream[4];
+	std::vector<s16> mix_stream;
 }; 
 
 /****** SDL Audio Callback ******/ 
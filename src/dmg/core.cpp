@@ -15,6 +15,8 @@
 #include <sstream>
 
 #include "common/util.h"
+#include "common/state_file.h"
+#include "common/profiler.h"
 
 #include "core.h"
 
@@ -32,6 +34,15 @@ DMG_core::DMG_core()
 	core_cpu.controllers.audio.mem = &core_mmu;
 	core_mmu.set_apu_data(&core_cpu.controllers.audio.apu_stat);
 
+	//Link LCD and APU
+	core_cpu.controllers.video.audio_output = &core_cpu.controllers.audio.output;
+
+	//Link APU and A/V recorder
+	core_cpu.controllers.audio.output.recorder = &av_capture;
+
+	//Record at the system's real refresh rate
+	av_capture.set_frame_rate(4194304, 70224);
+
 	//Link SIO and MMU
 	core_cpu.controllers.serial_io.mem = &core_mmu;
 	core_mmu.set_sio_data(&core_cpu.controllers.serial_io.sio_stat);
@@ -59,6 +70,9 @@ DMG_core::DMG_core()
 	config::osd_count = 180;
 }
 
+/****** Core Destructor ******/
+DMG_core::~DMG_core() { }
+
 /****** Start the core ******/
 void DMG_core::start()
 {
@@ -84,6 +98,10 @@ void DMG_core::start()
 
 	//Initialize the GamePad
 	core_pad.init();
+
+	//Clear rewind history and run-ahead state
+	rewind_data.reset();
+	run_ahead_data.reset();
 }
 
 /****** Stop the core ******/
@@ -97,8 +115,22 @@ void DMG_core::stop()
 /****** Shutdown core's components ******/
 void DMG_core::shutdown()
 {
-	core_mmu.DMG_MMU::~DMG_MMU();
-	core_cpu.Z80::~Z80();
+	//Finish any movie being recorded
+	movie_data.stop();
+
+	//Finish any background save write before the MMU writes the save on its own
+	save_sync.stop();
+
+	//Finish writing any queued screenshots
+	screenshots.stop();
+
+	//Finish any audio/video recording
+	av_capture.stop();
+
+	//Free rewind history and run-ahead state
+	rewind_data.reset();
+	run_ahead_data.reset();
+
 	config::gba_enhance = false;
 }
 
@@ -107,6 +139,7 @@ void DMG_core::reset()
 {
 	bool can_reset = true;
 
+	save_sync.reset();
 	core_cpu.reset();
 	core_cpu.controllers.video.reset();
 	core_cpu.controllers.audio.reset();
@@ -122,6 +155,12 @@ void DMG_core::reset()
 	//Link APU and MMU
 	core_cpu.controllers.audio.mem = &core_mmu;
 
+	//Link LCD and APU
+	core_cpu.controllers.video.audio_output = &core_cpu.controllers.audio.output;
+
+	//Link APU and A/V recorder
+	core_cpu.controllers.audio.output.recorder = &av_capture;
+
 	//Link SIO and MMU
 	core_cpu.controllers.serial_io.mem = &core_mmu;
 
@@ -147,8 +186,6 @@ void DMG_core::load_state(u8 slot)
 	std::string state_file = config::rom_file + ".ss";
 	state_file += id;
 
-	u32 offset = 0;
-
 	//Check if save state is accessible
 	std::ifstream test(state_file.c_str());
 	
@@ -159,20 +196,11 @@ void DMG_core::load_state(u8 slot)
 		return;
 	}
 
-	//Offset 0, size 43
-	if(!core_cpu.cpu_read(offset, state_file)) { return; }
-	offset += core_cpu.size();	
-
-	//Offset 43, size 213047
-	if(!core_mmu.mmu_read(offset, state_file)) { return; }
-	offset += core_mmu.size();
-
-	//Offset 213090, size 320
-	if(!core_cpu.controllers.audio.apu_read(offset, state_file)) { return; }
-	offset += core_cpu.controllers.audio.size();
-
-	//Offset 213410
-	if(!core_cpu.controllers.video.lcd_read(offset, state_file)) { return; }
+	if(!load_state_file(this, state_file))
+	{
+		std::cout<<"GBE::Error - Could not load save state " << state_file << "\n";
+		return;
+	}
 
 	std::cout<<"GBE::Loaded state " << state_file << "\n";
 
@@ -189,10 +217,7 @@ void DMG_core::save_state(u8 slot)
 	std::string state_file = config::rom_file + ".ss";
 	state_file += id;
 
-	if(!core_cpu.cpu_write(state_file)) { return; }
-	if(!core_mmu.mmu_write(state_file)) { return; }
-	if(!core_cpu.controllers.audio.apu_write(state_file)) { return; }
-	if(!core_cpu.controllers.video.lcd_write(state_file)) { return; }
+	if(!save_state_file(this, state_file)) { return; }
 
 	std::cout<<"GBE::Saved state " << state_file << "\n";
 
@@ -201,6 +226,54 @@ void DMG_core::save_state(u8 slot)
 	config::osd_count = 180;
 }
 
+/****** Serializes the core into a contiguous save state buffer ******/
+bool DMG_core::serialize(std::vector<u8> &buffer)
+{
+	buffer.clear();
+
+	if(!core_cpu.serialize(buffer)) { return false; }
+	if(!core_mmu.serialize(buffer)) { return false; }
+	if(!core_cpu.controllers.audio.serialize(buffer)) { return false; }
+	if(!core_cpu.controllers.video.serialize(buffer)) { return false; }
+
+	return true;
+}
+
+/****** Restores the core from a contiguous save state buffer ******/
+bool DMG_core::deserialize(const u8* buffer, u32 length)
+{
+	u32 offset = 0;
+
+	//Every component has a fixed size, so reject anything that doesn't match before touching the core
+	u64 total_size = u64(core_cpu.size()) + core_mmu.size() + core_cpu.controllers.audio.size() + core_cpu.controllers.video.size();
+	if(total_size != length) { return false; }
+
+	if(!core_cpu.deserialize(buffer, length)) { return false; }
+	offset += core_cpu.size();
+
+	if((offset > length) || (!core_mmu.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_mmu.size();
+
+	if((offset > length) || (!core_cpu.controllers.audio.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_cpu.controllers.audio.size();
+
+	if((offset > length) || (!core_cpu.controllers.video.deserialize((buffer + offset), (length - offset)))) { return false; }
+
+	return true;
+}
+
+/****** Lists the components of a save state in order, returns the system's tag ******/
+u32 DMG_core::get_state_sections(std::vector<state_section> &sections)
+{
+	sections.clear();
+	sections.push_back({ GBE_STATE_TAG('C', 'P', 'U', ' '), core_cpu.size() });
+	sections.push_back({ GBE_STATE_TAG('M', 'M', 'U', ' '), core_mmu.size() });
+	sections.push_back({ GBE_STATE_TAG('A', 'P', 'U', ' '), core_cpu.controllers.audio.size() });
+	sections.push_back({ GBE_STATE_TAG('L', 'C', 'D', ' '), core_cpu.controllers.video.size() });
+
+	return GBE_STATE_TAG('D', 'M', 'G', ' ');
+}
+
 /****** Run the core in a loop until exit ******/
 void DMG_core::run_core()
 {
@@ -223,7 +296,9 @@ void DMG_core::run_core()
 				|| (event.type == SDL_JOYAXISMOTION) || (event.type == SDL_JOYHATMOTION)
 				|| (event.type == SDL_CONTROLLERSENSORUPDATE))
 				{
+					movie_data.begin_live_input(this);
 					core_pad.handle_input(event);
+					movie_data.end_live_input(this);
 					handle_hotkey(event);
 
 					//Trigger Joypad Interrupt if necessary
@@ -302,6 +377,8 @@ void DMG_core::run_core()
 
 			if(db_unit.debug_mode) { debug_step(); }
 	
+			PROFILER_ENTER(PROF_CPU);
+
 			//Halt CPU if necessary
 			if(core_cpu.halt == true)
 			{
@@ -328,9 +405,26 @@ void DMG_core::run_core()
 				core_cpu.exec_op(core_cpu.opcode);
 			}
 
+			PROFILER_CYCLES(PROF_CPU, core_cpu.cycles);
+			PROFILER_LEAVE();
+
 			//Update LCD
+			PROFILER_ENTER(PROF_LCD);
 			if(core_cpu.double_speed) { core_cpu.controllers.video.step(core_cpu.cycles >> 1); }
 			else { core_cpu.controllers.video.step(core_cpu.cycles); }
+			PROFILER_CYCLES(PROF_LCD, core_cpu.cycles);
+			PROFILER_LEAVE();
+
+			//Mix audio once per frame, skip frames run-ahead throws away
+			if((core_cpu.controllers.video.realtime_frame) && (core_cpu.controllers.audio.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				PROFILER_ENTER(PROF_APU);
+				core_cpu.controllers.audio.last_frame = core_cpu.controllers.video.frame_count;
+				core_cpu.controllers.audio.buffer_frame();
+				PROFILER_LEAVE();
+			}
+
+			PROFILER_ENTER(PROF_TIMERS);
 
 			//Update DIV timer - Every 4 M clocks
 			core_cpu.div_counter += core_cpu.cycles;
@@ -374,9 +468,14 @@ void DMG_core::run_core()
 				}
 			}
 
+			PROFILER_CYCLES(PROF_TIMERS, core_cpu.cycles);
+			PROFILER_LEAVE();
+
 			//Update serial input-output operations
 			if(core_cpu.controllers.serial_io.sio_stat.shifts_left != 0)
 			{
+				PROFILER_ENTER(PROF_SIO);
+
 				core_cpu.controllers.serial_io.sio_stat.shift_counter += (core_cpu.double_speed) ? (core_cpu.cycles >> 1) : core_cpu.cycles;
 
 				if((core_cpu.controllers.serial_io.barcode_boy.send_data) && ((core_mmu.memory_map[REG_SC] & 0x80) == 0))
@@ -510,6 +609,40 @@ void DMG_core::run_core()
 				{
 					core_cpu.controllers.serial_io.singer_izek_data_process();
 				}
+
+				PROFILER_LEAVE();
+			}
+
+			//Record or play back input movies once per frame
+			if((movie_data.active) && (!run_ahead_data.active) && (movie_data.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				movie_data.update(this, core_cpu.controllers.video.frame_count);
+			}
+
+			//Write changed battery save data in the background every few seconds
+			if((config::save_flush_interval) && (!run_ahead_data.active) && (save_sync.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				save_sync.update(this, core_cpu.controllers.video.frame_count);
+			}
+
+			//Record presented frames and mixed audio
+			if((av_capture.active) && (!run_ahead_data.active) && (av_capture.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				av_capture.update(core_cpu.controllers.video.screen_buffer, config::sys_width, core_cpu.controllers.video.frame_count);
+			}
+
+			//Capture or restore rewind snapshots once per frame, except while a movie is active
+			if((config::rewind_buffer_size) && (!run_ahead_data.active) && (!movie_data.active) && (rewind_data.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				rewind_data.update(this, core_cpu.controllers.video.frame_count);
+			}
+
+			//Run ahead of the real frame to hide input lag, audio from frames ahead is never recorded
+			if((!run_ahead_data.active) && (run_ahead_data.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				av_capture.hold_audio = true;
+				run_ahead_data.update(this, core_cpu.controllers.video.frame_count, core_cpu.controllers.video.present_frame, core_cpu.controllers.video.realtime_frame);
+				av_capture.hold_audio = false;
 			}
 		}
 
@@ -583,6 +716,8 @@ void DMG_core::step()
 		//Handle Interrupts
 		core_cpu.handle_interrupts();
 	
+		PROFILER_ENTER(PROF_CPU);
+
 		//Halt CPU if necessary
 		if(core_cpu.halt == true)
 		{
@@ -609,9 +744,26 @@ void DMG_core::step()
 			core_cpu.exec_op(core_cpu.opcode);
 		}
 
+		PROFILER_CYCLES(PROF_CPU, core_cpu.cycles);
+		PROFILER_LEAVE();
+
 		//Update LCD
+		PROFILER_ENTER(PROF_LCD);
 		if(core_cpu.double_speed) { core_cpu.controllers.video.step(core_cpu.cycles >> 1); }
 		else { core_cpu.controllers.video.step(core_cpu.cycles); }
+		PROFILER_CYCLES(PROF_LCD, core_cpu.cycles);
+		PROFILER_LEAVE();
+
+		//Mix audio once per frame, skip frames run-ahead throws away
+		if((core_cpu.controllers.video.realtime_frame) && (core_cpu.controllers.audio.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			PROFILER_ENTER(PROF_APU);
+			core_cpu.controllers.audio.last_frame = core_cpu.controllers.video.frame_count;
+			core_cpu.controllers.audio.buffer_frame();
+			PROFILER_LEAVE();
+		}
+
+		PROFILER_ENTER(PROF_TIMERS);
 
 		//Update DIV timer - Every 4 M clocks
 		core_cpu.div_counter += core_cpu.cycles;
@@ -649,9 +801,14 @@ void DMG_core::step()
 			}
 		}
 
+		PROFILER_CYCLES(PROF_TIMERS, core_cpu.cycles);
+		PROFILER_LEAVE();
+
 		//Update serial input-output operations
 		if(core_cpu.controllers.serial_io.sio_stat.shifts_left != 0)
 		{
+			PROFILER_ENTER(PROF_SIO);
+
 			core_cpu.controllers.serial_io.sio_stat.shift_counter += (core_cpu.double_speed) ? (core_cpu.cycles >> 1) : core_cpu.cycles;;
 
 			if((core_cpu.controllers.serial_io.barcode_boy.send_data) && ((core_mmu.memory_map[REG_SC] & 0x80) == 0))
@@ -777,6 +934,40 @@ void DMG_core::step()
 					}
 				}
 			}
+
+			PROFILER_LEAVE();
+		}
+
+		//Record or play back input movies once per frame
+		if((movie_data.active) && (!run_ahead_data.active) && (movie_data.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			movie_data.update(this, core_cpu.controllers.video.frame_count);
+		}
+
+		//Write changed battery save data in the background every few seconds
+		if((config::save_flush_interval) && (!run_ahead_data.active) && (save_sync.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			save_sync.update(this, core_cpu.controllers.video.frame_count);
+		}
+
+		//Record presented frames and mixed audio
+		if((av_capture.active) && (!run_ahead_data.active) && (av_capture.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			av_capture.update(core_cpu.controllers.video.screen_buffer, config::sys_width, core_cpu.controllers.video.frame_count);
+		}
+
+		//Capture or restore rewind snapshots once per frame, except while a movie is active
+		if((config::rewind_buffer_size) && (!run_ahead_data.active) && (!movie_data.active) && (rewind_data.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			rewind_data.update(this, core_cpu.controllers.video.frame_count);
+		}
+
+		//Run ahead of the real frame to hide input lag, audio from frames ahead is never recorded
+		if((!run_ahead_data.active) && (run_ahead_data.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			av_capture.hold_audio = true;
+			run_ahead_data.update(this, core_cpu.controllers.video.frame_count, core_cpu.controllers.video.present_frame, core_cpu.controllers.video.realtime_frame);
+			av_capture.hold_audio = false;
 		}
 	}
 }
@@ -821,6 +1012,17 @@ void DMG_core::handle_hotkey(SDL_Event& event)
 		load_state(0);
 	}
 
+	//Rewind while held
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == config::hotkey_rewind))
+	{
+		rewind_data.rewinding = (config::rewind_buffer_size != 0);
+	}
+
+	else if((event.type == SDL_KEYUP) && (event.key.keysym.sym == config::hotkey_rewind))
+	{
+		rewind_data.rewinding = false;
+	}
+
 	//Pause and wait for netplay connection on F5
 	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_F5))
 	{
@@ -859,9 +1061,9 @@ void DMG_core::handle_hotkey(SDL_Event& event)
 		//Append random number to screenshot name
 		srand(SDL_GetTicks());
 		save_stream << rand() % 1024 << rand() % 1024 << rand() % 1024;
-		save_name += save_stream.str() + ".bmp";
+		save_name += save_stream.str() + ".png";
 	
-		SDL_SaveBMP(core_cpu.controllers.video.final_screen, save_name.c_str());
+		screenshots.save(core_cpu.controllers.video.final_screen, save_name);
 
 		//OSD
 		config::osd_message = "SAVED SCREENSHOT";
@@ -933,6 +1135,7 @@ void DMG_core::handle_hotkey(SDL_Event& event)
 				config::pause_emu = false;
 				SDL_PauseAudio(0);
 				std::cout<<"EMU::Unpaused\n";
+				frame_pacer::notify_resume();
 			}
 		}
 	}
@@ -1058,6 +1261,9 @@ void DMG_core::handle_hotkey(int input, bool pressed)
 	//Toggle turbo off
 	else if((input == config::hotkey_turbo) && (!pressed)) { config::turbo = false; }
 
+	//Rewind while held
+	else if(input == config::hotkey_rewind) { rewind_data.rewinding = ((pressed) && (config::rewind_buffer_size != 0)); }
+
 	//GB Camera load/unload external picture into VRAM
 	else if((input == config::hotkey_camera) && (pressed))
 	{
@@ -1166,10 +1372,50 @@ void DMG_core::update_volume(u8 volume)
 /****** Feeds key input from an external source (useful for TAS) ******/
 void DMG_core::feed_key_input(int sdl_key, bool pressed)
 {
+	movie_data.begin_live_input(this);
 	core_pad.process_keyboard(sdl_key, pressed);
+	movie_data.end_live_input(this);
 	handle_hotkey(sdl_key, pressed);
 }
 
+/****** Captures the GamePad's state for input movies ******/
+void DMG_core::get_movie_input(movie_input &input)
+{
+	input.keys = ((core_pad.p14 << 8) | core_pad.p15);
+	input.touch_x = 0;
+	input.touch_y = 0;
+	input.sensor_x = core_pad.sensor_x;
+	input.sensor_y = core_pad.sensor_y;
+	input.gyro_value = 0;
+	input.gyro_flags = core_pad.gyro_flags;
+	input.solar_value = 0;
+}
+
+/****** Applies GamePad state from input movies, triggers the Joypad Interrupt on new frames ******/
+void DMG_core::set_movie_input(const movie_input &input, bool new_frame)
+{
+	u16 last_input = ((core_pad.p14 << 8) | core_pad.p15);
+
+	core_pad.p14 = (input.keys >> 8);
+	core_pad.p15 = (input.keys & 0xFF);
+	core_pad.gyro_flags = input.gyro_flags;
+	core_pad.joypad_irq = false;
+
+	if(!new_frame) { return; }
+
+	//Sensors keep moving on their own during a frame, so only set them at frame boundaries
+	core_pad.sensor_x = input.sensor_x;
+	core_pad.sensor_y = input.sensor_y;
+
+	if((last_input != (input.keys & 0xFFFF)) && ((input.keys & 0xFFFF) != 0xDFEF)) { core_mmu.memory_map[IF_FLAG] |= 0x10; }
+}
+
+/****** Copies battery-backed save data for background writes ******/
+bool DMG_core::get_save_image(std::vector<u8> &image)
+{
+	return core_mmu.get_save_image(image);
+}
+
 /****** Return a CPU register ******/
 u32 DMG_core::ex_get_reg(u8 reg_index)
 {
@@ -10,13 +10,19 @@
 // Responsible for blitting pixel data and limiting frame rate
 
 #include <cmath>
+#include <cstring>
 
 #include "lcd.h"
 #include "common/util.h"
+#include "common/profiler.h"
 
 /****** LCD Constructor ******/
 DMG_LCD::DMG_LCD()
 {
+	//Both are written to save states as raw blocks, padding included
+	memset(&lcd_stat, 0, sizeof(lcd_stat));
+	memset(obj, 0, sizeof(obj));
+
 	window = NULL;
 	reset();
 }
@@ -33,6 +39,7 @@ void DMG_LCD::reset()
 {
 	final_screen = NULL;
 	mem = NULL;
+	audio_output = NULL;
 
 	if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
 	window = NULL;
@@ -49,18 +56,14 @@ void DMG_LCD::reset()
 	scanline_raw.resize(0x100, 0);
 	scanline_priority.resize(0x100, 0);
 
-	frame_start_time = 0;
-	frame_current_time = 0;
 	fps_count = 0;
+	frame_count = 0;
+	present_frame = true;
+	realtime_frame = true;
+	skip_frame = false;
 	fps_time = 0;
 
-	for(u32 x = 0; x < 60; x++)
-	{
-		u16 max = (config::max_fps) ? config::max_fps : 60;
-		double frame_1 = ((1000.0 / max) * x);
-		double frame_2 = ((1000.0 / max) * (x + 1));
-		frame_delay[x] = (std::round(frame_2) - std::round(frame_1));
-	}
+	pacer.reset((config::max_fps) ? config::max_fps : 60);
 
 	//Initialize various LCD status variables
 	lcd_stat.lcd_control = 0;
@@ -219,22 +222,17 @@ bool DMG_LCD::init()
 }
 
 /****** Read LCD data from save state ******/
-bool DMG_LCD::lcd_read(u32 offset, std::string filename)
+bool DMG_LCD::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize LCD data from file stream
-	file.read((char*)&lcd_stat, sizeof(lcd_stat));
+	state.read(&lcd_stat, sizeof(lcd_stat));
 
 	//Serialize OBJ data from file stream
 	for(int x = 0; x < 40; x++)
 	{
-		file.read((char*)&obj[x], sizeof(obj[x]));
+		state.read(&obj[x], sizeof(obj[x]));
 	}
 
 	//Sanitize LCD data
@@ -245,30 +243,37 @@ bool DMG_LCD::lcd_read(u32 offset, std::string filename)
 	lcd_stat.lcd_mode &= 0x3;
 	lcd_stat.hdma_type &= 0x1;
 	
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Read LCD data from save state ******/
-bool DMG_LCD::lcd_write(std::string filename)
+bool DMG_LCD::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize LCD data to file stream
-	file.write((char*)&lcd_stat, sizeof(lcd_stat));
+	state.write(&lcd_stat, sizeof(lcd_stat));
 
 	//Serialize OBJ data to file stream
 	for(int x = 0; x < 40; x++)
 	{
-		file.write((char*)&obj[x], sizeof(obj[x]));
+		state.write(&obj[x], sizeof(obj[x]));
 	}
 
-	file.close();
 	return true;
 }
 
+/****** Gets the size of LCD data for serialization ******/
+u32 DMG_LCD::size()
+{
+	u32 lcd_size = 0;
+
+	lcd_size += sizeof(lcd_stat);
+	lcd_size += (sizeof(obj[0]) * 40);
+
+	return lcd_size;
+}
+
 /****** Compares LY and LYC - Generates STAT interrupt ******/
 void DMG_LCD::scanline_compare()
 {
@@ -1194,7 +1199,13 @@ void DMG_LCD::step(int cpu_clock)
 					else { update_obj_render_list(); }
 					
 					//Render scanline when first entering Mode 0
-					if(config::gb_type != 2 ) { render_dmg_scanline(); }
+					//Skipped frames only latch the Window's Y position like rendering would
+					if((!present_frame) || (skip_frame))
+					{
+						if((lcd_stat.window_enable) && (lcd_stat.current_scanline == lcd_stat.window_y) && (lcd_stat.window_x < 160)) { lcd_stat.lock_window_y = true; }
+					}
+
+					else if(config::gb_type != 2 ) { render_dmg_scanline(); }
 					else { render_gbc_scanline(); }
 
 					//HBlank STAT INT
@@ -1288,6 +1299,12 @@ void DMG_LCD::step(int cpu_clock)
 					draw_osd_msg(config::osd_message, screen_buffer, 0, 0);
 				}
 
+				//Display profiler counters
+				PROFILER_DRAW_OSD(screen_buffer);
+
+				//Display frame time statistics
+				pacer.draw_osd(screen_buffer);
+
 				//Process Power Antenna
 				if(power_antenna_osd)
 				{
@@ -1299,8 +1316,8 @@ void DMG_LCD::step(int cpu_clock)
 				//Process sewing machines
 				if(mem->g_pad->con_flags & 0x800) { mem->g_pad->con_update = true; }
 
-				//Render final screen buffer
-				if(lcd_stat.lcd_enable)
+				//Render final screen buffer, unless the frame is hidden (e.g. run-ahead) or skipped
+				if((lcd_stat.lcd_enable) && (present_frame) && (!skip_frame))
 				{
 					//Copy sub-screen to screen buffer
 					if(mem->sub_screen_buffer.size())
@@ -1411,16 +1428,29 @@ void DMG_LCD::step(int cpu_clock)
 				}
 
 				//Limit framerate
-				if(!config::turbo)
+				if((!config::turbo) && (realtime_frame))
+				{
+					PROFILER_ENTER(PROF_IDLE);
+
+					//Pace on the audio device's clock when syncing to audio, otherwise wait for the frame's deadline
+					pacer.limit(audio_output);
+
+					PROFILER_LEAVE();
+				}
+
+				PROFILER_END_FRAME();
+
+				//Update FPS counter + title, frame time and health statistics
+				if(realtime_frame)
 				{
-					frame_current_time = SDL_GetTicks();
-					int delay = frame_delay[fps_count % 60];
-					if((frame_current_time - frame_start_time) < delay) { SDL_Delay(delay - (frame_current_time - frame_start_time));}
-					frame_start_time = SDL_GetTicks();
+					fps_count++;
+					pacer.record(audio_output);
 				}
 
-				//Update FPS counter + title
-				fps_count++;
+				frame_count++;
+
+				//While in turbo, only render 1 out of every N+1 frames
+				skip_frame = (config::turbo) && (config::turbo_frameskip) && ((frame_count % (config::turbo_frameskip + 1)) != 0);
 				if(((SDL_GetTicks() - fps_time) >= 1000) && (config::sdl_render)) 
 				{ 
 					fps_time = SDL_GetTicks();
@@ -15,6 +15,8 @@
 #include "SDL2/SDL.h"
 #include "SDL2/SDL_opengl.h"
 #include "mmu.h"
+#include "common/audio_buffer.h"
+#include "common/frame_pacer.h"
 
 class DMG_LCD
 {
@@ -23,6 +25,9 @@ class DMG_LCD
 	//Link to memory map
 	DMG_MMU* mem;
 
+	//Link to APU output for audio sync
+	audio_buffer* audio_output;
+
 	//Core Functions
 	DMG_LCD();
 	~DMG_LCD();
@@ -36,13 +41,15 @@ class DMG_LCD
 	u32 get_scanline_pixel(u8 pixel);
 
 	//Serialize data for save state loading/saving
-	bool lcd_read(u32 offset, std::string filename);
-	bool lcd_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
+	u32 size();
 
 	//Screen data
 	SDL_Window *window;
 	SDL_Surface* final_screen;
 	SDL_Surface* original_screen;
+	std::vector<u32> screen_buffer;
 
 	//OpenGL data
 	#ifdef GBE_OGL
@@ -63,6 +70,16 @@ class DMG_LCD
 
 	bool power_antenna_osd;
 
+	//Frames completed since reset
+	u32 frame_count;
+
+	//Frame output controls - Blit to screen, throttle and count towards FPS
+	bool present_frame;
+	bool realtime_frame;
+
+	//Leaves the frame unrendered (turbo frameskip)
+	bool skip_frame;
+
 	private:
 
 	struct oam_entries
@@ -93,16 +110,13 @@ class DMG_LCD
 
 	//Screen pixel buffer
 	std::vector<u32> scanline_buffer;
-	std::vector<u32> screen_buffer;
 	std::vector<u8> scanline_raw;
 	std::vector<u8> scanline_priority;
 	std::vector<u32> stretched_buffer;
 
-	int frame_start_time;
-	int frame_current_time;
 	int fps_count;
 	int fps_time;
-	int frame_delay[60];
+	frame_pacer pacer;
 
 	bool try_window_rebuild;
 
@@ -14,12 +14,14 @@
 #include <chrono>
 
 #include "mmu.h"
+#include "common/rtc_time.h"
 
 /****** Grab current system time for Real-Time Clock ******/
 void DMG_MMU::grab_time()
 {
-	//Grab local time as a seconds since epoch
+	//Grab local time as a seconds since epoch, unless the RTC runs on a fixed time
 	u64 current_timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	if(config::fixed_rtc_time) { current_timestamp = config::fixed_rtc_time; }
 
 	if(!cart.rtc_timestamp)
 	{
@@ -32,90 +34,9 @@ void DMG_MMU::grab_time()
 	current_timestamp += (config::rtc_offset[2] * 3600);
 	current_timestamp += (config::rtc_offset[3] * 86400);
 
+	//Catch the RTC up in one go, however long it's been
 	s64 time_passed = current_timestamp - cart.rtc_timestamp;
-
-	if(time_passed > 0)
-	{
-		for(int x = 0; x < time_passed; x++)
-		{
-			cart.rtc_reg[0]++;
-
-			//Update seconds
-			if(cart.rtc_reg[0] >= 60)
-			{
-				cart.rtc_reg[0] = 0;
-				cart.rtc_reg[1]++;
-			}
-
-			//Update minutes
-			if(cart.rtc_reg[1] >= 60)
-			{
-				cart.rtc_reg[1] = 0;
-				cart.rtc_reg[2]++;
-			}
-
-			//Update hours
-			if(cart.rtc_reg[2] >= 24)
-			{
-				cart.rtc_reg[2] = 0;
-
-				u16 days = ((cart.rtc_reg[4] << 8) | cart.rtc_reg[3]) & 0x1FF;
-				
-				//Set Days Overflow
-				if(days == 511) { cart.rtc_reg[4] |= 0x80; }
-
-				days++;
-
-				cart.rtc_reg[4] &= ~0x7F;
-				cart.rtc_reg[4] |= ((days & 0x0100) >> 8);
-				cart.rtc_reg[3] = (days & 0xFF);
-			}
-		}
-	}
-
-	else if(time_passed < 0)
-	{
-		time_passed *= -1;
-
-		for(int x = 0; x < time_passed; x++)
-		{
-			cart.rtc_reg[0]--;
-
-			//Update seconds
-			if(cart.rtc_reg[0] == 0xFF)
-			{
-				cart.rtc_reg[0] = 59;
-				cart.rtc_reg[1]--;
-			}
-
-			//Update minutes
-			if(cart.rtc_reg[1] == 0xFF)
-			{
-				cart.rtc_reg[1] = 59;
-				cart.rtc_reg[2]--;
-			}
-
-			//Update hours
-			if(cart.rtc_reg[2] == 0xFF)
-			{
-				cart.rtc_reg[2] = 23;
-
-				u16 days = ((cart.rtc_reg[4] << 8) | cart.rtc_reg[3]) & 0x1FF;
-				
-				//Set Days Underflow
-				if((days == 0) && (cart.rtc_reg[4] & 0x80))
-				{
-					cart.rtc_reg[4] &= ~0x80;
-				}
-
-				days--;
-
-				cart.rtc_reg[4] &= ~0x7F;
-				cart.rtc_reg[4] |= ((days & 0x0100) >> 8);
-				cart.rtc_reg[3] = (days & 0xFF);
-			}
-		}
-	}
+	advance_rtc_counter(cart.rtc_reg, time_passed);
 
 	//Manually set new time
 	cart.rtc_timestamp = current_timestamp;
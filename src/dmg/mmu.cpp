@@ -10,13 +10,17 @@
 // Used to switch ROM and RAM banks
 // Also loads ROM and BIOS files
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 
 #include "mmu.h"
 #include "common/util.h"
+#include "common/rom_patch.h"
+#include "common/save_flusher.h"
 
 /****** MMU Constructor ******/
-DMG_MMU::DMG_MMU() 
+DMG_MMU::DMG_MMU() : cart(), previous_value(0)
 {
 	reset();
 }
@@ -156,93 +160,171 @@ void DMG_MMU::reset()
 }
 
 /****** Read MMU data from save state ******/
-bool DMG_MMU::mmu_read(u32 offset, std::string filename)
+bool DMG_MMU::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize DMG/GBC RAM from save state
 	u8* ex_ram = &memory_map[0x8000];
-	file.read((char*)ex_ram, 0x8000);
+	state.read(ex_ram, 0x8000);
 
 	for(int x = 0; x < 0x2; x++)
 	{
 		ex_ram = &video_ram[x][0];
-		file.read((char*)ex_ram, 0x2000);
+		state.read(ex_ram, 0x2000);
 	}
 
 	for(int x = 0; x < 0x8; x++)
 	{
 		ex_ram = &working_ram_bank[x][0];
-		file.read((char*)ex_ram, 0x1000);
+		state.read(ex_ram, 0x1000);
 	}
 
 	for(int x = 0; x < 0x10; x++)
 	{
 		ex_ram = &random_access_bank[x][0];
-		file.read((char*)ex_ram, 0x2000);
+		state.read(ex_ram, 0x2000);
 	}
 
 	//Serialize misc MMU data from save state
-	file.read((char*)&rom_bank, sizeof(rom_bank));
-	file.read((char*)&ram_bank, sizeof(ram_bank));
-	file.read((char*)&wram_bank, sizeof(wram_bank));
-	file.read((char*)&vram_bank, sizeof(vram_bank));
-	file.read((char*)&bank_bits, sizeof(bank_bits));
-	file.read((char*)&bank_mode, sizeof(bank_mode));
-	file.read((char*)&ram_banking_enabled, sizeof(ram_banking_enabled));
-	file.read((char*)&in_bios, sizeof(in_bios));
-	file.read((char*)&bios_type, sizeof(bios_type));
-	file.read((char*)&bios_size, sizeof(bios_size));
-	file.read((char*)&cart, sizeof(cart));
-	file.read((char*)&previous_value, sizeof(previous_value));
+	state.read(&rom_bank, sizeof(rom_bank));
+	state.read(&ram_bank, sizeof(ram_bank));
+	state.read(&wram_bank, sizeof(wram_bank));
+	state.read(&vram_bank, sizeof(vram_bank));
+	state.read(&bank_bits, sizeof(bank_bits));
+	state.read(&bank_mode, sizeof(bank_mode));
+	state.read(&ram_banking_enabled, sizeof(ram_banking_enabled));
+	state.read(&in_bios, sizeof(in_bios));
+	state.read(&bios_type, sizeof(bios_type));
+	state.read(&bios_size, sizeof(bios_size));
+
+	//Cartridge data is stored field by field, skipping its buffers
+	state.read(&cart.rom_size, sizeof(cart.rom_size));
+	state.read(&cart.ram_size, sizeof(cart.ram_size));
+	state.read(&cart.mbc_type, sizeof(cart.mbc_type));
+	state.read(&cart.battery, sizeof(cart.battery));
+	state.read(&cart.ram, sizeof(cart.ram));
+	state.read(&cart.multicart, sizeof(cart.multicart));
+	state.read(&cart.sonar, sizeof(cart.sonar));
+	state.read(&cart.rumble, sizeof(cart.rumble));
+	state.read(&cart.rtc, sizeof(cart.rtc));
+	state.read(&cart.rtc_enabled, sizeof(cart.rtc_enabled));
+	state.read(&cart.rtc_latched, sizeof(cart.rtc_latched));
+	state.read(&cart.rtc_latch_1, sizeof(cart.rtc_latch_1));
+	state.read(&cart.rtc_latch_2, sizeof(cart.rtc_latch_2));
+	state.read(&cart.rtc_reg, sizeof(cart.rtc_reg));
+	state.read(&cart.latch_reg, sizeof(cart.latch_reg));
+	state.read(&cart.rtc_timestamp, sizeof(cart.rtc_timestamp));
+	state.read(&cart.flash_cnt, sizeof(cart.flash_cnt));
+	state.read(&cart.flash_cmd, sizeof(cart.flash_cmd));
+	state.read(&cart.flash_stat, sizeof(cart.flash_stat));
+	state.read(&cart.flash_io_bank, sizeof(cart.flash_io_bank));
+	state.read(&cart.flash_get_id, sizeof(cart.flash_get_id));
+	state.read(&cart.idle, sizeof(cart.idle));
+	state.read(&cart.internal_value, sizeof(cart.internal_value));
+	state.read(&cart.internal_state, sizeof(cart.internal_state));
+	state.read(&cart.cs, sizeof(cart.cs));
+	state.read(&cart.sk, sizeof(cart.sk));
+	state.read(&cart.buffer_length, sizeof(cart.buffer_length));
+	state.read(&cart.command_code, sizeof(cart.command_code));
+	state.read(&cart.addr, sizeof(cart.addr));
+	state.read(&cart.buffer, sizeof(cart.buffer));
+	state.read(&cart.cam_reg, sizeof(cart.cam_reg));
+	state.read(&cart.cam_lock, sizeof(cart.cam_lock));
+	state.read(&cart.sonar_byte, sizeof(cart.sonar_byte));
+	state.read(&cart.depth, sizeof(cart.depth));
+	state.read(&cart.pulse_count, sizeof(cart.pulse_count));
+	state.read(&cart.frame_count, sizeof(cart.frame_count));
+	state.read(&cart.tama_reg, sizeof(cart.tama_reg));
+	state.read(&cart.tama_ram, sizeof(cart.tama_ram));
+	state.read(&cart.tama_cmd, sizeof(cart.tama_cmd));
+	state.read(&cart.tama_out, sizeof(cart.tama_out));
+	state.read(&cart.gb_mem_map, sizeof(cart.gb_mem_map));
+
+	state.read(&previous_value, sizeof(previous_value));
 
 	//Sanitize MMU data from save state
 	if((bios_size != 0x100) && (bios_size != 0x900)) { bios_size = 0x100; }
 	
 	rom_bank &= 0x1FF;
 	ram_bank &= 0xF;
-	wram_bank &= 0x3;
+	wram_bank &= 0x7;
+	if(wram_bank == 0) { wram_bank = 1; }
 	vram_bank &= 0x1;
 	bank_mode &= 0x1;
 	bank_bits &= 0xF;
 
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Write MMU data to save state ******/
-bool DMG_MMU::mmu_write(std::string filename)
+bool DMG_MMU::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize DMG/GBC RAM to save state
-	file.write(reinterpret_cast<char*> (&memory_map[0x8000]), 0x8000);
-	for(int x = 0; x < 0x2; x++) { file.write(reinterpret_cast<char*> (&video_ram[x][0]), 0x2000); }
-	for(int x = 0; x < 0x8; x++) { file.write(reinterpret_cast<char*> (&working_ram_bank[x][0]), 0x1000); }
-	for(int x = 0; x < 0x10; x++) { file.write(reinterpret_cast<char*> (&random_access_bank[x][0]), 0x2000); }
+	state.write(&memory_map[0x8000], 0x8000);
+	for(int x = 0; x < 0x2; x++) { state.write(&video_ram[x][0], 0x2000); }
+	for(int x = 0; x < 0x8; x++) { state.write(&working_ram_bank[x][0], 0x1000); }
+	for(int x = 0; x < 0x10; x++) { state.write(&random_access_bank[x][0], 0x2000); }
 
 	//Serialize misc MMU data to save state
-	file.write((char*)&rom_bank, sizeof(rom_bank));
-	file.write((char*)&ram_bank, sizeof(ram_bank));
-	file.write((char*)&wram_bank, sizeof(wram_bank));
-	file.write((char*)&vram_bank, sizeof(vram_bank));
-	file.write((char*)&bank_bits, sizeof(bank_bits));
-	file.write((char*)&bank_mode, sizeof(bank_mode));
-	file.write((char*)&ram_banking_enabled, sizeof(ram_banking_enabled));
-	file.write((char*)&in_bios, sizeof(in_bios));
-	file.write((char*)&bios_type, sizeof(bios_type));
-	file.write((char*)&bios_size, sizeof(bios_size));
-	file.write((char*)&cart, sizeof(cart));
-	file.write((char*)&previous_value, sizeof(previous_value));
+	state.write(&rom_bank, sizeof(rom_bank));
+	state.write(&ram_bank, sizeof(ram_bank));
+	state.write(&wram_bank, sizeof(wram_bank));
+	state.write(&vram_bank, sizeof(vram_bank));
+	state.write(&bank_bits, sizeof(bank_bits));
+	state.write(&bank_mode, sizeof(bank_mode));
+	state.write(&ram_banking_enabled, sizeof(ram_banking_enabled));
+	state.write(&in_bios, sizeof(in_bios));
+	state.write(&bios_type, sizeof(bios_type));
+	state.write(&bios_size, sizeof(bios_size));
+
+	//Cartridge data is stored field by field, skipping its buffers
+	state.write(&cart.rom_size, sizeof(cart.rom_size));
+	state.write(&cart.ram_size, sizeof(cart.ram_size));
+	state.write(&cart.mbc_type, sizeof(cart.mbc_type));
+	state.write(&cart.battery, sizeof(cart.battery));
+	state.write(&cart.ram, sizeof(cart.ram));
+	state.write(&cart.multicart, sizeof(cart.multicart));
+	state.write(&cart.sonar, sizeof(cart.sonar));
+	state.write(&cart.rumble, sizeof(cart.rumble));
+	state.write(&cart.rtc, sizeof(cart.rtc));
+	state.write(&cart.rtc_enabled, sizeof(cart.rtc_enabled));
+	state.write(&cart.rtc_latched, sizeof(cart.rtc_latched));
+	state.write(&cart.rtc_latch_1, sizeof(cart.rtc_latch_1));
+	state.write(&cart.rtc_latch_2, sizeof(cart.rtc_latch_2));
+	state.write(&cart.rtc_reg, sizeof(cart.rtc_reg));
+	state.write(&cart.latch_reg, sizeof(cart.latch_reg));
+	state.write(&cart.rtc_timestamp, sizeof(cart.rtc_timestamp));
+	state.write(&cart.flash_cnt, sizeof(cart.flash_cnt));
+	state.write(&cart.flash_cmd, sizeof(cart.flash_cmd));
+	state.write(&cart.flash_stat, sizeof(cart.flash_stat));
+	state.write(&cart.flash_io_bank, sizeof(cart.flash_io_bank));
+	state.write(&cart.flash_get_id, sizeof(cart.flash_get_id));
+	state.write(&cart.idle, sizeof(cart.idle));
+	state.write(&cart.internal_value, sizeof(cart.internal_value));
+	state.write(&cart.internal_state, sizeof(cart.internal_state));
+	state.write(&cart.cs, sizeof(cart.cs));
+	state.write(&cart.sk, sizeof(cart.sk));
+	state.write(&cart.buffer_length, sizeof(cart.buffer_length));
+	state.write(&cart.command_code, sizeof(cart.command_code));
+	state.write(&cart.addr, sizeof(cart.addr));
+	state.write(&cart.buffer, sizeof(cart.buffer));
+	state.write(&cart.cam_reg, sizeof(cart.cam_reg));
+	state.write(&cart.cam_lock, sizeof(cart.cam_lock));
+	state.write(&cart.sonar_byte, sizeof(cart.sonar_byte));
+	state.write(&cart.depth, sizeof(cart.depth));
+	state.write(&cart.pulse_count, sizeof(cart.pulse_count));
+	state.write(&cart.frame_count, sizeof(cart.frame_count));
+	state.write(&cart.tama_reg, sizeof(cart.tama_reg));
+	state.write(&cart.tama_ram, sizeof(cart.tama_ram));
+	state.write(&cart.tama_cmd, sizeof(cart.tama_cmd));
+	state.write(&cart.tama_out, sizeof(cart.tama_out));
+	state.write(&cart.gb_mem_map, sizeof(cart.gb_mem_map));
+
+	state.write(&previous_value, sizeof(previous_value));
 
-	file.close();
 	return true;
 }
 
@@ -263,7 +345,49 @@ u32 DMG_MMU::size()
 	mmu_size += sizeof(in_bios);
 	mmu_size += sizeof(bios_type);
 	mmu_size += sizeof(bios_size);
-	mmu_size += sizeof(cart);
+
+	mmu_size += sizeof(cart.rom_size);
+	mmu_size += sizeof(cart.ram_size);
+	mmu_size += sizeof(cart.mbc_type);
+	mmu_size += sizeof(cart.battery);
+	mmu_size += sizeof(cart.ram);
+	mmu_size += sizeof(cart.multicart);
+	mmu_size += sizeof(cart.sonar);
+	mmu_size += sizeof(cart.rumble);
+	mmu_size += sizeof(cart.rtc);
+	mmu_size += sizeof(cart.rtc_enabled);
+	mmu_size += sizeof(cart.rtc_latched);
+	mmu_size += sizeof(cart.rtc_latch_1);
+	mmu_size += sizeof(cart.rtc_latch_2);
+	mmu_size += sizeof(cart.rtc_reg);
+	mmu_size += sizeof(cart.latch_reg);
+	mmu_size += sizeof(cart.rtc_timestamp);
+	mmu_size += sizeof(cart.flash_cnt);
+	mmu_size += sizeof(cart.flash_cmd);
+	mmu_size += sizeof(cart.flash_stat);
+	mmu_size += sizeof(cart.flash_io_bank);
+	mmu_size += sizeof(cart.flash_get_id);
+	mmu_size += sizeof(cart.idle);
+	mmu_size += sizeof(cart.internal_value);
+	mmu_size += sizeof(cart.internal_state);
+	mmu_size += sizeof(cart.cs);
+	mmu_size += sizeof(cart.sk);
+	mmu_size += sizeof(cart.buffer_length);
+	mmu_size += sizeof(cart.command_code);
+	mmu_size += sizeof(cart.addr);
+	mmu_size += sizeof(cart.buffer);
+	mmu_size += sizeof(cart.cam_reg);
+	mmu_size += sizeof(cart.cam_lock);
+	mmu_size += sizeof(cart.sonar_byte);
+	mmu_size += sizeof(cart.depth);
+	mmu_size += sizeof(cart.pulse_count);
+	mmu_size += sizeof(cart.frame_count);
+	mmu_size += sizeof(cart.tama_reg);
+	mmu_size += sizeof(cart.tama_ram);
+	mmu_size += sizeof(cart.tama_cmd);
+	mmu_size += sizeof(cart.tama_out);
+	mmu_size += sizeof(cart.gb_mem_map);
+
 	mmu_size += sizeof(previous_value);
 
 	return mmu_size;
@@ -1623,7 +1747,12 @@ bool DMG_MMU::read_file(std::string filename)
 		return true;
 	}
 
-	std::ifstream file(filename.c_str(), std::ios::binary);
+	//Patched ROMs are built once and cached, then read like any other ROM
+	//Banks 0-1 plus 0x200 switchable banks
+	std::string rom_source = filename;
+	bool patch_in_memory = (config::use_patches) && (!get_patched_rom(filename, rom_source, 0x808000));
+
+	std::ifstream file(rom_source.c_str(), std::ios::binary);
 
 	if(!file.is_open()) 
 	{
@@ -1644,7 +1773,10 @@ bool DMG_MMU::read_file(std::string filename)
 
 	//Read entire ROM file
 	file.read((char*)ex_mem, file_size);
-	file.seekg(0, file.beg);
+	file.close();
+
+	//Apply patches to the ROM data if they couldn't be cached
+	if((patch_in_memory) && (patch_rom_data(filename, rom_file, 0x808000))) { file_size = rom_file.size(); }
 
 	//Grab CRC32
 	u32 crc32 = util::get_crc32(&rom_file[0], file_size);
@@ -1662,9 +1794,7 @@ bool DMG_MMU::read_file(std::string filename)
 			if (pos > 0)
 			{
 				//Read the last 32KB and put it as Bank 0
-				file.seekg(pos);
-				file.read((char*)ex_mem, 0x8000);
-				file.seekg(0, file.beg);
+				memcpy(ex_mem, &rom_file[pos], 0x8000);
 			}
 
 			else
@@ -1678,7 +1808,7 @@ bool DMG_MMU::read_file(std::string filename)
 		else
 		{
 			//Read 32KB worth of data from ROM file
-			file.read((char*)ex_mem, 0x8000);
+			memcpy(ex_mem, &rom_file[0], std::min<u32>(file_size, 0x8000));
 		}
 	}
 
@@ -1990,33 +2120,15 @@ bool DMG_MMU::read_file(std::string filename)
 		while(file_pos < (cart.rom_size * 1024))
 		{
 			u8* ex_rom = &read_only_bank[bank_count][0];
-			file.read((char*)ex_rom, 0x4000);
+			if(file_pos < file_size) { memcpy(ex_rom, &rom_file[file_pos], std::min<u32>((file_size - file_pos), 0x4000)); }
 			file_pos += 0x4000;
 			bank_count++;
 		}
 	}
 
-	file.close();
 	std::cout<<"MMU::ROM CRC32: " << std::hex << crc32 << "\n";
 	std::cout<<"MMU::" << filename << " loaded successfully. \n";
 
-	//Apply patches to the ROM data
-	if(config::use_patches)
-	{
-		bool patch_pass = false;
-
-		std::size_t dot = filename.find_last_of(".");
-		if(dot == std::string::npos) { dot = filename.size(); }
-
-		std::string patch_file = filename.substr(0, dot);
-
-		//Attempt a IPS patch
-		patch_pass = patch_ips(patch_file + ".ips");
-
-		//Attempt a UPS patch
-		if(!patch_pass) { patch_pass = patch_ups(patch_file + ".ups"); }
-	}
-
 	//Apply Game Genie codes to ROM data
 	if(config::use_cheats) { set_gg_cheats(); }
 
@@ -2116,6 +2228,8 @@ bool DMG_MMU::read_bios(std::string filename)
 		u32 hash = 0;
 		u8 rank = 0;
 
+		get_firmware_hashes();
+
 		//Select BIOS is this order: GBC (REV1, REV0), MGB, DMG (REV1, REV0)
 		for(u32 x = 0; x < config::bin_hashes.size(); x++)
 		{
@@ -2179,6 +2293,9 @@ bool DMG_MMU::load_backup(std::string filename)
 		 filename = config::save_path + util::get_filename_from_path(filename);
 	}
 
+	//Finish any background save write that was interrupted
+	save_flusher::recover(filename);
+
 	//Import save if applicable
 	if(!config::save_import_path.empty()) { filename = config::save_import_path; }
 
@@ -2331,6 +2448,60 @@ bool DMG_MMU::load_backup(std::string filename)
 	return true;
 }
 
+/****** Copies battery-backed RAM exactly as save_backup() lays it out, minus any RTC data ******/
+bool DMG_MMU::get_save_image(std::vector<u8> &image)
+{
+	//GB Memory Cartridge saves are rearranged on exit, MBC6 Flash is a separate file
+	if((!cart.battery) || (config::cart_type == DMG_GBMEM)) { return false; }
+
+	image.clear();
+
+	//MBC RAM
+	if((cart.mbc_type != ROM_ONLY) && (cart.mbc_type != MBC7) && (cart.mbc_type != TAMA5))
+	{
+		u32 block_size = 0x10;
+
+		if(!config::use_legacy_save_size)
+		{
+			switch(memory_map[ROM_RAMSIZE])
+			{
+				case 0x02: block_size = 1; break;
+				case 0x03: block_size = 4; break;
+				case 0x04: block_size = 16; break;
+				case 0x05: block_size = 8; break;
+				default: block_size = 0;
+			}
+		}
+
+		if((cart.mbc_type == MBC2) && (!config::use_legacy_save_size)) { image.assign(random_access_bank[0].begin(), (random_access_bank[0].begin() + 0x200)); }
+		else { for(u32 x = 0; x < block_size; x++) { image.insert(image.end(), random_access_bank[x].begin(), random_access_bank[x].end()); } }
+
+		//Leave out the external camera pic, same as on exit
+		if(cart.mbc_type == GB_CAMERA)
+		{
+			for(u32 x = 0; (x < cart.cam_buffer.size()) && ((0x100 + x) < image.size()); x++) { image[0x100 + x] = 0x0; }
+		}
+	}
+
+	//MBC7 EEPROM
+	else if(cart.mbc_type == MBC7) { image.assign(&memory_map[0xA000], &memory_map[0xA100]); }
+
+	//TAMA5 EEPROM
+	else if(cart.mbc_type == TAMA5)
+	{
+		for(u32 x = 0; x < 16; x++)
+		{
+			image.push_back(cart.tama_ram[(x << 4)]);
+			image.push_back(cart.tama_ram[(x << 4) + 1]);
+		}
+	}
+
+	//8KB Cart RAM
+	else { image.assign(&memory_map[0xA000], &memory_map[0xC000]); }
+
+	return !image.empty();
+}
+
 /****** Save backup save data ******/
 bool DMG_MMU::save_backup(std::string filename)
 {
@@ -2711,270 +2882,6 @@ void DMG_MMU::set_gg_cheats()
 	}
 }
 
-/****** Applies an IPS patch to a ROM loaded in memory ******/
-bool DMG_MMU::patch_ips(std::string filename)
-{
-	std::ifstream patch_file(filename.c_str(), std::ios::binary);
-
-	if(!patch_file.is_open()) 
-	{ 
-		std::cout<<"MMU::" << filename << " IPS patch file could not be opened. Check file path or permissions. \n";
-		return false;
-	}
-
-	//Get the file size
-	patch_file.seekg(0, patch_file.end);
-	u32 file_size = patch_file.tellg();
-	patch_file.seekg(0, patch_file.beg);
-
-	std::vector<u8> patch_data;
-	patch_data.resize(file_size, 0);
-
-	//Read patch file into buffer
-	u8* ex_patch = &patch_data[0];
-	patch_file.read((char*)ex_patch, file_size);
-
-	//Check header for PATCH string
-	if((patch_data[0] != 0x50) || (patch_data[1] != 0x41) || (patch_data[2] != 0x54) || (patch_data[3] != 0x43) || (patch_data[4] != 0x48))
-	{
-		std::cout<<"MMU::" << filename << " IPS patch file has invalid header\n";
-		return false;
-	}
-
-	bool end_of_file = false;
-	u32 patch_pos = 5;
-
-	while((patch_pos < file_size) && (!end_of_file))
-	{
-		//Grab a record offset - 3 bytes
-		if((patch_pos + 3) > file_size)
-		{
-			std::cout<<"MMU::" << filename << " file ends unexpectedly (OFFSET). Aborting further patching.\n";
-		}
-
-		u32 offset = (patch_data[patch_pos++] << 16) | (patch_data[patch_pos++] << 8) | patch_data[patch_pos++];
-
-		//Quit if EOF marker is reached
-		if(offset == 0x454F46) { end_of_file = true; break; }
-
-		//Grab record size - 2 bytes
-		if((patch_pos + 2) > file_size)
-		{
-			std::cout<<"MMU::" << filename << " file ends unexpectedly (DATA_SIZE). Aborting further patching.\n";
-			return false;
-		}
-
-		u16 data_size = (patch_data[patch_pos++] << 8) | patch_data[patch_pos++];
-
-		//Perform regular patching if size is non-zero
-		if(data_size)
-		{
-			if((patch_pos + data_size) > file_size)
-			{
-				std::cout<<"MMU::" << filename << " file ends unexpectedly (DATA). Aborting further patching.\n";
-				return false;
-			}
-
-			for(u32 x = 0; x < data_size; x++)
-			{
-				u8 patch_byte = patch_data[patch_pos++];
-
-				//Patch for Banks 2 and above
-				if(offset > 0x7FFF)
-				{
-					u16 patch_bank = (offset >> 14) - 2;	
-					u16 patch_addr = offset & 0x3FFF;
-
-					if(patch_bank > 0x1FF)
-					{
-						std::cout<<"MMU::" << filename << " patches beyond max ROM size (DATA). Aborting further patching.\n";
-						return false;
-					}
-
-					read_only_bank[patch_bank][patch_addr] = patch_byte;
-				}
-
-				//Patch for Banks 0-1
-				else { memory_map[offset] = patch_byte; }
-
-				offset++;
-			}
-		}
-
-		//Patch with RLE
-		else
-		{
-			//Grab Run-length size and value - 3 bytes
-			if((patch_pos + 3) > file_size)
-			{
-				std::cout<<"MMU::" << filename << " file ends unexpectedly (RLE). Aborting further patching.\n";
-				return false;
-			}
-
-			u16 rle_size = (patch_data[patch_pos++] << 8) | patch_data[patch_pos++];
-			u8 patch_byte = patch_data[patch_pos++];
-
-			for(u32 x = 0; x < rle_size; x++)
-			{
-				//Patch for Banks 2 and above
-				if(offset > 0x7FFF)
-				{
-					u16 patch_bank = (offset >> 14) - 2;	
-					u16 patch_addr = offset & 0x3FFF;
-
-					if(patch_bank > 0x1FF)
-					{
-						std::cout<<"MMU::" << filename << " patches beyond max ROM size (RLE DATA). Aborting further patching.\n";
-						return false;
-					}
-
-					read_only_bank[patch_bank][patch_addr] = patch_byte;
-				}
-
-				//Patch for Banks 0-1
-				else { memory_map[offset] = patch_byte; }
-
-				offset++;
-			}
-		}
-	}
-
-	patch_file.close();
-	patch_data.clear();
-
-	return true;
-}
-
-/****** Applies an UPS patch to a ROM loaded in memory ******/
-bool DMG_MMU::patch_ups(std::string filename)
-{
-	std::ifstream patch_file(filename.c_str(), std::ios::binary);
-
-	if(!patch_file.is_open()) 
-	{ 
-		std::cout<<"MMU::" << filename << " UPS patch file could not be opened. Check file path or permissions. \n";
-		return false;
-	}
-
-	//Get the file size
-	patch_file.seekg(0, patch_file.end);
-	u32 file_size = patch_file.tellg();
-	patch_file.seekg(0, patch_file.beg);
-
-	std::vector<u8> patch_data;
-	patch_data.resize(file_size, 0);
-
-	//Read patch file into buffer
-	u8* ex_patch = &patch_data[0];
-	patch_file.read((char*)ex_patch, file_size);
-
-	//Check header for UPS1 string
-	if((patch_data[0] != 0x55) || (patch_data[1] != 0x50) || (patch_data[2] != 0x53) || (patch_data[3] != 0x31))
-	{
-		std::cout<<"MMU::" << filename << " UPS patch file has invalid header\n";
-		return false;
-	}
-
-	u32 patch_pos = 4;
-	u32 patch_size = file_size - 12;
-	u32 file_pos = 0;
-
-	//Grab file sizes
-	for(u32 x = 0; x < 2; x++)
-	{
-		//Grab variable width integer
-		u32 var_int = 0;
-		bool var_end = false;
-		u8 var_shift = 0;
-
-		while(!var_end)
-		{
-			//Grab byte from patch file
-			u8 var_byte = patch_data[patch_pos++];
-			
-			if(var_byte & 0x80)
-			{
-				var_int += ((var_byte & 0x7F) << var_shift);
-				var_end = true;
-			}
-
-			else
-			{
-				var_int += ((var_byte | 0x80) << var_shift);
-				var_shift += 7;
-			}
-		}
-	}
-
-	//Begin patching the source file
-	while(patch_pos < patch_size)
-	{
-		//Grab variable width integer
-		u32 var_int = 0;
-		bool var_end = false;
-		u8 var_shift = 0;
-
-		while(!var_end)
-		{
-			//Grab byte from patch file
-			u8 var_byte = patch_data[patch_pos++];
-			
-			if(var_byte & 0x80)
-			{
-				var_int += ((var_byte & 0x7F) << var_shift);
-				var_end = true;
-			}
-
-			else
-			{
-				var_int += ((var_byte | 0x80) << var_shift);
-				var_shift += 7;
-			}
-		}
-
-		//XOR data at offset with patch
-		var_end = false;
-		file_pos += var_int;
-
-		while(!var_end)
-		{
-			u8 patch_byte = patch_data[patch_pos++];
-
-			//Terminate patching for this chunk if encountering a zero byte
-			if(patch_byte == 0) { var_end = true; }
-
-			//Otherwise, use the byte to patch
-			else
-			{
-				//Patch for Banks 2 and above
-				if(file_pos > 0x7FFF)
-				{
-					u16 patch_bank = (file_pos >> 14) - 2;	
-					u16 patch_addr = file_pos & 0x3FFF;
-
-					if(patch_bank > 0x1FF)
-					{
-						std::cout<<"MMU::" << filename << " patches beyond max ROM size. Aborting further patching.\n";
-						return false;
-					}
-
-					read_only_bank[patch_bank][patch_addr] ^= patch_byte;
-				}
-
-				//Patch for Banks 0-1
-				else { memory_map[file_pos] ^= patch_byte; }
-			}
-
-			file_pos++;
-		}
-	}
-
-	patch_file.close();
-	patch_data.clear();
-
-	return true;
-}
-
 /****** Points the MMU to an lcd_data structure (FROM THE LCD ITSELF) ******/
 void DMG_MMU::set_lcd_data(dmg_lcd_data* ex_lcd_stat) { lcd_stat = ex_lcd_stat; }
 
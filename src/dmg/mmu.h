@@ -174,9 +174,7 @@ class DMG_MMU
 	bool read_bios(std::string filename);
 	bool save_backup(std::string filename);
 	bool load_backup(std::string filename);
-
-	bool patch_ips(std::string filename);
-	bool patch_ups(std::string filename);
+	bool get_save_image(std::vector<u8> &image);
 
 	//Memory Bank Controller dedicated read/write operations
 	void mbc_write(u16 address, u8 value);
@@ -237,8 +235,8 @@ class DMG_MMU
 	void set_sio_data(dmg_sio_data* ex_sio_stat);
 
 	//Serialize data for save state loading/saving
-	bool mmu_read(u32 offset, std::string filename);
-	bool mmu_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
 	u32 size();
 
 	private:
@@ -1412,18 +1412,14 @@ void DMG_SIO::print_image()
 
 	srand(SDL_GetTicks());
 
-	std::string filename = config::ss_path + "gb_print_";
+	std::string filename = "gb_print_";
 	filename += util::to_str(rand() % 1024);
 	filename += util::to_str(rand() % 1024);
 	filename += util::to_str(rand() % 1024);
-	filename += ".bmp";
+	filename += ".png";
 
-	//Create a 160x144 image from the buffer, save as BMP
-	SDL_Surface *print_screen = SDL_CreateRGBSurface(SDL_SWSURFACE, 160, height, 32, 0, 0, 0, 0);
-
-	//Lock source surface
-	if(SDL_MUSTLOCK(print_screen)){ SDL_LockSurface(print_screen); }
-	u32* out_pixel_data = (u32*)print_screen->pixels;
+	//Create a 160xN image from the buffer, save as PNG
+	std::vector<u32> print_pixels(img_size);
 
 	for(u32 x = 0; x < img_size; x++)
 	{
@@ -1454,17 +1450,13 @@ void DMG_SIO::print_image()
 				break;
 		}
 			
-		out_pixel_data[x] = printer.scanline_buffer[x];
+		print_pixels[x] = printer.scanline_buffer[x];
 
 		//Fill full print buffer continuously
 		printer.full_buffer.push_back(printer.scanline_buffer[x]);
 	}
 
-	//Unlock source surface
-	if(SDL_MUSTLOCK(print_screen)){ SDL_UnlockSurface(print_screen); }
-
-	SDL_SaveBMP(print_screen, filename.c_str());
-	SDL_FreeSurface(print_screen);
+	printer_output.save(print_pixels, 160, height, (config::ss_path + filename));
 
 	printer.strip_count = 0;
 
@@ -1472,21 +1464,11 @@ void DMG_SIO::print_image()
 	if(print_full_pix)
 	{
 		height = printer.full_buffer.size() / 160;
-		SDL_Surface *full_screen = SDL_CreateRGBSurface(SDL_SWSURFACE, 160, height, 32, 0, 0, 0, 0);
-
-		if(SDL_MUSTLOCK(full_screen)){ SDL_LockSurface(full_screen); }
-		u32* full_pixel_data = (u32*)full_screen->pixels;
-
-		for(u32 x = 0; x < printer.full_buffer.size(); x++) { full_pixel_data[x] = printer.full_buffer[x]; }
-		printer.full_buffer.clear();
-
-		//Unlock source surface
-		if(SDL_MUSTLOCK(full_screen)){ SDL_UnlockSurface(full_screen); }
 
-		filename = "full_" + filename;
+		std::vector<u32> full_pixels;
+		full_pixels.swap(printer.full_buffer);
 
-		SDL_SaveBMP(full_screen, filename.c_str());
-		SDL_FreeSurface(full_screen);
+		printer_output.save(full_pixels, 160, height, (config::ss_path + "full_" + filename));
 	}
 
 	//OSD
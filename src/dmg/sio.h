@@ -22,6 +22,7 @@
 
 #include "mmu.h"
 #include "sio_data.h"
+#include "common/screenshot.h"
 
 class DMG_SIO
 {
@@ -265,6 +266,9 @@ class DMG_SIO
 
 	bool dmg07_init;
 
+	//GB Printer images are encoded and written in the background
+	screenshot_writer printer_output;
+
 	DMG_SIO();
 	~DMG_SIO();
 
@@ -13,6 +13,7 @@
 
 #include "mmu.h"
 #include "common/util.h"
+#include "common/rtc_time.h"
 
 /****** Performs write operations specific to the TAMA5 ******/
 void DMG_MMU::tama5_write(u16 address, u8 value)
@@ -148,75 +149,53 @@ void DMG_MMU::grab_tama5_time(u8 index)
 {
 	index &= 0xF;
 
-	//Grab local time
-	time_t system_time = time(0);
-	tm* current_time = localtime(&system_time);
-
-	//Add offsets to system time
-	if((current_time->tm_sec + config::rtc_offset[0]) >= 60) { current_time->tm_min++; }
-	current_time->tm_sec += config::rtc_offset[0];
-	current_time->tm_sec = (current_time->tm_sec % 60);
-
-	if((current_time->tm_min + config::rtc_offset[1]) >= 60) { current_time->tm_hour++; }
-	current_time->tm_min += config::rtc_offset[1];
-	current_time->tm_min = (current_time->tm_min % 60);
-
-	if((current_time->tm_hour + config::rtc_offset[2]) >= 24) { current_time->tm_mday++; }
-	current_time->tm_hour += config::rtc_offset[2];
-	current_time->tm_hour = (current_time->tm_hour % 24);
-
-	current_time->tm_mday += config::rtc_offset[3];
-	current_time->tm_mday = (current_time->tm_mday % 366);
-
-	current_time->tm_mon++;
-	if((current_time->tm_mon + config::rtc_offset[4]) >= 12) { current_time->tm_year++; }
-	current_time->tm_mon += config::rtc_offset[4];
-	current_time->tm_mon = (current_time->tm_mon % 12);
-	if(current_time->tm_mon == 0) { current_time->tm_mon++; }
+	//Grab local time with RTC offsets
+	rtc_date current_time = get_rtc_date();
+	u8 year = (current_time.year % 100);
 
 	//Set time based on index
 	switch(index)
 	{
 		//Set Seconds LO
-		case 0x00: cart.tama_ram[0x18] = (util::get_bcd(current_time->tm_sec) & 0xF); break;
+		case 0x00: cart.tama_ram[0x18] = (util::get_bcd(current_time.second) & 0xF); break;
 		
 		//Set Seconds HI
-		case 0x01: cart.tama_ram[0x18] = ((util::get_bcd(current_time->tm_sec) >> 4) & 0xF); break;
+		case 0x01: cart.tama_ram[0x18] = ((util::get_bcd(current_time.second) >> 4) & 0xF); break;
 
 		//Set Minutes LO
-		case 0x02: cart.tama_ram[0x18] = (util::get_bcd(current_time->tm_min) & 0xF); break;
+		case 0x02: cart.tama_ram[0x18] = (util::get_bcd(current_time.minute) & 0xF); break;
 		
 		//Set Minutes HI
-		case 0x03: cart.tama_ram[0x18] = ((util::get_bcd(current_time->tm_min) >> 4) & 0xF); break;
+		case 0x03: cart.tama_ram[0x18] = ((util::get_bcd(current_time.minute) >> 4) & 0xF); break;
 
 		//Set Hours LO
-		case 0x04: cart.tama_ram[0x18] = (util::get_bcd(current_time->tm_hour) & 0xF); break;
+		case 0x04: cart.tama_ram[0x18] = (util::get_bcd(current_time.hour) & 0xF); break;
 		
 		//Set Hours HI
-		case 0x05: cart.tama_ram[0x18] = ((util::get_bcd(current_time->tm_hour) >> 4) & 0xF); break;
+		case 0x05: cart.tama_ram[0x18] = ((util::get_bcd(current_time.hour) >> 4) & 0xF); break;
 
 		//Set Days LO
-		case 0x07: cart.tama_ram[0x18] = (util::get_bcd(current_time->tm_mday) & 0xF); break;
+		case 0x07: cart.tama_ram[0x18] = (util::get_bcd(current_time.day) & 0xF); break;
 		
 		//Set Days HI
-		case 0x08: cart.tama_ram[0x18] = ((util::get_bcd(current_time->tm_mday) >> 4) & 0xF); break;
+		case 0x08: cart.tama_ram[0x18] = ((util::get_bcd(current_time.day) >> 4) & 0xF); break;
 
 		//Set Months LO
-		case 0x09: cart.tama_ram[0x18] = (util::get_bcd(current_time->tm_mon) & 0xF); break;
+		case 0x09: cart.tama_ram[0x18] = (util::get_bcd(current_time.month) & 0xF); break;
 		
 		//Set Months HI
-		case 0x0A: cart.tama_ram[0x18] = ((util::get_bcd(current_time->tm_mon) >> 4) & 0xF); break;
+		case 0x0A: cart.tama_ram[0x18] = ((util::get_bcd(current_time.month) >> 4) & 0xF); break;
 
 		//Set Years - Digit 3
-		case 0x0B: cart.tama_ram[0x18] = ((util::get_bcd(current_time->tm_year) >> 4) & 0xF); break;
+		case 0x0B: cart.tama_ram[0x18] = ((util::get_bcd(year) >> 4) & 0xF); break;
 
 		//Set Years - Digit 4
-		case 0x0C: cart.tama_ram[0x18] = (util::get_bcd(current_time->tm_year) & 0xF); break;
+		case 0x0C: cart.tama_ram[0x18] = (util::get_bcd(year) & 0xF); break;
 	}
 
-	cart.tama_ram[0x54] = util::get_bcd(current_time->tm_sec);
-	cart.tama_ram[0x64] = util::get_bcd(current_time->tm_min);
-	cart.tama_ram[0x74] = util::get_bcd(current_time->tm_hour);
-	cart.tama_ram[0x84] = util::get_bcd(current_time->tm_mday);
-	cart.tama_ram[0x94] = util::get_bcd(current_time->tm_mon);
+	cart.tama_ram[0x54] = util::get_bcd(current_time.second);
+	cart.tama_ram[0x64] = util::get_bcd(current_time.minute);
+	cart.tama_ram[0x74] = util::get_bcd(current_time.hour);
+	cart.tama_ram[0x84] = util::get_bcd(current_time.day);
+	cart.tama_ram[0x94] = util::get_bcd(current_time.month);
 }
\ No newline at end of file
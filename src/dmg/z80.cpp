@@ -9,6 +9,7 @@
 // Emulates the GB Z80 in software
 
 #include "z80.h"
+#include "common/util.h"
 
 /****** Z80 Constructor ******/
 Z80::Z80() 
@@ -95,85 +96,76 @@ void Z80::reset_bios()
 }
 
 /****** Read CPU data from save state ******/
-bool Z80::cpu_read(u32 offset, std::string filename)
+bool Z80::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize CPU registers data to file stream
-	file.read((char*)&reg.a, sizeof(reg.a));
-	file.read((char*)&reg.b, sizeof(reg.b));
-	file.read((char*)&reg.c, sizeof(reg.c));
-	file.read((char*)&reg.d, sizeof(reg.d));
-	file.read((char*)&reg.e, sizeof(reg.e));
-	file.read((char*)&reg.h, sizeof(reg.h));
-	file.read((char*)&reg.l, sizeof(reg.l));
-	file.read((char*)&reg.f, sizeof(reg.f));
-	file.read((char*)&reg.pc, sizeof(reg.pc));
-	file.read((char*)&reg.sp, sizeof(reg.sp));
+	state.read(&reg.a, sizeof(reg.a));
+	state.read(&reg.b, sizeof(reg.b));
+	state.read(&reg.c, sizeof(reg.c));
+	state.read(&reg.d, sizeof(reg.d));
+	state.read(&reg.e, sizeof(reg.e));
+	state.read(&reg.h, sizeof(reg.h));
+	state.read(&reg.l, sizeof(reg.l));
+	state.read(&reg.f, sizeof(reg.f));
+	state.read(&reg.pc, sizeof(reg.pc));
+	state.read(&reg.sp, sizeof(reg.sp));
 
 	//Serialize CPU clock data to file stream
-	file.read((char*)&cpu_clock_m, sizeof(cpu_clock_m));
-	file.read((char*)&cpu_clock_t, sizeof(cpu_clock_t));
-	file.read((char*)&div_counter, sizeof(div_counter));
-	file.read((char*)&tima_counter, sizeof(tima_counter));
-	file.read((char*)&tima_speed, sizeof(tima_speed));
-	file.read((char*)&cycles, sizeof(cycles));
+	state.read(&cpu_clock_m, sizeof(cpu_clock_m));
+	state.read(&cpu_clock_t, sizeof(cpu_clock_t));
+	state.read(&div_counter, sizeof(div_counter));
+	state.read(&tima_counter, sizeof(tima_counter));
+	state.read(&tima_speed, sizeof(tima_speed));
+	state.read(&cycles, sizeof(cycles));
 	
 	//Serialize misc CPU data to filestream
-	file.read((char*)&running, sizeof(running));
-	file.read((char*)&halt, sizeof(halt));
-	file.read((char*)&pause, sizeof(pause));
-	file.read((char*)&interrupt, sizeof(interrupt));
-	file.read((char*)&double_speed, sizeof(double_speed));
-	file.read((char*)&interrupt_delay, sizeof(interrupt_delay));
-	file.read((char*)&skip_instruction, sizeof(skip_instruction));
-
-	file.close();
-	return true;
+	state.read(&running, sizeof(running));
+	state.read(&halt, sizeof(halt));
+	state.read(&pause, sizeof(pause));
+	state.read(&interrupt, sizeof(interrupt));
+	state.read(&double_speed, sizeof(double_speed));
+	state.read(&interrupt_delay, sizeof(interrupt_delay));
+	state.read(&skip_instruction, sizeof(skip_instruction));
+
+	return state.good();
 }
 
 /****** Write CPU data to save state ******/
-bool Z80::cpu_write(std::string filename)
+bool Z80::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize CPU registers data to file stream
-	file.write((char*)&reg.a, sizeof(reg.a));
-	file.write((char*)&reg.b, sizeof(reg.b));
-	file.write((char*)&reg.c, sizeof(reg.c));
-	file.write((char*)&reg.d, sizeof(reg.d));
-	file.write((char*)&reg.e, sizeof(reg.e));
-	file.write((char*)&reg.h, sizeof(reg.h));
-	file.write((char*)&reg.l, sizeof(reg.l));
-	file.write((char*)&reg.f, sizeof(reg.f));
-	file.write((char*)&reg.pc, sizeof(reg.pc));
-	file.write((char*)&reg.sp, sizeof(reg.sp));
+	state.write(&reg.a, sizeof(reg.a));
+	state.write(&reg.b, sizeof(reg.b));
+	state.write(&reg.c, sizeof(reg.c));
+	state.write(&reg.d, sizeof(reg.d));
+	state.write(&reg.e, sizeof(reg.e));
+	state.write(&reg.h, sizeof(reg.h));
+	state.write(&reg.l, sizeof(reg.l));
+	state.write(&reg.f, sizeof(reg.f));
+	state.write(&reg.pc, sizeof(reg.pc));
+	state.write(&reg.sp, sizeof(reg.sp));
 
 	//Serialize CPU clock data to file stream
-	file.write((char*)&cpu_clock_m, sizeof(cpu_clock_m));
-	file.write((char*)&cpu_clock_t, sizeof(cpu_clock_t));
-	file.write((char*)&div_counter, sizeof(div_counter));
-	file.write((char*)&tima_counter, sizeof(tima_counter));
-	file.write((char*)&tima_speed, sizeof(tima_speed));
-	file.write((char*)&cycles, sizeof(cycles));
+	state.write(&cpu_clock_m, sizeof(cpu_clock_m));
+	state.write(&cpu_clock_t, sizeof(cpu_clock_t));
+	state.write(&div_counter, sizeof(div_counter));
+	state.write(&tima_counter, sizeof(tima_counter));
+	state.write(&tima_speed, sizeof(tima_speed));
+	state.write(&cycles, sizeof(cycles));
 	
 	//Serialize misc CPU data to filestream
-	file.write((char*)&running, sizeof(running));
-	file.write((char*)&halt, sizeof(halt));
-	file.write((char*)&pause, sizeof(pause));
-	file.write((char*)&interrupt, sizeof(interrupt));
-	file.write((char*)&double_speed, sizeof(double_speed));
-	file.write((char*)&interrupt_delay, sizeof(interrupt_delay));
-	file.write((char*)&skip_instruction, sizeof(skip_instruction));
-
-	file.close();
+	state.write(&running, sizeof(running));
+	state.write(&halt, sizeof(halt));
+	state.write(&pause, sizeof(pause));
+	state.write(&interrupt, sizeof(interrupt));
+	state.write(&double_speed, sizeof(double_speed));
+	state.write(&interrupt_delay, sizeof(interrupt_delay));
+	state.write(&skip_instruction, sizeof(skip_instruction));
+
 	return true;
 }
 
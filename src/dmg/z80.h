@@ -119,8 +119,8 @@ class Z80
 	void exec_op(u16 opcode);
 
 	//Serialize data for save state loading/saving
-	bool cpu_read(u32 offset, std::string filename);
-	bool cpu_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
 	u32 size();
 
 	//Interrupt handling
@@ -10,12 +10,17 @@
 // Generates and mixes samples for the GBA's 4 sound channels + DMA channels  
 
 #include <cmath>
+#include <cstring>
 
 #include "apu.h"
+#include "common/util.h"
 
 /****** APU Constructor ******/
 AGB_APU::AGB_APU()
 {
+	//Save states store this struct as raw bytes, so clear its padding as well
+	memset(&apu_stat, 0, sizeof(apu_stat));
+
 	reset();
 }
 
@@ -27,6 +32,12 @@ AGB_APU::~AGB_APU()
 	SDL_FreeWAV(apu_stat.ext_audio.karaoke_buffer);
 
 	SDL_CloseAudio();
+
+	if((output.underruns) || (output.overruns))
+	{
+		std::cout<<"APU::Audio buffer underruns - " << std::dec << output.underruns << " :: overruns - " << output.overruns << "\n";
+	}
+
 	std::cout<<"APU::Shutdown\n";
 }
 
@@ -190,6 +201,9 @@ bool AGB_APU::init()
 
 		apu_stat.psg_fill_rate = apu_stat.sample_rate / 60;
 
+		//Room for a few callbacks' worth of samples
+		output.resize((desired_spec.samples * 4), 1, desired_spec.freq);
+
 		SDL_PauseAudio(0);
 		init_status = true;
 		std::cout<<"APU::Initialized\n";
@@ -541,58 +555,57 @@ void AGB_APU::generate_ext_audio_hi_samples(s16* stream, int length)
 	apu_stat.ext_audio.sample_pos = buffer_pos;
 }
 
-/****** SDL Audio Callback ******/ 
-void agb_audio_callback(void* _apu, u8 *_stream, int _length)
+/****** Mixes one VBlank's worth of samples for the SDL callback ******/
+void AGB_APU::buffer_frame()
 {
-	s16* stream = (s16*) _stream;
-	int length = _length/2;
-
-	std::vector<s16> channel_1_stream(length);
-	std::vector<s16> channel_2_stream(length);
-	std::vector<s16> channel_3_stream(length);
-	std::vector<s16> channel_4_stream(length);
-
-	std::vector<s16> dma_a_stream(length);
-	std::vector<s16> dma_b_stream(length);
+	int length = apu_stat.psg_fill_rate;
+	if(length == 0) { return; }
 
-	std::vector<s16> ext_stream(length);
+	//Streams only grow if the sample rate changes
+	if(mix_stream.size() != length)
+	{
+		for(u32 x = 0; x < 4; x++) { channel_stream[x].resize(length); }
+		dma_stream[0].resize(length);
+		dma_stream[1].resize(length);
+		ext_stream.resize(length);
+		mix_stream.resize(length);
+	}
 
-	AGB_APU* apu_link = (AGB_APU*) _apu;
-	apu_link->generate_channel_1_samples(&channel_1_stream[0], length);
-	apu_link->generate_channel_2_samples(&channel_2_stream[0], length);
-	apu_link->generate_channel_3_samples(&channel_3_stream[0], length);
-	apu_link->generate_channel_4_samples(&channel_4_stream[0], length);
-	apu_link->generate_dma_a_samples(&dma_a_stream[0], length);
-	apu_link->generate_dma_b_samples(&dma_b_stream[0], length);
+	generate_channel_1_samples(&channel_stream[0][0], length);
+	generate_channel_2_samples(&channel_stream[1][0], length);
+	generate_channel_3_samples(&channel_stream[2][0], length);
+	generate_channel_4_samples(&channel_stream[3][0], length);
+	generate_dma_a_samples(&dma_stream[0][0], length);
+	generate_dma_b_samples(&dma_stream[1][0], length);
 
-	double channel_ratio = apu_link->apu_stat.channel_master_volume / 128.0;
-	double dma_a_ratio = apu_link->apu_stat.dma[0].master_volume / 128.0;
-	double dma_b_ratio = apu_link->apu_stat.dma[1].master_volume / 128.0;
+	double channel_ratio = apu_stat.channel_master_volume / 128.0;
+	double dma_a_ratio = apu_stat.dma[0].master_volume / 128.0;
+	double dma_b_ratio = apu_stat.dma[1].master_volume / 128.0;
 
-	double ext_ratio = apu_link->apu_stat.ext_audio.volume / 63.0;
+	double ext_ratio = apu_stat.ext_audio.volume / 63.0;
 
 	//Custom software mixing
 	for(u32 x = 0; x < length; x++)
 	{
 		//Add Sound Channels 1-4 and multiply by volume ratio
-		s32 out_sample = (channel_1_stream[x] + channel_2_stream[x] + channel_3_stream[x] + channel_4_stream[x]) * channel_ratio;
+		s32 out_sample = (channel_stream[0][x] + channel_stream[1][x] + channel_stream[2][x] + channel_stream[3][x]) * channel_ratio;
 
 		//Add DMA Channels A and B and multiply by volume ratio
-		out_sample += (dma_a_stream[x] * dma_a_ratio) + (dma_b_stream[x] * dma_b_ratio);
+		out_sample += (dma_stream[0][x] * dma_a_ratio) + (dma_stream[1][x] * dma_b_ratio);
 
 		//Divide final wave by total amount of channels
 		out_sample /= 6;
 
-		stream[x] = out_sample;
+		mix_stream[x] = out_sample;
 	}
 
 	//Mix in external audio if necessary
-	if(apu_link->apu_stat.ext_audio.playing)
+	if(apu_stat.ext_audio.playing)
 	{
 		//Generate raw samples (high quality)
-		if(apu_link->apu_stat.ext_audio.output_path)
+		if(apu_stat.ext_audio.output_path)
 		{
-			apu_link->generate_ext_audio_hi_samples(&ext_stream[0], length);
+			generate_ext_audio_hi_samples(&ext_stream[0], length);
 		}
 
 		//Generate GBA samples (low quality)
@@ -604,14 +617,23 @@ void agb_audio_callback(void* _apu, u8 *_stream, int _length)
 		//Custom software mixing
 		for(u32 x = 0; x < length; x++)
 		{
-			s32 out_sample = stream[x] + (ext_stream[x] * ext_ratio);
+			s32 out_sample = mix_stream[x] + (ext_stream[x] * ext_ratio);
 			
 			//Divide final wave by total amount of channels
 			out_sample /= 2;
 
-			stream[x] = out_sample;
+			mix_stream[x] = out_sample;
 		}
 	}
+
+	output.write(&mix_stream[0], length);
+}
+
+/****** SDL Audio Callback ******/ 
+void agb_audio_callback(void* _apu, u8 *_stream, int _length)
+{
+	AGB_APU* apu_link = (AGB_APU*) _apu;
+	apu_link->output.read((s16*) _stream, (_length / 2));
 }
 
 /****** SDL Audio Callback - Microphone ******/ 
@@ -777,15 +799,6 @@ void agb_microphone_callback(void* _apu, u8 *_stream, int _length)
 	}
 }
 
-/****** Fill PSG channels with audio data when buffering ******/
-void AGB_APU::buffer_channels()
-{
-	buffer_channel_1();
-	buffer_channel_2();
-	buffer_channel_3();
-	buffer_channel_4();
-}
-
 /****** Buffer GBA Channel 1 data ******/
 void AGB_APU::buffer_channel_1()
 {
@@ -1233,33 +1246,24 @@ void AGB_APU::buffer_channel_4()
 }
 
 /****** Read APU data from save state ******/
-bool AGB_APU::apu_read(u32 offset, std::string filename)
+bool AGB_APU::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize APU data from save state
-	file.read((char*)&apu_stat, sizeof(apu_stat));
+	state.read(&apu_stat, sizeof(apu_stat));
 
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Write APU data to save state ******/
-bool AGB_APU::apu_write(std::string filename)
+bool AGB_APU::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize APU data to save state
-	file.write((char*)&apu_stat, sizeof(apu_stat));
+	state.write(&apu_stat, sizeof(apu_stat));
 
-	file.close();
 	return true;
 }
 
@@ -15,6 +15,7 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_audio.h>
 #include "mmu.h"
+#include "common/audio_buffer.h"
 
 class AGB_APU
 {
@@ -31,13 +32,16 @@ class AGB_APU
 	//Recording buffer for microphone input
 	std::vector<s16> mic_buffer;
 
+	//Mixed samples waiting for the SDL callback
+	audio_buffer output;
+
 	AGB_APU();
 	~AGB_APU();
 
 	bool init();
 	void reset();
 
-	void buffer_channels();
+	void buffer_frame();
 	void buffer_channel_1();
 	void buffer_channel_2();
 	void buffer_channel_3();
@@ -52,9 +56,15 @@ class AGB_APU
 	void generate_ext_audio_hi_samples(s16* stream, int length);
 
 	//Serialize data for save state loading/saving
-	bool apu_read(u32 offset, std::string filename);
-	bool apu_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
 	u32 size();
+
+	//Preallocated per-channel streams for mixing
+	std::vector<s16> channel_stream[4];
+	std::vector<s16> dma_stream[2];
+	std::vector<s16> ext_stream;
+	std::vector<s16> mix_stream;
 };
 
 /****** SDL Audio Callback ******/ 
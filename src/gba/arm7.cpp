@@ -10,10 +10,13 @@
 // This is basically the core of the GBA
 
 #include "arm7.h"
+#include "common/util.h"
+#include "common/profiler.h"
 
 /****** CPU Constructor ******/
 ARM7::ARM7()
 {
+	fast_fetch = true;
 	reset();
 }
 
@@ -309,30 +312,33 @@ void ARM7::fetch()
 
 	#ifdef GBE_FAST_FETCH
 
-	//Fetch THUMB instructions
-	if(arm_mode == THUMB)
+	if(fast_fetch)
 	{
-		//Read 16-bit THUMB instruction
-		instruction_pipeline[pipeline_pointer] = mem->read_u16_fast(reg.r15);
+		//Fetch THUMB instructions
+		if(arm_mode == THUMB)
+		{
+			//Read 16-bit THUMB instruction
+			instruction_pipeline[pipeline_pointer] = mem->read_u16_fast(reg.r15);
 
-		//Set the operation to perform as UNDEFINED until decoded
-		instruction_operation[pipeline_pointer] = UNDEFINED;
-	}
+			//Set the operation to perform as UNDEFINED until decoded
+			instruction_operation[pipeline_pointer] = UNDEFINED;
+		}
 
-	//Fetch ARM instructions
-	else if(arm_mode == ARM)
-	{
-		//Read 32-bit ARM instruction
-		instruction_pipeline[pipeline_pointer] = mem->read_u32_fast(reg.r15);
+		//Fetch ARM instructions
+		else if(arm_mode == ARM)
+		{
+			//Read 32-bit ARM instruction
+			instruction_pipeline[pipeline_pointer] = mem->read_u32_fast(reg.r15);
 
-		//Set the operation to perform as UNDEFINED until decoded
-		instruction_operation[pipeline_pointer] = UNDEFINED;
+			//Set the operation to perform as UNDEFINED until decoded
+			instruction_operation[pipeline_pointer] = UNDEFINED;
+		}
+
+		return;
 	}
 
 	#endif
 
-	#ifndef GBE_FAST_FETCH
-
 	//Fetch THUMB instructions
 	if(arm_mode == THUMB)
 	{
@@ -352,8 +358,6 @@ void ARM7::fetch()
 		//Set the operation to perform as UNDEFINED until decoded
 		instruction_operation[pipeline_pointer] = UNDEFINED;
 	}
-
-	#endif
 }
 
 /****** Decode ARM instruction ******/
@@ -1493,34 +1497,59 @@ void ARM7::clock(u32 access_addr, bool first_access)
 	//Run controllers for each cycle		 
 	for(int x = 0; x < access_cycles; x++)
 	{
+		PROFILER_ENTER(PROF_LCD);
 		controllers.video.step();
+		PROFILER_LEAVE();
+
+		PROFILER_ENTER(PROF_TIMERS);
 		clock_timers();
+		PROFILER_LEAVE();
+
+		PROFILER_ENTER(PROF_DMA);
 		clock_dma();
+		PROFILER_LEAVE();
+
 		debug_cycles++;
 
-		//Generate audio buffers for PSG channels on VBlank
-		if(controllers.video.lcd_clock == 0)
+		//Mix audio on VBlank, skip frames run-ahead throws away
+		if((controllers.video.lcd_clock == 0) && (controllers.video.realtime_frame))
 		{
-			if(controllers.audio.apu_stat.psg_needs_fill) { controllers.audio.buffer_channels(); }
-			controllers.audio.apu_stat.psg_needs_fill = true;
+			PROFILER_ENTER(PROF_APU);
+			controllers.audio.buffer_frame();
+			PROFILER_LEAVE();
 		}
 	}
+
+	PROFILER_CYCLES(PROF_LCD, access_cycles);
+	PROFILER_CYCLES(PROF_TIMERS, access_cycles);
 }
 
 /****** Runs audio and video controllers every clock cycle ******/
 void ARM7::clock()
 {
+	PROFILER_ENTER(PROF_LCD);
 	controllers.video.step();
+	PROFILER_LEAVE();
+
+	PROFILER_ENTER(PROF_TIMERS);
 	clock_timers();
+	PROFILER_LEAVE();
+
+	PROFILER_ENTER(PROF_DMA);
 	clock_dma();
+	PROFILER_LEAVE();
 
-	//Generate audio buffers for PSG channels on VBlank
-	if(controllers.video.lcd_clock == 0)
+	//Mix audio on VBlank, skip frames run-ahead throws away
+	if((controllers.video.lcd_clock == 0) && (controllers.video.realtime_frame))
 	{
-		if(controllers.audio.apu_stat.psg_needs_fill) { controllers.audio.buffer_channels(); }
-		controllers.audio.apu_stat.psg_needs_fill = true;
+		PROFILER_ENTER(PROF_APU);
+		controllers.audio.buffer_frame();
+		PROFILER_LEAVE();
 	}
 
+	PROFILER_CYCLES(PROF_LCD, 1);
+	PROFILER_CYCLES(PROF_TIMERS, 1);
+
 	system_cycles++;
 }
 
@@ -1934,87 +1963,78 @@ void ARM7::handle_interrupt()
 }
 
 /****** Read CPU data from save state ******/
-bool ARM7::cpu_read(u32 offset, std::string filename)
+bool ARM7::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize CPU registers data from file stream
-	file.read((char*)&reg, sizeof(reg));
+	state.read(&reg, sizeof(reg));
 
 	//Serialize misc CPU data from file stream
-	file.read((char*)&current_cpu_mode, sizeof(current_cpu_mode));
-	file.read((char*)&arm_mode, sizeof(arm_mode));
-	file.read((char*)&bios_read_state, sizeof(bios_read_state));
-	file.read((char*)&running, sizeof(running));
-	file.read((char*)&needs_flush, sizeof(needs_flush));
-	file.read((char*)&needs_reset, sizeof(needs_reset));
-	file.read((char*)&in_interrupt, sizeof(in_interrupt));
-	file.read((char*)&sleep, sizeof(sleep));
-	file.read((char*)&swi_vblank_wait, sizeof(swi_vblank_wait));
-	file.read((char*)&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
-	file.read((char*)&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
-	file.read((char*)&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
-	file.read((char*)&instruction_operation[0], sizeof(instruction_operation[0]));
-	file.read((char*)&instruction_operation[1], sizeof(instruction_operation[1]));
-	file.read((char*)&instruction_operation[2], sizeof(instruction_operation[2]));
-	file.read((char*)&pipeline_pointer, sizeof(pipeline_pointer));
-	file.read((char*)&debug_message, sizeof(debug_message));
-	file.read((char*)&debug_code, sizeof(debug_code));
-	file.read((char*)&debug_cycles, sizeof(debug_cycles));
+	state.read(&current_cpu_mode, sizeof(current_cpu_mode));
+	state.read(&arm_mode, sizeof(arm_mode));
+	state.read(&bios_read_state, sizeof(bios_read_state));
+	state.read(&running, sizeof(running));
+	state.read(&needs_flush, sizeof(needs_flush));
+	state.read(&needs_reset, sizeof(needs_reset));
+	state.read(&in_interrupt, sizeof(in_interrupt));
+	state.read(&sleep, sizeof(sleep));
+	state.read(&swi_vblank_wait, sizeof(swi_vblank_wait));
+	state.read(&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
+	state.read(&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
+	state.read(&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
+	state.read(&instruction_operation[0], sizeof(instruction_operation[0]));
+	state.read(&instruction_operation[1], sizeof(instruction_operation[1]));
+	state.read(&instruction_operation[2], sizeof(instruction_operation[2]));
+	state.read(&pipeline_pointer, sizeof(pipeline_pointer));
+	state.read(&debug_message, sizeof(debug_message));
+	state.read(&debug_code, sizeof(debug_code));
+	state.read(&debug_cycles, sizeof(debug_cycles));
 
 	//Serialize timers from save state
-	file.read((char*)&controllers.timer[0], sizeof(controllers.timer[0]));
-	file.read((char*)&controllers.timer[1], sizeof(controllers.timer[1]));
-	file.read((char*)&controllers.timer[2], sizeof(controllers.timer[2]));
-	file.read((char*)&controllers.timer[3], sizeof(controllers.timer[3]));
+	state.read(&controllers.timer[0], sizeof(controllers.timer[0]));
+	state.read(&controllers.timer[1], sizeof(controllers.timer[1]));
+	state.read(&controllers.timer[2], sizeof(controllers.timer[2]));
+	state.read(&controllers.timer[3], sizeof(controllers.timer[3]));
 
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Write CPU data to save state ******/
-bool ARM7::cpu_write(std::string filename)
+bool ARM7::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize CPU registers data to save state
-	file.write((char*)&reg, sizeof(reg));
+	state.write(&reg, sizeof(reg));
 
 	//Serialize misc CPU data to save state
-	file.write((char*)&current_cpu_mode, sizeof(current_cpu_mode));
-	file.write((char*)&arm_mode, sizeof(arm_mode));
-	file.write((char*)&bios_read_state, sizeof(bios_read_state));
-	file.write((char*)&running, sizeof(running));
-	file.write((char*)&needs_flush, sizeof(needs_flush));
-	file.write((char*)&needs_reset, sizeof(needs_reset));
-	file.write((char*)&in_interrupt, sizeof(in_interrupt));
-	file.write((char*)&sleep, sizeof(sleep));
-	file.write((char*)&swi_vblank_wait, sizeof(swi_vblank_wait));
-	file.write((char*)&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
-	file.write((char*)&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
-	file.write((char*)&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
-	file.write((char*)&instruction_operation[0], sizeof(instruction_operation[0]));
-	file.write((char*)&instruction_operation[1], sizeof(instruction_operation[1]));
-	file.write((char*)&instruction_operation[2], sizeof(instruction_operation[2]));
-	file.write((char*)&pipeline_pointer, sizeof(pipeline_pointer));
-	file.write((char*)&debug_message, sizeof(debug_message));
-	file.write((char*)&debug_code, sizeof(debug_code));
-	file.write((char*)&debug_cycles, sizeof(debug_cycles));
+	state.write(&current_cpu_mode, sizeof(current_cpu_mode));
+	state.write(&arm_mode, sizeof(arm_mode));
+	state.write(&bios_read_state, sizeof(bios_read_state));
+	state.write(&running, sizeof(running));
+	state.write(&needs_flush, sizeof(needs_flush));
+	state.write(&needs_reset, sizeof(needs_reset));
+	state.write(&in_interrupt, sizeof(in_interrupt));
+	state.write(&sleep, sizeof(sleep));
+	state.write(&swi_vblank_wait, sizeof(swi_vblank_wait));
+	state.write(&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
+	state.write(&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
+	state.write(&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
+	state.write(&instruction_operation[0], sizeof(instruction_operation[0]));
+	state.write(&instruction_operation[1], sizeof(instruction_operation[1]));
+	state.write(&instruction_operation[2], sizeof(instruction_operation[2]));
+	state.write(&pipeline_pointer, sizeof(pipeline_pointer));
+	state.write(&debug_message, sizeof(debug_message));
+	state.write(&debug_code, sizeof(debug_code));
+	state.write(&debug_cycles, sizeof(debug_cycles));
 
 	//Serialize timers to save state
-	file.write((char*)&controllers.timer[0], sizeof(controllers.timer[0]));
-	file.write((char*)&controllers.timer[1], sizeof(controllers.timer[1]));
-	file.write((char*)&controllers.timer[2], sizeof(controllers.timer[2]));
-	file.write((char*)&controllers.timer[3], sizeof(controllers.timer[3]));
+	state.write(&controllers.timer[0], sizeof(controllers.timer[0]));
+	state.write(&controllers.timer[1], sizeof(controllers.timer[1]));
+	state.write(&controllers.timer[2], sizeof(controllers.timer[2]));
+	state.write(&controllers.timer[3], sizeof(controllers.timer[3]));
 
-	file.close();
 	return true;
 }
 
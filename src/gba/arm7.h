@@ -175,6 +175,9 @@ class ARM7
 	u8 pipeline_pointer;
 	u32 system_cycles;
 
+	//Fetch without memory checks (GBE_FAST_FETCH builds only), gbe_check disables this on its reference core
+	bool fast_fetch;
+
 	u8 debug_message;
 	u32 debug_code;
 	u32 debug_cycles;
@@ -295,8 +298,8 @@ class ARM7
 	void swi_hardreset();
 
 	//Serialize data for save state loading/saving
-	bool cpu_read(u32 offset, std::string filename);
-	bool cpu_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
 	u32 size();
 };
 		
@@ -60,7 +60,8 @@ void AGB_MMU::campho_reset()
 
 	campho.contact_index = -1;
 
-	campho_read_contact_list();
+	//Read contact data only for the Campho Advance itself
+	if(config::cart_type == AGB_CAMPHO) { campho_read_contact_list(); }
 
 	//Setup Campho networking
 	//Note that all networking done here is completely separate from SIO
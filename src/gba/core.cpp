@@ -15,6 +15,8 @@
 #include <sstream>
 
 #include "common/util.h"
+#include "common/state_file.h"
+#include "common/profiler.h"
 
 #include "core.h"
 
@@ -32,6 +34,15 @@ AGB_core::AGB_core()
 	core_cpu.controllers.audio.mem = &core_mmu;
 	core_mmu.set_apu_data(&core_cpu.controllers.audio.apu_stat);
 
+	//Link LCD and APU
+	core_cpu.controllers.video.audio_output = &core_cpu.controllers.audio.output;
+
+	//Link APU and A/V recorder
+	core_cpu.controllers.audio.output.recorder = &av_capture;
+
+	//Record at the system's real refresh rate
+	av_capture.set_frame_rate(16777216, 280896);
+
 	//Link SIO and MMU
 	core_cpu.controllers.serial_io.mem = &core_mmu;
 	core_mmu.set_sio_data(&core_cpu.controllers.serial_io.sio_stat);
@@ -69,6 +80,9 @@ AGB_core::AGB_core()
 	config::osd_count = 180;
 }
 
+/****** Core Destructor ******/
+AGB_core::~AGB_core() { }
+
 /****** Start the core ******/
 void AGB_core::start()
 {
@@ -95,6 +109,10 @@ void AGB_core::start()
 	//Initialize the GamePad
 	core_pad.init();
 	if(core_mmu.gpio.type == AGB_MMU::GPIO_RUMBLE) { core_pad.is_gb_player = false; }
+
+	//Clear rewind history and run-ahead state
+	rewind_data.reset();
+	run_ahead_data.reset();
 }
 
 /****** Stop the core ******/
@@ -118,8 +136,21 @@ void AGB_core::stop()
 /****** Shutdown core's components ******/
 void AGB_core::shutdown()
 {
-	core_mmu.AGB_MMU::~AGB_MMU();
-	core_cpu.ARM7::~ARM7();
+	//Finish any movie being recorded
+	movie_data.stop();
+
+	//Finish any background save write before the MMU writes the save on its own
+	save_sync.stop();
+
+	//Finish writing any queued screenshots
+	screenshots.stop();
+
+	//Finish any audio/video recording
+	av_capture.stop();
+
+	//Free rewind history and run-ahead state
+	rewind_data.reset();
+	run_ahead_data.reset();
 }
 
 /****** Force the core to sleep ******/
@@ -166,6 +197,7 @@ void AGB_core::reset()
 {
 	bool can_reset = true;
 
+	save_sync.reset();
 	core_cpu.reset();
 	core_cpu.controllers.video.reset();
 	core_cpu.controllers.audio.reset();
@@ -181,6 +213,12 @@ void AGB_core::reset()
 	//Link APU and MMU
 	core_cpu.controllers.audio.mem = &core_mmu;
 
+	//Link LCD and APU
+	core_cpu.controllers.video.audio_output = &core_cpu.controllers.audio.output;
+
+	//Link APU and A/V recorder
+	core_cpu.controllers.audio.output.recorder = &av_capture;
+
 	//Link SIO and MMU
 	core_cpu.controllers.serial_io.mem = &core_mmu;
 	core_mmu.set_sio_data(&core_cpu.controllers.serial_io.sio_stat);
@@ -213,8 +251,6 @@ void AGB_core::load_state(u8 slot)
 	std::string state_file = config::rom_file + ".ss";
 	state_file += id;
 
-	u32 offset = 0;
-
 	//Check if save state is accessible
 	std::ifstream test(state_file.c_str());
 	
@@ -225,16 +261,11 @@ void AGB_core::load_state(u8 slot)
 		return;
 	}
 
-	if(!core_cpu.cpu_read(offset, state_file)) { return; }
-	offset += core_cpu.size();
-
-	if(!core_mmu.mmu_read(offset, state_file)) { return; }
-	offset += core_mmu.size();
-
-	if(!core_cpu.controllers.audio.apu_read(offset, state_file)) { return; }
-	offset += core_cpu.controllers.audio.size();
-
-	if(!core_cpu.controllers.video.lcd_read(offset, state_file)) { return; }
+	if(!load_state_file(this, state_file))
+	{
+		std::cout<<"GBE::Error - Could not load save state " << state_file << "\n";
+		return;
+	}
 
 	std::cout<<"GBE::Loaded state " << state_file << "\n";
 
@@ -251,10 +282,7 @@ void AGB_core::save_state(u8 slot)
 	std::string state_file = config::rom_file + ".ss";
 	state_file += id;
 
-	if(!core_cpu.cpu_write(state_file)) { return; }
-	if(!core_mmu.mmu_write(state_file)) { return; }
-	if(!core_cpu.controllers.audio.apu_write(state_file)) { return; }
-	if(!core_cpu.controllers.video.lcd_write(state_file)) { return; }
+	if(!save_state_file(this, state_file)) { return; }
 
 	std::cout<<"GBE::Saved state " << state_file << "\n";
 
@@ -263,6 +291,57 @@ void AGB_core::save_state(u8 slot)
 	config::osd_count = 180;
 }
 
+/****** Serializes the core into a contiguous save state buffer ******/
+bool AGB_core::serialize(std::vector<u8> &buffer)
+{
+	buffer.clear();
+
+	if(!core_cpu.serialize(buffer)) { return false; }
+	if(!core_mmu.serialize(buffer)) { return false; }
+	if(!core_cpu.controllers.audio.serialize(buffer)) { return false; }
+	if(!core_cpu.controllers.video.serialize(buffer)) { return false; }
+
+	return true;
+}
+
+/****** Restores the core from a contiguous save state buffer ******/
+bool AGB_core::deserialize(const u8* buffer, u32 length)
+{
+	u32 offset = 0;
+
+	//Validate the whole state before applying any of it, so bad input never leaves the core half-loaded
+	u32 cpu_size = core_cpu.size();
+	u32 mmu_size = (length > cpu_size) ? core_mmu.state_size((buffer + cpu_size), (length - cpu_size)) : 0;
+	u64 total_size = u64(cpu_size) + mmu_size + core_cpu.controllers.audio.size() + core_cpu.controllers.video.size();
+
+	if((!mmu_size) || (total_size != length)) { return false; }
+
+	if(!core_cpu.deserialize(buffer, length)) { return false; }
+	offset += core_cpu.size();
+
+	if((offset > length) || (!core_mmu.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_mmu.size();
+
+	if((offset > length) || (!core_cpu.controllers.audio.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_cpu.controllers.audio.size();
+
+	if((offset > length) || (!core_cpu.controllers.video.deserialize((buffer + offset), (length - offset)))) { return false; }
+
+	return true;
+}
+
+/****** Lists the components of a save state in order, returns the system's tag ******/
+u32 AGB_core::get_state_sections(std::vector<state_section> &sections)
+{
+	sections.clear();
+	sections.push_back({ GBE_STATE_TAG('C', 'P', 'U', ' '), core_cpu.size() });
+	sections.push_back({ GBE_STATE_TAG('M', 'M', 'U', ' '), core_mmu.size() });
+	sections.push_back({ GBE_STATE_TAG('A', 'P', 'U', ' '), core_cpu.controllers.audio.size() });
+	sections.push_back({ GBE_STATE_TAG('L', 'C', 'D', ' '), core_cpu.controllers.video.size() });
+
+	return GBE_STATE_TAG('A', 'G', 'B', ' ');
+}
+
 /****** Run the core in a loop until exit ******/
 void AGB_core::run_core()
 {
@@ -281,7 +360,9 @@ void AGB_core::run_core()
 			|| (event.type == SDL_JOYAXISMOTION) || (event.type == SDL_JOYHATMOTION)
 			|| (event.type == SDL_CONTROLLERSENSORUPDATE))
 			{
+				movie_data.begin_live_input(this);
 				core_pad.handle_input(event);
+				movie_data.end_live_input(this);
 				handle_hotkey(event);
 
 				//Trigger Joypad Interrupt if necessary
@@ -301,11 +382,15 @@ void AGB_core::run_core()
 				//Perform syncing operations when hard sync is enabled
 				if(config::netplay_hard_sync) { hard_sync(); }
 
+				PROFILER_ENTER(PROF_SIO);
+
 				//Receive bytes normally
 				core_cpu.controllers.serial_io.receive_byte();
 
 				//Clock SIO
 				core_cpu.clock_sio();
+
+				PROFILER_LEAVE();
 			}
 
 			//Otherwise, try to run any emulate SIO devices attached to GBE+
@@ -333,6 +418,8 @@ void AGB_core::run_core()
 
 			if(db_unit.debug_mode) { debug_step(); }
 
+			PROFILER_ENTER(PROF_CPU);
+
 			core_cpu.fetch();
 			core_cpu.decode();
 			core_cpu.execute();
@@ -348,6 +435,41 @@ void AGB_core::run_core()
 				core_cpu.pipeline_pointer = (core_cpu.pipeline_pointer + 1) % 3;
 				core_cpu.update_pc(); 
 			}
+
+			PROFILER_CYCLES(PROF_CPU, core_cpu.system_cycles);
+			PROFILER_LEAVE();
+
+			//Record or play back input movies once per frame
+			if((movie_data.active) && (!run_ahead_data.active) && (movie_data.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				movie_data.update(this, core_cpu.controllers.video.frame_count);
+			}
+
+			//Write changed battery save data in the background every few seconds
+			if((config::save_flush_interval) && (!run_ahead_data.active) && (save_sync.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				save_sync.update(this, core_cpu.controllers.video.frame_count);
+			}
+
+			//Record presented frames and mixed audio
+			if((av_capture.active) && (!run_ahead_data.active) && (av_capture.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				av_capture.update(core_cpu.controllers.video.screen_buffer, config::sys_width, core_cpu.controllers.video.frame_count);
+			}
+
+			//Capture or restore rewind snapshots once per frame, except while a movie is active
+			if((config::rewind_buffer_size) && (!run_ahead_data.active) && (!movie_data.active) && (rewind_data.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				rewind_data.update(this, core_cpu.controllers.video.frame_count);
+			}
+
+			//Run ahead of the real frame to hide input lag, audio from frames ahead is never recorded
+			if((!run_ahead_data.active) && (run_ahead_data.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				av_capture.hold_audio = true;
+				run_ahead_data.update(this, core_cpu.controllers.video.frame_count, core_cpu.controllers.video.present_frame, core_cpu.controllers.video.realtime_frame);
+				av_capture.hold_audio = false;
+			}
 		}
 
 		//Stop emulation
@@ -364,6 +486,11 @@ void AGB_core::step()
 	//Run the CPU
 	if(core_cpu.running)
 	{	
+		//Reset system cycles for next instruction
+		core_cpu.system_cycles = 0;
+
+		PROFILER_ENTER(PROF_CPU);
+
 		core_cpu.fetch();
 		core_cpu.decode();
 		core_cpu.execute();
@@ -379,6 +506,41 @@ void AGB_core::step()
 			core_cpu.pipeline_pointer = (core_cpu.pipeline_pointer + 1) % 3;
 			core_cpu.update_pc(); 
 		}
+
+		PROFILER_CYCLES(PROF_CPU, core_cpu.system_cycles);
+		PROFILER_LEAVE();
+
+		//Record or play back input movies once per frame
+		if((movie_data.active) && (!run_ahead_data.active) && (movie_data.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			movie_data.update(this, core_cpu.controllers.video.frame_count);
+		}
+
+		//Write changed battery save data in the background every few seconds
+		if((config::save_flush_interval) && (!run_ahead_data.active) && (save_sync.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			save_sync.update(this, core_cpu.controllers.video.frame_count);
+		}
+
+		//Record presented frames and mixed audio
+		if((av_capture.active) && (!run_ahead_data.active) && (av_capture.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			av_capture.update(core_cpu.controllers.video.screen_buffer, config::sys_width, core_cpu.controllers.video.frame_count);
+		}
+
+		//Capture or restore rewind snapshots once per frame, except while a movie is active
+		if((config::rewind_buffer_size) && (!run_ahead_data.active) && (!movie_data.active) && (rewind_data.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			rewind_data.update(this, core_cpu.controllers.video.frame_count);
+		}
+
+		//Run ahead of the real frame to hide input lag, audio from frames ahead is never recorded
+		if((!run_ahead_data.active) && (run_ahead_data.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			av_capture.hold_audio = true;
+			run_ahead_data.update(this, core_cpu.controllers.video.frame_count, core_cpu.controllers.video.present_frame, core_cpu.controllers.video.realtime_frame);
+			av_capture.hold_audio = false;
+		}
 	}
 }
 	
@@ -422,6 +584,17 @@ void AGB_core::handle_hotkey(SDL_Event& event)
 		load_state(0);
 	}
 
+	//Rewind while held
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == config::hotkey_rewind))
+	{
+		rewind_data.rewinding = (config::rewind_buffer_size != 0);
+	}
+
+	else if((event.type == SDL_KEYUP) && (event.key.keysym.sym == config::hotkey_rewind))
+	{
+		rewind_data.rewinding = false;
+	}
+
 	//Cancel sub screen on F3
 	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_F3)) 
 	{
@@ -470,9 +643,9 @@ void AGB_core::handle_hotkey(SDL_Event& event)
 		//Append random number to screenshot name
 		srand(SDL_GetTicks());
 		save_stream << rand() % 1024 << rand() % 1024 << rand() % 1024;
-		save_name += save_stream.str() + ".bmp";
+		save_name += save_stream.str() + ".png";
 	
-		SDL_SaveBMP(core_cpu.controllers.video.final_screen, save_name.c_str());
+		screenshots.save(core_cpu.controllers.video.final_screen, save_name);
 
 		//OSD
 		config::osd_message = "SAVED SCREENSHOT";
@@ -544,6 +717,7 @@ void AGB_core::handle_hotkey(SDL_Event& event)
 				config::pause_emu = false;
 				SDL_PauseAudio(0);
 				std::cout<<"EMU::Unpaused\n";
+				frame_pacer::notify_resume();
 			}
 		}
 	}
@@ -594,6 +768,9 @@ void AGB_core::handle_hotkey(int input, bool pressed)
 	//Toggle turbo off
 	else if((input == config::hotkey_turbo) && (!pressed)) { config::turbo = false; }
 
+	//Rewind while held
+	else if(input == config::hotkey_rewind) { rewind_data.rewinding = ((pressed) && (config::rewind_buffer_size != 0)); }
+
 	//Initiate various communication functions
 	//Soul Doll Adapter - Reset Soul Doll
 	else if((input == SDLK_F3) && (pressed))
@@ -641,10 +818,58 @@ void AGB_core::update_volume(u8 volume)
 /****** Feeds key input from an external source (useful for TAS) ******/
 void AGB_core::feed_key_input(int sdl_key, bool pressed)
 {
+	movie_data.begin_live_input(this);
 	core_pad.process_keyboard(sdl_key, pressed);
+	movie_data.end_live_input(this);
 	handle_hotkey(sdl_key, pressed);
 }
 
+/****** Captures the GamePad's state for input movies ******/
+void AGB_core::get_movie_input(movie_input &input)
+{
+	input.keys = core_pad.key_input;
+	input.touch_x = 0;
+	input.touch_y = 0;
+	input.sensor_x = core_pad.sensor_x;
+	input.sensor_y = core_pad.sensor_y;
+	input.gyro_value = core_pad.gyro_value;
+	input.gyro_flags = core_pad.gyro_flags;
+	input.solar_value = core_pad.solar_value;
+}
+
+/****** Applies GamePad state from input movies, triggers the Joypad Interrupt on new frames ******/
+void AGB_core::set_movie_input(const movie_input &input, bool new_frame)
+{
+	u16 last_input = core_pad.key_input;
+	u16 key_mask = (core_pad.key_cnt & 0x3FF);
+
+	core_pad.key_input = input.keys;
+	core_pad.gyro_flags = input.gyro_flags;
+	core_pad.solar_value = input.solar_value;
+	core_pad.joypad_irq = false;
+
+	if(!new_frame) { return; }
+
+	//Sensors keep moving on their own during a frame, so only set them at frame boundaries
+	core_pad.sensor_x = input.sensor_x;
+	core_pad.sensor_y = input.sensor_y;
+	core_pad.gyro_value = input.gyro_value;
+
+	if((last_input == core_pad.key_input) || (core_pad.key_input == 0x3FF)) { return; }
+
+	//Logical OR mode
+	if(((core_pad.key_cnt & 0x8000) == 0) && (~core_pad.key_input & key_mask)) { core_mmu.memory_map[REG_IF + 1] |= 0x10; }
+
+	//Logical AND mode
+	else if((core_pad.key_cnt & 0x8000) && ((~core_pad.key_input & key_mask) == key_mask)) { core_mmu.memory_map[REG_IF + 1] |= 0x10; }
+}
+
+/****** Copies battery-backed save data for background writes ******/
+bool AGB_core::get_save_image(std::vector<u8> &image)
+{
+	return core_mmu.get_save_image(image);
+}
+
 /****** Return a CPU register ******/
 u32 AGB_core::ex_get_reg(u8 reg_index)
 {
@@ -63,7 +63,7 @@ void AGB_MMU::write_glucoboy(u32 address, u8 value)
 			//On this index, update Glucoboy with system date
 			case 0x20:
 				{
-					time_t system_time = time(0);
+					time_t system_time = (config::fixed_rtc_time) ? config::fixed_rtc_time : time(0);
 					tm* current_time = localtime(&system_time);
 
 					u8 min = current_time->tm_min;
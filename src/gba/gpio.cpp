@@ -13,6 +13,7 @@
 
 #include "mmu.h"
 #include "common/util.h"
+#include "common/rtc_time.h"
 
 //Handles GPIO for the Real-Time Clock
 void AGB_MMU::process_rtc()
@@ -97,46 +98,31 @@ void AGB_MMU::process_rtc()
 									gpio.state = 0x103;
 									u8 raw_hours = 0;
 
-									//Grab local time
-									time_t system_time = time(0);
-									tm* current_time = localtime(&system_time);
+									//Grab local time with RTC offsets
+									rtc_date current_time = get_rtc_date();
 
 									//Year
-									gpio.serial_data[0] = (current_time->tm_year % 100);
-									gpio.serial_data[0] = util::get_bcd(gpio.serial_data[0]);
+									gpio.serial_data[0] = util::get_bcd(current_time.year % 100);
 
 									//Month
-									gpio.serial_data[1] = (current_time->tm_mon + 1);
-									gpio.serial_data[1] = util::get_bcd(gpio.serial_data[1]);
+									gpio.serial_data[1] = util::get_bcd(current_time.month);
 
 									//Day of month
-									gpio.serial_data[2] = current_time->tm_mday;
-									gpio.serial_data[2] = util::get_bcd(gpio.serial_data[2]);
+									gpio.serial_data[2] = util::get_bcd(current_time.day);
 									
 									//Day of week
-									gpio.serial_data[3] = current_time->tm_wday;
-									gpio.serial_data[3] = util::get_bcd(gpio.serial_data[3]);
+									gpio.serial_data[3] = util::get_bcd(current_time.weekday);
 
 									//Hours
-									gpio.serial_data[4] = current_time->tm_hour;
-									gpio.serial_data[4] += config::rtc_offset[2];
-									gpio.serial_data[4] = (gpio.rtc_control & 0x40) ? (gpio.serial_data[4] % 24) : (gpio.serial_data[4] % 12);
+									gpio.serial_data[4] = (gpio.rtc_control & 0x40) ? (current_time.hour % 24) : (current_time.hour % 12);
 									raw_hours = gpio.serial_data[4];
 									gpio.serial_data[4] = util::get_bcd(gpio.serial_data[4]);
 									
 									//Minutes
-									gpio.serial_data[5] = current_time->tm_min;
-									gpio.serial_data[5] += config::rtc_offset[1];
-									gpio.serial_data[5] = (gpio.serial_data[5] % 60);
-									gpio.serial_data[5] = util::get_bcd(gpio.serial_data[5]);
-
-									//Seconds - Disregard tm_sec's 60 or 61 seconds
-									gpio.serial_data[6] = current_time->tm_sec;
-									if(gpio.serial_data[6] > 59) { gpio.serial_data[6] = 59; }
-
-									gpio.serial_data[6] += config::rtc_offset[0];
-									gpio.serial_data[6] = (gpio.serial_data[6] % 60);
-									gpio.serial_data[6] = util::get_bcd(gpio.serial_data[6]);
+									gpio.serial_data[5] = util::get_bcd(current_time.minute);
+
+									//Seconds
+									gpio.serial_data[6] = util::get_bcd(current_time.second);
 								}
 
 								//Receive 7 bytes for date+time
@@ -154,30 +140,19 @@ void AGB_MMU::process_rtc()
 									gpio.state = 0x103;
 									u8 raw_hours = 0;
 
-									//Grab local time
-									time_t system_time = time(0);
-									tm* current_time = localtime(&system_time);
+									//Grab local time with RTC offsets
+									rtc_date current_time = get_rtc_date();
 
 									//Hours
-									gpio.serial_data[0] = current_time->tm_hour;
-									gpio.serial_data[0] += config::rtc_offset[2];
-									gpio.serial_data[0] = (gpio.rtc_control & 0x40) ? (gpio.serial_data[0] % 24) : (gpio.serial_data[0] % 12);
+									gpio.serial_data[0] = (gpio.rtc_control & 0x40) ? (current_time.hour % 24) : (current_time.hour % 12);
 									raw_hours = gpio.serial_data[0];
 									gpio.serial_data[0] = util::get_bcd(gpio.serial_data[0]);
 									
 									//Minutes
-									gpio.serial_data[1] = current_time->tm_min;
-									gpio.serial_data[1] += config::rtc_offset[1];
-									gpio.serial_data[1] = (gpio.serial_data[1] % 60);
-									gpio.serial_data[1] = util::get_bcd(gpio.serial_data[1]);
-
-									//Seconds - Disregard tm_sec's 60 or 61 seconds
-									gpio.serial_data[2] = current_time->tm_sec;
-									if(gpio.serial_data[2] > 59) { gpio.serial_data[2] = 59; }
-
-									gpio.serial_data[2] += config::rtc_offset[0];
-									gpio.serial_data[2] = (gpio.serial_data[2] % 60);
-									gpio.serial_data[2] = util::get_bcd(gpio.serial_data[2]);
+									gpio.serial_data[1] = util::get_bcd(current_time.minute);
+
+									//Seconds
+									gpio.serial_data[2] = util::get_bcd(current_time.second);
 								}
 
 								//Write 3 bytes for time
@@ -10,13 +10,19 @@
 // Responsible for blitting pixel data and limiting frame rate
 
 #include <cmath>
+#include <cstring>
 
 #include "lcd.h"
 #include "common/util.h"
+#include "common/profiler.h"
 
 /****** LCD Constructor ******/
-AGB_LCD::AGB_LCD()
+AGB_LCD::AGB_LCD() : obj_render_list(), pal(), raw_pal(), bg_offset_x(), bg_offset_y()
 {
+	//Save states store these structs as raw bytes, so clear their padding as well
+	memset(&lcd_stat, 0, sizeof(lcd_stat));
+	memset(obj, 0, sizeof(obj));
+
 	window = NULL;
 	reset();
 }
@@ -36,6 +42,7 @@ void AGB_LCD::reset()
 	final_screen = NULL;
 	original_screen = NULL;
 	mem = NULL;
+	audio_output = NULL;
 
 	if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
 	window = NULL;
@@ -46,18 +53,14 @@ void AGB_LCD::reset()
 	lcd_clock = 0;
 	lcd_mode = 0;
 
-	frame_start_time = 0;
-	frame_current_time = 0;
 	fps_count = 0;
+	frame_count = 0;
+	present_frame = true;
+	realtime_frame = true;
+	skip_frame = false;
 	fps_time = 0;
 
-	for(u32 x = 0; x < 60; x++)
-	{
-		u16 max = (config::max_fps) ? config::max_fps : 60;
-		double frame_1 = ((1000.0 / max) * x);
-		double frame_2 = ((1000.0 / max) * (x + 1));
-		frame_delay[x] = (std::round(frame_2) - std::round(frame_1));
-	}
+	pacer.reset((config::max_fps) ? config::max_fps : 60);
 
 	current_scanline = 0;
 	scanline_pixel_counter = 0;
@@ -1481,10 +1484,15 @@ void AGB_LCD::step()
 		}
 
 		//Render scanline data (per-pixel every 4 cycles)
+		//Pixels are only drawn for frames that will be shown, timing continues regardless
 		if((lcd_clock % 4) == 0) 
 		{
-			render_scanline();
-			if(lcd_stat.current_sfx_type != NORMAL) { apply_sfx(); }
+			if((present_frame) && (!skip_frame))
+			{
+				render_scanline();
+				if(lcd_stat.current_sfx_type != NORMAL) { apply_sfx(); }
+			}
+
 			scanline_pixel_counter++;
 		}
 	}
@@ -1504,8 +1512,11 @@ void AGB_LCD::step()
 			//Raise HBlank interrupt
 			if(mem->memory_map[DISPSTAT] & 0x10) { mem->memory_map[REG_IF] |= 0x2; }
 
+			//Skipped frames leave the final buffer alone
+			if((!present_frame) || (skip_frame)) { }
+
 			//Push scanline data to final buffer - Only if Forced Blank is disabled
-			if((lcd_stat.display_control & 0x80) == 0)
+			else if((lcd_stat.display_control & 0x80) == 0)
 			{
 				for(int x = 0, y = (240 * current_scanline); x < 240; x++, y++)
 				{
@@ -1589,6 +1600,12 @@ void AGB_LCD::step()
 				draw_osd_msg(config::osd_message, screen_buffer, 0, 0);
 			}
 
+			//Display profiler counters
+			PROFILER_DRAW_OSD(screen_buffer);
+
+			//Display frame time statistics
+			pacer.draw_osd(screen_buffer);
+
 			//Process Power Antenna
 			if(power_antenna_osd)
 			{
@@ -1606,71 +1623,36 @@ void AGB_LCD::step()
 			//Process Turbo Buttons
 			if(mem->g_pad->turbo_button_enabled) { mem->g_pad->process_turbo_buttons(); }
 
-			//Use SDL
-			if(config::sdl_render)
+			//Present frame unless it is hidden (e.g. run-ahead) or skipped
+			if((present_frame) && (!skip_frame))
 			{
-				//If using SDL and no OpenGL, manually stretch for fullscreen via SDL
-				if((config::flags & SDL_WINDOW_FULLSCREEN) && (!config::use_opengl))
+				//Use SDL
+				if(config::sdl_render)
 				{
-					//Lock source surface
-					if(SDL_MUSTLOCK(original_screen)){ SDL_LockSurface(original_screen); }
-					u32* out_pixel_data = (u32*)original_screen->pixels;
-
-					for(int a = 0; a < 0x9600; a++)
-					{
-						out_pixel_data[a] = screen_buffer[a];
-						if(mem->sub_screen_buffer.size()) { out_pixel_data[0x9600 + a] = mem->sub_screen_buffer[a]; }
-					}
-
-					//Unlock source surface
-					if(SDL_MUSTLOCK(original_screen)){ SDL_UnlockSurface(original_screen); }
-		
-					//Blit the original surface to the final stretched one
-					SDL_Rect dest_rect;
-					dest_rect.w = config::sys_width * max_fullscreen_ratio;
-					dest_rect.h = config::sys_height * max_fullscreen_ratio;
-					dest_rect.x = ((config::win_width - dest_rect.w) >> 1);
-					dest_rect.y = ((config::win_height - dest_rect.h) >> 1);
-					SDL_BlitScaled(original_screen, NULL, final_screen, &dest_rect);
-
-					if(SDL_UpdateWindowSurface(window) != 0)
+					//If using SDL and no OpenGL, manually stretch for fullscreen via SDL
+					if((config::flags & SDL_WINDOW_FULLSCREEN) && (!config::use_opengl))
 					{
-						std::cout<<"LCD::Error - Could not blit\n";
+						//Lock source surface
+						if(SDL_MUSTLOCK(original_screen)){ SDL_LockSurface(original_screen); }
+						u32* out_pixel_data = (u32*)original_screen->pixels;
 
-						//Try to make a new the window if the blit failed
-						if(!try_window_rebuild)
+						for(int a = 0; a < 0x9600; a++)
 						{
-							try_window_rebuild = true;
-							if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
-							init();
+							out_pixel_data[a] = screen_buffer[a];
+							if(mem->sub_screen_buffer.size()) { out_pixel_data[0x9600 + a] = mem->sub_screen_buffer[a]; }
 						}
-					}
-
-					else { try_window_rebuild = false; }
-				}
-					
-				//Otherwise, render normally (SDL 1:1, OpenGL handles its own stretching)
-				else
-				{
-					//Lock source surface
-					if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
-					u32* out_pixel_data = (u32*)final_screen->pixels;
-
-					for(int a = 0; a < 0x9600; a++)
-					{
-						out_pixel_data[a] = screen_buffer[a];
-						if(mem->sub_screen_buffer.size()) { out_pixel_data[0x9600 + a] = mem->sub_screen_buffer[a]; }
-					}
 
-					//Unlock source surface
-					if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
+						//Unlock source surface
+						if(SDL_MUSTLOCK(original_screen)){ SDL_UnlockSurface(original_screen); }
 		
-					//Display final screen buffer - OpenGL
-					if(config::use_opengl) { opengl_blit(); }
-				
-					//Display final screen buffer - SDL
-					else 
-					{
+						//Blit the original surface to the final stretched one
+						SDL_Rect dest_rect;
+						dest_rect.w = config::sys_width * max_fullscreen_ratio;
+						dest_rect.h = config::sys_height * max_fullscreen_ratio;
+						dest_rect.x = ((config::win_width - dest_rect.w) >> 1);
+						dest_rect.y = ((config::win_height - dest_rect.h) >> 1);
+						SDL_BlitScaled(original_screen, NULL, final_screen, &dest_rect);
+
 						if(SDL_UpdateWindowSurface(window) != 0)
 						{
 							std::cout<<"LCD::Error - Could not blit\n";
@@ -1686,52 +1668,104 @@ void AGB_LCD::step()
 
 						else { try_window_rebuild = false; }
 					}
-				}
-			}
-
-			//Use external rendering method (GUI)
-			else
-			{
-				if(!config::use_opengl)
-				{
-					if(mem->sub_screen_buffer.size())
+					
+					//Otherwise, render normally (SDL 1:1, OpenGL handles its own stretching)
+					else
 					{
-						for(int a = 0; a < 0x9600; a++) { screen_buffer[0x9600 + a] = mem->sub_screen_buffer[a]; }
-					}
+						//Lock source surface
+						if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
+						u32* out_pixel_data = (u32*)final_screen->pixels;
 
-					config::render_external_sw(screen_buffer);
+						for(int a = 0; a < 0x9600; a++)
+						{
+							out_pixel_data[a] = screen_buffer[a];
+							if(mem->sub_screen_buffer.size()) { out_pixel_data[0x9600 + a] = mem->sub_screen_buffer[a]; }
+						}
+
+						//Unlock source surface
+						if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
+		
+						//Display final screen buffer - OpenGL
+						if(config::use_opengl) { opengl_blit(); }
+				
+						//Display final screen buffer - SDL
+						else 
+						{
+							if(SDL_UpdateWindowSurface(window) != 0)
+							{
+								std::cout<<"LCD::Error - Could not blit\n";
+
+								//Try to make a new the window if the blit failed
+								if(!try_window_rebuild)
+								{
+									try_window_rebuild = true;
+									if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
+									init();
+								}
+							}
+
+							else { try_window_rebuild = false; }
+						}
+					}
 				}
 
+				//Use external rendering method (GUI)
 				else
 				{
-					//Lock source surface
-					if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
-					u32* out_pixel_data = (u32*)final_screen->pixels;
-
-					for(int a = 0; a < 0x9600; a++)
+					if(!config::use_opengl)
 					{
-						out_pixel_data[a] = screen_buffer[a];
-						if(mem->sub_screen_buffer.size()) { out_pixel_data[0x9600 + a] = mem->sub_screen_buffer[a]; }
+						if(mem->sub_screen_buffer.size())
+						{
+							for(int a = 0; a < 0x9600; a++) { screen_buffer[0x9600 + a] = mem->sub_screen_buffer[a]; }
+						}
+
+						config::render_external_sw(screen_buffer);
 					}
 
-					//Unlock source surface
-					if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
+					else
+					{
+						//Lock source surface
+						if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
+						u32* out_pixel_data = (u32*)final_screen->pixels;
+
+						for(int a = 0; a < 0x9600; a++)
+						{
+							out_pixel_data[a] = screen_buffer[a];
+							if(mem->sub_screen_buffer.size()) { out_pixel_data[0x9600 + a] = mem->sub_screen_buffer[a]; }
+						}
+
+						//Unlock source surface
+						if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
 
-					config::render_external_hw(final_screen);
+						config::render_external_hw(final_screen);
+					}
 				}
 			}
 
 			//Limit framerate
-			if(!config::turbo)
+			if((!config::turbo) && (realtime_frame))
+			{
+				PROFILER_ENTER(PROF_IDLE);
+
+				//Pace on the audio device's clock when syncing to audio, otherwise wait for the frame's deadline
+				pacer.limit(audio_output);
+
+				PROFILER_LEAVE();
+			}
+
+			PROFILER_END_FRAME();
+
+			//Update FPS counter + title, frame time and health statistics
+			if(realtime_frame)
 			{
-				frame_current_time = SDL_GetTicks();
-				int delay = frame_delay[fps_count % 60];
-				if((frame_current_time - frame_start_time) < delay) { SDL_Delay(delay - (frame_current_time - frame_start_time));}
-				frame_start_time = SDL_GetTicks();
+				fps_count++;
+				pacer.record(audio_output);
 			}
 
-			//Update FPS counter + title
-			fps_count++;
+			frame_count++;
+
+			//While in turbo, only render 1 out of every N+1 frames
+			skip_frame = (config::turbo) && (config::turbo_frameskip) && ((frame_count % (config::turbo_frameskip + 1)) != 0);
 			if(((SDL_GetTicks() - fps_time) >= 1000) && (config::sdl_render))
 			{ 
 				fps_time = SDL_GetTicks(); 
@@ -1881,100 +1915,116 @@ void AGB_LCD::reload_affine_references(u32 bg_control)
 }
 
 /****** Read LCD data from save state ******/
-bool AGB_LCD::lcd_read(u32 offset, std::string filename)
+bool AGB_LCD::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize LCD data from save state
-	file.read((char*)&lcd_stat, sizeof(lcd_stat));
+	state.read(&lcd_stat, sizeof(lcd_stat));
 
 	//Serialize OBJ data from save state
 	for(int x = 0; x < 128; x++)
 	{
-		file.read((char*)&obj[x], sizeof(obj[x]));
-		file.read((char*)&obj_render_list[x], sizeof(obj_render_list[x]));
+		state.read(&obj[x], sizeof(obj[x]));
+		state.read(&obj_render_list[x], sizeof(obj_render_list[x]));
 	}
 
 	//Serialize Misc LCD data from save state
-	file.read((char*)&lcd_mode, sizeof(lcd_mode));
-	file.read((char*)&current_scanline, sizeof(current_scanline));
-	file.read((char*)&lcd_clock, sizeof(lcd_clock));
-	file.read((char*)&obj_render_length, sizeof(obj_render_length));
-	file.read((char*)&last_obj_priority, sizeof(last_obj_priority));
-	file.read((char*)&last_obj_mode, sizeof(last_obj_mode));
-	file.read((char*)&last_bg_priority, sizeof(last_bg_priority));
-	file.read((char*)&last_raw_color, sizeof(last_raw_color));
-	file.read((char*)&obj_win_pixel, sizeof(obj_win_pixel));
-	file.read((char*)&scanline_pixel_counter, sizeof(scanline_pixel_counter));
+	state.read(&lcd_mode, sizeof(lcd_mode));
+	state.read(&current_scanline, sizeof(current_scanline));
+	state.read(&lcd_clock, sizeof(lcd_clock));
+	state.read(&obj_render_length, sizeof(obj_render_length));
+	state.read(&last_obj_priority, sizeof(last_obj_priority));
+	state.read(&last_obj_mode, sizeof(last_obj_mode));
+	state.read(&last_bg_priority, sizeof(last_bg_priority));
+	state.read(&last_raw_color, sizeof(last_raw_color));
+	state.read(&obj_win_pixel, sizeof(obj_win_pixel));
+	state.read(&scanline_pixel_counter, sizeof(scanline_pixel_counter));
 
 	for(int x = 0; x < 256; x++)
 	{
 		for(int y = 0; y < 2; y++)
 		{
-			file.read((char*)&pal[x][y], sizeof(pal[x][y]));
-			file.read((char*)&raw_pal[x][y], sizeof(raw_pal[x][y]));
+			state.read(&pal[x][y], sizeof(pal[x][y]));
+			state.read(&raw_pal[x][y], sizeof(raw_pal[x][y]));
 		}
 	}
 
 	for(int x = 0; x < 4; x++)
 	{
-		file.read((char*)&bg_offset_x[x], sizeof(bg_offset_x[x]));
-		file.read((char*)&bg_offset_y[x], sizeof(bg_offset_y[x]));
+		state.read(&bg_offset_x[x], sizeof(bg_offset_x[x]));
+		state.read(&bg_offset_y[x], sizeof(bg_offset_y[x]));
 	}
 
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Read LCD data from save state ******/
-bool AGB_LCD::lcd_write(std::string filename)
+bool AGB_LCD::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize LCD data to save state
-	file.write((char*)&lcd_stat, sizeof(lcd_stat));
+	state.write(&lcd_stat, sizeof(lcd_stat));
 
 	//Serialize OBJ data to save state
 	for(int x = 0; x < 128; x++)
 	{
-		file.write((char*)&obj[x], sizeof(obj[x]));
-		file.write((char*)&obj_render_list[x], sizeof(obj_render_list[x]));
+		state.write(&obj[x], sizeof(obj[x]));
+		state.write(&obj_render_list[x], sizeof(obj_render_list[x]));
 	}
 
 	//Serialize Misc LCD data to save state
-	file.write((char*)&lcd_mode, sizeof(lcd_mode));
-	file.write((char*)&current_scanline, sizeof(current_scanline));
-	file.write((char*)&lcd_clock, sizeof(lcd_clock));
-	file.write((char*)&obj_render_length, sizeof(obj_render_length));
-	file.write((char*)&last_obj_priority, sizeof(last_obj_priority));
-	file.write((char*)&last_obj_mode, sizeof(last_obj_mode));
-	file.write((char*)&last_bg_priority, sizeof(last_bg_priority));
-	file.write((char*)&last_raw_color, sizeof(last_raw_color));
-	file.write((char*)&obj_win_pixel, sizeof(obj_win_pixel));
-	file.write((char*)&scanline_pixel_counter, sizeof(scanline_pixel_counter));
+	state.write(&lcd_mode, sizeof(lcd_mode));
+	state.write(&current_scanline, sizeof(current_scanline));
+	state.write(&lcd_clock, sizeof(lcd_clock));
+	state.write(&obj_render_length, sizeof(obj_render_length));
+	state.write(&last_obj_priority, sizeof(last_obj_priority));
+	state.write(&last_obj_mode, sizeof(last_obj_mode));
+	state.write(&last_bg_priority, sizeof(last_bg_priority));
+	state.write(&last_raw_color, sizeof(last_raw_color));
+	state.write(&obj_win_pixel, sizeof(obj_win_pixel));
+	state.write(&scanline_pixel_counter, sizeof(scanline_pixel_counter));
 
 	for(int x = 0; x < 256; x++)
 	{
 		for(int y = 0; y < 2; y++)
 		{
-			file.write((char*)&pal[x][y], sizeof(pal[x][y]));
-			file.write((char*)&raw_pal[x][y], sizeof(raw_pal[x][y]));
+			state.write(&pal[x][y], sizeof(pal[x][y]));
+			state.write(&raw_pal[x][y], sizeof(raw_pal[x][y]));
 		}
 	}
 
 	for(int x = 0; x < 4; x++)
 	{
-		file.write((char*)&bg_offset_x[x], sizeof(bg_offset_x[x]));
-		file.write((char*)&bg_offset_y[x], sizeof(bg_offset_y[x]));
+		state.write(&bg_offset_x[x], sizeof(bg_offset_x[x]));
+		state.write(&bg_offset_y[x], sizeof(bg_offset_y[x]));
 	}
 
-	file.close();
 	return true;
 }
+
+/****** Gets the size of LCD data for serialization ******/
+u32 AGB_LCD::size()
+{
+	u32 lcd_size = 0;
+
+	lcd_size += sizeof(lcd_stat);
+	lcd_size += ((sizeof(obj[0]) + sizeof(obj_render_list[0])) * 128);
+
+	lcd_size += sizeof(lcd_mode);
+	lcd_size += sizeof(current_scanline);
+	lcd_size += sizeof(lcd_clock);
+	lcd_size += sizeof(obj_render_length);
+	lcd_size += sizeof(last_obj_priority);
+	lcd_size += sizeof(last_obj_mode);
+	lcd_size += sizeof(last_bg_priority);
+	lcd_size += sizeof(last_raw_color);
+	lcd_size += sizeof(obj_win_pixel);
+	lcd_size += sizeof(scanline_pixel_counter);
+
+	lcd_size += ((sizeof(pal[0][0]) + sizeof(raw_pal[0][0])) * 512);
+	lcd_size += ((sizeof(bg_offset_x[0]) + sizeof(bg_offset_y[0])) * 4);
+
+	return lcd_size;
+}
@@ -12,6 +12,8 @@
 #include "SDL2/SDL.h"
 #include "SDL2/SDL_opengl.h"
 #include "mmu.h"
+#include "common/audio_buffer.h"
+#include "common/frame_pacer.h"
 
 #ifndef GBA_LCD
 #define GBA_LCD
@@ -23,6 +25,9 @@ class AGB_LCD
 	//Link to memory map
 	AGB_MMU* mem;
 
+	//Link to APU output for audio sync
+	audio_buffer* audio_output;
+
 	u8 lcd_mode;
 	u8 current_scanline;
 
@@ -38,13 +43,15 @@ class AGB_LCD
 	void clear_screen_buffer(u32 color);
 
 	//Serialize data for save state loading/saving
-	bool lcd_read(u32 offset, std::string filename);
-	bool lcd_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
+	u32 size();
 
 	//Screen data
 	SDL_Window* window;
 	SDL_Surface* final_screen;
 	SDL_Surface* original_screen;
+	std::vector<u32> screen_buffer;
 
 	//OpenGL data
 	#ifdef GBE_OGL
@@ -63,6 +70,19 @@ class AGB_LCD
 	int max_fullscreen_ratio;
 	bool power_antenna_osd;
 
+	//Frames completed since reset
+	u32 frame_count;
+
+	//Frame output controls - Blit to screen, throttle and count towards FPS
+	bool present_frame;
+	bool realtime_frame;
+
+	//Leaves the frame unrendered (turbo frameskip)
+	bool skip_frame;
+
+	//Component microbenchmarks drive the rendering kernels directly
+	friend class micro_bench;
+
 	private:
 
 	void update_oam();
@@ -136,15 +156,12 @@ class AGB_LCD
 
 	//Screen pixel buffer
 	std::vector<u32> scanline_buffer;
-	std::vector<u32> screen_buffer;
 
 	u32 scanline_pixel_counter;
 
-	int frame_start_time;
-	int frame_current_time;
 	int fps_count;
 	int fps_time;
-	int frame_delay[60];
+	frame_pacer pacer;
 
 	bool try_window_rebuild;
 
@@ -9,13 +9,20 @@
 // Handles reading and writing bytes to memory locations
 
 #include <filesystem>
+#include <cstring>
 
 #include "mmu.h"
 #include "common/util.h"
+#include "common/rom_patch.h"
+#include "common/save_flusher.h"
 
 /****** MMU Constructor ******/
-AGB_MMU::AGB_MMU() 
+AGB_MMU::AGB_MMU() : eeprom()
 {
+	//Save states store these structs as raw bytes, so clear their padding as well
+	memset(dma, 0, sizeof(dma));
+	memset(&gpio, 0, sizeof(gpio));
+
 	reset();
 }
 
@@ -46,8 +53,10 @@ AGB_MMU::~AGB_MMU()
 /****** MMU Reset ******/
 void AGB_MMU::reset()
 {
+	//Start from fresh zero pages, only the regions actually used get committed
 	memory_map.clear();
-	memory_map.resize(0x10000000, 0);
+	memory_map.shrink_to_fit();
+	memory_map.resize(0x10000000);
 
 	eeprom.data.clear();
 	eeprom.data.resize(0x200, 0);
@@ -2232,7 +2241,11 @@ bool AGB_MMU::read_file(std::string filename)
 		return true;
 	}
 
-	std::ifstream file(filename.c_str(), std::ios::binary);
+	//Patched ROMs are built once and cached, then read like any other ROM
+	std::string rom_source = filename;
+	bool patch_in_memory = (config::use_patches) && (!get_patched_rom(filename, rom_source, 0x2000000));
+
+	std::ifstream file(rom_source.c_str(), std::ios::binary);
 
 	if(!file.is_open()) 
 	{
@@ -2309,7 +2322,22 @@ bool AGB_MMU::read_file(std::string filename)
 	}	
 
 	//Read data from the ROM file
-	else { file.read((char*)ex_mem, file_size); }
+	else
+	{
+		file.read((char*)ex_mem, file_size);
+
+		//Apply patches to the ROM data if they couldn't be cached
+		if(patch_in_memory)
+		{
+			std::vector<u8> rom_data(ex_mem, (ex_mem + file_size));
+
+			if(patch_rom_data(filename, rom_data, 0x2000000))
+			{
+				file_size = rom_data.size();
+				memcpy(ex_mem, rom_data.data(), file_size);
+			}
+		}
+	}
 
 	file.close();
 
@@ -2324,11 +2352,9 @@ bool AGB_MMU::read_file(std::string filename)
 		}
 	}
 
-	for(u32 x = 0; x < file_size; x++)
-	{
-		memory_map[0xA000000 + x] = memory_map[0x8000000 + x];
-		memory_map[0xC000000 + x] = memory_map[0x8000000 + x];
-	}
+	//Mirror ROM to the other wait state regions
+	memcpy(&memory_map[0xA000000], &memory_map[0x8000000], file_size);
+	memcpy(&memory_map[0xC000000], &memory_map[0x8000000], file_size);
 
 	std::string title = "";
 	for(u32 x = 0; x < 12; x++) { title += memory_map[0x80000A0 + x]; }
@@ -2346,21 +2372,6 @@ bool AGB_MMU::read_file(std::string filename)
 	std::cout<<"MMU::ROM CRC32: " << std::hex << util::get_crc32(&memory_map[0x8000000], file_size) << "\n";
 	std::cout<<"MMU::" << filename << " loaded successfully. \n";
 
-	//Apply patches to the ROM data
-	if(config::use_patches)
-	{
-		std::size_t dot = filename.find_last_of(".");
-		if(dot == std::string::npos) { dot = filename.size(); }
-
-		std::string patch_file = filename.substr(0, dot);
-
-		//Attempt a IPS patch
-		bool patch_pass = patch_ips(patch_file + ".ips");
-
-		//Attempt a UPS patch
-		if(!patch_pass) { patch_pass = patch_ups(patch_file + ".ups"); }
-	}
-
 	//Calculate 8-bit checksum
 	u8 checksum = 0;
 
@@ -2556,6 +2567,8 @@ bool AGB_MMU::read_bios(std::string filename)
 		u32 hash = 0;
 		u8 rank = 0;
 
+		get_firmware_hashes();
+
 		//Select BIOS is this order: Standard GBA, GameCube version, NDS ARM7TDMI GBA BIOS
 		for(u32 x = 0; x < config::bin_hashes.size(); x++)
 		{
@@ -2609,6 +2622,9 @@ bool AGB_MMU::load_backup(std::string filename)
 		 filename = config::save_path + util::get_filename_from_path(filename);
 	}
 
+	//Finish any background save write that was interrupted
+	save_flusher::recover(filename);
+
 	//Import save if applicable
 	if(!config::save_import_path.empty()) { filename = config::save_import_path; }
 
@@ -2797,6 +2813,24 @@ bool AGB_MMU::load_backup(std::string filename)
 	return true;
 }
 
+/****** Copies battery-backed save data exactly as save_backup() lays it out ******/
+bool AGB_MMU::get_save_image(std::vector<u8> &image)
+{
+	if(current_save_type == SRAM) { image.assign(&memory_map[0xE000000], &memory_map[0xE008000]); }
+	else if(current_save_type == EEPROM) { image.assign(eeprom.data.begin(), (eeprom.data.begin() + eeprom.size)); }
+
+	else if((current_save_type == FLASH_64) || (current_save_type == FLASH_128))
+	{
+		image.assign(flash_ram.data[0].begin(), (flash_ram.data[0].begin() + 0x10000));
+		if(current_save_type == FLASH_128) { image.insert(image.end(), flash_ram.data[1].begin(), (flash_ram.data[1].begin() + 0x10000)); }
+	}
+
+	//DACS, Jukebox, and Campho data are only written on exit
+	else { return false; }
+
+	return true;
+}
+
 /****** Save backup save data ******/
 bool AGB_MMU::save_backup(std::string filename)
 {
@@ -3518,229 +3552,6 @@ void AGB_MMU::magic_watch_recv()
 	}		
 }
 
-/****** Applies an IPS patch to a ROM loaded in memory ******/
-bool AGB_MMU::patch_ips(std::string filename)
-{
-	std::ifstream patch_file(filename.c_str(), std::ios::binary);
-
-	if(!patch_file.is_open()) 
-	{ 
-		std::cout<<"MMU::" << filename << " IPS patch file could not be opened. Check file path or permissions. \n";
-		return false;
-	}
-
-	//Get the file size
-	patch_file.seekg(0, patch_file.end);
-	u32 file_size = patch_file.tellg();
-	patch_file.seekg(0, patch_file.beg);
-
-	std::vector<u8> patch_data;
-	patch_data.resize(file_size, 0);
-
-	//Read patch file into buffer
-	u8* ex_patch = &patch_data[0];
-	patch_file.read((char*)ex_patch, file_size);
-
-	//Check header for PATCH string
-	if((patch_data[0] != 0x50) || (patch_data[1] != 0x41) || (patch_data[2] != 0x54) || (patch_data[3] != 0x43) || (patch_data[4] != 0x48))
-	{
-		std::cout<<"MMU::" << filename << " IPS patch file has invalid header\n";
-		return false;
-	}
-
-	bool end_of_file = false;
-	u32 patch_pos = 5;
-
-	while((patch_pos < file_size) && (!end_of_file))
-	{
-		//Grab a record offset - 3 bytes
-		if((patch_pos + 3) > file_size)
-		{
-			std::cout<<"MMU::" << filename << " file ends unexpectedly (OFFSET). Aborting further patching.\n";
-		}
-
-		u32 offset = (patch_data[patch_pos++] << 16) | (patch_data[patch_pos++] << 8) | patch_data[patch_pos++];
-
-		//Quit if EOF marker is reached
-		if(offset == 0x454F46) { end_of_file = true; break; }
-
-		//Grab record size - 2 bytes
-		if((patch_pos + 2) > file_size)
-		{
-			std::cout<<"MMU::" << filename << " file ends unexpectedly (DATA_SIZE). Aborting further patching.\n";
-			return false;
-		}
-
-		u16 data_size = (patch_data[patch_pos++] << 8) | patch_data[patch_pos++];
-
-		//Perform regular patching if size is non-zero
-		if(data_size)
-		{
-			if((patch_pos + data_size) > file_size)
-			{
-				std::cout<<"MMU::" << filename << " file ends unexpectedly (DATA). Aborting further patching.\n";
-				return false;
-			}
-
-			for(u32 x = 0; x < data_size; x++)
-			{
-				u8 patch_byte = patch_data[patch_pos++];
-
-				memory_map[0x8000000 + offset] = patch_byte;
-
-				offset++;
-			}
-		}
-
-		//Patch with RLE
-		else
-		{
-			//Grab Run-length size and value - 3 bytes
-			if((patch_pos + 3) > file_size)
-			{
-				std::cout<<"MMU::" << filename << " file ends unexpectedly (RLE). Aborting further patching.\n";
-				return false;
-			}
-
-			u16 rle_size = (patch_data[patch_pos++] << 8) | patch_data[patch_pos++];
-			u8 patch_byte = patch_data[patch_pos++];
-
-			for(u32 x = 0; x < rle_size; x++)
-			{
-				memory_map[0x8000000 + offset] = patch_byte;
-
-				offset++;
-			}
-		}
-	}
-
-	patch_file.close();
-	patch_data.clear();
-
-	return true;
-}
-
-/****** Applies an UPS patch to a ROM loaded in memory ******/
-bool AGB_MMU::patch_ups(std::string filename)
-{
-	std::ifstream patch_file(filename.c_str(), std::ios::binary);
-
-	if(!patch_file.is_open()) 
-	{ 
-		std::cout<<"MMU::" << filename << " UPS patch file could not be opened. Check file path or permissions. \n";
-		return false;
-	}
-
-	//Get the file size
-	patch_file.seekg(0, patch_file.end);
-	u32 file_size = patch_file.tellg();
-	patch_file.seekg(0, patch_file.beg);
-
-	std::vector<u8> patch_data;
-	patch_data.resize(file_size, 0);
-
-	//Read patch file into buffer
-	u8* ex_patch = &patch_data[0];
-	patch_file.read((char*)ex_patch, file_size);
-
-	//Check header for UPS1 string
-	if((patch_data[0] != 0x55) || (patch_data[1] != 0x50) || (patch_data[2] != 0x53) || (patch_data[3] != 0x31))
-	{
-		std::cout<<"MMU::" << filename << " UPS patch file has invalid header\n";
-		return false;
-	}
-
-	u32 patch_pos = 4;
-	u32 patch_size = file_size - 12;
-	u32 file_pos = 0;
-
-	//Grab file sizes
-	for(u32 x = 0; x < 2; x++)
-	{
-		//Grab variable width integer
-		u32 var_int = 0;
-		bool var_end = false;
-		u8 var_shift = 0;
-
-		while(!var_end)
-		{
-			//Grab byte from patch file
-			u8 var_byte = patch_data[patch_pos++];
-			
-			if(var_byte & 0x80)
-			{
-				var_int += ((var_byte & 0x7F) << var_shift);
-				var_end = true;
-			}
-
-			else
-			{
-				var_int += ((var_byte | 0x80) << var_shift);
-				var_shift += 7;
-			}
-		}
-	}
-
-	//Begin patching the source file
-	while(patch_pos < patch_size)
-	{
-		//Grab variable width integer
-		u32 var_int = 0;
-		bool var_end = false;
-		u8 var_shift = 0;
-
-		while(!var_end)
-		{
-			//Grab byte from patch file
-			u8 var_byte = patch_data[patch_pos++];
-			
-			if(var_byte & 0x80)
-			{
-				var_int += ((var_byte & 0x7F) << var_shift);
-				var_end = true;
-			}
-
-			else
-			{
-				var_int += ((var_byte | 0x80) << var_shift);
-				var_shift += 7;
-			}
-		}
-
-		//XOR data at offset with patch
-		var_end = false;
-		file_pos += var_int;
-
-		while(!var_end)
-		{
-			//Abort if patching greater than 32MB
-			if(file_pos > 0x2000000)
-			{
-				std::cout<<"MMU::" << filename << "patches beyond max ROM size. Aborting further patching.\n";
-				return false;
-			}
-
-			u8 patch_byte = patch_data[patch_pos++];
-
-			//Terminate patching for this chunk if encountering a zero byte
-			if(patch_byte == 0) { var_end = true; }
-
-			//Otherwise, use the byte to patch
-			else
-			{
-				memory_map[0x8000000 + file_pos] ^= patch_byte;
-			}
-
-			file_pos++;
-		}
-	}
-
-	patch_file.close();
-	patch_data.clear();
-
-	return true;
-}
-
 /****** Points the MMU to an lcd_data structure (FROM THE LCD ITSELF) ******/
 void AGB_MMU::set_lcd_data(agb_lcd_data* ex_lcd_stat) { lcd_stat = ex_lcd_stat; }
 
@@ -3754,191 +3565,189 @@ void AGB_MMU::set_sio_data(agb_sio_data* ex_sio_stat) { sio_stat = ex_sio_stat;
 void AGB_MMU::set_mw_data(mag_watch* ex_mw_data) { mw = ex_mw_data; }
 
 /****** Read MMU data from save state ******/
-bool AGB_MMU::mmu_read(u32 offset, std::string filename)
+bool AGB_MMU::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize WRAM from save state
 	u8* ex_mem = &memory_map[0x2000000];
-	file.read((char*)ex_mem, 0x40000);
+	state.read(ex_mem, 0x40000);
 
 	//Serialize WRAM from save state
 	ex_mem = &memory_map[0x3000000];
-	file.read((char*)ex_mem, 0x8000);
+	state.read(ex_mem, 0x8000);
 
 	//Serialize IO registers from save state
 	ex_mem = &memory_map[0x4000000];
-	file.read((char*)ex_mem, 0x400);
+	state.read(ex_mem, 0x400);
 
 	//Serialize BG and OBJ palettes from save state
 	ex_mem = &memory_map[0x5000000];
-	file.read((char*)ex_mem, 0x400);
+	state.read(ex_mem, 0x400);
 
 	//Serialize VRAM from save state
 	ex_mem = &memory_map[0x6000000];
-	file.read((char*)ex_mem, 0x18000);
+	state.read(ex_mem, 0x18000);
 
 	//Serialize OAM from save state
 	ex_mem = &memory_map[0x7000000];
-	file.read((char*)ex_mem, 0x400);
+	state.read(ex_mem, 0x400);
 
 	//Serialize SRAM from save state
 	ex_mem = &memory_map[0xE000000];
-	file.read((char*)ex_mem, 0x10000);
+	state.read(ex_mem, 0x10000);
 
 	//Serialize misc data from MMU from save state
-	file.read((char*)&current_save_type, sizeof(current_save_type));
-	file.read((char*)&n_clock, sizeof(n_clock));
-	file.read((char*)&s_clock, sizeof(s_clock));
-	file.read((char*)&bios_lock, sizeof(bios_lock));
-	file.read((char*)&dma[0], sizeof(dma[0]));
-	file.read((char*)&dma[1], sizeof(dma[1]));
-	file.read((char*)&dma[2], sizeof(dma[2]));
-	file.read((char*)&dma[3], sizeof(dma[3]));
-	file.read((char*)&gpio, sizeof(gpio));
+	state.read(&current_save_type, sizeof(current_save_type));
+	state.read(&n_clock, sizeof(n_clock));
+	state.read(&s_clock, sizeof(s_clock));
+	state.read(&bios_lock, sizeof(bios_lock));
+	state.read(&dma[0], sizeof(dma[0]));
+	state.read(&dma[1], sizeof(dma[1]));
+	state.read(&dma[2], sizeof(dma[2]));
+	state.read(&dma[3], sizeof(dma[3]));
+	state.read(&gpio, sizeof(gpio));
 
 	//Serialize EEPROM from save state
-	file.read((char*)&eeprom.bitstream_byte, sizeof(eeprom.bitstream_byte));
-	file.read((char*)&eeprom.address, sizeof(eeprom.address));
-	file.read((char*)&eeprom.dma_ptr, sizeof(eeprom.dma_ptr));
-	file.read((char*)&eeprom.size, sizeof(eeprom.size));
-	file.read((char*)&eeprom.size_lock, sizeof(eeprom.size_lock));
-	file.read((char*)&eeprom.data[0], eeprom.size);
+	state.read(&eeprom.bitstream_byte, sizeof(eeprom.bitstream_byte));
+	state.read(&eeprom.address, sizeof(eeprom.address));
+	state.read(&eeprom.dma_ptr, sizeof(eeprom.dma_ptr));
+	u16 eeprom_size = 0;
+	state.read(&eeprom_size, sizeof(eeprom_size));
+	state.read(&eeprom.size_lock, sizeof(eeprom.size_lock));
+
+	//Only accept real EEPROM sizes, and make sure the data can hold them before reading
+	if((eeprom_size != 0x200) && (eeprom_size != 0x2000)) { return false; }
+	if(eeprom.data.size() < eeprom_size) { eeprom.data.resize(eeprom_size, 0); }
+
+	eeprom.size = eeprom_size;
+	state.read(&eeprom.data[0], eeprom.size);
 
 	//Serialize FLASH RAM from save state
-	file.read((char*)&flash_ram.current_command, sizeof(flash_ram.current_command));
-	file.read((char*)&flash_ram.bank, sizeof(flash_ram.bank));
-	file.read((char*)&flash_ram.write_single_byte, sizeof(flash_ram.write_single_byte));
-	file.read((char*)&flash_ram.switch_bank, sizeof(flash_ram.switch_bank));
-	file.read((char*)&flash_ram.grab_ids, sizeof(flash_ram.grab_ids));
-	file.read((char*)&flash_ram.next_write, sizeof(flash_ram.next_write));
-	file.read((char*)&flash_ram.data[0][0], 0x10000);
-	file.read((char*)&flash_ram.data[1][0], 0x10000);
+	state.read(&flash_ram.current_command, sizeof(flash_ram.current_command));
+	state.read(&flash_ram.bank, sizeof(flash_ram.bank));
+	state.read(&flash_ram.write_single_byte, sizeof(flash_ram.write_single_byte));
+	state.read(&flash_ram.switch_bank, sizeof(flash_ram.switch_bank));
+	state.read(&flash_ram.grab_ids, sizeof(flash_ram.grab_ids));
+	state.read(&flash_ram.next_write, sizeof(flash_ram.next_write));
+	state.read(&flash_ram.data[0][0], 0x10000);
+	state.read(&flash_ram.data[1][0], 0x10000);
 
 	//Serialize AM3 data from save state
 	if(config::cart_type == AGB_AM3)
 	{
-		file.read((char*)&am3.read_sm_card, sizeof(am3.read_sm_card));
-		file.read((char*)&am3.read_key, sizeof(am3.read_key));
-		file.read((char*)&am3.op_delay, sizeof(am3.op_delay));
-		file.read((char*)&am3.transfer_delay, sizeof(am3.transfer_delay));
-		file.read((char*)&am3.base_addr, sizeof(am3.base_addr));
-		file.read((char*)&am3.blk_stat, sizeof(am3.blk_stat));
-		file.read((char*)&am3.blk_size, sizeof(am3.blk_size));
-		file.read((char*)&am3.blk_addr, sizeof(am3.blk_addr));
-		file.read((char*)&am3.smc_offset, sizeof(am3.smc_offset));
-		file.read((char*)&am3.last_offset, sizeof(am3.last_offset));
-		file.read((char*)&am3.smc_size, sizeof(am3.smc_size));
-		file.read((char*)&am3.smc_base, sizeof(am3.smc_base));
-		file.read((char*)&am3.file_index, sizeof(am3.file_index));
-		file.read((char*)&am3.file_count, sizeof(am3.file_count));
-		file.read((char*)&am3.file_size, sizeof(am3.file_size));
-		file.read((char*)&am3.remaining_size, sizeof(am3.remaining_size));
-		file.read((char*)&am3.file_size_list[0], (sizeof(u32) * am3.file_size_list.size()));
-		file.read((char*)&am3.file_addr_list[0], (sizeof(u32) * am3.file_addr_list.size()));
-		file.read((char*)&am3.smid[0], 0x10);
-		file.read((char*)&memory_map[0x8000000], 0x400);
-	}
-
-	file.close();
-	return true;
+		state.read(&am3.read_sm_card, sizeof(am3.read_sm_card));
+		state.read(&am3.read_key, sizeof(am3.read_key));
+		state.read(&am3.op_delay, sizeof(am3.op_delay));
+		state.read(&am3.transfer_delay, sizeof(am3.transfer_delay));
+		state.read(&am3.base_addr, sizeof(am3.base_addr));
+		state.read(&am3.blk_stat, sizeof(am3.blk_stat));
+		state.read(&am3.blk_size, sizeof(am3.blk_size));
+		state.read(&am3.blk_addr, sizeof(am3.blk_addr));
+		state.read(&am3.smc_offset, sizeof(am3.smc_offset));
+		state.read(&am3.last_offset, sizeof(am3.last_offset));
+		state.read(&am3.smc_size, sizeof(am3.smc_size));
+		state.read(&am3.smc_base, sizeof(am3.smc_base));
+		state.read(&am3.file_index, sizeof(am3.file_index));
+		state.read(&am3.file_count, sizeof(am3.file_count));
+		state.read(&am3.file_size, sizeof(am3.file_size));
+		state.read(&am3.remaining_size, sizeof(am3.remaining_size));
+		state.read(&am3.file_size_list[0], (sizeof(u32) * am3.file_size_list.size()));
+		state.read(&am3.file_addr_list[0], (sizeof(u32) * am3.file_addr_list.size()));
+		state.read(&am3.smid[0], 0x10);
+		state.read(&memory_map[0x8000000], 0x400);
+	}
+
+	return state.good();
 }
 
 /****** Write MMU data to save state ******/
-bool AGB_MMU::mmu_write(std::string filename)
+bool AGB_MMU::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize WRAM to save state
 	u8* ex_mem = &memory_map[0x2000000];
-	file.write((char*)ex_mem, 0x40000);
+	state.write(ex_mem, 0x40000);
 
 	//Serialize WRAM to save state
 	ex_mem = &memory_map[0x3000000];
-	file.write((char*)ex_mem, 0x8000);
+	state.write(ex_mem, 0x8000);
 
 	//Serialize IO registers to save state
 	ex_mem = &memory_map[0x4000000];
-	file.write((char*)ex_mem, 0x400);
+	state.write(ex_mem, 0x400);
 
 	//Serialize BG and OBJ palettes to save state
 	ex_mem = &memory_map[0x5000000];
-	file.write((char*)ex_mem, 0x400);
+	state.write(ex_mem, 0x400);
 
 	//Serialize VRAM to save state
 	ex_mem = &memory_map[0x6000000];
-	file.write((char*)ex_mem, 0x18000);
+	state.write(ex_mem, 0x18000);
 
 	//Serialize OAM to save state
 	ex_mem = &memory_map[0x7000000];
-	file.write((char*)ex_mem, 0x400);
+	state.write(ex_mem, 0x400);
 
 	//Serialize SRAM to save state
 	ex_mem = &memory_map[0xE000000];
-	file.write((char*)ex_mem, 0x10000);
+	state.write(ex_mem, 0x10000);
 
 	//Serialize misc data from MMU to save state
-	file.write((char*)&current_save_type, sizeof(current_save_type));
-	file.write((char*)&n_clock, sizeof(n_clock));
-	file.write((char*)&s_clock, sizeof(s_clock));
-	file.write((char*)&bios_lock, sizeof(bios_lock));
-	file.write((char*)&dma[0], sizeof(dma[0]));
-	file.write((char*)&dma[1], sizeof(dma[1]));
-	file.write((char*)&dma[2], sizeof(dma[2]));
-	file.write((char*)&dma[3], sizeof(dma[3]));
-	file.write((char*)&gpio, sizeof(gpio));
+	state.write(&current_save_type, sizeof(current_save_type));
+	state.write(&n_clock, sizeof(n_clock));
+	state.write(&s_clock, sizeof(s_clock));
+	state.write(&bios_lock, sizeof(bios_lock));
+	state.write(&dma[0], sizeof(dma[0]));
+	state.write(&dma[1], sizeof(dma[1]));
+	state.write(&dma[2], sizeof(dma[2]));
+	state.write(&dma[3], sizeof(dma[3]));
+	state.write(&gpio, sizeof(gpio));
 
 	//Serialize EEPROM to save state
-	file.write((char*)&eeprom.bitstream_byte, sizeof(eeprom.bitstream_byte));
-	file.write((char*)&eeprom.address, sizeof(eeprom.address));
-	file.write((char*)&eeprom.dma_ptr, sizeof(eeprom.dma_ptr));
-	file.write((char*)&eeprom.size, sizeof(eeprom.size));
-	file.write((char*)&eeprom.size_lock, sizeof(eeprom.size_lock));
-	file.write((char*)&eeprom.data[0], eeprom.size);
+	state.write(&eeprom.bitstream_byte, sizeof(eeprom.bitstream_byte));
+	state.write(&eeprom.address, sizeof(eeprom.address));
+	state.write(&eeprom.dma_ptr, sizeof(eeprom.dma_ptr));
+	state.write(&eeprom.size, sizeof(eeprom.size));
+	state.write(&eeprom.size_lock, sizeof(eeprom.size_lock));
+	state.write(&eeprom.data[0], eeprom.size);
 
 	//Serialize FLASH RAM to save state
-	file.write((char*)&flash_ram.current_command, sizeof(flash_ram.current_command));
-	file.write((char*)&flash_ram.bank, sizeof(flash_ram.bank));
-	file.write((char*)&flash_ram.write_single_byte, sizeof(flash_ram.write_single_byte));
-	file.write((char*)&flash_ram.switch_bank, sizeof(flash_ram.switch_bank));
-	file.write((char*)&flash_ram.grab_ids, sizeof(flash_ram.grab_ids));
-	file.write((char*)&flash_ram.next_write, sizeof(flash_ram.next_write));
-	file.write((char*)&flash_ram.data[0][0], 0x10000);
-	file.write((char*)&flash_ram.data[1][0], 0x10000);
+	state.write(&flash_ram.current_command, sizeof(flash_ram.current_command));
+	state.write(&flash_ram.bank, sizeof(flash_ram.bank));
+	state.write(&flash_ram.write_single_byte, sizeof(flash_ram.write_single_byte));
+	state.write(&flash_ram.switch_bank, sizeof(flash_ram.switch_bank));
+	state.write(&flash_ram.grab_ids, sizeof(flash_ram.grab_ids));
+	state.write(&flash_ram.next_write, sizeof(flash_ram.next_write));
+	state.write(&flash_ram.data[0][0], 0x10000);
+	state.write(&flash_ram.data[1][0], 0x10000);
 
 	//Serialize AM3 data to save state
 	if(config::cart_type == AGB_AM3)
 	{ 
-		file.write((char*)&am3.read_sm_card, sizeof(am3.read_sm_card));
-		file.write((char*)&am3.read_key, sizeof(am3.read_key));
-		file.write((char*)&am3.op_delay, sizeof(am3.op_delay));
-		file.write((char*)&am3.transfer_delay, sizeof(am3.transfer_delay));
-		file.write((char*)&am3.base_addr, sizeof(am3.base_addr));
-		file.write((char*)&am3.blk_stat, sizeof(am3.blk_stat));
-		file.write((char*)&am3.blk_size, sizeof(am3.blk_size));
-		file.write((char*)&am3.blk_addr, sizeof(am3.blk_addr));
-		file.write((char*)&am3.smc_offset, sizeof(am3.smc_offset));
-		file.write((char*)&am3.last_offset, sizeof(am3.last_offset));
-		file.write((char*)&am3.smc_size, sizeof(am3.smc_size));
-		file.write((char*)&am3.smc_base, sizeof(am3.smc_base));
-		file.write((char*)&am3.file_index, sizeof(am3.file_index));
-		file.write((char*)&am3.file_count, sizeof(am3.file_count));
-		file.write((char*)&am3.file_size, sizeof(am3.file_size));
-		file.write((char*)&am3.remaining_size, sizeof(am3.remaining_size));
-		file.write((char*)&am3.file_size_list[0], (sizeof(u32) * am3.file_size_list.size()));
-		file.write((char*)&am3.file_addr_list[0], (sizeof(u32) * am3.file_addr_list.size()));
-		file.write((char*)&am3.smid[0], 0x10);
-		file.write((char*)&memory_map[0x8000000], 0x400);
+		state.write(&am3.read_sm_card, sizeof(am3.read_sm_card));
+		state.write(&am3.read_key, sizeof(am3.read_key));
+		state.write(&am3.op_delay, sizeof(am3.op_delay));
+		state.write(&am3.transfer_delay, sizeof(am3.transfer_delay));
+		state.write(&am3.base_addr, sizeof(am3.base_addr));
+		state.write(&am3.blk_stat, sizeof(am3.blk_stat));
+		state.write(&am3.blk_size, sizeof(am3.blk_size));
+		state.write(&am3.blk_addr, sizeof(am3.blk_addr));
+		state.write(&am3.smc_offset, sizeof(am3.smc_offset));
+		state.write(&am3.last_offset, sizeof(am3.last_offset));
+		state.write(&am3.smc_size, sizeof(am3.smc_size));
+		state.write(&am3.smc_base, sizeof(am3.smc_base));
+		state.write(&am3.file_index, sizeof(am3.file_index));
+		state.write(&am3.file_count, sizeof(am3.file_count));
+		state.write(&am3.file_size, sizeof(am3.file_size));
+		state.write(&am3.remaining_size, sizeof(am3.remaining_size));
+		state.write(&am3.file_size_list[0], (sizeof(u32) * am3.file_size_list.size()));
+		state.write(&am3.file_addr_list[0], (sizeof(u32) * am3.file_addr_list.size()));
+		state.write(&am3.smid[0], 0x10);
+		state.write(&memory_map[0x8000000], 0x400);
 	}
 
-	file.close();
 	return true;
 }
 
@@ -3998,3 +3807,33 @@ u32 AGB_MMU::size()
 
 	return mmu_size;
 }
+
+/****** Gets the size of MMU data stored in a save state, returns 0 if the data is invalid ******/
+u32 AGB_MMU::state_size(const u8* buffer, u32 length)
+{
+	//Everything before the EEPROM size has a fixed layout
+	u32 offset = 0x70C00;
+
+	offset += sizeof(current_save_type);
+	offset += sizeof(n_clock);
+	offset += sizeof(s_clock);
+	offset += sizeof(bios_lock);
+	offset += sizeof(dma[0]);
+	offset += sizeof(dma[1]);
+	offset += sizeof(dma[2]);
+	offset += sizeof(dma[3]);
+	offset += sizeof(gpio);
+
+	offset += sizeof(eeprom.bitstream_byte);
+	offset += sizeof(eeprom.address);
+	offset += sizeof(eeprom.dma_ptr);
+
+	if(length < (offset + sizeof(eeprom.size))) { return 0; }
+
+	u16 eeprom_size = 0;
+	memcpy(&eeprom_size, (buffer + offset), sizeof(eeprom_size));
+
+	if((eeprom_size != 0x200) && (eeprom_size != 0x2000)) { return 0; }
+
+	return size() - eeprom.size + eeprom_size;
+}
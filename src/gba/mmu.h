@@ -22,6 +22,7 @@
 #endif
 
 #include "common.h"
+#include "common/util.h"
 #include "gamepad.h"
 #include "timer.h"
 #include "lcd_data.h"
@@ -134,7 +135,7 @@ class AGB_MMU
 
 	backup_types current_save_type;
 
-	std::vector <u8> memory_map;
+	std::vector <u8, util::zero_page_allocator<u8> > memory_map;
 
 	//Memory access timings (Nonsequential and Sequential)
 	u8 n_clock;
@@ -560,9 +561,7 @@ class AGB_MMU
 	bool read_smid(std::string filename);
 	bool save_backup(std::string filename);
 	bool load_backup(std::string filename);
-
-	bool patch_ips(std::string filename);
-	bool patch_ups(std::string filename);
+	bool get_save_image(std::vector<u8> &image);
 
 	void eeprom_set_addr();
 	void eeprom_read_data();
@@ -667,9 +666,10 @@ class AGB_MMU
 	std::vector<gba_timer>* timer;
 
 	//Serialize data for save state loading/saving
-	bool mmu_read(u32 offset, std::string filename);
-	bool mmu_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
 	u32 size();
+	u32 state_size(const u8* buffer, u32 length);
 
 	private:
 
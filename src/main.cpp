@@ -15,16 +15,52 @@
 #include "min/core.h"
 #include "common/config.h"
 
+#include <chrono>
+
 #include <SDL2/SDL_main.h>
 
+//Startup steps and how long each one took, printed with --verbose
+std::vector <std::string> startup_steps;
+std::vector <u64> startup_times;
+std::chrono::steady_clock::time_point last_step;
+
+/****** Records how long a startup step took since the previous one ******/
+void log_startup_step(std::string step)
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	startup_steps.push_back(step);
+	startup_times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(now - last_step).count());
+
+	last_step = now;
+}
+
+/****** Prints the time taken by each startup step ******/
+void print_startup_times()
+{
+	if(!config::verbose) { return; }
+
+	u64 total = 0;
+
+	for(u32 x = 0; x < startup_steps.size(); x++)
+	{
+		std::cout<<"GBE::Startup " << startup_steps[x] << " : " << std::dec << (startup_times[x] / 1000.0) << " ms\n";
+		total += startup_times[x];
+	}
+
+	std::cout<<"GBE::Startup total : " << (total / 1000.0) << " ms\n";
+}
+
 int main(int argc, char* args[])
 {
 	std::cout<<"GBE+ 1.8 [SDL]\n";
 
 	core_emu* gbe_plus = NULL;
+	last_step = std::chrono::steady_clock::now();
 
 	//Start SDL from the main thread now, report specific init errors later in the core
 	SDL_Init(SDL_INIT_VIDEO);
+	log_startup_step("SDL init");
 
 	//Grab command-line arguments
 	for(int x = 0; x++ < argc - 1;) 
@@ -36,18 +72,18 @@ int main(int argc, char* args[])
 
 	//Parse .ini options
 	parse_ini_file();
-
-	//Load OSD font
-	load_osd_font();
+	log_startup_step(".ini file");
 
 	//Parse cheat file
 	if(config::use_cheats) { parse_cheats_file(false); }
+	log_startup_step("cheats file");
 
 	if(config::mute) { config::volume = 0; }
 
 	//Parse command-line arguments
 	//These will override .ini options!
 	if(!parse_cli_args()) { return 0; }
+	log_startup_step("command-line");
 
 	//Get emulated system type from file
 	config::gb_type = get_system_type_from_file(config::rom_file);
@@ -82,6 +118,8 @@ int main(int argc, char* args[])
 		gbe_plus = new NTR_core();
 	}
 
+	log_startup_step("core setup");
+
 	//Read BIOS file optionally
 	if(config::use_bios) 
 	{
@@ -98,19 +136,24 @@ int main(int argc, char* args[])
 		}
 
 		if(!gbe_plus->read_bios(config::bios_file)) { return 0; } 
+		log_startup_step("BIOS");
 	}
 
 	//Read specified ROM file
 	if(!gbe_plus->read_file(config::rom_file)) { return 0; }
+	log_startup_step("ROM");
 
 	//Read firmware optionally (NDS)
 	if((config::use_firmware) && (config::gb_type == 4))
 	{
 		if(!gbe_plus->read_firmware(config::nds_firmware_path)) { return 0; }
+		log_startup_step("firmware");
 	}
 
 	//Engage the core
 	gbe_plus->start();
+	log_startup_step("core start");
+	print_startup_times();
 	gbe_plus->db_unit.debug_mode = config::use_debugger;
 
 	if(gbe_plus->db_unit.debug_mode) { SDL_CloseAudio(); }
@@ -121,5 +164,8 @@ int main(int argc, char* args[])
 	//Actually run the core
 	gbe_plus->run_core();
 
+	//Destroying the core writes out the save file
+	delete gbe_plus;
+
 	return 0;
 }  
@@ -10,12 +10,16 @@
 // Generates and mixes samples for the PM's single sound channel  
 
 #include <cmath>
+#include <cstring>
 
 #include "apu.h"
 
 /****** APU Constructor ******/
 MIN_APU::MIN_APU()
 {
+	//Copied into save states as raw bytes
+	memset(&apu_stat, 0, sizeof(apu_stat));
+
 	reset();
 }
 
@@ -23,6 +27,12 @@ MIN_APU::MIN_APU()
 MIN_APU::~MIN_APU()
 {
 	SDL_CloseAudio();
+
+	if((output.underruns) || (output.overruns))
+	{
+		std::cout<<"APU::Audio buffer underruns - " << std::dec << output.underruns << " :: overruns - " << output.overruns << "\n";
+	}
+
 	std::cout<<"APU::Shutdown\n";
 }
 
@@ -89,6 +99,9 @@ bool MIN_APU::init()
 
 		apu_stat.pwm_fill_rate = apu_stat.sample_rate / 144;
 
+		//Room for a few callbacks' worth of samples
+		output.resize((desired_spec.samples * 4), 1, desired_spec.freq);
+
 		SDL_PauseAudio(0);
 		std::cout<<"APU::Initialized\n";
 		return true;
@@ -180,18 +193,22 @@ void MIN_APU::buffer_channel()
 	}
 }
 
-/****** SDL Audio Callback ******/ 
-void min_audio_callback(void* _apu, u8 *_stream, int _length)
+/****** Mixes half a frame's worth of samples for the SDL callback ******/
+void MIN_APU::buffer_frame()
 {
-	s16* stream = (s16*) _stream;
-	int length = _length/2;
+	int length = apu_stat.pwm_fill_rate;
+	if(length == 0) { return; }
 
-	std::vector<s16> channel_stream(length);
+	//Streams only grow if the sample rate changes
+	if(mix_stream.size() != length)
+	{
+		channel_stream.resize(length);
+		mix_stream.resize(length);
+	}
 
-	MIN_APU* apu_link = (MIN_APU*) _apu;
-	apu_link->generate_samples(&channel_stream[0], length);
+	generate_samples(&channel_stream[0], length);
 
-	double channel_ratio = apu_link->apu_stat.channel_master_volume / 128.0;
+	double channel_ratio = apu_stat.channel_master_volume / 128.0;
 
 	//Custom software mixing
 	for(u32 x = 0; x < length; x++)
@@ -199,38 +216,38 @@ void min_audio_callback(void* _apu, u8 *_stream, int _length)
 		//Multiply output by volume ratio
 		s16 out_sample = channel_stream[x] * channel_ratio;
 
-		stream[x] = out_sample;
+		mix_stream[x] = out_sample;
 	}
+
+	output.write(&mix_stream[0], length);
 }
 
-/****** Read APU data from save state ******/
-bool MIN_APU::apu_read(u32 offset, std::string filename)
+/****** SDL Audio Callback ******/ 
+void min_audio_callback(void* _apu, u8 *_stream, int _length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
+	MIN_APU* apu_link = (MIN_APU*) _apu;
+	apu_link->output.read((s16*) _stream, (_length / 2));
+}
 
-	//Go to offset
-	file.seekg(offset);
+/****** Read APU data from save state ******/
+bool MIN_APU::deserialize(const u8* buffer, u32 length)
+{
+	util::state_reader state(buffer, length);
 
 	//Serialize misc APU data from save state
-	file.read((char*)&apu_stat, sizeof(apu_stat));
+	state.read(&apu_stat, sizeof(apu_stat));
 
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Read MMU data from save state ******/
-bool MIN_APU::apu_write(std::string filename)
+bool MIN_APU::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize misc APU data from save state
-	file.write((char*)&apu_stat, sizeof(apu_stat));
+	state.write(&apu_stat, sizeof(apu_stat));
 
-	file.close();
 	return true;
 }
 
@@ -15,6 +15,7 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_audio.h>
 #include "mmu.h"
+#include "common/audio_buffer.h"
 
 class MIN_APU
 {
@@ -27,6 +28,9 @@ class MIN_APU
 
 	SDL_AudioSpec desired_spec;
 
+	//Mixed samples waiting for the SDL callback
+	audio_buffer output;
+
 	MIN_APU();
 	~MIN_APU();
 
@@ -35,11 +39,16 @@ class MIN_APU
 
 	void buffer_channel();
 	void generate_samples(s16* stream, int length);
+	void buffer_frame();
 
 	//Serialize data for save state loading/saving
-	bool apu_read(u32 offset, std::string filename);
-	bool apu_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
 	u32 size();
+
+	//Preallocated streams for mixing
+	std::vector<s16> channel_stream;
+	std::vector<s16> mix_stream;
 };
 
 /****** SDL Audio Callback ******/ 
@@ -15,6 +15,8 @@
 #include <sstream>
 
 #include "common/util.h"
+#include "common/state_file.h"
+#include "common/profiler.h"
 
 #include "core.h"
 
@@ -32,6 +34,15 @@ MIN_core::MIN_core()
 	core_cpu.controllers.audio.mem = &core_mmu;
 	core_mmu.set_apu_data(&core_cpu.controllers.audio.apu_stat);
 
+	//Link LCD and APU
+	core_cpu.controllers.video.audio_output = &core_cpu.controllers.audio.output;
+
+	//Link APU and A/V recorder
+	core_cpu.controllers.audio.output.recorder = &av_capture;
+
+	//Record at the system's real refresh rate
+	av_capture.set_frame_rate(72, 1);
+
 	//Link MMU and GamePad
 	core_cpu.mem->g_pad = &core_pad;
 
@@ -62,6 +73,9 @@ MIN_core::MIN_core()
 	config::osd_count = 180;
 }
 
+/****** Core Destructor ******/
+MIN_core::~MIN_core() { }
+
 /****** Start the core ******/
 void MIN_core::start()
 {
@@ -84,6 +98,10 @@ void MIN_core::start()
 
 	//Initialize the GamePad
 	core_pad.init();
+
+	//Clear rewind history and run-ahead state
+	rewind_data.reset();
+	run_ahead_data.reset();
 }
 
 /****** Stop the core ******/
@@ -97,8 +115,21 @@ void MIN_core::stop()
 /****** Shutdown core's components ******/
 void MIN_core::shutdown()
 {
-	core_mmu.MIN_MMU::~MIN_MMU();
-	core_cpu.S1C88::~S1C88();
+	//Finish any movie being recorded
+	movie_data.stop();
+
+	//Finish any background save write before the MMU writes the save on its own
+	save_sync.stop();
+
+	//Finish writing any queued screenshots
+	screenshots.stop();
+
+	//Finish any audio/video recording
+	av_capture.stop();
+
+	//Free rewind history and run-ahead state
+	rewind_data.reset();
+	run_ahead_data.reset();
 }
 
 /****** Reset the core ******/
@@ -106,6 +137,7 @@ void MIN_core::reset()
 {
 	bool can_reset = true;
 
+	save_sync.reset();
 	core_cpu.reset();
 	core_cpu.controllers.video.reset();
 	core_cpu.controllers.audio.reset();
@@ -122,6 +154,12 @@ void MIN_core::reset()
 	core_cpu.controllers.audio.mem = &core_mmu;
 	core_mmu.set_apu_data(&core_cpu.controllers.audio.apu_stat);
 
+	//Link LCD and APU
+	core_cpu.controllers.video.audio_output = &core_cpu.controllers.audio.output;
+
+	//Link APU and A/V recorder
+	core_cpu.controllers.audio.output.recorder = &av_capture;
+
 	//Link MMU and GamePad
 	core_cpu.mem->g_pad = &core_pad;
 
@@ -147,8 +185,6 @@ void MIN_core::load_state(u8 slot)
 	std::string state_file = config::rom_file + ".ss";
 	state_file += id;
 
-	u32 offset = 0;
-
 	//Check if save state is accessible
 	std::ifstream test(state_file.c_str());
 	
@@ -159,16 +195,11 @@ void MIN_core::load_state(u8 slot)
 		return;
 	}
 
-	if(!core_cpu.cpu_read(offset, state_file)) { return; }
-	offset += core_cpu.size();
-
-	if(!core_mmu.mmu_read(offset, state_file)) { return; }
-	offset += core_mmu.size();
-
-	if(!core_cpu.controllers.audio.apu_read(offset, state_file)) { return; }
-	offset += core_cpu.controllers.audio.size();
-
-	if(!core_cpu.controllers.video.lcd_read(offset, state_file)) { return; }
+	if(!load_state_file(this, state_file))
+	{
+		std::cout<<"GBE::Error - Could not load save state " << state_file << "\n";
+		return;
+	}
 
 	std::cout<<"GBE::Loaded state " << state_file << "\n";
 
@@ -185,10 +216,7 @@ void MIN_core::save_state(u8 slot)
 	std::string state_file = config::rom_file + ".ss";
 	state_file += id;
 
-	if(!core_cpu.cpu_write(state_file)) { return; }
-	if(!core_mmu.mmu_write(state_file)) { return; }
-	if(!core_cpu.controllers.audio.apu_write(state_file)) { return; }
-	if(!core_cpu.controllers.video.lcd_write(state_file)) { return; }
+	if(!save_state_file(this, state_file)) { return; }
 
 	std::cout<<"GBE::Saved state " << state_file << "\n";
 
@@ -197,6 +225,54 @@ void MIN_core::save_state(u8 slot)
 	config::osd_count = 180;
 }
 
+/****** Serializes the core into a contiguous save state buffer ******/
+bool MIN_core::serialize(std::vector<u8> &buffer)
+{
+	buffer.clear();
+
+	if(!core_cpu.serialize(buffer)) { return false; }
+	if(!core_mmu.serialize(buffer)) { return false; }
+	if(!core_cpu.controllers.audio.serialize(buffer)) { return false; }
+	if(!core_cpu.controllers.video.serialize(buffer)) { return false; }
+
+	return true;
+}
+
+/****** Restores the core from a contiguous save state buffer ******/
+bool MIN_core::deserialize(const u8* buffer, u32 length)
+{
+	u32 offset = 0;
+
+	//Check the total against the fixed component sizes first so a bad state can't leave the core half-loaded
+	u64 total_size = u64(core_cpu.size()) + core_mmu.size() + core_cpu.controllers.audio.size() + core_cpu.controllers.video.size();
+	if(total_size != length) { return false; }
+
+	if(!core_cpu.deserialize(buffer, length)) { return false; }
+	offset += core_cpu.size();
+
+	if((offset > length) || (!core_mmu.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_mmu.size();
+
+	if((offset > length) || (!core_cpu.controllers.audio.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_cpu.controllers.audio.size();
+
+	if((offset > length) || (!core_cpu.controllers.video.deserialize((buffer + offset), (length - offset)))) { return false; }
+
+	return true;
+}
+
+/****** Lists the components of a save state in order, returns the system's tag ******/
+u32 MIN_core::get_state_sections(std::vector<state_section> &sections)
+{
+	sections.clear();
+	sections.push_back({ GBE_STATE_TAG('C', 'P', 'U', ' '), core_cpu.size() });
+	sections.push_back({ GBE_STATE_TAG('M', 'M', 'U', ' '), core_mmu.size() });
+	sections.push_back({ GBE_STATE_TAG('A', 'P', 'U', ' '), core_cpu.controllers.audio.size() });
+	sections.push_back({ GBE_STATE_TAG('L', 'C', 'D', ' '), core_cpu.controllers.video.size() });
+
+	return GBE_STATE_TAG('M', 'I', 'N', ' ');
+}
+
 /****** Run the core in a loop until exit ******/
 void MIN_core::run_core()
 {
@@ -214,7 +290,9 @@ void MIN_core::run_core()
 			|| (event.type == SDL_JOYBUTTONDOWN) || (event.type == SDL_JOYBUTTONUP)
 			|| (event.type == SDL_JOYAXISMOTION) || (event.type == SDL_JOYHATMOTION))
 			{
+				movie_data.begin_live_input(this);
 				core_pad.handle_input(event);
+				movie_data.end_live_input(this);
 				handle_hotkey(event);
 				process_keypad_irqs();
 
@@ -262,8 +340,44 @@ void MIN_core::run_core()
 
 			if(db_unit.debug_mode) { debug_step(); }
 
+			PROFILER_ENTER(PROF_CPU);
 			core_cpu.execute();
+			PROFILER_CYCLES(PROF_CPU, core_cpu.system_cycles);
+			PROFILER_LEAVE();
+
 			core_cpu.clock_system();
+
+			//Record or play back input movies once per frame
+			if((movie_data.active) && (!run_ahead_data.active) && (movie_data.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				movie_data.update(this, core_cpu.controllers.video.frame_count);
+			}
+
+			//Write changed battery save data in the background every few seconds
+			if((config::save_flush_interval) && (!run_ahead_data.active) && (save_sync.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				save_sync.update(this, core_cpu.controllers.video.frame_count);
+			}
+
+			//Record presented frames and mixed audio
+			if((av_capture.active) && (!run_ahead_data.active) && (av_capture.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				av_capture.update(core_cpu.controllers.video.screen_buffer, config::sys_width, core_cpu.controllers.video.frame_count);
+			}
+
+			//Capture or restore rewind snapshots once per frame, except while a movie is active
+			if((config::rewind_buffer_size) && (!run_ahead_data.active) && (!movie_data.active) && (rewind_data.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				rewind_data.update(this, core_cpu.controllers.video.frame_count);
+			}
+
+			//Run ahead of the real frame to hide input lag, audio from frames ahead is never recorded
+			if((!run_ahead_data.active) && (run_ahead_data.last_frame != core_cpu.controllers.video.frame_count))
+			{
+				av_capture.hold_audio = true;
+				run_ahead_data.update(this, core_cpu.controllers.video.frame_count, core_cpu.controllers.video.present_frame, core_cpu.controllers.video.realtime_frame);
+				av_capture.hold_audio = false;
+			}
 		}
 
 		//Stop emulation
@@ -287,8 +401,44 @@ void MIN_core::step()
 
 		if(db_unit.debug_mode) { debug_step(); }
 
+		PROFILER_ENTER(PROF_CPU);
 		core_cpu.execute();
+		PROFILER_CYCLES(PROF_CPU, core_cpu.system_cycles);
+		PROFILER_LEAVE();
+
 		core_cpu.clock_system();
+
+		//Record or play back input movies once per frame
+		if((movie_data.active) && (!run_ahead_data.active) && (movie_data.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			movie_data.update(this, core_cpu.controllers.video.frame_count);
+		}
+
+		//Write changed battery save data in the background every few seconds
+		if((config::save_flush_interval) && (!run_ahead_data.active) && (save_sync.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			save_sync.update(this, core_cpu.controllers.video.frame_count);
+		}
+
+		//Record presented frames and mixed audio
+		if((av_capture.active) && (!run_ahead_data.active) && (av_capture.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			av_capture.update(core_cpu.controllers.video.screen_buffer, config::sys_width, core_cpu.controllers.video.frame_count);
+		}
+
+		//Capture or restore rewind snapshots once per frame, except while a movie is active
+		if((config::rewind_buffer_size) && (!run_ahead_data.active) && (!movie_data.active) && (rewind_data.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			rewind_data.update(this, core_cpu.controllers.video.frame_count);
+		}
+
+		//Run ahead of the real frame to hide input lag, audio from frames ahead is never recorded
+		if((!run_ahead_data.active) && (run_ahead_data.last_frame != core_cpu.controllers.video.frame_count))
+		{
+			av_capture.hold_audio = true;
+			run_ahead_data.update(this, core_cpu.controllers.video.frame_count, core_cpu.controllers.video.present_frame, core_cpu.controllers.video.realtime_frame);
+			av_capture.hold_audio = false;
+		}
 	}
 }
 
@@ -332,6 +482,17 @@ void MIN_core::handle_hotkey(SDL_Event& event)
 		load_state(0);
 	}
 
+	//Rewind while held
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == config::hotkey_rewind))
+	{
+		rewind_data.rewinding = (config::rewind_buffer_size != 0);
+	}
+
+	else if((event.type == SDL_KEYUP) && (event.key.keysym.sym == config::hotkey_rewind))
+	{
+		rewind_data.rewinding = false;
+	}
+
 	//Switch current netplay connection on F3 
 	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_F3) && (core_mmu.ir_stat.sync_timeout == 0))
 	{
@@ -420,6 +581,7 @@ void MIN_core::handle_hotkey(SDL_Event& event)
 				config::pause_emu = false;
 				SDL_PauseAudio(0);
 				std::cout<<"EMU::Unpaused\n";
+				frame_pacer::notify_resume();
 			}
 		}
 	}
@@ -454,9 +616,9 @@ void MIN_core::handle_hotkey(SDL_Event& event)
 		//Append random number to screenshot name
 		srand(SDL_GetTicks());
 		save_stream << rand() % 1024 << rand() % 1024 << rand() % 1024;
-		save_name += save_stream.str() + ".bmp";
+		save_name += save_stream.str() + ".png";
 	
-		SDL_SaveBMP(core_cpu.controllers.video.final_screen, save_name.c_str());
+		screenshots.save(core_cpu.controllers.video.final_screen, save_name);
 
 		//OSD
 		config::osd_message = "SAVED SCREENSHOT";
@@ -522,6 +684,9 @@ void MIN_core::handle_hotkey(int input, bool pressed)
 	//Toggle turbo off
 	else if((input == config::hotkey_turbo) && (!pressed)) { config::turbo = false; }
 
+	//Rewind while held
+	else if(input == config::hotkey_rewind) { rewind_data.rewinding = ((pressed) && (config::rewind_buffer_size != 0)); }
+
 	//Switch current netplay connection on F3 
 	else if((input == SDLK_F3) && (core_mmu.ir_stat.sync_timeout == 0) && (pressed))
 	{
@@ -588,7 +753,9 @@ void MIN_core::update_volume(u8 volume)
 /****** Feeds key input from an external source (useful for TAS) ******/
 void MIN_core::feed_key_input(int sdl_key, bool pressed)
 {
+	movie_data.begin_live_input(this);
 	core_pad.process_keyboard(sdl_key, pressed);
+	movie_data.end_live_input(this);
 	handle_hotkey(sdl_key, pressed);
 	process_keypad_irqs();
 
@@ -600,6 +767,47 @@ void MIN_core::feed_key_input(int sdl_key, bool pressed)
 	}
 }
 
+/****** Captures the GamePad's state for input movies ******/
+void MIN_core::get_movie_input(movie_input &input)
+{
+	input.keys = core_pad.key_input;
+	input.touch_x = 0;
+	input.touch_y = 0;
+	input.sensor_x = 0;
+	input.sensor_y = 0;
+	input.gyro_value = 0;
+	input.gyro_flags = 0;
+	input.solar_value = 0;
+
+	//Shock Sensor hits are one-shot events
+	if(core_pad.send_shock_irq) { input.keys |= 0x1000000; }
+}
+
+/****** Applies GamePad state from input movies, triggers keypad and Shock Sensor IRQs on new frames ******/
+void MIN_core::set_movie_input(const movie_input &input, bool new_frame)
+{
+	u8 last_input = core_pad.key_input;
+
+	core_pad.key_input = (input.keys & 0xFF);
+	core_pad.last_input = core_pad.key_input;
+	core_pad.send_keypad_irq = false;
+	core_pad.send_shock_irq = false;
+
+	if(!new_frame) { return; }
+
+	core_pad.send_keypad_irq = (last_input != core_pad.key_input);
+	process_keypad_irqs();
+
+	//Handle Shock Sensor
+	if(input.keys & 0x1000000) { core_mmu.update_irq_flags(SHOCK_SENSOR_IRQ); }
+}
+
+/****** Copies battery-backed save data for background writes ******/
+bool MIN_core::get_save_image(std::vector<u8> &image)
+{
+	return core_mmu.get_save_image(image);
+}
+
 /****** Return a CPU register ******/
 u32 MIN_core::ex_get_reg(u8 reg_index)
 {
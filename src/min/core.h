@@ -16,6 +16,12 @@
 #define PM_CORE
 
 #include "common/core_emu.h"
+#include "common/rewind.h"
+#include "common/run_ahead.h"
+#include "common/input_movie.h"
+#include "common/save_flusher.h"
+#include "common/screenshot.h"
+#include "common/av_recorder.h"
 #include "mmu.h"
 #include "s1c88.h"
 
@@ -38,6 +44,9 @@ class MIN_core : virtual public core_emu
 		void feed_key_input(int sdl_key, bool pressed);
 		void save_state(u8 slot);
 		void load_state(u8 slot);
+		bool serialize(std::vector<u8> &buffer);
+		bool deserialize(const u8* buffer, u32 length);
+		u32 get_state_sections(std::vector<state_section> &sections);
 		void run_core();
 
 		//Core debugging
@@ -61,12 +70,25 @@ class MIN_core : virtual public core_emu
 		void stop_netplay();
 		void hard_sync();
 
+		//Input movies
+		void get_movie_input(movie_input &input);
+		void set_movie_input(const movie_input &input, bool new_frame);
+
+		//Battery saves
+		bool get_save_image(std::vector<u8> &image);
+
 		//Misc
 		u32 get_core_data(u32 core_index);
 
 		MIN_MMU core_mmu;
 		S1C88 core_cpu;
 		MIN_GamePad core_pad;
+		rewind_buffer rewind_data;
+		run_ahead run_ahead_data;
+		input_movie movie_data;
+		save_flusher save_sync;
+		screenshot_writer screenshots;
+		av_recorder av_capture;
 };
 		
 #endif // PM_CORE 
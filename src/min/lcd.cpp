@@ -10,13 +10,16 @@
 // Responsible for blitting pixel data and limiting frame rate
 
 #include <cmath>
+#include <cstring>
 
 #include "lcd.h"
 #include "common/util.h"
+#include "common/profiler.h"
 
 /****** LCD Constructor ******/
 MIN_LCD::MIN_LCD()
 {
+	memset(&lcd_stat, 0, sizeof(lcd_stat));
 	window = NULL;
 	reset();
 }
@@ -36,6 +39,7 @@ void MIN_LCD::reset()
 	final_screen = NULL;
 	original_screen = NULL;
 	mem = NULL;
+	audio_output = NULL;
 
 	if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
 	window = NULL;
@@ -55,18 +59,14 @@ void MIN_LCD::reset()
 	lcd_stat.force_update = false;
 	lcd_stat.sed_enabled = true;
 
-	frame_start_time = 0;
-	frame_current_time = 0;
 	fps_count = 0;
+	frame_count = 0;
+	present_frame = true;
+	realtime_frame = true;
+	skip_frame = false;
 	fps_time = 0;
 
-	for(u32 x = 0; x < 72; x++)
-	{
-		u16 max = (config::max_fps) ? config::max_fps : 72;
-		double frame_1 = ((1000.0 / max) * x);
-		double frame_2 = ((1000.0 / max) * (x + 1));
-		frame_delay[x] = (std::round(frame_2) - std::round(frame_1));
-	}
+	pacer.reset((config::max_fps) ? config::max_fps : 72);
 
 	//Set LCD colors
 	u32 custom_color = config::min_custom_color;
@@ -167,85 +167,45 @@ void MIN_LCD::update()
 	}
 
 	//Render pixel for a new frame if necessary
-	if(new_frame || lcd_stat.sed_update) { render_frame(); }
+	//Map and sprites above still go to GDRAM, only the final framebuffer is skipped
+	if((new_frame || lcd_stat.sed_update) && (!skip_frame)) { render_frame(); }
 
-	//Use SDL
-	if(config::sdl_render)
+	//Present frame unless it is hidden (e.g. run-ahead) or skipped
+	if((present_frame) && (!skip_frame))
 	{
-		//If using SDL and no OpenGL, manually stretch for fullscreen via SDL
-		if((config::flags & SDL_WINDOW_FULLSCREEN) && (!config::use_opengl))
+		//Use SDL
+		if(config::sdl_render)
 		{
-			//Lock source surface
-			if(SDL_MUSTLOCK(original_screen)){ SDL_LockSurface(original_screen); }
-			u32* out_pixel_data = (u32*)original_screen->pixels;
-
-			for(int a = 0; a < 0x1800; a++)
-			{
-				out_pixel_data[a] = screen_buffer[a];
-			}
-
-			//Display any OSD messages
-			if(config::osd_count)
+			//If using SDL and no OpenGL, manually stretch for fullscreen via SDL
+			if((config::flags & SDL_WINDOW_FULLSCREEN) && (!config::use_opengl))
 			{
-				config::osd_count--;
-				draw_osd_msg(config::osd_message, out_pixel_data, 0, 0, 0x1800);
-			}
+				//Lock source surface
+				if(SDL_MUSTLOCK(original_screen)){ SDL_LockSurface(original_screen); }
+				u32* out_pixel_data = (u32*)original_screen->pixels;
 
-			//Unlock source surface
-			if(SDL_MUSTLOCK(original_screen)){ SDL_UnlockSurface(original_screen); }
-		
-			//Blit the original surface to the final stretched one
-			SDL_Rect dest_rect;
-			dest_rect.w = config::sys_width * max_fullscreen_ratio;
-			dest_rect.h = config::sys_height * max_fullscreen_ratio;
-			dest_rect.x = ((config::win_width - dest_rect.w) >> 1);
-			dest_rect.y = ((config::win_height - dest_rect.h) >> 1);
-			SDL_BlitScaled(original_screen, NULL, final_screen, &dest_rect);
-
-			if(SDL_UpdateWindowSurface(window) != 0)
-			{
-				std::cout<<"LCD::Error - Could not blit\n";
-
-				//Try to make a new the window if the blit failed
-				if(!try_window_rebuild)
+				for(int a = 0; a < 0x1800; a++)
 				{
-					try_window_rebuild = true;
-					if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
-					init();
+					out_pixel_data[a] = screen_buffer[a];
 				}
-			}
 
-			else { try_window_rebuild = false; }
-		}
-					
-		//Otherwise, render normally (SDL 1:1, OpenGL handles its own stretching)
-		else
-		{
-			//Lock source surface
-			if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
-			u32* out_pixel_data = (u32*)final_screen->pixels;
-
-			for(int a = 0; a < 0x1800; a++)
-			{
-				out_pixel_data[a] = screen_buffer[a];
-			}
-
-			//Display any OSD messages
-			if(config::osd_count)
-			{
-				config::osd_count--;
-				draw_osd_msg(config::osd_message, out_pixel_data, 0, 0, 0x1800);
-			}
+				//Display any OSD messages
+				if(config::osd_count)
+				{
+					config::osd_count--;
+					draw_osd_msg(config::osd_message, out_pixel_data, 0, 0, 0x1800);
+				}
 
-			//Unlock source surface
-			if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
+				//Unlock source surface
+				if(SDL_MUSTLOCK(original_screen)){ SDL_UnlockSurface(original_screen); }
 		
-			//Display final screen buffer - OpenGL
-			if(config::use_opengl) { opengl_blit(); }
-				
-			//Display final screen buffer - SDL
-			else 
-			{
+				//Blit the original surface to the final stretched one
+				SDL_Rect dest_rect;
+				dest_rect.w = config::sys_width * max_fullscreen_ratio;
+				dest_rect.h = config::sys_height * max_fullscreen_ratio;
+				dest_rect.x = ((config::win_width - dest_rect.w) >> 1);
+				dest_rect.y = ((config::win_height - dest_rect.h) >> 1);
+				SDL_BlitScaled(original_screen, NULL, final_screen, &dest_rect);
+
 				if(SDL_UpdateWindowSurface(window) != 0)
 				{
 					std::cout<<"LCD::Error - Could not blit\n";
@@ -261,62 +221,120 @@ void MIN_LCD::update()
 
 				else { try_window_rebuild = false; }
 			}
-		}
-	}
+					
+			//Otherwise, render normally (SDL 1:1, OpenGL handles its own stretching)
+			else
+			{
+				//Lock source surface
+				if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
+				u32* out_pixel_data = (u32*)final_screen->pixels;
 
-	//Use external rendering method (GUI)
-	else
-	{
-		if(!config::use_opengl)
-		{
-			std::vector<u32> out_pixel_data(screen_buffer);
+				for(int a = 0; a < 0x1800; a++)
+				{
+					out_pixel_data[a] = screen_buffer[a];
+				}
 
-			//Display any OSD messages
-			if(config::osd_count)
-			{
-				config::osd_count--;
-				draw_osd_msg(config::osd_message, out_pixel_data, 0, 0);
-			}
+				//Display any OSD messages
+				if(config::osd_count)
+				{
+					config::osd_count--;
+					draw_osd_msg(config::osd_message, out_pixel_data, 0, 0, 0x1800);
+				}
+
+				//Unlock source surface
+				if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
+		
+				//Display final screen buffer - OpenGL
+				if(config::use_opengl) { opengl_blit(); }
+				
+				//Display final screen buffer - SDL
+				else 
+				{
+					if(SDL_UpdateWindowSurface(window) != 0)
+					{
+						std::cout<<"LCD::Error - Could not blit\n";
+
+						//Try to make a new the window if the blit failed
+						if(!try_window_rebuild)
+						{
+							try_window_rebuild = true;
+							if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
+							init();
+						}
+					}
 
-			config::render_external_sw(out_pixel_data);
+					else { try_window_rebuild = false; }
+				}
+			}
 		}
 
+		//Use external rendering method (GUI)
 		else
 		{
-			//Lock source surface
-			if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
-			u32* out_pixel_data = (u32*)final_screen->pixels;
-
-			for(int a = 0; a < 0x1800; a++)
+			if(!config::use_opengl)
 			{
-				out_pixel_data[a] = screen_buffer[a];
+				std::vector<u32> out_pixel_data(screen_buffer);
+
+				//Display any OSD messages
+				if(config::osd_count)
+				{
+					config::osd_count--;
+					draw_osd_msg(config::osd_message, out_pixel_data, 0, 0);
+				}
+
+				config::render_external_sw(out_pixel_data);
 			}
 
-			//Display any OSD messages
-			if(config::osd_count)
+			else
 			{
-				config::osd_count--;
-				draw_osd_msg(config::osd_message, out_pixel_data, 0, 0, 0x1800);
-			}
+				//Lock source surface
+				if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
+				u32* out_pixel_data = (u32*)final_screen->pixels;
 
-			//Unlock source surface
-			if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
+				for(int a = 0; a < 0x1800; a++)
+				{
+					out_pixel_data[a] = screen_buffer[a];
+				}
 
-			config::render_external_hw(final_screen);
+				//Display any OSD messages
+				if(config::osd_count)
+				{
+					config::osd_count--;
+					draw_osd_msg(config::osd_message, out_pixel_data, 0, 0, 0x1800);
+				}
+
+				//Unlock source surface
+				if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
+
+				config::render_external_hw(final_screen);
+			}
 		}
 	}
 
 	//Limit framerate
-	if(!config::turbo)
+	if((!config::turbo) && (realtime_frame))
+	{
+		PROFILER_ENTER(PROF_IDLE);
+
+		//Pace on the audio device's clock when syncing to audio, otherwise wait for the frame's deadline
+		pacer.limit(audio_output);
+
+		PROFILER_LEAVE();
+	}
+
+	PROFILER_END_FRAME();
+
+	//Update FPS counter + title, frame time and health statistics
+	if(realtime_frame)
 	{
-		frame_current_time = SDL_GetTicks();
-		int delay = frame_delay[fps_count % 72];
-		if((frame_current_time - frame_start_time) < delay) { SDL_Delay(delay - (frame_current_time - frame_start_time));}
-		frame_start_time = SDL_GetTicks();
+		fps_count++;
+		pacer.record(audio_output);
 	}
 
-	//Update FPS counter + title
-	fps_count++;
+	frame_count++;
+
+	//While in turbo, only render 1 out of every N+1 frames
+	skip_frame = (config::turbo) && (config::turbo_frameskip) && ((frame_count % (config::turbo_frameskip + 1)) != 0);
 	if(((SDL_GetTicks() - fps_time) >= 1000) && (config::sdl_render))
 	{ 
 		fps_time = SDL_GetTicks(); 
@@ -692,48 +710,51 @@ void MIN_LCD::render_frame()
 }
 
 /****** Read LCD data from save state ******/
-bool MIN_LCD::lcd_read(u32 offset, std::string filename)
+bool MIN_LCD::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize misc LCD data from save state
-	file.read((char*)&lcd_stat, sizeof(lcd_stat));
-	file.read((char*)&new_frame, sizeof(new_frame));
+	state.read(&lcd_stat, sizeof(lcd_stat));
+	state.read(&new_frame, sizeof(new_frame));
 
 	//Serialize screen buffers from save state
 	for(u32 x = 0; x < 0x1800; x++)
 	{
-		file.read((char*)&screen_buffer[x], sizeof(screen_buffer[x]));
-		file.read((char*)&old_buffer[x], sizeof(old_buffer[x]));
+		state.read(&screen_buffer[x], sizeof(screen_buffer[x]));
+		state.read(&old_buffer[x], sizeof(old_buffer[x]));
 	}
 
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Write LCD data to save state ******/
-bool MIN_LCD::lcd_write(std::string filename)
+bool MIN_LCD::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize misc LCD data from save state
-	file.write((char*)&lcd_stat, sizeof(lcd_stat));
-	file.write((char*)&new_frame, sizeof(new_frame));
+	state.write(&lcd_stat, sizeof(lcd_stat));
+	state.write(&new_frame, sizeof(new_frame));
 
 	//Serialize screen buffers from save state
 	for(u32 x = 0; x < 0x1800; x++)
 	{
-		file.write((char*)&screen_buffer[x], sizeof(screen_buffer[x]));
-		file.write((char*)&old_buffer[x], sizeof(old_buffer[x]));
+		state.write(&screen_buffer[x], sizeof(screen_buffer[x]));
+		state.write(&old_buffer[x], sizeof(old_buffer[x]));
 	}
 
-	file.close();
 	return true;
 }
+
+/****** Gets the size of LCD data for serialization ******/
+u32 MIN_LCD::size()
+{
+	u32 lcd_size = 0;
+
+	lcd_size += sizeof(lcd_stat);
+	lcd_size += sizeof(new_frame);
+	lcd_size += ((sizeof(screen_buffer[0]) + sizeof(old_buffer[0])) * 0x1800);
+
+	return lcd_size;
+}
@@ -12,6 +12,8 @@
 #include "SDL2/SDL.h"
 #include "SDL2/SDL_opengl.h"
 #include "mmu.h"
+#include "common/audio_buffer.h"
+#include "common/frame_pacer.h"
 
 #ifndef PM_LCD
 #define PM_LCD
@@ -23,6 +25,9 @@ class MIN_LCD
 	//Link to memory map
 	MIN_MMU* mem;
 
+	//Link to APU output for audio sync
+	audio_buffer* audio_output;
+
 	//Core Functions
 	MIN_LCD();
 	~MIN_LCD();
@@ -36,6 +41,7 @@ class MIN_LCD
 	SDL_Window* window;
 	SDL_Surface* final_screen;
 	SDL_Surface* original_screen;
+	std::vector<u32> screen_buffer;
 
 	//OpenGL data
 	#ifdef GBE_OGL
@@ -58,8 +64,19 @@ class MIN_LCD
 	u32 mix_colors[64];
 
 	//Serialize data for save state loading/saving
-	bool lcd_read(u32 offset, std::string filename);
-	bool lcd_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
+	u32 size();
+
+	//Frames completed since reset
+	u32 frame_count;
+
+	//Frame output controls - Blit to screen, throttle and count towards FPS
+	bool present_frame;
+	bool realtime_frame;
+
+	//Leaves the frame unrendered (turbo frameskip)
+	bool skip_frame;
 
 	private:
 
@@ -70,14 +87,11 @@ class MIN_LCD
 	void opengl_blit();
 
 	//Screen pixel buffer
-	std::vector<u32> screen_buffer;
 	std::vector<u32> old_buffer;
 
-	int frame_start_time;
-	int frame_current_time;
 	int fps_count;
 	int fps_time;
-	int frame_delay[72];
+	frame_pacer pacer;
 
 	bool try_window_rebuild;
 };
@@ -11,8 +11,10 @@
 
 #include <filesystem>
 #include <ctime>
+#include <cstring>
 
 #include "mmu.h"
+#include "common/save_flusher.h"
 
 /****** MMU Constructor ******/
 MIN_MMU::MIN_MMU() 
@@ -20,6 +22,11 @@ MIN_MMU::MIN_MMU()
 	//Use shared EEPROM if necessary
 	if((config::min_config & 0x4) == 0) { config::save_file = config::data_path + "min_shared.sav"; }
 
+	//These go into save states verbatim, so their padding has to be zeroed too
+	memset(&eeprom, 0, sizeof(eeprom));
+	memset(&sed, 0, sizeof(sed));
+	memset(&ir_stat, 0, sizeof(ir_stat));
+
 	reset();
 	init_ir();
 }
@@ -723,6 +730,8 @@ bool MIN_MMU::read_bios(std::string filename)
 
 	if(!std::filesystem::exists(bios_file))
 	{
+		get_firmware_hashes();
+
 		for(u32 x = 0; x < config::bin_hashes.size(); x++)
 		{
 			if(config::bin_hashes[x] == 0xAED3C14D) { filename = config::bin_files[x]; break; }
@@ -772,6 +781,9 @@ bool MIN_MMU::load_backup(std::string filename)
 		 filename = config::save_path + util::get_filename_from_path(filename);
 	}
 
+	//Finish any background save write that was interrupted
+	save_flusher::recover(filename);
+
 	//Import save if applicable
 	if(!config::save_import_path.empty()) { filename = config::save_import_path; }
 
@@ -802,7 +814,7 @@ bool MIN_MMU::load_backup(std::string filename)
 	if(enable_rtc)
 	{
 		//Grab local time
-		time_t system_time = time(0);
+		time_t system_time = (config::fixed_rtc_time) ? config::fixed_rtc_time : time(0);
 		tm* current_time = localtime(&system_time);
 
 		u8 year = (current_time->tm_year % 100);
@@ -883,6 +895,16 @@ bool MIN_MMU::save_backup(std::string filename)
 	return true;
 }
 
+/****** Copies EEPROM data exactly as save_backup() writes it ******/
+bool MIN_MMU::get_save_image(std::vector<u8> &image)
+{
+	//Same as on exit, nothing gets written until the game saves something
+	if(!save_eeprom) { return false; }
+
+	image.assign(eeprom.data, (eeprom.data + 0x2000));
+	return true;
+}
+
 /****** Calculates general purpose timer prescales for oscillator 1 ******/
 u32 MIN_MMU::get_prescalar_1(u8 val)
 {
@@ -1436,73 +1458,64 @@ void MIN_MMU::set_lcd_data(min_lcd_data* ex_lcd_stat) { lcd_stat = ex_lcd_stat;
 void MIN_MMU::set_apu_data(min_apu_data* ex_apu_stat) { apu_stat = ex_apu_stat; }
 
 /****** Read MMU data from save state ******/
-bool MIN_MMU::mmu_read(u32 offset, std::string filename)
+bool MIN_MMU::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize RAM and hardware MMIO registers from save state
 	u8* ex_mem = &memory_map[0x1000];
-	file.read((char*)ex_mem, 0x1100);
+	state.read(ex_mem, 0x1100);
 
 	//Serialize IRQ stuff to save state
 	for(u32 x = 0; x < 32; x++)
 	{
-		file.read((char*)&irq_priority[x], sizeof(irq_priority[x]));
-		file.read((char*)&irq_enable[x], sizeof(irq_enable[x]));
-		file.read((char*)&irq_vectors[x], sizeof(irq_vectors[x]));
+		state.read(&irq_priority[x], sizeof(irq_priority[x]));
+		state.read(&irq_enable[x], sizeof(irq_enable[x]));
+		state.read(&irq_vectors[x], sizeof(irq_vectors[x]));
 	}
 
 	//Serialize misc data from MMU from save state
-	file.read((char*)&master_irq_flags, sizeof(master_irq_flags));
-	file.read((char*)&osc_1_enable, sizeof(osc_1_enable));
-	file.read((char*)&osc_2_enable, sizeof(osc_2_enable));
-	file.read((char*)&save_eeprom, sizeof(save_eeprom));
-	file.read((char*)&rtc, sizeof(rtc));
-	file.read((char*)&enable_rtc, sizeof(enable_rtc));
-	file.read((char*)&eeprom, sizeof(eeprom));
-	file.read((char*)&sed, sizeof(sed));
-	file.read((char*)&ir_stat, sizeof(ir_stat));
-
-	file.close();
-	return true;
+	state.read(&master_irq_flags, sizeof(master_irq_flags));
+	state.read(&osc_1_enable, sizeof(osc_1_enable));
+	state.read(&osc_2_enable, sizeof(osc_2_enable));
+	state.read(&save_eeprom, sizeof(save_eeprom));
+	state.read(&rtc, sizeof(rtc));
+	state.read(&enable_rtc, sizeof(enable_rtc));
+	state.read(&eeprom, sizeof(eeprom));
+	state.read(&sed, sizeof(sed));
+	state.read(&ir_stat, sizeof(ir_stat));
+
+	return state.good();
 }
 
 /****** Write MMU data to save state ******/
-bool MIN_MMU::mmu_write(std::string filename)
+bool MIN_MMU::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize RAM and hardware MMIO registers to save state
 	u8* ex_mem = &memory_map[0x1000];
-	file.write((char*)ex_mem, 0x1100);
+	state.write(ex_mem, 0x1100);
 
 	//Serialize IRQ stuff to save state
 	for(u32 x = 0; x < 32; x++)
 	{
-		file.write((char*)&irq_priority[x], sizeof(irq_priority[x]));
-		file.write((char*)&irq_enable[x], sizeof(irq_enable[x]));
-		file.write((char*)&irq_vectors[x], sizeof(irq_vectors[x]));
+		state.write(&irq_priority[x], sizeof(irq_priority[x]));
+		state.write(&irq_enable[x], sizeof(irq_enable[x]));
+		state.write(&irq_vectors[x], sizeof(irq_vectors[x]));
 	}
 
 	//Serialize misc data from MMU to save state
-	file.write((char*)&master_irq_flags, sizeof(master_irq_flags));
-	file.write((char*)&osc_1_enable, sizeof(osc_1_enable));
-	file.write((char*)&osc_2_enable, sizeof(osc_2_enable));
-	file.write((char*)&save_eeprom, sizeof(save_eeprom));
-	file.write((char*)&rtc, sizeof(rtc));
-	file.write((char*)&enable_rtc, sizeof(enable_rtc));
-	file.write((char*)&eeprom, sizeof(eeprom));
-	file.write((char*)&sed, sizeof(sed));
-	file.write((char*)&ir_stat, sizeof(ir_stat));
+	state.write(&master_irq_flags, sizeof(master_irq_flags));
+	state.write(&osc_1_enable, sizeof(osc_1_enable));
+	state.write(&osc_2_enable, sizeof(osc_2_enable));
+	state.write(&save_eeprom, sizeof(save_eeprom));
+	state.write(&rtc, sizeof(rtc));
+	state.write(&enable_rtc, sizeof(enable_rtc));
+	state.write(&eeprom, sizeof(eeprom));
+	state.write(&sed, sizeof(sed));
+	state.write(&ir_stat, sizeof(ir_stat));
 
-	file.close();
 	return true;
 }
 
@@ -62,6 +62,7 @@ class MIN_MMU
 	bool read_bios(std::string filename);
 	bool load_backup(std::string filename);
 	bool save_backup(std::string filename);
+	bool get_save_image(std::vector<u8> &image);
 
 	u32 get_prescalar_1(u8 val);
 	u32 get_prescalar_2(u8 val);
@@ -196,8 +197,8 @@ class MIN_MMU
 	void reset();
 
 	//Serialize data for save state loading/saving
-	bool mmu_read(u32 offset, std::string filename);
-	bool mmu_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
 	u32 size();
 
 	private:
@@ -9,6 +9,7 @@
 // Emulates a S1C88 in software
 
 #include "s1c88.h"
+#include "common/profiler.h"
 
 /****** S1C88 Constructor ******/
 S1C88::S1C88() 
@@ -6036,7 +6037,9 @@ void S1C88::clock_system()
 			//Otherwise refresh using existing pixel data
 			else { controllers.video.new_frame = false; }
 
+			PROFILER_ENTER(PROF_LCD);
 			controllers.video.update();
+			PROFILER_LEAVE();
 
 			controllers.video.lcd_stat.prc_rate &= ~0xF0;
 			controllers.video.lcd_stat.prc_rate |= (frame_counter << 4);
@@ -6045,9 +6048,13 @@ void S1C88::clock_system()
 
 		if((controllers.video.lcd_stat.prc_counter == 0x1) || (controllers.video.lcd_stat.prc_counter == 0x21))
 		{
-			//Generate audio buffer for sound channels on VBlank
-			if(controllers.audio.apu_stat.pwm_needs_fill) { controllers.audio.buffer_channel(); }
-			controllers.audio.apu_stat.pwm_needs_fill = true;
+			//Mix audio on VBlank, skip frames run-ahead throws away
+			if(controllers.video.realtime_frame)
+			{
+				PROFILER_ENTER(PROF_APU);
+				controllers.audio.buffer_frame();
+				PROFILER_LEAVE();
+			}
 		}
 
 		//Reset counter for CPU cycles
@@ -6281,65 +6288,56 @@ void S1C88::clock_system()
 }
 
 /****** Read CPU data from save state ******/
-bool S1C88::cpu_read(u32 offset, std::string filename)
+bool S1C88::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize CPU registers data from file stream
-	file.read((char*)&reg, sizeof(reg));
+	state.read(&reg, sizeof(reg));
 
 	//Serialize misc CPU data from file stream
-	file.read((char*)&opcode, sizeof(opcode));
-	file.read((char*)&log_addr, sizeof(log_addr));
-	file.read((char*)&system_cycles, sizeof(system_cycles));
-	file.read((char*)&debug_cycles, sizeof(debug_cycles));
-	file.read((char*)&halt, sizeof(halt));
-	file.read((char*)&debug_opcode, sizeof(debug_opcode));
-	file.read((char*)&running, sizeof(running));
-	file.read((char*)&skip_irq, sizeof(skip_irq));
+	state.read(&opcode, sizeof(opcode));
+	state.read(&log_addr, sizeof(log_addr));
+	state.read(&system_cycles, sizeof(system_cycles));
+	state.read(&debug_cycles, sizeof(debug_cycles));
+	state.read(&halt, sizeof(halt));
+	state.read(&debug_opcode, sizeof(debug_opcode));
+	state.read(&running, sizeof(running));
+	state.read(&skip_irq, sizeof(skip_irq));
 
 	//Serialize timers from file stream
-	file.read((char*)&controllers.timer[0], sizeof(controllers.timer[0]));
-	file.read((char*)&controllers.timer[1], sizeof(controllers.timer[1]));
-	file.read((char*)&controllers.timer[2], sizeof(controllers.timer[2]));
-	file.read((char*)&controllers.timer[3], sizeof(controllers.timer[3]));
+	state.read(&controllers.timer[0], sizeof(controllers.timer[0]));
+	state.read(&controllers.timer[1], sizeof(controllers.timer[1]));
+	state.read(&controllers.timer[2], sizeof(controllers.timer[2]));
+	state.read(&controllers.timer[3], sizeof(controllers.timer[3]));
 
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Write CPU data to save state ******/
-bool S1C88::cpu_write(std::string filename)
+bool S1C88::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize CPU registers data to save state
-	file.write((char*)&reg, sizeof(reg));
+	state.write(&reg, sizeof(reg));
 
 	//Serialize misc CPU data to save state
-	file.write((char*)&opcode, sizeof(opcode));
-	file.write((char*)&log_addr, sizeof(log_addr));
-	file.write((char*)&system_cycles, sizeof(system_cycles));
-	file.write((char*)&debug_cycles, sizeof(debug_cycles));
-	file.write((char*)&halt, sizeof(halt));
-	file.write((char*)&debug_opcode, sizeof(debug_opcode));
-	file.write((char*)&running, sizeof(running));
-	file.write((char*)&skip_irq, sizeof(skip_irq));
+	state.write(&opcode, sizeof(opcode));
+	state.write(&log_addr, sizeof(log_addr));
+	state.write(&system_cycles, sizeof(system_cycles));
+	state.write(&debug_cycles, sizeof(debug_cycles));
+	state.write(&halt, sizeof(halt));
+	state.write(&debug_opcode, sizeof(debug_opcode));
+	state.write(&running, sizeof(running));
+	state.write(&skip_irq, sizeof(skip_irq));
 
 	//Serialize timers from file stream
-	file.write((char*)&controllers.timer[0], sizeof(controllers.timer[0]));
-	file.write((char*)&controllers.timer[1], sizeof(controllers.timer[1]));
-	file.write((char*)&controllers.timer[2], sizeof(controllers.timer[2]));
-	file.write((char*)&controllers.timer[3], sizeof(controllers.timer[3]));
+	state.write(&controllers.timer[0], sizeof(controllers.timer[0]));
+	state.write(&controllers.timer[1], sizeof(controllers.timer[1]));
+	state.write(&controllers.timer[2], sizeof(controllers.timer[2]));
+	state.write(&controllers.timer[3], sizeof(controllers.timer[3]));
 
-	file.close();
 	return true;
 }
 
@@ -10,8 +10,10 @@
 // Generates and mixes samples for the NDS's 16 sound channels  
 
 #include <cmath>
+#include <cstring>
 
 #include "apu.h"
+#include "common/util.h"
 
 /****** APU Constructor ******/
 NTR_APU::NTR_APU()
@@ -23,6 +25,12 @@ NTR_APU::NTR_APU()
 NTR_APU::~NTR_APU()
 {
 	SDL_CloseAudio();
+
+	if((output.underruns) || (output.overruns))
+	{
+		std::cout<<"APU::Audio buffer underruns - " << std::dec << output.underruns << " :: overruns - " << output.overruns << "\n";
+	}
+
 	std::cout<<"APU::Shutdown\n";
 }
 
@@ -31,6 +39,9 @@ void NTR_APU::reset()
 {
 	SDL_CloseAudio();
 
+	last_frame = 0;
+	frame_samples = 0;
+
 	apu_stat.sound_on = false;
 	apu_stat.stereo = false;
 
@@ -118,6 +129,10 @@ bool NTR_APU::init()
 	{
 		apu_stat.channel_master_volume = config::volume;
 
+		//Mix once per frame, keep room for a few callbacks' worth of samples
+		frame_samples = apu_stat.sample_rate / 60;
+		output.resize((desired_spec.samples * 4), 1, desired_spec.freq);
+
 		SDL_PauseAudio(0);
 		std::cout<<"APU::Initialized\n";
 		return true;
@@ -331,29 +346,196 @@ void NTR_APU::decode_adpcm_samples(u8 id)
 	}
 }	
 
-/****** SDL Audio Callback ******/ 
-void ntr_audio_callback(void* _apu, u8 *_stream, int _length)
+/****** Read APU data from save state ******/
+bool NTR_APU::deserialize(const u8* buffer, u32 length)
 {
-	s16* stream = (s16*) _stream;
-	int length = _length/2;
-	std::vector<s32> channel_stream(length);
+	util::state_reader state(buffer, length);
 
-	NTR_APU* apu_link = (NTR_APU*) _apu;
+	//Serialize sound channels from save state
+	for(u32 x = 0; x < 16; x++)
+	{
+		state.read(&apu_stat.channel[x].output_frequency, sizeof(apu_stat.channel[x].output_frequency));
+		state.read(&apu_stat.channel[x].data_src, sizeof(apu_stat.channel[x].data_src));
+		state.read(&apu_stat.channel[x].data_pos, sizeof(apu_stat.channel[x].data_pos));
+		state.read(&apu_stat.channel[x].loop_start, sizeof(apu_stat.channel[x].loop_start));
+		state.read(&apu_stat.channel[x].length, sizeof(apu_stat.channel[x].length));
+		state.read(&apu_stat.channel[x].samples, sizeof(apu_stat.channel[x].samples));
+		state.read(&apu_stat.channel[x].cnt, sizeof(apu_stat.channel[x].cnt));
+		state.read(&apu_stat.channel[x].volume, sizeof(apu_stat.channel[x].volume));
+		state.read(&apu_stat.channel[x].playing, sizeof(apu_stat.channel[x].playing));
+		state.read(&apu_stat.channel[x].enable, sizeof(apu_stat.channel[x].enable));
+		state.read(&apu_stat.channel[x].adpcm_header, sizeof(apu_stat.channel[x].adpcm_header));
+		state.read(&apu_stat.channel[x].adpcm_pos, sizeof(apu_stat.channel[x].adpcm_pos));
+		state.read(&apu_stat.channel[x].adpcm_index, sizeof(apu_stat.channel[x].adpcm_index));
+		state.read(&apu_stat.channel[x].adpcm_val, sizeof(apu_stat.channel[x].adpcm_val));
+		state.read(&apu_stat.channel[x].decode_adpcm, sizeof(apu_stat.channel[x].decode_adpcm));
+
+		//Decoded IMA-ADPCM samples
+		u32 adpcm_size = 0;
+		state.read(&adpcm_size, sizeof(adpcm_size));
+
+		if(adpcm_size > ((state.state_length - state.state_offset) >> 1)) { return false; }
+
+		apu_stat.channel[x].adpcm_buffer.resize(adpcm_size);
+		if(adpcm_size) { state.read(&apu_stat.channel[x].adpcm_buffer[0], (adpcm_size * 2)); }
+	}
+
+	//Serialize misc APU data from save state
+	state.read(&apu_stat.sound_on, sizeof(apu_stat.sound_on));
+	state.read(&apu_stat.stereo, sizeof(apu_stat.stereo));
+	state.read(&apu_stat.main_volume, sizeof(apu_stat.main_volume));
+
+	return state.good();
+}
+
+/****** Write APU data to save state ******/
+bool NTR_APU::serialize(std::vector<u8> &buffer)
+{
+	util::state_writer state(buffer);
+
+	//Serialize sound channels to save state
+	for(u32 x = 0; x < 16; x++)
+	{
+		state.write(&apu_stat.channel[x].output_frequency, sizeof(apu_stat.channel[x].output_frequency));
+		state.write(&apu_stat.channel[x].data_src, sizeof(apu_stat.channel[x].data_src));
+		state.write(&apu_stat.channel[x].data_pos, sizeof(apu_stat.channel[x].data_pos));
+		state.write(&apu_stat.channel[x].loop_start, sizeof(apu_stat.channel[x].loop_start));
+		state.write(&apu_stat.channel[x].length, sizeof(apu_stat.channel[x].length));
+		state.write(&apu_stat.channel[x].samples, sizeof(apu_stat.channel[x].samples));
+		state.write(&apu_stat.channel[x].cnt, sizeof(apu_stat.channel[x].cnt));
+		state.write(&apu_stat.channel[x].volume, sizeof(apu_stat.channel[x].volume));
+		state.write(&apu_stat.channel[x].playing, sizeof(apu_stat.channel[x].playing));
+		state.write(&apu_stat.channel[x].enable, sizeof(apu_stat.channel[x].enable));
+		state.write(&apu_stat.channel[x].adpcm_header, sizeof(apu_stat.channel[x].adpcm_header));
+		state.write(&apu_stat.channel[x].adpcm_pos, sizeof(apu_stat.channel[x].adpcm_pos));
+		state.write(&apu_stat.channel[x].adpcm_index, sizeof(apu_stat.channel[x].adpcm_index));
+		state.write(&apu_stat.channel[x].adpcm_val, sizeof(apu_stat.channel[x].adpcm_val));
+		state.write(&apu_stat.channel[x].decode_adpcm, sizeof(apu_stat.channel[x].decode_adpcm));
+
+		//Decoded IMA-ADPCM samples
+		u32 adpcm_size = apu_stat.channel[x].adpcm_buffer.size();
+		state.write(&adpcm_size, sizeof(adpcm_size));
+		if(adpcm_size) { state.write(&apu_stat.channel[x].adpcm_buffer[0], (adpcm_size * 2)); }
+	}
+
+	//Serialize misc APU data to save state
+	state.write(&apu_stat.sound_on, sizeof(apu_stat.sound_on));
+	state.write(&apu_stat.stereo, sizeof(apu_stat.stereo));
+	state.write(&apu_stat.main_volume, sizeof(apu_stat.main_volume));
+
+	return true;
+}
+
+/****** Gets the size of APU data stored in a save state, returns 0 if the data is invalid ******/
+u32 NTR_APU::state_size(const u8* buffer, u32 length)
+{
+	//Each channel's fixed data is followed by its decoded ADPCM sample count and samples
+	u32 channel_size = sizeof(apu_stat.channel[0].output_frequency);
+	channel_size += sizeof(apu_stat.channel[0].data_src);
+	channel_size += sizeof(apu_stat.channel[0].data_pos);
+	channel_size += sizeof(apu_stat.channel[0].loop_start);
+	channel_size += sizeof(apu_stat.channel[0].length);
+	channel_size += sizeof(apu_stat.channel[0].samples);
+	channel_size += sizeof(apu_stat.channel[0].cnt);
+	channel_size += sizeof(apu_stat.channel[0].volume);
+	channel_size += sizeof(apu_stat.channel[0].playing);
+	channel_size += sizeof(apu_stat.channel[0].enable);
+	channel_size += sizeof(apu_stat.channel[0].adpcm_header);
+	channel_size += sizeof(apu_stat.channel[0].adpcm_pos);
+	channel_size += sizeof(apu_stat.channel[0].adpcm_index);
+	channel_size += sizeof(apu_stat.channel[0].adpcm_val);
+	channel_size += sizeof(apu_stat.channel[0].decode_adpcm);
+
+	u64 offset = 0;
+
+	for(u32 x = 0; x < 16; x++)
+	{
+		offset += channel_size;
+		if((offset + 4) > length) { return 0; }
+
+		u32 adpcm_size = 0;
+		memcpy(&adpcm_size, (buffer + offset), sizeof(adpcm_size));
+		offset += (4 + (u64(adpcm_size) * 2));
+	}
+
+	offset += sizeof(apu_stat.sound_on);
+	offset += sizeof(apu_stat.stereo);
+	offset += sizeof(apu_stat.main_volume);
+
+	if(offset > length) { return 0; }
+
+	return offset;
+}
+
+/****** Gets the size of APU data for serialization ******/
+u32 NTR_APU::size()
+{
+	u32 apu_size = 0;
+
+	for(u32 x = 0; x < 16; x++)
+	{
+		apu_size += sizeof(apu_stat.channel[x].output_frequency);
+		apu_size += sizeof(apu_stat.channel[x].data_src);
+		apu_size += sizeof(apu_stat.channel[x].data_pos);
+		apu_size += sizeof(apu_stat.channel[x].loop_start);
+		apu_size += sizeof(apu_stat.channel[x].length);
+		apu_size += sizeof(apu_stat.channel[x].samples);
+		apu_size += sizeof(apu_stat.channel[x].cnt);
+		apu_size += sizeof(apu_stat.channel[x].volume);
+		apu_size += sizeof(apu_stat.channel[x].playing);
+		apu_size += sizeof(apu_stat.channel[x].enable);
+		apu_size += sizeof(apu_stat.channel[x].adpcm_header);
+		apu_size += sizeof(apu_stat.channel[x].adpcm_pos);
+		apu_size += sizeof(apu_stat.channel[x].adpcm_index);
+		apu_size += sizeof(apu_stat.channel[x].adpcm_val);
+		apu_size += sizeof(apu_stat.channel[x].decode_adpcm);
+		apu_size += (4 + (apu_stat.channel[x].adpcm_buffer.size() * 2));
+	}
+
+	apu_size += sizeof(apu_stat.sound_on);
+	apu_size += sizeof(apu_stat.stereo);
+	apu_size += sizeof(apu_stat.main_volume);
+
+	return apu_size;
+}
+
+/****** Mixes one frame's worth of samples for the SDL callback ******/
+void NTR_APU::buffer_frame()
+{
+	if(frame_samples == 0) { return; }
+
+	u32 length = frame_samples;
+
+	//Streams only grow if the sample rate changes
+	if(mix_stream.size() != length)
+	{
+		channel_stream.resize(length);
+		mix_stream.resize(length);
+	}
 
 	//Generate samples
 	for(u32 x = 0; x < 16; x++)
 	{
 		//Decode IMA-ADPCM samples first
-		if(apu_link->apu_stat.channel[x].decode_adpcm) { apu_link->decode_adpcm_samples(x); }
+		if(apu_stat.channel[x].decode_adpcm) { decode_adpcm_samples(x); }
 
 		//Grab samples
-		apu_link->generate_channel_samples(&channel_stream[0], length, x);
+		generate_channel_samples(&channel_stream[0], length, x);
 	}
 
 	//Custom software mixing
 	for(u32 x = 0; x < length; x++)
 	{
 		channel_stream[x] /= 16;
-		stream[x] = channel_stream[x];
+		mix_stream[x] = channel_stream[x];
 	}
+
+	output.write(&mix_stream[0], length);
+}
+
+/****** SDL Audio Callback ******/ 
+void ntr_audio_callback(void* _apu, u8 *_stream, int _length)
+{
+	NTR_APU* apu_link = (NTR_APU*) _apu;
+	apu_link->output.read((s16*) _stream, (_length / 2));
 }
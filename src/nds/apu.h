@@ -15,6 +15,7 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_audio.h>
 #include "mmu.h"
+#include "common/audio_buffer.h"
 
 class NTR_APU
 {
@@ -27,14 +28,32 @@ class NTR_APU
 
 	SDL_AudioSpec desired_spec;
 
+	//Mixed samples waiting for the SDL callback
+	audio_buffer output;
+
+	//Last frame mixed and how many samples each one produces
+	u32 last_frame;
+	u32 frame_samples;
+
 	NTR_APU();
 	~NTR_APU();
 
 	void generate_channel_samples(s32* stream, int length, u8 id);
 	void decode_adpcm_samples(u8 id);
+	void buffer_frame();
 
 	bool init();
 	void reset();
+
+	//Serialize data for save state loading/saving
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
+	u32 size();
+	u32 state_size(const u8* buffer, u32 length);
+
+	//Preallocated streams for mixing
+	std::vector<s32> channel_stream;
+	std::vector<s16> mix_stream;
 };
 
 /****** SDL Audio Callback ******/ 
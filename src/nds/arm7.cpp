@@ -9,6 +9,8 @@
 // Emulates an ARM7TDMI CPU in software
 
 #include "arm7.h"
+#include "common/profiler.h"
+#include "common/util.h"
 
 /****** CPU Constructor ******/
 NTR_ARM7::NTR_ARM7()
@@ -1400,10 +1402,14 @@ void NTR_ARM7::clock_system()
 	sync_cycles += system_cycles;
 
 	//Run DMA channels
+	PROFILER_ENTER(PROF_DMA);
 	clock_dma();
+	PROFILER_LEAVE();
 
 	//Run timers
+	PROFILER_ENTER(PROF_TIMERS);
 	clock_timers(system_cycles);
+	PROFILER_LEAVE();
 
 	//Run RTC
 	if((mem->nds7_ie & 0x80) && (mem->nds7_rtc.int1_enable) && (mem->memory_map[NDS_RCNT+1] & 0x1))
@@ -1579,97 +1585,88 @@ void NTR_ARM7::handle_interrupt()
 }
 
 /****** Read CPU data from save state ******/
-bool NTR_ARM7::cpu_read(u32 offset, std::string filename)
+bool NTR_ARM7::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize CPU registers data from file stream
-	file.read((char*)&reg, sizeof(reg));
+	state.read(&reg, sizeof(reg));
 
 	//Serialize misc CPU data to save state
-	file.read((char*)&current_cpu_mode, sizeof(current_cpu_mode));
-	file.read((char*)&arm_mode, sizeof(arm_mode));
-	file.read((char*)&running, sizeof(running));
-	file.read((char*)&needs_flush, sizeof(needs_flush));
-	file.read((char*)&in_interrupt, sizeof(in_interrupt));
-	file.read((char*)&idle_state, sizeof(idle_state));
-	file.read((char*)&last_idle_state, sizeof(last_idle_state));
-	file.read((char*)&thumb_long_branch, sizeof(thumb_long_branch));
-	file.read((char*)&last_instr_branch, sizeof(last_instr_branch));
-	file.read((char*)&swi_waitbyloop_count, sizeof(swi_waitbyloop_count));
-	file.read((char*)&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
-	file.read((char*)&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
-	file.read((char*)&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
-	file.read((char*)&instruction_operation[0], sizeof(instruction_operation[0]));
-	file.read((char*)&instruction_operation[1], sizeof(instruction_operation[1]));
-	file.read((char*)&instruction_operation[2], sizeof(instruction_operation[2]));
-	file.read((char*)&pipeline_pointer, sizeof(pipeline_pointer));
-	file.read((char*)&debug_message, sizeof(debug_message));
-	file.read((char*)&debug_code, sizeof(debug_code));
-	file.read((char*)&debug_cycles, sizeof(debug_cycles));
-	file.read((char*)&debug_addr, sizeof(debug_addr));
-	file.read((char*)&sync_cycles, sizeof(sync_cycles));
-	file.read((char*)&system_cycles, sizeof(system_cycles));
-	file.read((char*)&re_sync, sizeof(re_sync));
+	state.read(&current_cpu_mode, sizeof(current_cpu_mode));
+	state.read(&arm_mode, sizeof(arm_mode));
+	state.read(&running, sizeof(running));
+	state.read(&needs_flush, sizeof(needs_flush));
+	state.read(&in_interrupt, sizeof(in_interrupt));
+	state.read(&idle_state, sizeof(idle_state));
+	state.read(&last_idle_state, sizeof(last_idle_state));
+	state.read(&thumb_long_branch, sizeof(thumb_long_branch));
+	state.read(&last_instr_branch, sizeof(last_instr_branch));
+	state.read(&swi_waitbyloop_count, sizeof(swi_waitbyloop_count));
+	state.read(&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
+	state.read(&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
+	state.read(&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
+	state.read(&instruction_operation[0], sizeof(instruction_operation[0]));
+	state.read(&instruction_operation[1], sizeof(instruction_operation[1]));
+	state.read(&instruction_operation[2], sizeof(instruction_operation[2]));
+	state.read(&pipeline_pointer, sizeof(pipeline_pointer));
+	state.read(&debug_message, sizeof(debug_message));
+	state.read(&debug_code, sizeof(debug_code));
+	state.read(&debug_cycles, sizeof(debug_cycles));
+	state.read(&debug_addr, sizeof(debug_addr));
+	state.read(&sync_cycles, sizeof(sync_cycles));
+	state.read(&system_cycles, sizeof(system_cycles));
+	state.read(&re_sync, sizeof(re_sync));
 
 	//Serialize timers to save state
-	file.read((char*)&controllers.timer[0], sizeof(controllers.timer[0]));
-	file.read((char*)&controllers.timer[1], sizeof(controllers.timer[1]));
-	file.read((char*)&controllers.timer[2], sizeof(controllers.timer[2]));
-	file.read((char*)&controllers.timer[3], sizeof(controllers.timer[3]));
+	state.read(&controllers.timer[0], sizeof(controllers.timer[0]));
+	state.read(&controllers.timer[1], sizeof(controllers.timer[1]));
+	state.read(&controllers.timer[2], sizeof(controllers.timer[2]));
+	state.read(&controllers.timer[3], sizeof(controllers.timer[3]));
 
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Write CPU data to save state ******/
-bool NTR_ARM7::cpu_write(std::string filename)
+bool NTR_ARM7::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize CPU registers data to save state
-	file.write((char*)&reg, sizeof(reg));
+	state.write(&reg, sizeof(reg));
 
 	//Serialize misc CPU data to save state
-	file.write((char*)&current_cpu_mode, sizeof(current_cpu_mode));
-	file.write((char*)&arm_mode, sizeof(arm_mode));
-	file.write((char*)&running, sizeof(running));
-	file.write((char*)&needs_flush, sizeof(needs_flush));
-	file.write((char*)&in_interrupt, sizeof(in_interrupt));
-	file.write((char*)&idle_state, sizeof(idle_state));
-	file.write((char*)&last_idle_state, sizeof(last_idle_state));
-	file.write((char*)&thumb_long_branch, sizeof(thumb_long_branch));
-	file.write((char*)&last_instr_branch, sizeof(last_instr_branch));
-	file.write((char*)&swi_waitbyloop_count, sizeof(swi_waitbyloop_count));
-	file.write((char*)&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
-	file.write((char*)&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
-	file.write((char*)&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
-	file.write((char*)&instruction_operation[0], sizeof(instruction_operation[0]));
-	file.write((char*)&instruction_operation[1], sizeof(instruction_operation[1]));
-	file.write((char*)&instruction_operation[2], sizeof(instruction_operation[2]));
-	file.write((char*)&pipeline_pointer, sizeof(pipeline_pointer));
-	file.write((char*)&debug_message, sizeof(debug_message));
-	file.write((char*)&debug_code, sizeof(debug_code));
-	file.write((char*)&debug_cycles, sizeof(debug_cycles));
-	file.write((char*)&debug_addr, sizeof(debug_addr));
-	file.write((char*)&sync_cycles, sizeof(sync_cycles));
-	file.write((char*)&system_cycles, sizeof(system_cycles));
-	file.write((char*)&re_sync, sizeof(re_sync));
+	state.write(&current_cpu_mode, sizeof(current_cpu_mode));
+	state.write(&arm_mode, sizeof(arm_mode));
+	state.write(&running, sizeof(running));
+	state.write(&needs_flush, sizeof(needs_flush));
+	state.write(&in_interrupt, sizeof(in_interrupt));
+	state.write(&idle_state, sizeof(idle_state));
+	state.write(&last_idle_state, sizeof(last_idle_state));
+	state.write(&thumb_long_branch, sizeof(thumb_long_branch));
+	state.write(&last_instr_branch, sizeof(last_instr_branch));
+	state.write(&swi_waitbyloop_count, sizeof(swi_waitbyloop_count));
+	state.write(&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
+	state.write(&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
+	state.write(&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
+	state.write(&instruction_operation[0], sizeof(instruction_operation[0]));
+	state.write(&instruction_operation[1], sizeof(instruction_operation[1]));
+	state.write(&instruction_operation[2], sizeof(instruction_operation[2]));
+	state.write(&pipeline_pointer, sizeof(pipeline_pointer));
+	state.write(&debug_message, sizeof(debug_message));
+	state.write(&debug_code, sizeof(debug_code));
+	state.write(&debug_cycles, sizeof(debug_cycles));
+	state.write(&debug_addr, sizeof(debug_addr));
+	state.write(&sync_cycles, sizeof(sync_cycles));
+	state.write(&system_cycles, sizeof(system_cycles));
+	state.write(&re_sync, sizeof(re_sync));
 
 	//Serialize timers to save state
-	file.write((char*)&controllers.timer[0], sizeof(controllers.timer[0]));
-	file.write((char*)&controllers.timer[1], sizeof(controllers.timer[1]));
-	file.write((char*)&controllers.timer[2], sizeof(controllers.timer[2]));
-	file.write((char*)&controllers.timer[3], sizeof(controllers.timer[3]));
+	state.write(&controllers.timer[0], sizeof(controllers.timer[0]));
+	state.write(&controllers.timer[1], sizeof(controllers.timer[1]));
+	state.write(&controllers.timer[2], sizeof(controllers.timer[2]));
+	state.write(&controllers.timer[3], sizeof(controllers.timer[3]));
 
-	file.close();
 	return true;
 }
 
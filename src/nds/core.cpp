@@ -15,6 +15,8 @@
 #include <sstream>
 
 #include "common/util.h"
+#include "common/state_file.h"
+#include "common/profiler.h"
 
 #include "core.h"
 
@@ -37,6 +39,15 @@ NTR_core::NTR_core()
 	core_cpu_nds7.controllers.audio.mem = &core_mmu;
 	core_mmu.set_apu_data(&core_cpu_nds7.controllers.audio.apu_stat);
 
+	//Link LCD and APU
+	core_cpu_nds9.controllers.video.audio_output = &core_cpu_nds7.controllers.audio.output;
+
+	//Link APU and A/V recorder
+	core_cpu_nds7.controllers.audio.output.recorder = &av_capture;
+
+	//Record at the system's real refresh rate
+	av_capture.set_frame_rate(33513982, 560190);
+
 	//Link MMU and GamePad
 	core_mmu.g_pad = &core_pad;
 	core_pad.nds7_input_irq = &core_mmu.nds7_if;
@@ -81,6 +92,9 @@ NTR_core::NTR_core()
 	config::osd_count = 180;
 }
 
+/****** Core Destructor ******/
+NTR_core::~NTR_core() { }
+
 /****** Start the core ******/
 void NTR_core::start()
 {
@@ -106,6 +120,10 @@ void NTR_core::start()
 	core_pad.init();
 
 	get_core_data(3);
+
+	//Clear rewind history and run-ahead state
+	rewind_data.reset();
+	run_ahead_data.reset();
 }
 
 /****** Stop the core ******/
@@ -120,9 +138,21 @@ void NTR_core::stop()
 /****** Shutdown core's components ******/
 void NTR_core::shutdown() 
 { 
-	core_mmu.NTR_MMU::~NTR_MMU();
-	core_cpu_nds9.NTR_ARM9::~NTR_ARM9();
-	core_cpu_nds7.NTR_ARM7::~NTR_ARM7();
+	//Finish any movie being recorded
+	movie_data.stop();
+
+	//Finish any background save write before the MMU writes the save on its own
+	save_sync.stop();
+
+	//Finish writing any queued screenshots
+	screenshots.stop();
+
+	//Finish any audio/video recording
+	av_capture.stop();
+
+	//Free rewind history and run-ahead state
+	rewind_data.reset();
+	run_ahead_data.reset();
 }
 
 /****** Reset the core ******/
@@ -130,6 +160,7 @@ void NTR_core::reset()
 {
 	bool can_reset = true;
 
+	save_sync.reset();
 	core_cpu_nds9.controllers.video.reset();
 	core_cpu_nds7.controllers.audio.reset();
 
@@ -165,6 +196,12 @@ void NTR_core::reset()
 	core_cpu_nds7.controllers.audio.mem = &core_mmu;
 	core_mmu.set_apu_data(&core_cpu_nds7.controllers.audio.apu_stat);
 
+	//Link LCD and APU
+	core_cpu_nds9.controllers.video.audio_output = &core_cpu_nds7.controllers.audio.output;
+
+	//Link APU and A/V recorder
+	core_cpu_nds7.controllers.audio.output.recorder = &av_capture;
+
 	//Link MMU and GamePad
 	core_mmu.g_pad = &core_pad;
 	core_pad.nds7_input_irq = &core_mmu.nds7_if;
@@ -185,10 +222,121 @@ void NTR_core::reset()
 }
 
 /****** Loads a save state ******/
-void NTR_core::load_state(u8 slot) { }
+void NTR_core::load_state(u8 slot)
+{
+	std::string id = (slot > 0) ? util::to_str(slot) : "";
+
+	std::string state_file = config::rom_file + ".ss";
+	state_file += id;
+
+	//Check if save state is accessible
+	std::ifstream test(state_file.c_str());
+	
+	if(!test.good())
+	{
+		config::osd_message = "INVALID SAVE STATE " + util::to_str(slot);
+		config::osd_count = 180;
+		return;
+	}
+
+	if(!load_state_file(this, state_file))
+	{
+		std::cout<<"GBE::Error - Could not load save state " << state_file << "\n";
+		return;
+	}
+
+	std::cout<<"GBE::Loaded state " << state_file << "\n";
+
+	//OSD
+	config::osd_message = "LOADED STATE " + util::to_str(slot);
+	config::osd_count = 180;
+}
 
 /****** Saves a save state ******/
-void NTR_core::save_state(u8 slot) { }
+void NTR_core::save_state(u8 slot)
+{
+	std::string id = (slot > 0) ? util::to_str(slot) : "";
+
+	std::string state_file = config::rom_file + ".ss";
+	state_file += id;
+
+	if(!save_state_file(this, state_file)) { return; }
+
+	std::cout<<"GBE::Saved state " << state_file << "\n";
+
+	//OSD
+	config::osd_message = "SAVED STATE " + util::to_str(slot);
+	config::osd_count = 180;
+}
+
+/****** Serializes the core into a contiguous save state buffer ******/
+bool NTR_core::serialize(std::vector<u8> &buffer)
+{
+	buffer.clear();
+
+	if(!core_cpu_nds9.serialize(buffer)) { return false; }
+	if(!core_cpu_nds7.serialize(buffer)) { return false; }
+	if(!core_mmu.serialize(buffer)) { return false; }
+	if(!core_cpu_nds7.controllers.audio.serialize(buffer)) { return false; }
+	if(!core_cpu_nds9.controllers.video.serialize(buffer)) { return false; }
+
+	//Serialize CPU sync data
+	util::state_writer state(buffer);
+	state.write(&cpu_sync_cycles, sizeof(cpu_sync_cycles));
+
+	return true;
+}
+
+/****** Restores the core from a contiguous save state buffer ******/
+bool NTR_core::deserialize(const u8* buffer, u32 length)
+{
+	u32 offset = 0;
+
+	//MMU and APU sizes depend on FIFOs and buffers, so walk their stored lengths and check the total before restoring anything
+	u32 cpu_size = core_cpu_nds9.size() + core_cpu_nds7.size();
+	u32 mmu_size = (length > cpu_size) ? core_mmu.state_size((buffer + cpu_size), (length - cpu_size)) : 0;
+	u64 apu_offset = u64(cpu_size) + mmu_size;
+	u32 apu_size = (mmu_size && (length > apu_offset)) ? core_cpu_nds7.controllers.audio.state_size((buffer + apu_offset), (length - apu_offset)) : 0;
+	u64 total_size = apu_offset + apu_size + core_cpu_nds9.controllers.video.size() + sizeof(cpu_sync_cycles);
+
+	if((!mmu_size) || (!apu_size) || (total_size != length)) { return false; }
+
+	if(!core_cpu_nds9.deserialize(buffer, length)) { return false; }
+	offset += core_cpu_nds9.size();
+
+	if((offset > length) || (!core_cpu_nds7.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_cpu_nds7.size();
+
+	if((offset > length) || (!core_mmu.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_mmu.size();
+
+	if((offset > length) || (!core_cpu_nds7.controllers.audio.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_cpu_nds7.controllers.audio.size();
+
+	if((offset > length) || (!core_cpu_nds9.controllers.video.deserialize((buffer + offset), (length - offset)))) { return false; }
+	offset += core_cpu_nds9.controllers.video.size();
+
+	if(offset > length) { return false; }
+
+	util::state_reader state((buffer + offset), (length - offset));
+	state.read(&cpu_sync_cycles, sizeof(cpu_sync_cycles));
+
+	return state.good();
+}
+
+/****** Lists the components of a save state in order, returns the system's tag ******/
+u32 NTR_core::get_state_sections(std::vector<state_section> &sections)
+{
+	sections.clear();
+	sections.push_back({ GBE_STATE_TAG('A', 'R', 'M', '9'), core_cpu_nds9.size() });
+	sections.push_back({ GBE_STATE_TAG('A', 'R', 'M', '7'), core_cpu_nds7.size() });
+	sections.push_back({ GBE_STATE_TAG('M', 'M', 'U', ' '), core_mmu.size() });
+	sections.push_back({ GBE_STATE_TAG('A', 'P', 'U', ' '), core_cpu_nds7.controllers.audio.size() });
+	sections.push_back({ GBE_STATE_TAG('L', 'C', 'D', ' '), core_cpu_nds9.controllers.video.size() });
+	sections.push_back({ GBE_STATE_TAG('S', 'Y', 'N', 'C'), sizeof(cpu_sync_cycles) });
+
+	return GBE_STATE_TAG('N', 'T', 'R', ' ');
+}
 
 /****** Run the core in a loop until exit ******/
 void NTR_core::run_core()
@@ -221,7 +369,9 @@ void NTR_core::run_core()
 			|| (event.type == SDL_MOUSEBUTTONDOWN) || (event.type == SDL_MOUSEBUTTONUP)
 			|| (event.type == SDL_MOUSEMOTION))
 			{
+				movie_data.begin_live_input(this);
 				core_pad.handle_input(event);
+				movie_data.end_live_input(this);
 				handle_hotkey(event);
 
 				//Trigger Joypad Interrupt if necessary
@@ -241,6 +391,8 @@ void NTR_core::run_core()
 		{	
 			if(db_unit.debug_mode) { debug_step(); }
 
+			PROFILER_ENTER(PROF_CPU);
+
 			//Run NDS9
 			if(core_cpu_nds9.re_sync)
 			{
@@ -359,9 +511,51 @@ void NTR_core::run_core()
 					}
 				}
 
-				//Clock system components
+				//Clock system components, counting the cycles the CPU just used
+				PROFILER_CYCLES(PROF_CPU, core_cpu_nds9.system_cycles);
 				core_cpu_nds9.clock_system();
 
+				//Mix audio once per frame, skip frames run-ahead throws away
+				if((core_cpu_nds7.controllers.audio.last_frame != core_cpu_nds9.controllers.video.frame_count) && (core_cpu_nds9.controllers.video.realtime_frame))
+				{
+					PROFILER_ENTER(PROF_APU);
+					core_cpu_nds7.controllers.audio.last_frame = core_cpu_nds9.controllers.video.frame_count;
+					core_cpu_nds7.controllers.audio.buffer_frame();
+					PROFILER_LEAVE();
+				}
+
+				//Record or play back input movies once per frame
+				if((movie_data.active) && (!run_ahead_data.active) && (movie_data.last_frame != core_cpu_nds9.controllers.video.frame_count))
+				{
+					movie_data.update(this, core_cpu_nds9.controllers.video.frame_count);
+				}
+
+				//Write changed battery save data in the background every few seconds
+				if((config::save_flush_interval) && (!run_ahead_data.active) && (save_sync.last_frame != core_cpu_nds9.controllers.video.frame_count))
+				{
+					save_sync.update(this, core_cpu_nds9.controllers.video.frame_count);
+				}
+
+				//Record presented frames and mixed audio
+				if((av_capture.active) && (!run_ahead_data.active) && (av_capture.last_frame != core_cpu_nds9.controllers.video.frame_count))
+				{
+					av_capture.update(core_cpu_nds9.controllers.video.screen_buffer, 256, core_cpu_nds9.controllers.video.frame_count);
+				}
+
+				//Capture or restore rewind snapshots once per frame, except while a movie is active
+				if((config::rewind_buffer_size) && (!run_ahead_data.active) && (!movie_data.active) && (rewind_data.last_frame != core_cpu_nds9.controllers.video.frame_count))
+				{
+					rewind_data.update(this, core_cpu_nds9.controllers.video.frame_count);
+				}
+
+				//Run ahead of the real frame to hide input lag, audio from frames ahead is never recorded
+				if((!run_ahead_data.active) && (run_ahead_data.last_frame != core_cpu_nds9.controllers.video.frame_count))
+				{
+					av_capture.hold_audio = true;
+					run_ahead_data.update(this, core_cpu_nds9.controllers.video.frame_count, core_cpu_nds9.controllers.video.present_frame, core_cpu_nds9.controllers.video.realtime_frame);
+					av_capture.hold_audio = false;
+				}
+
 				//Determine if NDS7 needs to run in order to sync
 				cpu_sync_cycles -= core_cpu_nds9.sync_cycles;	
 
@@ -491,7 +685,8 @@ void NTR_core::run_core()
 					}
 				}
 
-				//Clock system components
+				//Clock system components, counting the cycles the CPU just used
+				PROFILER_CYCLES(PROF_CPU, core_cpu_nds7.system_cycles);
 				core_cpu_nds7.clock_system();
 
 				//Determine if NDS9 needs to run in order to sync
@@ -507,6 +702,8 @@ void NTR_core::run_core()
 
 				core_cpu_nds7.thumb_long_branch = false;
 			}
+
+			PROFILER_LEAVE();
 		}
 
 		//Stop emulation
@@ -525,6 +722,8 @@ void NTR_core::step()
 	{	
 		if(db_unit.debug_mode) { debug_step(); }
 
+		PROFILER_ENTER(PROF_CPU);
+
 		//Run NDS9
 		if(core_cpu_nds9.re_sync)
 		{
@@ -610,9 +809,51 @@ void NTR_core::step()
 				}
 			}
 
-			//Clock system components
+			//Clock system components, counting the cycles the CPU just used
+			PROFILER_CYCLES(PROF_CPU, core_cpu_nds9.system_cycles);
 			core_cpu_nds9.clock_system();
 
+			//Mix audio once per frame, skip frames run-ahead throws away
+			if((core_cpu_nds7.controllers.audio.last_frame != core_cpu_nds9.controllers.video.frame_count) && (core_cpu_nds9.controllers.video.realtime_frame))
+			{
+				PROFILER_ENTER(PROF_APU);
+				core_cpu_nds7.controllers.audio.last_frame = core_cpu_nds9.controllers.video.frame_count;
+				core_cpu_nds7.controllers.audio.buffer_frame();
+				PROFILER_LEAVE();
+			}
+
+			//Record or play back input movies once per frame
+			if((movie_data.active) && (!run_ahead_data.active) && (movie_data.last_frame != core_cpu_nds9.controllers.video.frame_count))
+			{
+				movie_data.update(this, core_cpu_nds9.controllers.video.frame_count);
+			}
+
+			//Write changed battery save data in the background every few seconds
+			if((config::save_flush_interval) && (!run_ahead_data.active) && (save_sync.last_frame != core_cpu_nds9.controllers.video.frame_count))
+			{
+				save_sync.update(this, core_cpu_nds9.controllers.video.frame_count);
+			}
+
+			//Record presented frames and mixed audio
+			if((av_capture.active) && (!run_ahead_data.active) && (av_capture.last_frame != core_cpu_nds9.controllers.video.frame_count))
+			{
+				av_capture.update(core_cpu_nds9.controllers.video.screen_buffer, 256, core_cpu_nds9.controllers.video.frame_count);
+			}
+
+			//Capture or restore rewind snapshots once per frame, except while a movie is active
+			if((config::rewind_buffer_size) && (!run_ahead_data.active) && (!movie_data.active) && (rewind_data.last_frame != core_cpu_nds9.controllers.video.frame_count))
+			{
+				rewind_data.update(this, core_cpu_nds9.controllers.video.frame_count);
+			}
+
+			//Run ahead of the real frame to hide input lag, audio from frames ahead is never recorded
+			if((!run_ahead_data.active) && (run_ahead_data.last_frame != core_cpu_nds9.controllers.video.frame_count))
+			{
+				av_capture.hold_audio = true;
+				run_ahead_data.update(this, core_cpu_nds9.controllers.video.frame_count, core_cpu_nds9.controllers.video.present_frame, core_cpu_nds9.controllers.video.realtime_frame);
+				av_capture.hold_audio = false;
+			}
+
 			//Determine if NDS7 needs to run in order to sync
 			cpu_sync_cycles -= core_cpu_nds9.sync_cycles;	
 
@@ -707,7 +948,8 @@ void NTR_core::step()
 				}
 			}
 
-			//Clock system components
+			//Clock system components, counting the cycles the CPU just used
+			PROFILER_CYCLES(PROF_CPU, core_cpu_nds7.system_cycles);
 			core_cpu_nds7.clock_system();
 
 			//Determine if NDS9 needs to run in order to sync
@@ -721,6 +963,8 @@ void NTR_core::step()
 				core_mmu.access_mode = 1;
 			}
 		}
+
+		PROFILER_LEAVE();
 	}
 }
 	
@@ -734,6 +978,29 @@ void NTR_core::handle_hotkey(SDL_Event& event)
 		SDL_Quit();
 	}
 
+	//Quick save state on F1
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_F1))
+	{
+		save_state(0);
+	}
+
+	//Quick load save state on F2
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_F2))
+	{
+		load_state(0);
+	}
+
+	//Rewind while held
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == config::hotkey_rewind))
+	{
+		rewind_data.rewinding = (config::rewind_buffer_size != 0);
+	}
+
+	else if((event.type == SDL_KEYUP) && (event.key.keysym.sym == config::hotkey_rewind))
+	{
+		rewind_data.rewinding = false;
+	}
+
 	//Screenshot on F9
 	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_F9)) 
 	{
@@ -748,9 +1015,9 @@ void NTR_core::handle_hotkey(SDL_Event& event)
 		//Append random number to screenshot name
 		srand(SDL_GetTicks());
 		save_stream << rand() % 1024 << rand() % 1024 << rand() % 1024;
-		save_name += save_stream.str() + ".bmp";
+		save_name += save_stream.str() + ".png";
 	
-		SDL_SaveBMP(core_cpu_nds9.controllers.video.final_screen, save_name.c_str());
+		screenshots.save(core_cpu_nds9.controllers.video.final_screen, save_name);
 
 		//OSD
 		config::osd_message = "SAVED SCREENSHOT";
@@ -835,6 +1102,7 @@ void NTR_core::handle_hotkey(SDL_Event& event)
 				config::pause_emu = false;
 				SDL_PauseAudio(0);
 				std::cout<<"EMU::Unpaused\n";
+				frame_pacer::notify_resume();
 			}
 		}
 	}
@@ -900,6 +1168,9 @@ void NTR_core::handle_hotkey(int input, bool pressed)
 	//Toggle turbo off
 	else if((input == config::hotkey_turbo) && (!pressed)) { config::turbo = false; }
 
+	//Rewind while held
+	else if(input == config::hotkey_rewind) { rewind_data.rewinding = ((pressed) && (config::rewind_buffer_size != 0)); }
+
 	//Toggle swap NDS screens on F4
 	else if((input == config::hotkey_swap_screen) && (pressed))
 	{
@@ -942,12 +1213,67 @@ void NTR_core::feed_key_input(int sdl_key, bool pressed)
 	//Process normal events
 	if((sdl_key & 0x70000) == 0)
 	{ 
+		movie_data.begin_live_input(this);
 		core_pad.process_keyboard(sdl_key, pressed);
+		movie_data.end_live_input(this);
 		handle_hotkey(sdl_key, pressed);
 	}
 
 	//Process mouse events
-	else { core_pad.process_mouse(sdl_key, pressed); }
+	else
+	{
+		movie_data.begin_live_input(this);
+		core_pad.process_mouse(sdl_key, pressed);
+		movie_data.end_live_input(this);
+	}
+}
+
+/****** Captures the GamePad's state for input movies ******/
+void NTR_core::get_movie_input(movie_input &input)
+{
+	input.keys = ((core_pad.ext_key_input << 16) | core_pad.key_input);
+	input.touch_x = core_pad.mouse_x;
+	input.touch_y = core_pad.mouse_y;
+	input.sensor_x = 0;
+	input.sensor_y = 0;
+	input.gyro_value = 0;
+	input.gyro_flags = 0;
+	input.solar_value = 0;
+}
+
+/****** Applies GamePad state from input movies, triggers Joypad and Lid IRQs on new frames ******/
+void NTR_core::set_movie_input(const movie_input &input, bool new_frame)
+{
+	u16 last_input = core_pad.key_input;
+	u16 last_ext_input = core_pad.ext_key_input;
+	u16 key_mask = (core_pad.key_cnt & 0x3FF);
+
+	core_pad.key_input = (input.keys & 0xFFFF);
+	core_pad.ext_key_input = (input.keys >> 16);
+	core_pad.mouse_x = input.touch_x;
+	core_pad.mouse_y = input.touch_y;
+	core_pad.joypad_irq = false;
+
+	if(!new_frame) { return; }
+
+	//Trigger Lid hardware IRQ
+	if((last_ext_input ^ core_pad.ext_key_input) & 0x80) { core_mmu.nds7_if |= 0x400000; }
+
+	if((last_input == core_pad.key_input) || (core_pad.key_input == 0x3FF)) { return; }
+
+	//Logical OR mode, Logical AND mode
+	if((((core_pad.key_cnt & 0x8000) == 0) && (~core_pad.key_input & key_mask))
+	|| ((core_pad.key_cnt & 0x8000) && ((~core_pad.key_input & key_mask) == key_mask)))
+	{
+		core_mmu.nds9_if |= 0x1000;
+		core_mmu.nds7_if |= 0x1000;
+	}
+}
+
+/****** Copies battery-backed save data for background writes ******/
+bool NTR_core::get_save_image(std::vector<u8> &image)
+{
+	return core_mmu.get_save_image(image);
 }
 
 /****** Return a CPU register ******/
@@ -17,6 +17,12 @@
 
 #include "common/core_emu.h"
 #include "common/config.h"
+#include "common/rewind.h"
+#include "common/run_ahead.h"
+#include "common/input_movie.h"
+#include "common/save_flusher.h"
+#include "common/screenshot.h"
+#include "common/av_recorder.h"
 #include "mmu.h"
 #include "lcd.h"
 #include "apu.h"
@@ -40,6 +46,9 @@ class NTR_core : virtual public core_emu
 		void feed_key_input(int sdl_key, bool pressed);
 		void save_state(u8 slot);
 		void load_state(u8 slot);
+		bool serialize(std::vector<u8> &buffer);
+		bool deserialize(const u8* buffer, u32 length);
+		u32 get_state_sections(std::vector<state_section> &sections);
 		void run_core();
 		void step();
 
@@ -64,6 +73,13 @@ class NTR_core : virtual public core_emu
 		void start_netplay();
 		void stop_netplay();
 
+		//Input movies
+		void get_movie_input(movie_input &input);
+		void set_movie_input(const movie_input &input, bool new_frame);
+
+		//Battery saves
+		bool get_save_image(std::vector<u8> &image);
+
 		//Misc
 		u32 get_core_data(u32 core_index);
 
@@ -76,6 +92,12 @@ class NTR_core : virtual public core_emu
 		bool arm_debug;
 
 		NTR_GamePad core_pad;
+		rewind_buffer rewind_data;
+		run_ahead run_ahead_data;
+		input_movie movie_data;
+		save_flusher save_sync;
+		screenshot_writer screenshots;
+		av_recorder av_capture;
 };
 		
 #endif // NDS_CORE
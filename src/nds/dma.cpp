@@ -123,7 +123,7 @@ void NTR_ARM9::nds9_dma(u8 index)
 
 		mem->nds_card.transfer_src = (mem->nds_card.cmd_lo << 8);
 		mem->nds_card.transfer_src |= (mem->nds_card.cmd_hi >> 24);
-		mem->nds_card.transfer_src &= (mem->cart_data.size() - 1);
+		mem->nds_card.transfer_src &= (mem->cart_size - 1);
 
 		while(mem->dma[index].word_count != 0)
 		{
@@ -121,9 +121,9 @@ void NTR_MMU::process_card_bus()
 					nds_card.transfer_size += 4;
 
 					//Make sure not to read non-existent data
-					if(nds_card.transfer_src + nds_card.transfer_size > cart_data.size())
+					if(nds_card.transfer_src + nds_card.transfer_size > cart_size)
 					{
-						nds_card.transfer_size = cart_data.size() - nds_card.transfer_src;
+						nds_card.transfer_size = cart_size - nds_card.transfer_src;
 						std::cout<<"MMU::Warning - Cart transfer address is too big\n";
 					}
 				}
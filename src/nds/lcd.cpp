@@ -10,12 +10,14 @@
 // Responsible for blitting pixel data and limiting frame rate
 
 #include <cmath>
+#include <algorithm>
 
 #include "lcd.h"
 #include "common/util.h"
+#include "common/profiler.h"
 
 /****** LCD Constructor ******/
-NTR_LCD::NTR_LCD()
+NTR_LCD::NTR_LCD() : lcd_stat(), lcd_3D_stat(), light_colors(), material_colors(), shine_table()
 {
 	window = NULL;
 	reset();
@@ -43,6 +45,7 @@ void NTR_LCD::reset()
 	final_screen = NULL;
 	original_screen = NULL;
 	mem = NULL;
+	audio_output = NULL;
 
 	if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
 	window = NULL;
@@ -61,18 +64,15 @@ void NTR_LCD::reset()
 	lcd_stat.lcd_clock = 0;
 	lcd_stat.lcd_mode = 0;
 
-	frame_start_time = 0;
-	frame_current_time = 0;
 	fps_count = 0;
+	frame_count = 0;
+	present_frame = true;
+	realtime_frame = true;
+	skip_frame = false;
+	skip_geometry = false;
 	fps_time = 0;
 
-	for(u32 x = 0; x < 60; x++)
-	{
-		u16 max = (config::max_fps) ? config::max_fps : 60;
-		double frame_1 = ((1000.0 / max) * x);
-		double frame_2 = ((1000.0 / max) * (x + 1));
-		frame_delay[x] = (std::round(frame_2) - std::round(frame_1));
-	}
+	pacer.reset((config::max_fps) ? config::max_fps : 60);
 
 	lcd_stat.current_scanline = 0;
 	scanline_pixel_counter = 0;
@@ -4033,7 +4033,15 @@ void NTR_LCD::step()
 	//Process GX commands and states
 	if(lcd_3D_stat.process_command) { process_gx_command(); }
 	
-	if(lcd_3D_stat.render_polygon) { render_geometry(); }
+	//Polygons appear on the frame after the next buffer swap, so drop them only if that frame is skipped
+	//Geometry is always drawn while a display capture is pending, since capture copies 3D output to VRAM
+	if((lcd_3D_stat.render_polygon) && (skip_geometry) && (lcd_stat.cap_finished))
+	{
+		lcd_3D_stat.render_polygon = false;
+		lcd_3D_stat.clip_flags = 0;
+	}
+
+	else if(lcd_3D_stat.render_polygon) { render_geometry(); }
 
 	//Mode 0 - Scanline rendering
 	if(((lcd_stat.lcd_clock % 2130) <= 1536) && (lcd_stat.lcd_clock < 408960)) 
@@ -4102,38 +4110,41 @@ void NTR_LCD::step()
 				lcd_stat.update_bg_control_b = false;
 			}
 
-			//Render scanline data
-			render_scanline();
+			//Render scanline data, unless the frame won't be shown
+			if(!skip_frame)
+			{
+				render_scanline();
 
-			//Apply Master Brightness on Engine A and/or Engine B if necessary
-			if(lcd_stat.master_bright_a & 0xC000) { adjust_master_brightness(1); }
-			if(lcd_stat.master_bright_b & 0xC000) { adjust_master_brightness(0); }
+				//Apply Master Brightness on Engine A and/or Engine B if necessary
+				if(lcd_stat.master_bright_a & 0xC000) { adjust_master_brightness(1); }
+				if(lcd_stat.master_bright_b & 0xC000) { adjust_master_brightness(0); }
 
-			u32 render_position = (lcd_stat.current_scanline * config::sys_width);
+				u32 render_position = (lcd_stat.current_scanline * config::sys_width);
 
-			//Swap top and bottom if POWERCNT1 Bit 15 is not set, otherwise A is top, B is bottom
-			u16 disp_a_offset = (mem->power_cnt1 & 0x8000) ? 0 : 0xC000;
-			u16 disp_b_offset = (mem->power_cnt1 & 0x8000) ? 0xC000 : 0;
+				//Swap top and bottom if POWERCNT1 Bit 15 is not set, otherwise A is top, B is bottom
+				u16 disp_a_offset = (mem->power_cnt1 & 0x8000) ? 0 : 0xC000;
+				u16 disp_b_offset = (mem->power_cnt1 & 0x8000) ? 0xC000 : 0;
 
-			//Swap top and bottom if LCD configuration calls for it
-			if(config::lcd_config & 0x1)
-			{
-				disp_a_offset = (disp_a_offset) ? 0 : 0xC000;
-				disp_b_offset = (disp_b_offset) ? 0 : 0xC000;
-			}
+				//Swap top and bottom if LCD configuration calls for it
+				if(config::lcd_config & 0x1)
+				{
+					disp_a_offset = (disp_a_offset) ? 0 : 0xC000;
+					disp_b_offset = (disp_b_offset) ? 0 : 0xC000;
+				}
 
-			//Horizontal vs. Vertical mode
-			if(config::lcd_config & 0x2)
-			{
-				disp_a_offset = (disp_a_offset) ? 0x100 : 0;
-				disp_b_offset = (disp_b_offset) ? 0x100 : 0;
-			} 
-			
-			//Push scanline pixel data to screen buffer
-			for(u16 x = 0; x < 256; x++)
-			{
-				screen_buffer[render_position + x + disp_a_offset] = scanline_buffer_a[x];
-				screen_buffer[render_position + x + disp_b_offset] = scanline_buffer_b[x];
+				//Horizontal vs. Vertical mode
+				if(config::lcd_config & 0x2)
+				{
+					disp_a_offset = (disp_a_offset) ? 0x100 : 0;
+					disp_b_offset = (disp_b_offset) ? 0x100 : 0;
+				} 
+				
+				//Push scanline pixel data to screen buffer
+				for(u16 x = 0; x < 256; x++)
+				{
+					screen_buffer[render_position + x + disp_a_offset] = scanline_buffer_a[x];
+					screen_buffer[render_position + x + disp_b_offset] = scanline_buffer_b[x];
+				}
 			}
 
 			//Start HBlank DMA
@@ -4175,6 +4186,12 @@ void NTR_LCD::step()
 				draw_osd_msg(config::osd_message, screen_buffer, 0, 0);
 			}
 
+			//Display profiler counters
+			PROFILER_DRAW_OSD(screen_buffer);
+
+			//Display frame time statistics
+			pacer.draw_osd(screen_buffer);
+
 			//Update and draw virtual cursor
 			if(config::vc_enable)
 			{
@@ -4182,63 +4199,33 @@ void NTR_LCD::step()
 				if(mem->g_pad->vc_pause < config::vc_timeout) { render_virtual_cursor(); }
 			}
 
-			//Use SDL
-			if(config::sdl_render)
+			//Present frame unless it is hidden (e.g. run-ahead) or skipped
+			//Hidden frames are still rendered, display capture may copy them back into VRAM
+			if((present_frame) && (!skip_frame))
 			{
-				//If using SDL and no OpenGL, manually stretch for fullscreen via SDL
-				if((config::flags & SDL_WINDOW_FULLSCREEN) && (!config::use_opengl))
+				//Use SDL
+				if(config::sdl_render)
 				{
-					//Lock source surface
-					if(SDL_MUSTLOCK(original_screen)){ SDL_LockSurface(original_screen); }
-					u32* out_pixel_data = (u32*)original_screen->pixels;
-
-					for(int a = 0; a < 0x18000; a++) { out_pixel_data[a] = screen_buffer[a]; }
-
-					//Unlock source surface
-					if(SDL_MUSTLOCK(original_screen)){ SDL_UnlockSurface(original_screen); }
-		
-					//Blit the original surface to the final stretched one
-					SDL_Rect dest_rect;
-					dest_rect.w = config::sys_width * max_fullscreen_ratio;
-					dest_rect.h = config::sys_height * max_fullscreen_ratio;
-					dest_rect.x = ((config::win_width - dest_rect.w) >> 1);
-					dest_rect.y = ((config::win_height - dest_rect.h) >> 1);
-					SDL_BlitScaled(original_screen, NULL, final_screen, &dest_rect);
-
-					if(SDL_UpdateWindowSurface(window) != 0)
+					//If using SDL and no OpenGL, manually stretch for fullscreen via SDL
+					if((config::flags & SDL_WINDOW_FULLSCREEN) && (!config::use_opengl))
 					{
-						std::cout<<"LCD::Error - Could not blit\n";
+						//Lock source surface
+						if(SDL_MUSTLOCK(original_screen)){ SDL_LockSurface(original_screen); }
+						u32* out_pixel_data = (u32*)original_screen->pixels;
 
-						//Try to make a new the window if the blit failed
-						if(!try_window_rebuild)
-						{
-							try_window_rebuild = true;
-							if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
-							init();
-						}
-					}
-
-					else { try_window_rebuild = false; }
-				}
-					
-				//Otherwise, render normally (SDL 1:1, OpenGL handles its own stretching)
-				else
-				{
-					//Lock source surface
-					if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
-					u32* out_pixel_data = (u32*)final_screen->pixels;
+						for(int a = 0; a < 0x18000; a++) { out_pixel_data[a] = screen_buffer[a]; }
 
-					for(int a = 0; a < 0x18000; a++) { out_pixel_data[a] = screen_buffer[a]; }
+						//Unlock source surface
+						if(SDL_MUSTLOCK(original_screen)){ SDL_UnlockSurface(original_screen); }
+			
+						//Blit the original surface to the final stretched one
+						SDL_Rect dest_rect;
+						dest_rect.w = config::sys_width * max_fullscreen_ratio;
+						dest_rect.h = config::sys_height * max_fullscreen_ratio;
+						dest_rect.x = ((config::win_width - dest_rect.w) >> 1);
+						dest_rect.y = ((config::win_height - dest_rect.h) >> 1);
+						SDL_BlitScaled(original_screen, NULL, final_screen, &dest_rect);
 
-					//Unlock source surface
-					if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
-		
-					//Display final screen buffer - OpenGL
-					if(config::use_opengl) { opengl_blit(); }
-				
-					//Display final screen buffer - SDL
-					else 
-					{
 						if(SDL_UpdateWindowSurface(window) != 0)
 						{
 							std::cout<<"LCD::Error - Could not blit\n";
@@ -4254,40 +4241,89 @@ void NTR_LCD::step()
 
 						else { try_window_rebuild = false; }
 					}
-				}
-			}
+						
+					//Otherwise, render normally (SDL 1:1, OpenGL handles its own stretching)
+					else
+					{
+						//Lock source surface
+						if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
+						u32* out_pixel_data = (u32*)final_screen->pixels;
 
-			//Use external rendering method (GUI)
-			else
-			{
-				if(!config::use_opengl) { config::render_external_sw(screen_buffer); }
+						for(int a = 0; a < 0x18000; a++) { out_pixel_data[a] = screen_buffer[a]; }
+
+						//Unlock source surface
+						if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
+			
+						//Display final screen buffer - OpenGL
+						if(config::use_opengl) { opengl_blit(); }
+					
+						//Display final screen buffer - SDL
+						else 
+						{
+							if(SDL_UpdateWindowSurface(window) != 0)
+							{
+								std::cout<<"LCD::Error - Could not blit\n";
+
+								//Try to make a new the window if the blit failed
+								if(!try_window_rebuild)
+								{
+									try_window_rebuild = true;
+									if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
+									init();
+								}
+							}
+
+							else { try_window_rebuild = false; }
+						}
+					}
+				}
 
+				//Use external rendering method (GUI)
 				else
 				{
-					//Lock source surface
-					if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
-					u32* out_pixel_data = (u32*)final_screen->pixels;
+					if(!config::use_opengl) { config::render_external_sw(screen_buffer); }
+
+					else
+					{
+						//Lock source surface
+						if(SDL_MUSTLOCK(final_screen)){ SDL_LockSurface(final_screen); }
+						u32* out_pixel_data = (u32*)final_screen->pixels;
 
-					for(int a = 0; a < 0x18000; a++) { out_pixel_data[a] = screen_buffer[a]; }
+						for(int a = 0; a < 0x18000; a++) { out_pixel_data[a] = screen_buffer[a]; }
 
-					//Unlock source surface
-					if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
+						//Unlock source surface
+						if(SDL_MUSTLOCK(final_screen)){ SDL_UnlockSurface(final_screen); }
 
-					config::render_external_hw(final_screen);
+						config::render_external_hw(final_screen);
+					}
 				}
 			}
 
 			//Limit framerate
-			if(!config::turbo)
+			if((!config::turbo) && (realtime_frame))
+			{
+				PROFILER_ENTER(PROF_IDLE);
+
+				//Pace on the audio device's clock when syncing to audio, otherwise wait for the frame's deadline
+				pacer.limit(audio_output);
+
+				PROFILER_LEAVE();
+			}
+
+			PROFILER_END_FRAME();
+
+			//Update FPS counter + title, frame time and health statistics
+			if(realtime_frame)
 			{
-				frame_current_time = SDL_GetTicks();
-				int delay = frame_delay[fps_count % 60];
-				if((frame_current_time - frame_start_time) < delay) { SDL_Delay(delay - (frame_current_time - frame_start_time));}
-				frame_start_time = SDL_GetTicks();
+				fps_count++;
+				pacer.record(audio_output);
 			}
 
-			//Update FPS counter + title
-			fps_count++;
+			frame_count++;
+
+			//While in turbo, only render 1 out of every N+1 frames
+			skip_frame = (config::turbo) && (config::turbo_frameskip) && ((frame_count % (config::turbo_frameskip + 1)) != 0);
+			skip_geometry = (config::turbo) && (config::turbo_frameskip) && (((frame_count + 1) % (config::turbo_frameskip + 1)) != 0);
 			if(((SDL_GetTicks() - fps_time) >= 1000) && (config::sdl_render))
 			{ 
 				fps_time = SDL_GetTicks(); 
@@ -4698,3 +4734,699 @@ void NTR_LCD::render_virtual_cursor()
 		}
 	}
 }
+
+/****** Read LCD data from save state ******/
+bool NTR_LCD::deserialize(const u8* buffer, u32 length)
+{
+	util::state_reader state(buffer, length);
+
+	//Serialize 2D engine data from save state
+	state.read(&lcd_stat.current_scanline, sizeof(lcd_stat.current_scanline));
+	state.read(&lcd_stat.lcd_clock, sizeof(lcd_stat.lcd_clock));
+	state.read(&lcd_stat.lcd_mode, sizeof(lcd_stat.lcd_mode));
+	state.read(&lcd_stat.lyc_nds9, sizeof(lcd_stat.lyc_nds9));
+	state.read(&lcd_stat.lyc_nds7, sizeof(lcd_stat.lyc_nds7));
+	state.read(&lcd_stat.display_control_a, sizeof(lcd_stat.display_control_a));
+	state.read(&lcd_stat.display_control_b, sizeof(lcd_stat.display_control_b));
+	state.read(&lcd_stat.display_stat_nds9, sizeof(lcd_stat.display_stat_nds9));
+	state.read(&lcd_stat.display_stat_nds7, sizeof(lcd_stat.display_stat_nds7));
+	state.read(&lcd_stat.bg_mode_a, sizeof(lcd_stat.bg_mode_a));
+	state.read(&lcd_stat.bg_mode_b, sizeof(lcd_stat.bg_mode_b));
+	state.read(&lcd_stat.display_mode_a, sizeof(lcd_stat.display_mode_a));
+	state.read(&lcd_stat.display_mode_b, sizeof(lcd_stat.display_mode_b));
+	state.read(&lcd_stat.ext_pal_a, sizeof(lcd_stat.ext_pal_a));
+	state.read(&lcd_stat.ext_pal_b, sizeof(lcd_stat.ext_pal_b));
+	state.read(&lcd_stat.obj_boundary_a, sizeof(lcd_stat.obj_boundary_a));
+	state.read(&lcd_stat.obj_boundary_b, sizeof(lcd_stat.obj_boundary_b));
+	state.read(&lcd_stat.bg_control_a, sizeof(lcd_stat.bg_control_a));
+	state.read(&lcd_stat.bg_control_b, sizeof(lcd_stat.bg_control_b));
+	state.read(&lcd_stat.hblank_interval_free, sizeof(lcd_stat.hblank_interval_free));
+	state.read(&lcd_stat.master_bright_a, sizeof(lcd_stat.master_bright_a));
+	state.read(&lcd_stat.master_bright_b, sizeof(lcd_stat.master_bright_b));
+	state.read(&lcd_stat.forced_blank_a, sizeof(lcd_stat.forced_blank_a));
+	state.read(&lcd_stat.forced_blank_b, sizeof(lcd_stat.forced_blank_b));
+	state.read(&lcd_stat.vram_bank_addr, sizeof(lcd_stat.vram_bank_addr));
+	state.read(&lcd_stat.vram_bank_enable, sizeof(lcd_stat.vram_bank_enable));
+	state.read(&lcd_stat.bg_offset_x_a, sizeof(lcd_stat.bg_offset_x_a));
+	state.read(&lcd_stat.bg_offset_x_b, sizeof(lcd_stat.bg_offset_x_b));
+	state.read(&lcd_stat.bg_offset_y_a, sizeof(lcd_stat.bg_offset_y_a));
+	state.read(&lcd_stat.bg_offset_y_b, sizeof(lcd_stat.bg_offset_y_b));
+	state.read(&lcd_stat.bg_depth_a, sizeof(lcd_stat.bg_depth_a));
+	state.read(&lcd_stat.bg_depth_b, sizeof(lcd_stat.bg_depth_b));
+	state.read(&lcd_stat.bg_size_a, sizeof(lcd_stat.bg_size_a));
+	state.read(&lcd_stat.bg_size_b, sizeof(lcd_stat.bg_size_b));
+	state.read(&lcd_stat.text_width_a, sizeof(lcd_stat.text_width_a));
+	state.read(&lcd_stat.text_width_b, sizeof(lcd_stat.text_width_b));
+	state.read(&lcd_stat.text_height_a, sizeof(lcd_stat.text_height_a));
+	state.read(&lcd_stat.text_height_b, sizeof(lcd_stat.text_height_b));
+	state.read(&lcd_stat.bg_base_map_addr_a, sizeof(lcd_stat.bg_base_map_addr_a));
+	state.read(&lcd_stat.bg_base_map_addr_b, sizeof(lcd_stat.bg_base_map_addr_b));
+	state.read(&lcd_stat.bg_base_tile_addr_a, sizeof(lcd_stat.bg_base_tile_addr_a));
+	state.read(&lcd_stat.bg_base_tile_addr_b, sizeof(lcd_stat.bg_base_tile_addr_b));
+	state.read(&lcd_stat.bg_bitmap_base_addr_a, sizeof(lcd_stat.bg_bitmap_base_addr_a));
+	state.read(&lcd_stat.bg_bitmap_base_addr_b, sizeof(lcd_stat.bg_bitmap_base_addr_b));
+	state.read(&lcd_stat.bg_priority_a, sizeof(lcd_stat.bg_priority_a));
+	state.read(&lcd_stat.bg_priority_b, sizeof(lcd_stat.bg_priority_b));
+	state.read(&lcd_stat.bg_enable_a, sizeof(lcd_stat.bg_enable_a));
+	state.read(&lcd_stat.bg_enable_b, sizeof(lcd_stat.bg_enable_b));
+	state.read(&lcd_stat.bg_pal_a, sizeof(lcd_stat.bg_pal_a));
+	state.read(&lcd_stat.raw_bg_pal_a, sizeof(lcd_stat.raw_bg_pal_a));
+	state.read(&lcd_stat.bg_pal_b, sizeof(lcd_stat.bg_pal_b));
+	state.read(&lcd_stat.raw_bg_pal_b, sizeof(lcd_stat.raw_bg_pal_b));
+	state.read(&lcd_stat.bg_ext_pal_a, sizeof(lcd_stat.bg_ext_pal_a));
+	state.read(&lcd_stat.raw_bg_ext_pal_a, sizeof(lcd_stat.raw_bg_ext_pal_a));
+	state.read(&lcd_stat.bg_ext_pal_b, sizeof(lcd_stat.bg_ext_pal_b));
+	state.read(&lcd_stat.raw_bg_ext_pal_b, sizeof(lcd_stat.raw_bg_ext_pal_b));
+	state.read(&lcd_stat.obj_pal_a, sizeof(lcd_stat.obj_pal_a));
+	state.read(&lcd_stat.raw_obj_pal_a, sizeof(lcd_stat.raw_obj_pal_a));
+	state.read(&lcd_stat.obj_pal_b, sizeof(lcd_stat.obj_pal_b));
+	state.read(&lcd_stat.raw_obj_pal_b, sizeof(lcd_stat.raw_obj_pal_b));
+	state.read(&lcd_stat.obj_ext_pal_a, sizeof(lcd_stat.obj_ext_pal_a));
+	state.read(&lcd_stat.raw_obj_ext_pal_a, sizeof(lcd_stat.raw_obj_ext_pal_a));
+	state.read(&lcd_stat.obj_ext_pal_b, sizeof(lcd_stat.obj_ext_pal_b));
+	state.read(&lcd_stat.raw_obj_ext_pal_b, sizeof(lcd_stat.raw_obj_ext_pal_b));
+	state.read(&lcd_stat.bg_affine_a, sizeof(lcd_stat.bg_affine_a));
+	state.read(&lcd_stat.bg_affine_b, sizeof(lcd_stat.bg_affine_b));
+	state.read(&lcd_stat.obj_affine, sizeof(lcd_stat.obj_affine));
+	state.read(&lcd_stat.sfx_target_a, sizeof(lcd_stat.sfx_target_a));
+	state.read(&lcd_stat.sfx_target_b, sizeof(lcd_stat.sfx_target_b));
+	state.read(&lcd_stat.current_sfx_type_a, sizeof(lcd_stat.current_sfx_type_a));
+	state.read(&lcd_stat.current_sfx_type_b, sizeof(lcd_stat.current_sfx_type_b));
+	state.read(&lcd_stat.brightness_coef_a, sizeof(lcd_stat.brightness_coef_a));
+	state.read(&lcd_stat.brightness_coef_b, sizeof(lcd_stat.brightness_coef_b));
+	state.read(&lcd_stat.alpha_coef_a, sizeof(lcd_stat.alpha_coef_a));
+	state.read(&lcd_stat.alpha_coef_b, sizeof(lcd_stat.alpha_coef_b));
+	state.read(&lcd_stat.window_x_a, sizeof(lcd_stat.window_x_a));
+	state.read(&lcd_stat.window_x_b, sizeof(lcd_stat.window_x_b));
+	state.read(&lcd_stat.window_y_a, sizeof(lcd_stat.window_y_a));
+	state.read(&lcd_stat.window_y_b, sizeof(lcd_stat.window_y_b));
+	state.read(&lcd_stat.window_enable_a, sizeof(lcd_stat.window_enable_a));
+	state.read(&lcd_stat.window_enable_b, sizeof(lcd_stat.window_enable_b));
+	state.read(&lcd_stat.obj_win_enable_a, sizeof(lcd_stat.obj_win_enable_a));
+	state.read(&lcd_stat.obj_win_enable_b, sizeof(lcd_stat.obj_win_enable_b));
+	state.read(&lcd_stat.window_in_enable_a, sizeof(lcd_stat.window_in_enable_a));
+	state.read(&lcd_stat.window_in_enable_b, sizeof(lcd_stat.window_in_enable_b));
+	state.read(&lcd_stat.window_out_enable_a, sizeof(lcd_stat.window_out_enable_a));
+	state.read(&lcd_stat.window_out_enable_b, sizeof(lcd_stat.window_out_enable_b));
+	state.read(&lcd_stat.window_status_a, sizeof(lcd_stat.window_status_a));
+	state.read(&lcd_stat.window_status_b, sizeof(lcd_stat.window_status_b));
+	state.read(&lcd_stat.window_id_a, sizeof(lcd_stat.window_id_a));
+	state.read(&lcd_stat.window_id_b, sizeof(lcd_stat.window_id_b));
+	state.read(&lcd_stat.current_window_a, sizeof(lcd_stat.current_window_a));
+	state.read(&lcd_stat.current_window_b, sizeof(lcd_stat.current_window_b));
+	state.read(&lcd_stat.cap_cnt, sizeof(lcd_stat.cap_cnt));
+	state.read(&lcd_stat.capture_slot, sizeof(lcd_stat.capture_slot));
+	state.read(&lcd_stat.cap_started, sizeof(lcd_stat.cap_started));
+	state.read(&lcd_stat.cap_finished, sizeof(lcd_stat.cap_finished));
+	state.read(&lcd_stat.vblank_irq_enable_a, sizeof(lcd_stat.vblank_irq_enable_a));
+	state.read(&lcd_stat.hblank_irq_enable_a, sizeof(lcd_stat.hblank_irq_enable_a));
+	state.read(&lcd_stat.vcount_irq_enable_a, sizeof(lcd_stat.vcount_irq_enable_a));
+	state.read(&lcd_stat.vblank_irq_enable_b, sizeof(lcd_stat.vblank_irq_enable_b));
+	state.read(&lcd_stat.hblank_irq_enable_b, sizeof(lcd_stat.hblank_irq_enable_b));
+	state.read(&lcd_stat.vcount_irq_enable_b, sizeof(lcd_stat.vcount_irq_enable_b));
+	state.read(&lcd_stat.bg_pal_update_a, sizeof(lcd_stat.bg_pal_update_a));
+	state.read(&lcd_stat.bg_pal_update_b, sizeof(lcd_stat.bg_pal_update_b));
+	state.read(&lcd_stat.obj_pal_update_a, sizeof(lcd_stat.obj_pal_update_a));
+	state.read(&lcd_stat.obj_pal_update_b, sizeof(lcd_stat.obj_pal_update_b));
+	state.read(&lcd_stat.bg_ext_pal_update_a, sizeof(lcd_stat.bg_ext_pal_update_a));
+	state.read(&lcd_stat.bg_ext_pal_update_b, sizeof(lcd_stat.bg_ext_pal_update_b));
+	state.read(&lcd_stat.obj_ext_pal_update_a, sizeof(lcd_stat.obj_ext_pal_update_a));
+	state.read(&lcd_stat.obj_ext_pal_update_b, sizeof(lcd_stat.obj_ext_pal_update_b));
+	state.read(&lcd_stat.update_bg_control_a, sizeof(lcd_stat.update_bg_control_a));
+	state.read(&lcd_stat.update_bg_control_b, sizeof(lcd_stat.update_bg_control_b));
+	state.read(&lcd_stat.oam_update, sizeof(lcd_stat.oam_update));
+
+	//Serialize 3D engine data from save state
+	state.read(&lcd_3D_stat.display_control, sizeof(lcd_3D_stat.display_control));
+	state.read(&lcd_3D_stat.gx_stat, sizeof(lcd_3D_stat.gx_stat));
+	state.read(&lcd_3D_stat.current_gx_command, sizeof(lcd_3D_stat.current_gx_command));
+	state.read(&lcd_3D_stat.current_packed_command, sizeof(lcd_3D_stat.current_packed_command));
+	state.read(&lcd_3D_stat.fifo_params, sizeof(lcd_3D_stat.fifo_params));
+	state.read(&lcd_3D_stat.command_parameters, sizeof(lcd_3D_stat.command_parameters));
+	state.read(&lcd_3D_stat.parameter_index, sizeof(lcd_3D_stat.parameter_index));
+	state.read(&lcd_3D_stat.buffer_id, sizeof(lcd_3D_stat.buffer_id));
+	state.read(&lcd_3D_stat.gx_state, sizeof(lcd_3D_stat.gx_state));
+	state.read(&lcd_3D_stat.process_command, sizeof(lcd_3D_stat.process_command));
+	state.read(&lcd_3D_stat.packed_command, sizeof(lcd_3D_stat.packed_command));
+	state.read(&lcd_3D_stat.view_port_x1, sizeof(lcd_3D_stat.view_port_x1));
+	state.read(&lcd_3D_stat.view_port_x2, sizeof(lcd_3D_stat.view_port_x2));
+	state.read(&lcd_3D_stat.view_port_y1, sizeof(lcd_3D_stat.view_port_y1));
+	state.read(&lcd_3D_stat.view_port_y2, sizeof(lcd_3D_stat.view_port_y2));
+	state.read(&lcd_3D_stat.matrix_mode, sizeof(lcd_3D_stat.matrix_mode));
+	state.read(&lcd_3D_stat.vertex_mode, sizeof(lcd_3D_stat.vertex_mode));
+	state.read(&lcd_3D_stat.vertex_list_index, sizeof(lcd_3D_stat.vertex_list_index));
+	state.read(&lcd_3D_stat.hi_fill, sizeof(lcd_3D_stat.hi_fill));
+	state.read(&lcd_3D_stat.lo_fill, sizeof(lcd_3D_stat.lo_fill));
+	state.read(&lcd_3D_stat.hi_overflow, sizeof(lcd_3D_stat.hi_overflow));
+	state.read(&lcd_3D_stat.lo_overflow, sizeof(lcd_3D_stat.lo_overflow));
+	state.read(&lcd_3D_stat.hi_color, sizeof(lcd_3D_stat.hi_color));
+	state.read(&lcd_3D_stat.lo_color, sizeof(lcd_3D_stat.lo_color));
+	state.read(&lcd_3D_stat.hi_line_z, sizeof(lcd_3D_stat.hi_line_z));
+	state.read(&lcd_3D_stat.lo_line_z, sizeof(lcd_3D_stat.lo_line_z));
+	state.read(&lcd_3D_stat.render_polygon, sizeof(lcd_3D_stat.render_polygon));
+	state.read(&lcd_3D_stat.use_texture, sizeof(lcd_3D_stat.use_texture));
+	state.read(&lcd_3D_stat.begin_strips, sizeof(lcd_3D_stat.begin_strips));
+	state.read(&lcd_3D_stat.update_clip_matrix, sizeof(lcd_3D_stat.update_clip_matrix));
+	state.read(&lcd_3D_stat.update_vector_matrix, sizeof(lcd_3D_stat.update_vector_matrix));
+	state.read(&lcd_3D_stat.rear_plane_color, sizeof(lcd_3D_stat.rear_plane_color));
+	state.read(&lcd_3D_stat.rear_plane_alpha, sizeof(lcd_3D_stat.rear_plane_alpha));
+	state.read(&lcd_3D_stat.vertex_color, sizeof(lcd_3D_stat.vertex_color));
+	state.read(&lcd_3D_stat.clip_flags, sizeof(lcd_3D_stat.clip_flags));
+	state.read(&lcd_3D_stat.poly_count, sizeof(lcd_3D_stat.poly_count));
+	state.read(&lcd_3D_stat.vert_count, sizeof(lcd_3D_stat.vert_count));
+	state.read(&lcd_3D_stat.edge_color, sizeof(lcd_3D_stat.edge_color));
+	state.read(&lcd_3D_stat.toon_table, sizeof(lcd_3D_stat.toon_table));
+	state.read(&lcd_3D_stat.last_x, sizeof(lcd_3D_stat.last_x));
+	state.read(&lcd_3D_stat.last_y, sizeof(lcd_3D_stat.last_y));
+	state.read(&lcd_3D_stat.last_z, sizeof(lcd_3D_stat.last_z));
+	state.read(&lcd_3D_stat.poly_min_x, sizeof(lcd_3D_stat.poly_min_x));
+	state.read(&lcd_3D_stat.poly_max_x, sizeof(lcd_3D_stat.poly_max_x));
+	state.read(&lcd_3D_stat.edge_marking, sizeof(lcd_3D_stat.edge_marking));
+	state.read(&lcd_3D_stat.z_buffering, sizeof(lcd_3D_stat.z_buffering));
+	state.read(&lcd_3D_stat.tex_offset, sizeof(lcd_3D_stat.tex_offset));
+	state.read(&lcd_3D_stat.pal_base, sizeof(lcd_3D_stat.pal_base));
+	state.read(&lcd_3D_stat.pal_bank_addr, sizeof(lcd_3D_stat.pal_bank_addr));
+	state.read(&lcd_3D_stat.tex_src_width, sizeof(lcd_3D_stat.tex_src_width));
+	state.read(&lcd_3D_stat.tex_src_height, sizeof(lcd_3D_stat.tex_src_height));
+	state.read(&lcd_3D_stat.tex_format, sizeof(lcd_3D_stat.tex_format));
+	state.read(&lcd_3D_stat.tex_transformation, sizeof(lcd_3D_stat.tex_transformation));
+	state.read(&lcd_3D_stat.tex_color_zero, sizeof(lcd_3D_stat.tex_color_zero));
+	state.read(&lcd_3D_stat.repeat_tex_x, sizeof(lcd_3D_stat.repeat_tex_x));
+	state.read(&lcd_3D_stat.repeat_tex_y, sizeof(lcd_3D_stat.repeat_tex_y));
+	state.read(&lcd_3D_stat.flip_tex_x, sizeof(lcd_3D_stat.flip_tex_x));
+	state.read(&lcd_3D_stat.flip_tex_y, sizeof(lcd_3D_stat.flip_tex_y));
+	state.read(&lcd_3D_stat.poly_id, sizeof(lcd_3D_stat.poly_id));
+	state.read(&lcd_3D_stat.poly_alpha, sizeof(lcd_3D_stat.poly_alpha));
+	state.read(&lcd_3D_stat.poly_mode, sizeof(lcd_3D_stat.poly_mode));
+	state.read(&lcd_3D_stat.poly_new_depth, sizeof(lcd_3D_stat.poly_new_depth));
+	state.read(&lcd_3D_stat.poly_depth_test, sizeof(lcd_3D_stat.poly_depth_test));
+	state.read(&lcd_3D_stat.tex_coord_x, sizeof(lcd_3D_stat.tex_coord_x));
+	state.read(&lcd_3D_stat.tex_coord_y, sizeof(lcd_3D_stat.tex_coord_y));
+	state.read(&lcd_3D_stat.hi_tx, sizeof(lcd_3D_stat.hi_tx));
+	state.read(&lcd_3D_stat.lo_tx, sizeof(lcd_3D_stat.lo_tx));
+	state.read(&lcd_3D_stat.hi_ty, sizeof(lcd_3D_stat.hi_ty));
+	state.read(&lcd_3D_stat.lo_ty, sizeof(lcd_3D_stat.lo_ty));
+
+	//Serialize 3D matrices, stacks, and lighting from save state
+	state.read(&last_poly, sizeof(last_poly));
+	state.read(&current_poly, sizeof(current_poly));
+	state.read(&position_sp, sizeof(position_sp));
+	state.read(&vector_sp, sizeof(vector_sp));
+	state.read(&projection_sp, sizeof(projection_sp));
+	state.read(&vert_colors, sizeof(vert_colors));
+	state.read(&gx_projection_matrix, sizeof(gx_projection_matrix));
+	state.read(&gx_position_matrix, sizeof(gx_position_matrix));
+	state.read(&gx_vector_matrix, sizeof(gx_vector_matrix));
+	state.read(&gx_texture_matrix, sizeof(gx_texture_matrix));
+	state.read(&last_pos_matrix, sizeof(last_pos_matrix));
+	state.read(&light_vector, sizeof(light_vector));
+	state.read(&current_normal, sizeof(current_normal));
+	state.read(&light_colors, sizeof(light_colors));
+	state.read(&material_colors, sizeof(material_colors));
+	state.read(&shine_table, sizeof(shine_table));
+
+	for(u32 x = 0; x < gx_projection_stack.size(); x++) { state.read(&gx_projection_stack[x], sizeof(gx_projection_stack[x])); }
+	for(u32 x = 0; x < gx_position_stack.size(); x++) { state.read(&gx_position_stack[x], sizeof(gx_position_stack[x])); }
+	for(u32 x = 0; x < gx_vector_stack.size(); x++) { state.read(&gx_vector_stack[x], sizeof(gx_vector_stack[x])); }
+	for(u32 x = 0; x < gx_texture_stack.size(); x++) { state.read(&gx_texture_stack[x], sizeof(gx_texture_stack[x])); }
+
+	//Serialize 3D rendering buffers from save state
+	for(u32 x = 0; x < 2; x++)
+	{
+		state.read(&gx_screen_buffer[x][0], (gx_screen_buffer[x].size() * 4));
+		state.read(&gx_render_buffer[x][0], gx_render_buffer[x].size());
+	}
+
+	state.read(&gx_z_buffer[0], (gx_z_buffer.size() * 4));
+
+	if(!state.good()) { return false; }
+
+	//Regenerate palettes and OBJs from restored memory
+	lcd_stat.bg_pal_update_a = true;
+	lcd_stat.bg_pal_update_b = true;
+	lcd_stat.obj_pal_update_a = true;
+	lcd_stat.obj_pal_update_b = true;
+	lcd_stat.bg_ext_pal_update_a = true;
+	lcd_stat.bg_ext_pal_update_b = true;
+	lcd_stat.obj_ext_pal_update_a = true;
+	lcd_stat.obj_ext_pal_update_b = true;
+	lcd_stat.oam_update = true;
+
+	std::fill(lcd_stat.bg_pal_update_list_a.begin(), lcd_stat.bg_pal_update_list_a.end(), true);
+	std::fill(lcd_stat.bg_pal_update_list_b.begin(), lcd_stat.bg_pal_update_list_b.end(), true);
+	std::fill(lcd_stat.obj_pal_update_list_a.begin(), lcd_stat.obj_pal_update_list_a.end(), true);
+	std::fill(lcd_stat.obj_pal_update_list_b.begin(), lcd_stat.obj_pal_update_list_b.end(), true);
+	std::fill(lcd_stat.bg_ext_pal_update_list_a.begin(), lcd_stat.bg_ext_pal_update_list_a.end(), true);
+	std::fill(lcd_stat.bg_ext_pal_update_list_b.begin(), lcd_stat.bg_ext_pal_update_list_b.end(), true);
+	std::fill(lcd_stat.obj_ext_pal_update_list_a.begin(), lcd_stat.obj_ext_pal_update_list_a.end(), true);
+	std::fill(lcd_stat.obj_ext_pal_update_list_b.begin(), lcd_stat.obj_ext_pal_update_list_b.end(), true);
+	std::fill(lcd_stat.oam_update_list.begin(), lcd_stat.oam_update_list.end(), true);
+
+	return true;
+}
+
+/****** Write LCD data to save state ******/
+bool NTR_LCD::serialize(std::vector<u8> &buffer)
+{
+	util::state_writer state(buffer);
+
+	//Serialize 2D engine data to save state
+	state.write(&lcd_stat.current_scanline, sizeof(lcd_stat.current_scanline));
+	state.write(&lcd_stat.lcd_clock, sizeof(lcd_stat.lcd_clock));
+	state.write(&lcd_stat.lcd_mode, sizeof(lcd_stat.lcd_mode));
+	state.write(&lcd_stat.lyc_nds9, sizeof(lcd_stat.lyc_nds9));
+	state.write(&lcd_stat.lyc_nds7, sizeof(lcd_stat.lyc_nds7));
+	state.write(&lcd_stat.display_control_a, sizeof(lcd_stat.display_control_a));
+	state.write(&lcd_stat.display_control_b, sizeof(lcd_stat.display_control_b));
+	state.write(&lcd_stat.display_stat_nds9, sizeof(lcd_stat.display_stat_nds9));
+	state.write(&lcd_stat.display_stat_nds7, sizeof(lcd_stat.display_stat_nds7));
+	state.write(&lcd_stat.bg_mode_a, sizeof(lcd_stat.bg_mode_a));
+	state.write(&lcd_stat.bg_mode_b, sizeof(lcd_stat.bg_mode_b));
+	state.write(&lcd_stat.display_mode_a, sizeof(lcd_stat.display_mode_a));
+	state.write(&lcd_stat.display_mode_b, sizeof(lcd_stat.display_mode_b));
+	state.write(&lcd_stat.ext_pal_a, sizeof(lcd_stat.ext_pal_a));
+	state.write(&lcd_stat.ext_pal_b, sizeof(lcd_stat.ext_pal_b));
+	state.write(&lcd_stat.obj_boundary_a, sizeof(lcd_stat.obj_boundary_a));
+	state.write(&lcd_stat.obj_boundary_b, sizeof(lcd_stat.obj_boundary_b));
+	state.write(&lcd_stat.bg_control_a, sizeof(lcd_stat.bg_control_a));
+	state.write(&lcd_stat.bg_control_b, sizeof(lcd_stat.bg_control_b));
+	state.write(&lcd_stat.hblank_interval_free, sizeof(lcd_stat.hblank_interval_free));
+	state.write(&lcd_stat.master_bright_a, sizeof(lcd_stat.master_bright_a));
+	state.write(&lcd_stat.master_bright_b, sizeof(lcd_stat.master_bright_b));
+	state.write(&lcd_stat.forced_blank_a, sizeof(lcd_stat.forced_blank_a));
+	state.write(&lcd_stat.forced_blank_b, sizeof(lcd_stat.forced_blank_b));
+	state.write(&lcd_stat.vram_bank_addr, sizeof(lcd_stat.vram_bank_addr));
+	state.write(&lcd_stat.vram_bank_enable, sizeof(lcd_stat.vram_bank_enable));
+	state.write(&lcd_stat.bg_offset_x_a, sizeof(lcd_stat.bg_offset_x_a));
+	state.write(&lcd_stat.bg_offset_x_b, sizeof(lcd_stat.bg_offset_x_b));
+	state.write(&lcd_stat.bg_offset_y_a, sizeof(lcd_stat.bg_offset_y_a));
+	state.write(&lcd_stat.bg_offset_y_b, sizeof(lcd_stat.bg_offset_y_b));
+	state.write(&lcd_stat.bg_depth_a, sizeof(lcd_stat.bg_depth_a));
+	state.write(&lcd_stat.bg_depth_b, sizeof(lcd_stat.bg_depth_b));
+	state.write(&lcd_stat.bg_size_a, sizeof(lcd_stat.bg_size_a));
+	state.write(&lcd_stat.bg_size_b, sizeof(lcd_stat.bg_size_b));
+	state.write(&lcd_stat.text_width_a, sizeof(lcd_stat.text_width_a));
+	state.write(&lcd_stat.text_width_b, sizeof(lcd_stat.text_width_b));
+	state.write(&lcd_stat.text_height_a, sizeof(lcd_stat.text_height_a));
+	state.write(&lcd_stat.text_height_b, sizeof(lcd_stat.text_height_b));
+	state.write(&lcd_stat.bg_base_map_addr_a, sizeof(lcd_stat.bg_base_map_addr_a));
+	state.write(&lcd_stat.bg_base_map_addr_b, sizeof(lcd_stat.bg_base_map_addr_b));
+	state.write(&lcd_stat.bg_base_tile_addr_a, sizeof(lcd_stat.bg_base_tile_addr_a));
+	state.write(&lcd_stat.bg_base_tile_addr_b, sizeof(lcd_stat.bg_base_tile_addr_b));
+	state.write(&lcd_stat.bg_bitmap_base_addr_a, sizeof(lcd_stat.bg_bitmap_base_addr_a));
+	state.write(&lcd_stat.bg_bitmap_base_addr_b, sizeof(lcd_stat.bg_bitmap_base_addr_b));
+	state.write(&lcd_stat.bg_priority_a, sizeof(lcd_stat.bg_priority_a));
+	state.write(&lcd_stat.bg_priority_b, sizeof(lcd_stat.bg_priority_b));
+	state.write(&lcd_stat.bg_enable_a, sizeof(lcd_stat.bg_enable_a));
+	state.write(&lcd_stat.bg_enable_b, sizeof(lcd_stat.bg_enable_b));
+	state.write(&lcd_stat.bg_pal_a, sizeof(lcd_stat.bg_pal_a));
+	state.write(&lcd_stat.raw_bg_pal_a, sizeof(lcd_stat.raw_bg_pal_a));
+	state.write(&lcd_stat.bg_pal_b, sizeof(lcd_stat.bg_pal_b));
+	state.write(&lcd_stat.raw_bg_pal_b, sizeof(lcd_stat.raw_bg_pal_b));
+	state.write(&lcd_stat.bg_ext_pal_a, sizeof(lcd_stat.bg_ext_pal_a));
+	state.write(&lcd_stat.raw_bg_ext_pal_a, sizeof(lcd_stat.raw_bg_ext_pal_a));
+	state.write(&lcd_stat.bg_ext_pal_b, sizeof(lcd_stat.bg_ext_pal_b));
+	state.write(&lcd_stat.raw_bg_ext_pal_b, sizeof(lcd_stat.raw_bg_ext_pal_b));
+	state.write(&lcd_stat.obj_pal_a, sizeof(lcd_stat.obj_pal_a));
+	state.write(&lcd_stat.raw_obj_pal_a, sizeof(lcd_stat.raw_obj_pal_a));
+	state.write(&lcd_stat.obj_pal_b, sizeof(lcd_stat.obj_pal_b));
+	state.write(&lcd_stat.raw_obj_pal_b, sizeof(lcd_stat.raw_obj_pal_b));
+	state.write(&lcd_stat.obj_ext_pal_a, sizeof(lcd_stat.obj_ext_pal_a));
+	state.write(&lcd_stat.raw_obj_ext_pal_a, sizeof(lcd_stat.raw_obj_ext_pal_a));
+	state.write(&lcd_stat.obj_ext_pal_b, sizeof(lcd_stat.obj_ext_pal_b));
+	state.write(&lcd_stat.raw_obj_ext_pal_b, sizeof(lcd_stat.raw_obj_ext_pal_b));
+	state.write(&lcd_stat.bg_affine_a, sizeof(lcd_stat.bg_affine_a));
+	state.write(&lcd_stat.bg_affine_b, sizeof(lcd_stat.bg_affine_b));
+	state.write(&lcd_stat.obj_affine, sizeof(lcd_stat.obj_affine));
+	state.write(&lcd_stat.sfx_target_a, sizeof(lcd_stat.sfx_target_a));
+	state.write(&lcd_stat.sfx_target_b, sizeof(lcd_stat.sfx_target_b));
+	state.write(&lcd_stat.current_sfx_type_a, sizeof(lcd_stat.current_sfx_type_a));
+	state.write(&lcd_stat.current_sfx_type_b, sizeof(lcd_stat.current_sfx_type_b));
+	state.write(&lcd_stat.brightness_coef_a, sizeof(lcd_stat.brightness_coef_a));
+	state.write(&lcd_stat.brightness_coef_b, sizeof(lcd_stat.brightness_coef_b));
+	state.write(&lcd_stat.alpha_coef_a, sizeof(lcd_stat.alpha_coef_a));
+	state.write(&lcd_stat.alpha_coef_b, sizeof(lcd_stat.alpha_coef_b));
+	state.write(&lcd_stat.window_x_a, sizeof(lcd_stat.window_x_a));
+	state.write(&lcd_stat.window_x_b, sizeof(lcd_stat.window_x_b));
+	state.write(&lcd_stat.window_y_a, sizeof(lcd_stat.window_y_a));
+	state.write(&lcd_stat.window_y_b, sizeof(lcd_stat.window_y_b));
+	state.write(&lcd_stat.window_enable_a, sizeof(lcd_stat.window_enable_a));
+	state.write(&lcd_stat.window_enable_b, sizeof(lcd_stat.window_enable_b));
+	state.write(&lcd_stat.obj_win_enable_a, sizeof(lcd_stat.obj_win_enable_a));
+	state.write(&lcd_stat.obj_win_enable_b, sizeof(lcd_stat.obj_win_enable_b));
+	state.write(&lcd_stat.window_in_enable_a, sizeof(lcd_stat.window_in_enable_a));
+	state.write(&lcd_stat.window_in_enable_b, sizeof(lcd_stat.window_in_enable_b));
+	state.write(&lcd_stat.window_out_enable_a, sizeof(lcd_stat.window_out_enable_a));
+	state.write(&lcd_stat.window_out_enable_b, sizeof(lcd_stat.window_out_enable_b));
+	state.write(&lcd_stat.window_status_a, sizeof(lcd_stat.window_status_a));
+	state.write(&lcd_stat.window_status_b, sizeof(lcd_stat.window_status_b));
+	state.write(&lcd_stat.window_id_a, sizeof(lcd_stat.window_id_a));
+	state.write(&lcd_stat.window_id_b, sizeof(lcd_stat.window_id_b));
+	state.write(&lcd_stat.current_window_a, sizeof(lcd_stat.current_window_a));
+	state.write(&lcd_stat.current_window_b, sizeof(lcd_stat.current_window_b));
+	state.write(&lcd_stat.cap_cnt, sizeof(lcd_stat.cap_cnt));
+	state.write(&lcd_stat.capture_slot, sizeof(lcd_stat.capture_slot));
+	state.write(&lcd_stat.cap_started, sizeof(lcd_stat.cap_started));
+	state.write(&lcd_stat.cap_finished, sizeof(lcd_stat.cap_finished));
+	state.write(&lcd_stat.vblank_irq_enable_a, sizeof(lcd_stat.vblank_irq_enable_a));
+	state.write(&lcd_stat.hblank_irq_enable_a, sizeof(lcd_stat.hblank_irq_enable_a));
+	state.write(&lcd_stat.vcount_irq_enable_a, sizeof(lcd_stat.vcount_irq_enable_a));
+	state.write(&lcd_stat.vblank_irq_enable_b, sizeof(lcd_stat.vblank_irq_enable_b));
+	state.write(&lcd_stat.hblank_irq_enable_b, sizeof(lcd_stat.hblank_irq_enable_b));
+	state.write(&lcd_stat.vcount_irq_enable_b, sizeof(lcd_stat.vcount_irq_enable_b));
+	state.write(&lcd_stat.bg_pal_update_a, sizeof(lcd_stat.bg_pal_update_a));
+	state.write(&lcd_stat.bg_pal_update_b, sizeof(lcd_stat.bg_pal_update_b));
+	state.write(&lcd_stat.obj_pal_update_a, sizeof(lcd_stat.obj_pal_update_a));
+	state.write(&lcd_stat.obj_pal_update_b, sizeof(lcd_stat.obj_pal_update_b));
+	state.write(&lcd_stat.bg_ext_pal_update_a, sizeof(lcd_stat.bg_ext_pal_update_a));
+	state.write(&lcd_stat.bg_ext_pal_update_b, sizeof(lcd_stat.bg_ext_pal_update_b));
+	state.write(&lcd_stat.obj_ext_pal_update_a, sizeof(lcd_stat.obj_ext_pal_update_a));
+	state.write(&lcd_stat.obj_ext_pal_update_b, sizeof(lcd_stat.obj_ext_pal_update_b));
+	state.write(&lcd_stat.update_bg_control_a, sizeof(lcd_stat.update_bg_control_a));
+	state.write(&lcd_stat.update_bg_control_b, sizeof(lcd_stat.update_bg_control_b));
+	state.write(&lcd_stat.oam_update, sizeof(lcd_stat.oam_update));
+
+	//Serialize 3D engine data to save state
+	state.write(&lcd_3D_stat.display_control, sizeof(lcd_3D_stat.display_control));
+	state.write(&lcd_3D_stat.gx_stat, sizeof(lcd_3D_stat.gx_stat));
+	state.write(&lcd_3D_stat.current_gx_command, sizeof(lcd_3D_stat.current_gx_command));
+	state.write(&lcd_3D_stat.current_packed_command, sizeof(lcd_3D_stat.current_packed_command));
+	state.write(&lcd_3D_stat.fifo_params, sizeof(lcd_3D_stat.fifo_params));
+	state.write(&lcd_3D_stat.command_parameters, sizeof(lcd_3D_stat.command_parameters));
+	state.write(&lcd_3D_stat.parameter_index, sizeof(lcd_3D_stat.parameter_index));
+	state.write(&lcd_3D_stat.buffer_id, sizeof(lcd_3D_stat.buffer_id));
+	state.write(&lcd_3D_stat.gx_state, sizeof(lcd_3D_stat.gx_state));
+	state.write(&lcd_3D_stat.process_command, sizeof(lcd_3D_stat.process_command));
+	state.write(&lcd_3D_stat.packed_command, sizeof(lcd_3D_stat.packed_command));
+	state.write(&lcd_3D_stat.view_port_x1, sizeof(lcd_3D_stat.view_port_x1));
+	state.write(&lcd_3D_stat.view_port_x2, sizeof(lcd_3D_stat.view_port_x2));
+	state.write(&lcd_3D_stat.view_port_y1, sizeof(lcd_3D_stat.view_port_y1));
+	state.write(&lcd_3D_stat.view_port_y2, sizeof(lcd_3D_stat.view_port_y2));
+	state.write(&lcd_3D_stat.matrix_mode, sizeof(lcd_3D_stat.matrix_mode));
+	state.write(&lcd_3D_stat.vertex_mode, sizeof(lcd_3D_stat.vertex_mode));
+	state.write(&lcd_3D_stat.vertex_list_index, sizeof(lcd_3D_stat.vertex_list_index));
+	state.write(&lcd_3D_stat.hi_fill, sizeof(lcd_3D_stat.hi_fill));
+	state.write(&lcd_3D_stat.lo_fill, sizeof(lcd_3D_stat.lo_fill));
+	state.write(&lcd_3D_stat.hi_overflow, sizeof(lcd_3D_stat.hi_overflow));
+	state.write(&lcd_3D_stat.lo_overflow, sizeof(lcd_3D_stat.lo_overflow));
+	state.write(&lcd_3D_stat.hi_color, sizeof(lcd_3D_stat.hi_color));
+	state.write(&lcd_3D_stat.lo_color, sizeof(lcd_3D_stat.lo_color));
+	state.write(&lcd_3D_stat.hi_line_z, sizeof(lcd_3D_stat.hi_line_z));
+	state.write(&lcd_3D_stat.lo_line_z, sizeof(lcd_3D_stat.lo_line_z));
+	state.write(&lcd_3D_stat.render_polygon, sizeof(lcd_3D_stat.render_polygon));
+	state.write(&lcd_3D_stat.use_texture, sizeof(lcd_3D_stat.use_texture));
+	state.write(&lcd_3D_stat.begin_strips, sizeof(lcd_3D_stat.begin_strips));
+	state.write(&lcd_3D_stat.update_clip_matrix, sizeof(lcd_3D_stat.update_clip_matrix));
+	state.write(&lcd_3D_stat.update_vector_matrix, sizeof(lcd_3D_stat.update_vector_matrix));
+	state.write(&lcd_3D_stat.rear_plane_color, sizeof(lcd_3D_stat.rear_plane_color));
+	state.write(&lcd_3D_stat.rear_plane_alpha, sizeof(lcd_3D_stat.rear_plane_alpha));
+	state.write(&lcd_3D_stat.vertex_color, sizeof(lcd_3D_stat.vertex_color));
+	state.write(&lcd_3D_stat.clip_flags, sizeof(lcd_3D_stat.clip_flags));
+	state.write(&lcd_3D_stat.poly_count, sizeof(lcd_3D_stat.poly_count));
+	state.write(&lcd_3D_stat.vert_count, sizeof(lcd_3D_stat.vert_count));
+	state.write(&lcd_3D_stat.edge_color, sizeof(lcd_3D_stat.edge_color));
+	state.write(&lcd_3D_stat.toon_table, sizeof(lcd_3D_stat.toon_table));
+	state.write(&lcd_3D_stat.last_x, sizeof(lcd_3D_stat.last_x));
+	state.write(&lcd_3D_stat.last_y, sizeof(lcd_3D_stat.last_y));
+	state.write(&lcd_3D_stat.last_z, sizeof(lcd_3D_stat.last_z));
+	state.write(&lcd_3D_stat.poly_min_x, sizeof(lcd_3D_stat.poly_min_x));
+	state.write(&lcd_3D_stat.poly_max_x, sizeof(lcd_3D_stat.poly_max_x));
+	state.write(&lcd_3D_stat.edge_marking, sizeof(lcd_3D_stat.edge_marking));
+	state.write(&lcd_3D_stat.z_buffering, sizeof(lcd_3D_stat.z_buffering));
+	state.write(&lcd_3D_stat.tex_offset, sizeof(lcd_3D_stat.tex_offset));
+	state.write(&lcd_3D_stat.pal_base, sizeof(lcd_3D_stat.pal_base));
+	state.write(&lcd_3D_stat.pal_bank_addr, sizeof(lcd_3D_stat.pal_bank_addr));
+	state.write(&lcd_3D_stat.tex_src_width, sizeof(lcd_3D_stat.tex_src_width));
+	state.write(&lcd_3D_stat.tex_src_height, sizeof(lcd_3D_stat.tex_src_height));
+	state.write(&lcd_3D_stat.tex_format, sizeof(lcd_3D_stat.tex_format));
+	state.write(&lcd_3D_stat.tex_transformation, sizeof(lcd_3D_stat.tex_transformation));
+	state.write(&lcd_3D_stat.tex_color_zero, sizeof(lcd_3D_stat.tex_color_zero));
+	state.write(&lcd_3D_stat.repeat_tex_x, sizeof(lcd_3D_stat.repeat_tex_x));
+	state.write(&lcd_3D_stat.repeat_tex_y, sizeof(lcd_3D_stat.repeat_tex_y));
+	state.write(&lcd_3D_stat.flip_tex_x, sizeof(lcd_3D_stat.flip_tex_x));
+	state.write(&lcd_3D_stat.flip_tex_y, sizeof(lcd_3D_stat.flip_tex_y));
+	state.write(&lcd_3D_stat.poly_id, sizeof(lcd_3D_stat.poly_id));
+	state.write(&lcd_3D_stat.poly_alpha, sizeof(lcd_3D_stat.poly_alpha));
+	state.write(&lcd_3D_stat.poly_mode, sizeof(lcd_3D_stat.poly_mode));
+	state.write(&lcd_3D_stat.poly_new_depth, sizeof(lcd_3D_stat.poly_new_depth));
+	state.write(&lcd_3D_stat.poly_depth_test, sizeof(lcd_3D_stat.poly_depth_test));
+	state.write(&lcd_3D_stat.tex_coord_x, sizeof(lcd_3D_stat.tex_coord_x));
+	state.write(&lcd_3D_stat.tex_coord_y, sizeof(lcd_3D_stat.tex_coord_y));
+	state.write(&lcd_3D_stat.hi_tx, sizeof(lcd_3D_stat.hi_tx));
+	state.write(&lcd_3D_stat.lo_tx, sizeof(lcd_3D_stat.lo_tx));
+	state.write(&lcd_3D_stat.hi_ty, sizeof(lcd_3D_stat.hi_ty));
+	state.write(&lcd_3D_stat.lo_ty, sizeof(lcd_3D_stat.lo_ty));
+
+	//Serialize 3D matrices, stacks, and lighting to save state
+	state.write(&last_poly, sizeof(last_poly));
+	state.write(&current_poly, sizeof(current_poly));
+	state.write(&position_sp, sizeof(position_sp));
+	state.write(&vector_sp, sizeof(vector_sp));
+	state.write(&projection_sp, sizeof(projection_sp));
+	state.write(&vert_colors, sizeof(vert_colors));
+	state.write(&gx_projection_matrix, sizeof(gx_projection_matrix));
+	state.write(&gx_position_matrix, sizeof(gx_position_matrix));
+	state.write(&gx_vector_matrix, sizeof(gx_vector_matrix));
+	state.write(&gx_texture_matrix, sizeof(gx_texture_matrix));
+	state.write(&last_pos_matrix, sizeof(last_pos_matrix));
+	state.write(&light_vector, sizeof(light_vector));
+	state.write(&current_normal, sizeof(current_normal));
+	state.write(&light_colors, sizeof(light_colors));
+	state.write(&material_colors, sizeof(material_colors));
+	state.write(&shine_table, sizeof(shine_table));
+
+	for(u32 x = 0; x < gx_projection_stack.size(); x++) { state.write(&gx_projection_stack[x], sizeof(gx_projection_stack[x])); }
+	for(u32 x = 0; x < gx_position_stack.size(); x++) { state.write(&gx_position_stack[x], sizeof(gx_position_stack[x])); }
+	for(u32 x = 0; x < gx_vector_stack.size(); x++) { state.write(&gx_vector_stack[x], sizeof(gx_vector_stack[x])); }
+	for(u32 x = 0; x < gx_texture_stack.size(); x++) { state.write(&gx_texture_stack[x], sizeof(gx_texture_stack[x])); }
+
+	//Serialize 3D rendering buffers to save state
+	for(u32 x = 0; x < 2; x++)
+	{
+		state.write(&gx_screen_buffer[x][0], (gx_screen_buffer[x].size() * 4));
+		state.write(&gx_render_buffer[x][0], gx_render_buffer[x].size());
+	}
+
+	state.write(&gx_z_buffer[0], (gx_z_buffer.size() * 4));
+
+	return true;
+}
+
+/****** Gets the size of LCD data for serialization ******/
+u32 NTR_LCD::size()
+{
+	u32 lcd_size = 0;
+
+	lcd_size += sizeof(lcd_stat.current_scanline);
+	lcd_size += sizeof(lcd_stat.lcd_clock);
+	lcd_size += sizeof(lcd_stat.lcd_mode);
+	lcd_size += sizeof(lcd_stat.lyc_nds9);
+	lcd_size += sizeof(lcd_stat.lyc_nds7);
+	lcd_size += sizeof(lcd_stat.display_control_a);
+	lcd_size += sizeof(lcd_stat.display_control_b);
+	lcd_size += sizeof(lcd_stat.display_stat_nds9);
+	lcd_size += sizeof(lcd_stat.display_stat_nds7);
+	lcd_size += sizeof(lcd_stat.bg_mode_a);
+	lcd_size += sizeof(lcd_stat.bg_mode_b);
+	lcd_size += sizeof(lcd_stat.display_mode_a);
+	lcd_size += sizeof(lcd_stat.display_mode_b);
+	lcd_size += sizeof(lcd_stat.ext_pal_a);
+	lcd_size += sizeof(lcd_stat.ext_pal_b);
+	lcd_size += sizeof(lcd_stat.obj_boundary_a);
+	lcd_size += sizeof(lcd_stat.obj_boundary_b);
+	lcd_size += sizeof(lcd_stat.bg_control_a);
+	lcd_size += sizeof(lcd_stat.bg_control_b);
+	lcd_size += sizeof(lcd_stat.hblank_interval_free);
+	lcd_size += sizeof(lcd_stat.master_bright_a);
+	lcd_size += sizeof(lcd_stat.master_bright_b);
+	lcd_size += sizeof(lcd_stat.forced_blank_a);
+	lcd_size += sizeof(lcd_stat.forced_blank_b);
+	lcd_size += sizeof(lcd_stat.vram_bank_addr);
+	lcd_size += sizeof(lcd_stat.vram_bank_enable);
+	lcd_size += sizeof(lcd_stat.bg_offset_x_a);
+	lcd_size += sizeof(lcd_stat.bg_offset_x_b);
+	lcd_size += sizeof(lcd_stat.bg_offset_y_a);
+	lcd_size += sizeof(lcd_stat.bg_offset_y_b);
+	lcd_size += sizeof(lcd_stat.bg_depth_a);
+	lcd_size += sizeof(lcd_stat.bg_depth_b);
+	lcd_size += sizeof(lcd_stat.bg_size_a);
+	lcd_size += sizeof(lcd_stat.bg_size_b);
+	lcd_size += sizeof(lcd_stat.text_width_a);
+	lcd_size += sizeof(lcd_stat.text_width_b);
+	lcd_size += sizeof(lcd_stat.text_height_a);
+	lcd_size += sizeof(lcd_stat.text_height_b);
+	lcd_size += sizeof(lcd_stat.bg_base_map_addr_a);
+	lcd_size += sizeof(lcd_stat.bg_base_map_addr_b);
+	lcd_size += sizeof(lcd_stat.bg_base_tile_addr_a);
+	lcd_size += sizeof(lcd_stat.bg_base_tile_addr_b);
+	lcd_size += sizeof(lcd_stat.bg_bitmap_base_addr_a);
+	lcd_size += sizeof(lcd_stat.bg_bitmap_base_addr_b);
+	lcd_size += sizeof(lcd_stat.bg_priority_a);
+	lcd_size += sizeof(lcd_stat.bg_priority_b);
+	lcd_size += sizeof(lcd_stat.bg_enable_a);
+	lcd_size += sizeof(lcd_stat.bg_enable_b);
+	lcd_size += sizeof(lcd_stat.bg_pal_a);
+	lcd_size += sizeof(lcd_stat.raw_bg_pal_a);
+	lcd_size += sizeof(lcd_stat.bg_pal_b);
+	lcd_size += sizeof(lcd_stat.raw_bg_pal_b);
+	lcd_size += sizeof(lcd_stat.bg_ext_pal_a);
+	lcd_size += sizeof(lcd_stat.raw_bg_ext_pal_a);
+	lcd_size += sizeof(lcd_stat.bg_ext_pal_b);
+	lcd_size += sizeof(lcd_stat.raw_bg_ext_pal_b);
+	lcd_size += sizeof(lcd_stat.obj_pal_a);
+	lcd_size += sizeof(lcd_stat.raw_obj_pal_a);
+	lcd_size += sizeof(lcd_stat.obj_pal_b);
+	lcd_size += sizeof(lcd_stat.raw_obj_pal_b);
+	lcd_size += sizeof(lcd_stat.obj_ext_pal_a);
+	lcd_size += sizeof(lcd_stat.raw_obj_ext_pal_a);
+	lcd_size += sizeof(lcd_stat.obj_ext_pal_b);
+	lcd_size += sizeof(lcd_stat.raw_obj_ext_pal_b);
+	lcd_size += sizeof(lcd_stat.bg_affine_a);
+	lcd_size += sizeof(lcd_stat.bg_affine_b);
+	lcd_size += sizeof(lcd_stat.obj_affine);
+	lcd_size += sizeof(lcd_stat.sfx_target_a);
+	lcd_size += sizeof(lcd_stat.sfx_target_b);
+	lcd_size += sizeof(lcd_stat.current_sfx_type_a);
+	lcd_size += sizeof(lcd_stat.current_sfx_type_b);
+	lcd_size += sizeof(lcd_stat.brightness_coef_a);
+	lcd_size += sizeof(lcd_stat.brightness_coef_b);
+	lcd_size += sizeof(lcd_stat.alpha_coef_a);
+	lcd_size += sizeof(lcd_stat.alpha_coef_b);
+	lcd_size += sizeof(lcd_stat.window_x_a);
+	lcd_size += sizeof(lcd_stat.window_x_b);
+	lcd_size += sizeof(lcd_stat.window_y_a);
+	lcd_size += sizeof(lcd_stat.window_y_b);
+	lcd_size += sizeof(lcd_stat.window_enable_a);
+	lcd_size += sizeof(lcd_stat.window_enable_b);
+	lcd_size += sizeof(lcd_stat.obj_win_enable_a);
+	lcd_size += sizeof(lcd_stat.obj_win_enable_b);
+	lcd_size += sizeof(lcd_stat.window_in_enable_a);
+	lcd_size += sizeof(lcd_stat.window_in_enable_b);
+	lcd_size += sizeof(lcd_stat.window_out_enable_a);
+	lcd_size += sizeof(lcd_stat.window_out_enable_b);
+	lcd_size += sizeof(lcd_stat.window_status_a);
+	lcd_size += sizeof(lcd_stat.window_status_b);
+	lcd_size += sizeof(lcd_stat.window_id_a);
+	lcd_size += sizeof(lcd_stat.window_id_b);
+	lcd_size += sizeof(lcd_stat.current_window_a);
+	lcd_size += sizeof(lcd_stat.current_window_b);
+	lcd_size += sizeof(lcd_stat.cap_cnt);
+	lcd_size += sizeof(lcd_stat.capture_slot);
+	lcd_size += sizeof(lcd_stat.cap_started);
+	lcd_size += sizeof(lcd_stat.cap_finished);
+	lcd_size += sizeof(lcd_stat.vblank_irq_enable_a);
+	lcd_size += sizeof(lcd_stat.hblank_irq_enable_a);
+	lcd_size += sizeof(lcd_stat.vcount_irq_enable_a);
+	lcd_size += sizeof(lcd_stat.vblank_irq_enable_b);
+	lcd_size += sizeof(lcd_stat.hblank_irq_enable_b);
+	lcd_size += sizeof(lcd_stat.vcount_irq_enable_b);
+	lcd_size += sizeof(lcd_stat.bg_pal_update_a);
+	lcd_size += sizeof(lcd_stat.bg_pal_update_b);
+	lcd_size += sizeof(lcd_stat.obj_pal_update_a);
+	lcd_size += sizeof(lcd_stat.obj_pal_update_b);
+	lcd_size += sizeof(lcd_stat.bg_ext_pal_update_a);
+	lcd_size += sizeof(lcd_stat.bg_ext_pal_update_b);
+	lcd_size += sizeof(lcd_stat.obj_ext_pal_update_a);
+	lcd_size += sizeof(lcd_stat.obj_ext_pal_update_b);
+	lcd_size += sizeof(lcd_stat.update_bg_control_a);
+	lcd_size += sizeof(lcd_stat.update_bg_control_b);
+	lcd_size += sizeof(lcd_stat.oam_update);
+
+	lcd_size += sizeof(lcd_3D_stat.display_control);
+	lcd_size += sizeof(lcd_3D_stat.gx_stat);
+	lcd_size += sizeof(lcd_3D_stat.current_gx_command);
+	lcd_size += sizeof(lcd_3D_stat.current_packed_command);
+	lcd_size += sizeof(lcd_3D_stat.fifo_params);
+	lcd_size += sizeof(lcd_3D_stat.command_parameters);
+	lcd_size += sizeof(lcd_3D_stat.parameter_index);
+	lcd_size += sizeof(lcd_3D_stat.buffer_id);
+	lcd_size += sizeof(lcd_3D_stat.gx_state);
+	lcd_size += sizeof(lcd_3D_stat.process_command);
+	lcd_size += sizeof(lcd_3D_stat.packed_command);
+	lcd_size += sizeof(lcd_3D_stat.view_port_x1);
+	lcd_size += sizeof(lcd_3D_stat.view_port_x2);
+	lcd_size += sizeof(lcd_3D_stat.view_port_y1);
+	lcd_size += sizeof(lcd_3D_stat.view_port_y2);
+	lcd_size += sizeof(lcd_3D_stat.matrix_mode);
+	lcd_size += sizeof(lcd_3D_stat.vertex_mode);
+	lcd_size += sizeof(lcd_3D_stat.vertex_list_index);
+	lcd_size += sizeof(lcd_3D_stat.hi_fill);
+	lcd_size += sizeof(lcd_3D_stat.lo_fill);
+	lcd_size += sizeof(lcd_3D_stat.hi_overflow);
+	lcd_size += sizeof(lcd_3D_stat.lo_overflow);
+	lcd_size += sizeof(lcd_3D_stat.hi_color);
+	lcd_size += sizeof(lcd_3D_stat.lo_color);
+	lcd_size += sizeof(lcd_3D_stat.hi_line_z);
+	lcd_size += sizeof(lcd_3D_stat.lo_line_z);
+	lcd_size += sizeof(lcd_3D_stat.render_polygon);
+	lcd_size += sizeof(lcd_3D_stat.use_texture);
+	lcd_size += sizeof(lcd_3D_stat.begin_strips);
+	lcd_size += sizeof(lcd_3D_stat.update_clip_matrix);
+	lcd_size += sizeof(lcd_3D_stat.update_vector_matrix);
+	lcd_size += sizeof(lcd_3D_stat.rear_plane_color);
+	lcd_size += sizeof(lcd_3D_stat.rear_plane_alpha);
+	lcd_size += sizeof(lcd_3D_stat.vertex_color);
+	lcd_size += sizeof(lcd_3D_stat.clip_flags);
+	lcd_size += sizeof(lcd_3D_stat.poly_count);
+	lcd_size += sizeof(lcd_3D_stat.vert_count);
+	lcd_size += sizeof(lcd_3D_stat.edge_color);
+	lcd_size += sizeof(lcd_3D_stat.toon_table);
+	lcd_size += sizeof(lcd_3D_stat.last_x);
+	lcd_size += sizeof(lcd_3D_stat.last_y);
+	lcd_size += sizeof(lcd_3D_stat.last_z);
+	lcd_size += sizeof(lcd_3D_stat.poly_min_x);
+	lcd_size += sizeof(lcd_3D_stat.poly_max_x);
+	lcd_size += sizeof(lcd_3D_stat.edge_marking);
+	lcd_size += sizeof(lcd_3D_stat.z_buffering);
+	lcd_size += sizeof(lcd_3D_stat.tex_offset);
+	lcd_size += sizeof(lcd_3D_stat.pal_base);
+	lcd_size += sizeof(lcd_3D_stat.pal_bank_addr);
+	lcd_size += sizeof(lcd_3D_stat.tex_src_width);
+	lcd_size += sizeof(lcd_3D_stat.tex_src_height);
+	lcd_size += sizeof(lcd_3D_stat.tex_format);
+	lcd_size += sizeof(lcd_3D_stat.tex_transformation);
+	lcd_size += sizeof(lcd_3D_stat.tex_color_zero);
+	lcd_size += sizeof(lcd_3D_stat.repeat_tex_x);
+	lcd_size += sizeof(lcd_3D_stat.repeat_tex_y);
+	lcd_size += sizeof(lcd_3D_stat.flip_tex_x);
+	lcd_size += sizeof(lcd_3D_stat.flip_tex_y);
+	lcd_size += sizeof(lcd_3D_stat.poly_id);
+	lcd_size += sizeof(lcd_3D_stat.poly_alpha);
+	lcd_size += sizeof(lcd_3D_stat.poly_mode);
+	lcd_size += sizeof(lcd_3D_stat.poly_new_depth);
+	lcd_size += sizeof(lcd_3D_stat.poly_depth_test);
+	lcd_size += sizeof(lcd_3D_stat.tex_coord_x);
+	lcd_size += sizeof(lcd_3D_stat.tex_coord_y);
+	lcd_size += sizeof(lcd_3D_stat.hi_tx);
+	lcd_size += sizeof(lcd_3D_stat.lo_tx);
+	lcd_size += sizeof(lcd_3D_stat.hi_ty);
+	lcd_size += sizeof(lcd_3D_stat.lo_ty);
+
+	lcd_size += sizeof(last_poly);
+	lcd_size += sizeof(current_poly);
+	lcd_size += sizeof(position_sp);
+	lcd_size += sizeof(vector_sp);
+	lcd_size += sizeof(projection_sp);
+	lcd_size += sizeof(vert_colors);
+	lcd_size += sizeof(gx_projection_matrix);
+	lcd_size += sizeof(gx_position_matrix);
+	lcd_size += sizeof(gx_vector_matrix);
+	lcd_size += sizeof(gx_texture_matrix);
+	lcd_size += sizeof(last_pos_matrix);
+	lcd_size += sizeof(light_vector);
+	lcd_size += sizeof(current_normal);
+	lcd_size += sizeof(light_colors);
+	lcd_size += sizeof(material_colors);
+	lcd_size += sizeof(shine_table);
+
+	lcd_size += (gx_projection_stack.size() * sizeof(gx_matrix));
+	lcd_size += (gx_position_stack.size() * sizeof(gx_matrix));
+	lcd_size += (gx_vector_stack.size() * sizeof(gx_matrix));
+	lcd_size += (gx_texture_stack.size() * sizeof(gx_matrix));
+
+	lcd_size += (gx_screen_buffer[0].size() * 8);
+	lcd_size += (gx_render_buffer[0].size() * 2);
+	lcd_size += (gx_z_buffer.size() * 4);
+
+	return lcd_size;
+}
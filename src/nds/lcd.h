@@ -12,6 +12,8 @@
 #include "SDL2/SDL.h"
 #include "SDL2/SDL_opengl.h"
 #include "mmu.h"
+#include "common/audio_buffer.h"
+#include "common/frame_pacer.h"
 #include "common/gx_util.h"
 
 #ifndef NDS_LCD
@@ -24,6 +26,9 @@ class NTR_LCD
 	//Link to memory map
 	NTR_MMU* mem;
 
+	//Link to APU output for audio sync
+	audio_buffer* audio_output;
+
 	//Core Functions
 	NTR_LCD();
 	~NTR_LCD();
@@ -41,6 +46,7 @@ class NTR_LCD
 	SDL_Window* window;
 	SDL_Surface* final_screen;
 	SDL_Surface* original_screen;
+	std::vector<u32> screen_buffer;
 
 	//OpenGL data
 	SDL_GLContext gl_context;
@@ -59,6 +65,25 @@ class NTR_LCD
 	//Needs to be called by ARM9 when performing GXFIFO DMA, so not private
 	void process_gx_command();
 
+	//Serialize data for save state loading/saving
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
+	u32 size();
+
+	//Frames completed since reset
+	u32 frame_count;
+
+	//Frame output controls - Blit to screen, throttle and count towards FPS
+	bool present_frame;
+	bool realtime_frame;
+
+	//Leaves the frame or its 3D geometry unrendered (turbo frameskip)
+	bool skip_frame;
+	bool skip_geometry;
+
+	//Component microbenchmarks drive the rendering kernels directly
+	friend class micro_bench;
+
 	private:
 
 	struct oam_entries
@@ -127,7 +152,6 @@ class NTR_LCD
 	//Screen pixel buffer
 	std::vector<u32> scanline_buffer_a;
 	std::vector<u32> scanline_buffer_b;
-	std::vector<u32> screen_buffer;
 	std::vector< std::vector<u32> > gx_screen_buffer;
 
 	//Render buffer
@@ -149,11 +173,9 @@ class NTR_LCD
 
 	u32 scanline_pixel_counter;
 
-	int frame_start_time;
-	int frame_current_time;
 	int fps_count;
 	int fps_time;
-	int frame_delay[60];
+	frame_pacer pacer;
 
 	bool try_window_rebuild;
 
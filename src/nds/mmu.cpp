@@ -10,14 +10,26 @@
 
 #include "mmu.h"
 #include "common/util.h"
+#include "common/save_flusher.h"
 
 #include <filesystem>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 
 /****** MMU Constructor ******/
-NTR_MMU::NTR_MMU() 
+NTR_MMU::NTR_MMU() : n_clock(), s_clock(), key_2_x(), key_2_y(), firmware_count(), in_firmware(), apu_io_id(),
+	pal_a_obj_slot(), pal_b_obj_slot(), vram_bank_log()
 {
+	//Save states store these structs as raw bytes, so clear their padding as well
+	memset(&nds7_spi, 0, sizeof(nds7_spi));
+	memset(&nds_aux_spi, 0, sizeof(nds_aux_spi));
+	memset(&nds_card, 0, sizeof(nds_card));
+	memset(&nds7_rtc, 0, sizeof(nds7_rtc));
+	memset(&nds9_math, 0, sizeof(nds9_math));
+	memset(&touchscreen, 0, sizeof(touchscreen));
+	memset(dma, 0, sizeof(dma));
+
 	reset();
 }
 
@@ -26,7 +38,7 @@ NTR_MMU::~NTR_MMU()
 {
 	save_backup(config::save_file);
 	memory_map.clear();
-	cart_data.clear();
+	cart_file.close();
 	nds7_bios.clear();
 	nds9_bios.clear();
 	std::cout<<"MMU::Shutdown\n"; 
@@ -81,10 +93,14 @@ void NTR_MMU::reset()
 			break;
 	}	
 
+	//Start from fresh zero pages, only the regions actually used get committed
 	memory_map.clear();
-	memory_map.resize(0x10000000, 0);
+	memory_map.shrink_to_fit();
+	memory_map.resize(0x10000000);
 
-	cart_data.clear();
+	cart_file.close();
+	cart_data = NULL;
+	cart_size = 0;
 
 	firmware.clear();
 	firmware.resize(0x40000, 0);
@@ -309,7 +325,7 @@ void NTR_MMU::reset()
 	bg_vram_bank_enable_a = false;
 	bg_vram_bank_enable_b = false;
 
-	for(u32 y = 0; y < 4; y++)
+	for(u32 y = 0; y < 5; y++)
 	{
 		for(u32 x = 0; x < 9; x++)
 		{
@@ -5193,28 +5209,27 @@ void NTR_MMU::write_u64_fast(u32 address, u64 value)
 /****** Read binary file to memory ******/
 bool NTR_MMU::read_file(std::string filename)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-
-	if(!file.is_open()) 
+	//Map the ROM instead of reading it, large carts then load instantly and share memory with the OS file cache
+	if(!cart_file.open(filename)) 
 	{
 		std::cout<<"MMU::" << filename << " could not be opened. Check file path or permissions. \n";
 		return false;
 	}
 
-	//Get the file size
-	file.seekg(0, file.end);
-	u32 file_size = file.tellg();
-	file.seekg(0, file.beg);
-
-	cart_data.resize(file_size);
+	if(cart_file.size < 0x200)
+	{
+		std::cout<<"MMU::" << filename << " is too small to be an NDS ROM. \n";
+		cart_file.close();
+		return false;
+	}
 
-	//Read data from the ROM file
-	file.read(reinterpret_cast<char*> (&cart_data[0]), file_size);
+	cart_data = cart_file.data;
+	cart_size = cart_file.size;
+	u32 file_size = cart_size;
 
 	//Copy 368 bytes from header to Main RAM on boot
 	for(u32 x = 0; x < 0x170; x++) { write_u8((0x27FFE00 + x), cart_data[x]); }
 
-	file.close();
 	std::cout<<"MMU::" << filename << " loaded successfully. \n";
 
 	parse_header();
@@ -5407,6 +5422,8 @@ bool NTR_MMU::read_bios_nds7(std::string filename)
 
 	if(!std::filesystem::exists(bios_file))
 	{
+		get_firmware_hashes();
+
 		for(u32 x = 0; x < config::bin_hashes.size(); x++)
 		{
 			if(config::bin_hashes[x] == 0x1280F0D5) { filename = config::bin_files[x]; break; }
@@ -5454,6 +5471,8 @@ bool NTR_MMU::read_bios_nds9(std::string filename)
 
 	if(!std::filesystem::exists(bios_file))
 	{
+		get_firmware_hashes();
+
 		for(u32 x = 0; x < config::bin_hashes.size(); x++)
 		{
 			if(config::bin_hashes[x] == 0x2AB23573) { filename = config::bin_files[x]; break; }
@@ -5557,6 +5576,9 @@ bool NTR_MMU::load_backup(std::string filename)
 		 filename = config::save_path + util::get_filename_from_path(filename);
 	}
 
+	//Finish any background save write that was interrupted
+	save_flusher::recover(filename);
+
 	//Import save if applicable
 	if(!config::save_import_path.empty()) { filename = config::save_import_path; }
 
@@ -5590,6 +5612,16 @@ bool NTR_MMU::load_backup(std::string filename)
 	return true;
 }
 
+/****** Copies save data exactly as save_backup() writes it ******/
+bool NTR_MMU::get_save_image(std::vector<u8> &image)
+{
+	//Same as on exit, nothing gets written until the game saves something
+	if(!do_save) { return false; }
+
+	image = save_data;
+	return true;
+}
+
 /****** Save backup save data ******/
 bool NTR_MMU::save_backup(std::string filename)
 {
@@ -5690,10 +5722,11 @@ void NTR_MMU::parse_header()
 	std::cout<<"MMU::Game Code - " << util::make_ascii_printable(header.game_code) << "\n";
 	std::cout<<"MMU::Maker Code - " << util::make_ascii_printable(header.maker_code) << "\n";
 
-	if(cart_data.size() < 0x100000) { std::cout<<"MMU::ROM Size: " << std::dec << (cart_data.size() / 1024) << "KB\n"; }
-	else { std::cout<<"MMU::ROM Size: " << std::dec << (cart_data.size() / 0x100000) << "MB\n"; }
+	if(cart_size < 0x100000) { std::cout<<"MMU::ROM Size: " << std::dec << (cart_size / 1024) << "KB\n"; }
+	else { std::cout<<"MMU::ROM Size: " << std::dec << (cart_size / 0x100000) << "MB\n"; }
 
-	std::cout<<"MMU::ROM CRC32: " << std::hex << util::get_crc32(&cart_data[0], cart_data.size()) << "\n";
+	//Hashing the whole cart would fault in every page of the mapped ROM, so only do it when asked
+	if(config::verbose) { std::cout<<"MMU::ROM CRC32: " << std::hex << util::get_crc32(&cart_data[0], cart_size) << "\n"; }
 
 	//ARM9 ROM Offset
 	header.arm9_rom_offset = 0;
@@ -6627,298 +6660,351 @@ void NTR_MMU::set_nds7_pc(u32* ex_pc) { nds7_pc = ex_pc; }
 void NTR_MMU::set_nds9_pc(u32* ex_pc) { nds9_pc = ex_pc; }
 
 /****** Read MMU data from save state ******/
-bool NTR_MMU::mmu_read(u32 offset, std::string filename)
+bool NTR_MMU::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize WRAM from save state
 	u8* ex_mem = &memory_map[0x2000000];
-	file.read((char*)ex_mem, 0x400000);
+	state.read(ex_mem, 0x400000);
 
 	//Serialize WRAM from save state
 	ex_mem = &memory_map[0x3000000];
-	file.read((char*)ex_mem, 0x8000);
+	state.read(ex_mem, 0x8000);
 
 	//Serialize WRAM from save state
 	ex_mem = &memory_map[0x3800000];
-	file.read((char*)ex_mem, 0x10000);
+	state.read(ex_mem, 0x10000);
 
 	//Serialize ARM9 IO registers from save state
 	ex_mem = &memory_map[0x4000000];
-	file.read((char*)ex_mem, 0x700);
+	state.read(ex_mem, 0x700);
 
 	ex_mem = &memory_map[0x4001000];
-	file.read((char*)ex_mem, 0x70);
+	state.read(ex_mem, 0x70);
 
 	ex_mem = &memory_map[0x4100000];
-	file.read((char*)ex_mem, 0x4);
+	state.read(ex_mem, 0x4);
 
 	ex_mem = &memory_map[0x4100010];
-	file.read((char*)ex_mem, 0x4);
+	state.read(ex_mem, 0x4);
 	
 	//Serialize palettes from save state
 	ex_mem = &memory_map[0x5000000];
-	file.read((char*)ex_mem, 0x800);
+	state.read(ex_mem, 0x800);
 
 	//Serialize VRAM from save state
 	ex_mem = &memory_map[0x6000000];
-	file.read((char*)ex_mem, 0x80000);
+	state.read(ex_mem, 0x80000);
 
 	ex_mem = &memory_map[0x6200000];
-	file.read((char*)ex_mem, 0x20000);
+	state.read(ex_mem, 0x20000);
 
 	ex_mem = &memory_map[0x6400000];
-	file.read((char*)ex_mem, 0x40000);
+	state.read(ex_mem, 0x40000);
 
 	ex_mem = &memory_map[0x6600000];
-	file.read((char*)ex_mem, 0x20000);
+	state.read(ex_mem, 0x20000);
 
 	ex_mem = &memory_map[0x6800000];
-	file.read((char*)ex_mem, 0xA4000);
+	state.read(ex_mem, 0xA4000);
 
 	//Serialize OAM from save state
 	ex_mem = &memory_map[0x7000000];
-	file.read((char*)ex_mem, 0x800);
+	state.read(ex_mem, 0x800);
 
 	//Serialize DTCM
 	ex_mem = &dtcm[0];
-	file.read((char*)ex_mem, 0x4000);
+	state.read(ex_mem, 0x4000);
+
+	//Serialize ITCM
+	ex_mem = &memory_map[0x0];
+	state.read(ex_mem, 0x8000);
+
+	//Serialize VRAM allocated to NDS7 as WRAM
+	ex_mem = &nds7_vwram[0];
+	state.read(ex_mem, 0x40000);
+
+	//Serialize display capture data
+	state.read(&capture_buffer[0], (capture_buffer.size() * 4));
 
 	//Serialize misc data from MMU from save state
-	file.read((char*)&current_save_type, sizeof(current_save_type));
-	file.read((char*)&gba_save_type, sizeof(gba_save_type));
-	file.read((char*)&current_slot2_device, sizeof(current_slot2_device));
+	state.read(&current_save_type, sizeof(current_save_type));
+	state.read(&gba_save_type, sizeof(gba_save_type));
+	state.read(&current_slot2_device, sizeof(current_slot2_device));
 
 	//Serialize IPC from save state
-	file.read((char*)&nds7_ipc.sync, sizeof(nds7_ipc.sync));
-	file.read((char*)&nds7_ipc.cnt, sizeof(nds7_ipc.cnt));
-	file.read((char*)&nds7_ipc.fifo, sizeof(nds7_ipc.fifo));
-	file.read((char*)&nds7_ipc.fifo_latest, sizeof(nds7_ipc.fifo_latest));
-	file.read((char*)&nds7_ipc.fifo_incoming, sizeof(nds7_ipc.fifo_incoming));
-
-	file.read((char*)&nds9_ipc.sync, sizeof(nds9_ipc.sync));
-	file.read((char*)&nds9_ipc.cnt, sizeof(nds9_ipc.cnt));
-	file.read((char*)&nds9_ipc.fifo, sizeof(nds9_ipc.fifo));
-	file.read((char*)&nds9_ipc.fifo_latest, sizeof(nds9_ipc.fifo_latest));
-	file.read((char*)&nds9_ipc.fifo_incoming, sizeof(nds9_ipc.fifo_incoming));
+	state.read(&nds7_ipc.sync, sizeof(nds7_ipc.sync));
+	state.read(&nds7_ipc.cnt, sizeof(nds7_ipc.cnt));
+	deserialize_fifo(state, nds7_ipc.fifo);
+	state.read(&nds7_ipc.fifo_latest, sizeof(nds7_ipc.fifo_latest));
+	state.read(&nds7_ipc.fifo_incoming, sizeof(nds7_ipc.fifo_incoming));
+
+	state.read(&nds9_ipc.sync, sizeof(nds9_ipc.sync));
+	state.read(&nds9_ipc.cnt, sizeof(nds9_ipc.cnt));
+	deserialize_fifo(state, nds9_ipc.fifo);
+	state.read(&nds9_ipc.fifo_latest, sizeof(nds9_ipc.fifo_latest));
+	state.read(&nds9_ipc.fifo_incoming, sizeof(nds9_ipc.fifo_incoming));
 
 	//Serialize SPI, AUX_SPI, Game Card, RTC, NDS9 Math, and Touchscreen from save state
-	file.read((char*)&nds7_spi, sizeof(nds7_spi));
-	file.read((char*)&nds_aux_spi, sizeof(nds_aux_spi));
-	file.read((char*)&nds_card, sizeof(nds_card));
-	file.read((char*)&nds7_rtc, sizeof(nds7_rtc));
-	file.read((char*)&nds9_math, sizeof(nds9_math));
-	file.read((char*)&touchscreen, sizeof(touchscreen));
+	state.read(&nds7_spi, sizeof(nds7_spi));
+	state.read(&nds_aux_spi, sizeof(nds_aux_spi));
+	state.read(&nds_card, sizeof(nds_card));
+	state.read(&nds7_rtc, sizeof(nds7_rtc));
+	state.read(&nds9_math, sizeof(nds9_math));
+	state.read(&touchscreen, sizeof(touchscreen));
 
 	//Serialize GX data from save state
-	file.read((char*)&nds9_gx_fifo, sizeof(nds9_gx_fifo));
-	file.read((char*)&gx_fifo_entry, sizeof(gx_fifo_entry));
-	file.read((char*)&gx_fifo_param_length, sizeof(gx_fifo_param_length));
+	deserialize_fifo(state, nds9_gx_fifo);
+	state.read(&gx_fifo_entry, sizeof(gx_fifo_entry));
+	state.read(&gx_fifo_param_length, sizeof(gx_fifo_param_length));
 
 	//Serialize more misc data from MMU from save state
-	file.read((char*)&n_clock, sizeof(n_clock));
-	file.read((char*)&s_clock, sizeof(s_clock));
-	file.read((char*)&nds9_bios_vector, sizeof(nds9_bios_vector));
-	file.read((char*)&nds9_irq_handler, sizeof(nds9_irq_handler));
-	file.read((char*)&nds7_bios_vector, sizeof(nds7_bios_vector));
-	file.read((char*)&nds7_irq_handler, sizeof(nds7_irq_handler));
-	file.read((char*)&access_mode, sizeof(access_mode));
-	file.read((char*)&wram_mode, sizeof(wram_mode));
-	file.read((char*)&rumble_state, sizeof(rumble_state));
-	file.read((char*)&do_save, sizeof(do_save));
-	file.read((char*)&fetch_request, sizeof(fetch_request));
-	file.read((char*)&gx_command, sizeof(gx_command));
-	file.read((char*)&header, sizeof(header));
+	state.read(&n_clock, sizeof(n_clock));
+	state.read(&s_clock, sizeof(s_clock));
+	state.read(&nds9_bios_vector, sizeof(nds9_bios_vector));
+	state.read(&nds9_irq_handler, sizeof(nds9_irq_handler));
+	state.read(&nds7_bios_vector, sizeof(nds7_bios_vector));
+	state.read(&nds7_irq_handler, sizeof(nds7_irq_handler));
+	state.read(&access_mode, sizeof(access_mode));
+	state.read(&wram_mode, sizeof(wram_mode));
+	state.read(&rumble_state, sizeof(rumble_state));
+	state.read(&do_save, sizeof(do_save));
+	state.read(&fetch_request, sizeof(fetch_request));
+	state.read(&gx_command, sizeof(gx_command));
 
 	//Serialize DMA data from save state
-	for(u32 x = 0; x < 8; x++) { file.read((char*)&dma[x], sizeof(dma[x])); }
+	for(u32 x = 0; x < 8; x++) { state.read(&dma[x], sizeof(dma[x])); }
 
 	//Serialize even more misc data from MMU from save state
-	file.read((char*)&nds9_ie, sizeof(nds9_ie));
-	file.read((char*)&nds9_if, sizeof(nds9_if));
-	file.read((char*)&nds9_temp_if, sizeof(nds9_temp_if));
-	file.read((char*)&nds9_ime, sizeof(nds9_ime));
-	file.read((char*)&power_cnt1, sizeof(power_cnt1));
-	file.read((char*)&nds9_exmem, sizeof(nds9_exmem));
-
-	file.read((char*)&nds7_ie, sizeof(nds7_ie));
-	file.read((char*)&nds7_if, sizeof(nds7_if));
-	file.read((char*)&nds7_temp_if, sizeof(nds7_temp_if));
-	file.read((char*)&nds7_ime, sizeof(nds7_ime));
-	file.read((char*)&power_cnt2, sizeof(power_cnt2));
-	file.read((char*)&nds7_exmem, sizeof(nds7_exmem));
-
-	file.read((char*)&firmware_status, sizeof(firmware_status));
-	file.read((char*)&firmware_state, sizeof(firmware_state));
-	file.read((char*)&firmware_count, sizeof(firmware_count));
-	file.read((char*)&firmware_index, sizeof(firmware_index));
-	file.read((char*)&in_firmware, sizeof(in_firmware));
-	file.read((char*)&touchscreen_state, sizeof(touchscreen_state));
-	file.read((char*)&apu_io_id, sizeof(apu_io_id));
-	file.read((char*)&dtcm_addr, sizeof(dtcm_addr));
-	file.read((char*)&itcm_addr, sizeof(itcm_addr));
-	file.read((char*)&pal_a_bg_slot, sizeof(pal_a_bg_slot));
-	file.read((char*)&pal_a_obj_slot, sizeof(pal_a_obj_slot));
-	file.read((char*)&pal_b_bg_slot, sizeof(pal_b_bg_slot));
-	file.read((char*)&pal_b_obj_slot, sizeof(pal_b_obj_slot));
-	file.read((char*)&vram_tex_slot, sizeof(vram_tex_slot));
-
-	file.close();
-	return true;
+	state.read(&nds9_ie, sizeof(nds9_ie));
+	state.read(&nds9_if, sizeof(nds9_if));
+	state.read(&nds9_temp_if, sizeof(nds9_temp_if));
+	state.read(&nds9_ime, sizeof(nds9_ime));
+	state.read(&power_cnt1, sizeof(power_cnt1));
+	state.read(&nds9_exmem, sizeof(nds9_exmem));
+
+	state.read(&nds7_ie, sizeof(nds7_ie));
+	state.read(&nds7_if, sizeof(nds7_if));
+	state.read(&nds7_temp_if, sizeof(nds7_temp_if));
+	state.read(&nds7_ime, sizeof(nds7_ime));
+	state.read(&power_cnt2, sizeof(power_cnt2));
+	state.read(&nds7_exmem, sizeof(nds7_exmem));
+
+	state.read(&firmware_status, sizeof(firmware_status));
+	state.read(&firmware_state, sizeof(firmware_state));
+	state.read(&firmware_count, sizeof(firmware_count));
+	state.read(&firmware_index, sizeof(firmware_index));
+	state.read(&in_firmware, sizeof(in_firmware));
+	state.read(&touchscreen_state, sizeof(touchscreen_state));
+	state.read(&apu_io_id, sizeof(apu_io_id));
+	state.read(&dtcm_addr, sizeof(dtcm_addr));
+	state.read(&itcm_addr, sizeof(itcm_addr));
+	state.read(&pal_a_bg_slot, sizeof(pal_a_bg_slot));
+	state.read(&pal_a_obj_slot, sizeof(pal_a_obj_slot));
+	state.read(&pal_b_bg_slot, sizeof(pal_b_bg_slot));
+	state.read(&pal_b_obj_slot, sizeof(pal_b_obj_slot));
+	state.read(&vram_tex_slot, sizeof(vram_tex_slot));
+	state.read(&vram_bank_log, sizeof(vram_bank_log));
+	state.read(&bg_vram_bank_enable_a, sizeof(bg_vram_bank_enable_a));
+	state.read(&bg_vram_bank_enable_b, sizeof(bg_vram_bank_enable_b));
+	state.read(&dtcm_end, sizeof(dtcm_end));
+	state.read(&dtcm_load_mode, sizeof(dtcm_load_mode));
+	state.read(&itcm_load_mode, sizeof(itcm_load_mode));
+	state.read(&gx_if, sizeof(gx_if));
+
+	//Serialize cartridge encryption from save state
+	state.read(&key_level, sizeof(key_level));
+	state.read(&key_id, sizeof(key_id));
+	state.read(&key_2_x, sizeof(key_2_x));
+	state.read(&key_2_y, sizeof(key_2_y));
+
+	//Serialize backup save data from save state
+	u32 save_size = 0;
+	state.read(&save_size, sizeof(save_size));
+
+	if(save_size > (state.state_length - state.state_offset)) { return false; }
+
+	save_data.resize(save_size);
+	if(save_size) { state.read(&save_data[0], save_size); }
+
+	return state.good();
 }
 
 /****** Write MMU data to save state ******/
-bool NTR_MMU::mmu_write(std::string filename)
+bool NTR_MMU::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize WRAM to save state
 	u8* ex_mem = &memory_map[0x2000000];
-	file.write((char*)ex_mem, 0x400000);
+	state.write(ex_mem, 0x400000);
 
 	//Serialize WRAM to save state
 	ex_mem = &memory_map[0x3000000];
-	file.write((char*)ex_mem, 0x8000);
+	state.write(ex_mem, 0x8000);
 
 	//Serialize WRAM to save state
 	ex_mem = &memory_map[0x3800000];
-	file.write((char*)ex_mem, 0x10000);
+	state.write(ex_mem, 0x10000);
 
 	//Serialize ARM9 IO registers to save state
 	ex_mem = &memory_map[0x4000000];
-	file.write((char*)ex_mem, 0x700);
+	state.write(ex_mem, 0x700);
 
 	ex_mem = &memory_map[0x4001000];
-	file.write((char*)ex_mem, 0x70);
+	state.write(ex_mem, 0x70);
 
 	ex_mem = &memory_map[0x4100000];
-	file.write((char*)ex_mem, 0x4);
+	state.write(ex_mem, 0x4);
 
 	ex_mem = &memory_map[0x4100010];
-	file.write((char*)ex_mem, 0x4);
+	state.write(ex_mem, 0x4);
 	
 	//Serialize palettes to save state
 	ex_mem = &memory_map[0x5000000];
-	file.write((char*)ex_mem, 0x800);
+	state.write(ex_mem, 0x800);
 
 	//Serialize VRAM to save state
 	ex_mem = &memory_map[0x6000000];
-	file.write((char*)ex_mem, 0x80000);
+	state.write(ex_mem, 0x80000);
 
 	ex_mem = &memory_map[0x6200000];
-	file.write((char*)ex_mem, 0x20000);
+	state.write(ex_mem, 0x20000);
 
 	ex_mem = &memory_map[0x6400000];
-	file.write((char*)ex_mem, 0x40000);
+	state.write(ex_mem, 0x40000);
 
 	ex_mem = &memory_map[0x6600000];
-	file.write((char*)ex_mem, 0x20000);
+	state.write(ex_mem, 0x20000);
 
 	ex_mem = &memory_map[0x6800000];
-	file.write((char*)ex_mem, 0xA4000);
+	state.write(ex_mem, 0xA4000);
 
 	//Serialize OAM to save state
 	ex_mem = &memory_map[0x7000000];
-	file.write((char*)ex_mem, 0x800);
+	state.write(ex_mem, 0x800);
 
 	//Serialize DTCM
 	ex_mem = &dtcm[0];
-	file.write((char*)ex_mem, 0x4000);
+	state.write(ex_mem, 0x4000);
+
+	//Serialize ITCM
+	ex_mem = &memory_map[0x0];
+	state.write(ex_mem, 0x8000);
+
+	//Serialize VRAM allocated to NDS7 as WRAM
+	ex_mem = &nds7_vwram[0];
+	state.write(ex_mem, 0x40000);
+
+	//Serialize display capture data
+	state.write(&capture_buffer[0], (capture_buffer.size() * 4));
 
 	//Serialize misc data to MMU to save state
-	file.write((char*)&current_save_type, sizeof(current_save_type));
-	file.write((char*)&gba_save_type, sizeof(gba_save_type));
-	file.write((char*)&current_slot2_device, sizeof(current_slot2_device));
+	state.write(&current_save_type, sizeof(current_save_type));
+	state.write(&gba_save_type, sizeof(gba_save_type));
+	state.write(&current_slot2_device, sizeof(current_slot2_device));
 
 	//Serialize IPC to save state
-	file.write((char*)&nds7_ipc.sync, sizeof(nds7_ipc.sync));
-	file.write((char*)&nds7_ipc.cnt, sizeof(nds7_ipc.cnt));
-	file.write((char*)&nds7_ipc.fifo, sizeof(nds7_ipc.fifo));
-	file.write((char*)&nds7_ipc.fifo_latest, sizeof(nds7_ipc.fifo_latest));
-	file.write((char*)&nds7_ipc.fifo_incoming, sizeof(nds7_ipc.fifo_incoming));
-
-	file.write((char*)&nds9_ipc.sync, sizeof(nds9_ipc.sync));
-	file.write((char*)&nds9_ipc.cnt, sizeof(nds9_ipc.cnt));
-	file.write((char*)&nds9_ipc.fifo, sizeof(nds9_ipc.fifo));
-	file.write((char*)&nds9_ipc.fifo_latest, sizeof(nds9_ipc.fifo_latest));
-	file.write((char*)&nds9_ipc.fifo_incoming, sizeof(nds9_ipc.fifo_incoming));
+	state.write(&nds7_ipc.sync, sizeof(nds7_ipc.sync));
+	state.write(&nds7_ipc.cnt, sizeof(nds7_ipc.cnt));
+	serialize_fifo(state, nds7_ipc.fifo);
+	state.write(&nds7_ipc.fifo_latest, sizeof(nds7_ipc.fifo_latest));
+	state.write(&nds7_ipc.fifo_incoming, sizeof(nds7_ipc.fifo_incoming));
+
+	state.write(&nds9_ipc.sync, sizeof(nds9_ipc.sync));
+	state.write(&nds9_ipc.cnt, sizeof(nds9_ipc.cnt));
+	serialize_fifo(state, nds9_ipc.fifo);
+	state.write(&nds9_ipc.fifo_latest, sizeof(nds9_ipc.fifo_latest));
+	state.write(&nds9_ipc.fifo_incoming, sizeof(nds9_ipc.fifo_incoming));
 
 	//Serialize SPI, AUX_SPI, Game Card, RTC, NDS9 Math, and Touchscreen to save state
-	file.write((char*)&nds7_spi, sizeof(nds7_spi));
-	file.write((char*)&nds_aux_spi, sizeof(nds_aux_spi));
-	file.write((char*)&nds_card, sizeof(nds_card));
-	file.write((char*)&nds7_rtc, sizeof(nds7_rtc));
-	file.write((char*)&nds9_math, sizeof(nds9_math));
-	file.write((char*)&touchscreen, sizeof(touchscreen));
+	state.write(&nds7_spi, sizeof(nds7_spi));
+	state.write(&nds_aux_spi, sizeof(nds_aux_spi));
+	state.write(&nds_card, sizeof(nds_card));
+	state.write(&nds7_rtc, sizeof(nds7_rtc));
+	state.write(&nds9_math, sizeof(nds9_math));
+	state.write(&touchscreen, sizeof(touchscreen));
 
 	//Serialize GX data to save state
-	file.write((char*)&nds9_gx_fifo, sizeof(nds9_gx_fifo));
-	file.write((char*)&gx_fifo_entry, sizeof(gx_fifo_entry));
-	file.write((char*)&gx_fifo_param_length, sizeof(gx_fifo_param_length));
+	serialize_fifo(state, nds9_gx_fifo);
+	state.write(&gx_fifo_entry, sizeof(gx_fifo_entry));
+	state.write(&gx_fifo_param_length, sizeof(gx_fifo_param_length));
 
 	//Serialize more misc data from MMU to save state
-	file.write((char*)&n_clock, sizeof(n_clock));
-	file.write((char*)&s_clock, sizeof(s_clock));
-	file.write((char*)&nds9_bios_vector, sizeof(nds9_bios_vector));
-	file.write((char*)&nds9_irq_handler, sizeof(nds9_irq_handler));
-	file.write((char*)&nds7_bios_vector, sizeof(nds7_bios_vector));
-	file.write((char*)&nds7_irq_handler, sizeof(nds7_irq_handler));
-	file.write((char*)&access_mode, sizeof(access_mode));
-	file.write((char*)&wram_mode, sizeof(wram_mode));
-	file.write((char*)&rumble_state, sizeof(rumble_state));
-	file.write((char*)&do_save, sizeof(do_save));
-	file.write((char*)&fetch_request, sizeof(fetch_request));
-	file.write((char*)&gx_command, sizeof(gx_command));
-	file.write((char*)&header, sizeof(header));
+	state.write(&n_clock, sizeof(n_clock));
+	state.write(&s_clock, sizeof(s_clock));
+	state.write(&nds9_bios_vector, sizeof(nds9_bios_vector));
+	state.write(&nds9_irq_handler, sizeof(nds9_irq_handler));
+	state.write(&nds7_bios_vector, sizeof(nds7_bios_vector));
+	state.write(&nds7_irq_handler, sizeof(nds7_irq_handler));
+	state.write(&access_mode, sizeof(access_mode));
+	state.write(&wram_mode, sizeof(wram_mode));
+	state.write(&rumble_state, sizeof(rumble_state));
+	state.write(&do_save, sizeof(do_save));
+	state.write(&fetch_request, sizeof(fetch_request));
+	state.write(&gx_command, sizeof(gx_command));
 
 	//Serialize DMA data to save state
-	for(u32 x = 0; x < 8; x++) { file.write((char*)&dma[x], sizeof(dma[x])); }
+	for(u32 x = 0; x < 8; x++) { state.write(&dma[x], sizeof(dma[x])); }
 
 	//Serialize even more misc data to MMU to save state
-	file.write((char*)&nds9_ie, sizeof(nds9_ie));
-	file.write((char*)&nds9_if, sizeof(nds9_if));
-	file.write((char*)&nds9_temp_if, sizeof(nds9_temp_if));
-	file.write((char*)&nds9_ime, sizeof(nds9_ime));
-	file.write((char*)&power_cnt1, sizeof(power_cnt1));
-	file.write((char*)&nds9_exmem, sizeof(nds9_exmem));
-
-	file.write((char*)&nds7_ie, sizeof(nds7_ie));
-	file.write((char*)&nds7_if, sizeof(nds7_if));
-	file.write((char*)&nds7_temp_if, sizeof(nds7_temp_if));
-	file.write((char*)&nds7_ime, sizeof(nds7_ime));
-	file.write((char*)&power_cnt2, sizeof(power_cnt2));
-	file.write((char*)&nds7_exmem, sizeof(nds7_exmem));
-
-	file.write((char*)&firmware_status, sizeof(firmware_status));
-	file.write((char*)&firmware_state, sizeof(firmware_state));
-	file.write((char*)&firmware_count, sizeof(firmware_count));
-	file.write((char*)&firmware_index, sizeof(firmware_index));
-	file.write((char*)&in_firmware, sizeof(in_firmware));
-	file.write((char*)&touchscreen_state, sizeof(touchscreen_state));
-	file.write((char*)&apu_io_id, sizeof(apu_io_id));
-	file.write((char*)&dtcm_addr, sizeof(dtcm_addr));
-	file.write((char*)&itcm_addr, sizeof(itcm_addr));
-	file.write((char*)&pal_a_bg_slot, sizeof(pal_a_bg_slot));
-	file.write((char*)&pal_a_obj_slot, sizeof(pal_a_obj_slot));
-	file.write((char*)&pal_b_bg_slot, sizeof(pal_b_bg_slot));
-	file.write((char*)&pal_b_obj_slot, sizeof(pal_b_obj_slot));
-	file.write((char*)&vram_tex_slot, sizeof(vram_tex_slot));
+	state.write(&nds9_ie, sizeof(nds9_ie));
+	state.write(&nds9_if, sizeof(nds9_if));
+	state.write(&nds9_temp_if, sizeof(nds9_temp_if));
+	state.write(&nds9_ime, sizeof(nds9_ime));
+	state.write(&power_cnt1, sizeof(power_cnt1));
+	state.write(&nds9_exmem, sizeof(nds9_exmem));
+
+	state.write(&nds7_ie, sizeof(nds7_ie));
+	state.write(&nds7_if, sizeof(nds7_if));
+	state.write(&nds7_temp_if, sizeof(nds7_temp_if));
+	state.write(&nds7_ime, sizeof(nds7_ime));
+	state.write(&power_cnt2, sizeof(power_cnt2));
+	state.write(&nds7_exmem, sizeof(nds7_exmem));
+
+	state.write(&firmware_status, sizeof(firmware_status));
+	state.write(&firmware_state, sizeof(firmware_state));
+	state.write(&firmware_count, sizeof(firmware_count));
+	state.write(&firmware_index, sizeof(firmware_index));
+	state.write(&in_firmware, sizeof(in_firmware));
+	state.write(&touchscreen_state, sizeof(touchscreen_state));
+	state.write(&apu_io_id, sizeof(apu_io_id));
+	state.write(&dtcm_addr, sizeof(dtcm_addr));
+	state.write(&itcm_addr, sizeof(itcm_addr));
+	state.write(&pal_a_bg_slot, sizeof(pal_a_bg_slot));
+	state.write(&pal_a_obj_slot, sizeof(pal_a_obj_slot));
+	state.write(&pal_b_bg_slot, sizeof(pal_b_bg_slot));
+	state.write(&pal_b_obj_slot, sizeof(pal_b_obj_slot));
+	state.write(&vram_tex_slot, sizeof(vram_tex_slot));
+	state.write(&vram_bank_log, sizeof(vram_bank_log));
+	state.write(&bg_vram_bank_enable_a, sizeof(bg_vram_bank_enable_a));
+	state.write(&bg_vram_bank_enable_b, sizeof(bg_vram_bank_enable_b));
+	state.write(&dtcm_end, sizeof(dtcm_end));
+	state.write(&dtcm_load_mode, sizeof(dtcm_load_mode));
+	state.write(&itcm_load_mode, sizeof(itcm_load_mode));
+	state.write(&gx_if, sizeof(gx_if));
+
+	//Serialize cartridge encryption to save state
+	state.write(&key_level, sizeof(key_level));
+	state.write(&key_id, sizeof(key_id));
+	state.write(&key_2_x, sizeof(key_2_x));
+	state.write(&key_2_y, sizeof(key_2_y));
+
+	//Serialize backup save data to save state
+	u32 save_size = save_data.size();
+	state.write(&save_size, sizeof(save_size));
+	if(save_size) { state.write(&save_data[0], save_size); }
 
-	file.close();
 	return true;
 }
 
 /****** Gets the size of MMU data for serialization ******/
 u32 NTR_MMU::size()
 {
-	u32 mmu_size = 0x5C1778;
+	u32 mmu_size = 0x609778;
+
+	mmu_size += (capture_buffer.size() * 4);
 
 	mmu_size += sizeof(current_save_type);
 	mmu_size += sizeof(gba_save_type);
@@ -6926,13 +7012,13 @@ u32 NTR_MMU::size()
 
 	mmu_size += sizeof(nds7_ipc.sync);
 	mmu_size += sizeof(nds7_ipc.cnt);
-	mmu_size += sizeof(nds7_ipc.fifo);
+	mmu_size += (4 + (nds7_ipc.fifo.size() * 4));
 	mmu_size += sizeof(nds7_ipc.fifo_latest);
 	mmu_size += sizeof(nds7_ipc.fifo_incoming);
 
 	mmu_size += sizeof(nds9_ipc.sync);
 	mmu_size += sizeof(nds9_ipc.cnt);
-	mmu_size += sizeof(nds9_ipc.fifo);
+	mmu_size += (4 + (nds9_ipc.fifo.size() * 4));
 	mmu_size += sizeof(nds9_ipc.fifo_latest);
 	mmu_size += sizeof(nds9_ipc.fifo_incoming);
 
@@ -6943,7 +7029,7 @@ u32 NTR_MMU::size()
 	mmu_size += sizeof(nds9_math);
 	mmu_size += sizeof(touchscreen);
 
-	mmu_size += sizeof(nds9_gx_fifo);
+	mmu_size += (4 + (nds9_gx_fifo.size() * 4));
 	mmu_size += sizeof(gx_fifo_entry);
 	mmu_size += sizeof(gx_fifo_param_length);
 
@@ -6959,7 +7045,6 @@ u32 NTR_MMU::size()
 	mmu_size += sizeof(do_save);
 	mmu_size += sizeof(fetch_request);
 	mmu_size += sizeof(gx_command);
-	mmu_size += sizeof(header);
 
 	for(u32 x = 0; x < 8; x++) { mmu_size += sizeof(dma[x]); }
 
@@ -6991,6 +7076,99 @@ u32 NTR_MMU::size()
 	mmu_size += sizeof(pal_b_bg_slot);
 	mmu_size += sizeof(pal_b_obj_slot);
 	mmu_size += sizeof(vram_tex_slot);
+	mmu_size += sizeof(vram_bank_log);
+	mmu_size += sizeof(bg_vram_bank_enable_a);
+	mmu_size += sizeof(bg_vram_bank_enable_b);
+	mmu_size += sizeof(dtcm_end);
+	mmu_size += sizeof(dtcm_load_mode);
+	mmu_size += sizeof(itcm_load_mode);
+	mmu_size += sizeof(gx_if);
+
+	mmu_size += sizeof(key_level);
+	mmu_size += sizeof(key_id);
+	mmu_size += sizeof(key_2_x);
+	mmu_size += sizeof(key_2_y);
+
+	mmu_size += (4 + save_data.size());
 
 	return mmu_size;
 }
+
+/****** Gets the size of MMU data stored in a save state, returns 0 if the data is invalid ******/
+u32 NTR_MMU::state_size(const u8* buffer, u32 length)
+{
+	//Fixed data ahead of each variable length block : IPC FIFO (NDS7), IPC FIFO (NDS9), GX FIFO, save data
+	u32 fixed_size[4];
+
+	fixed_size[0] = 0x609778 + (capture_buffer.size() * 4);
+	fixed_size[0] += sizeof(current_save_type) + sizeof(gba_save_type) + sizeof(current_slot2_device);
+	fixed_size[0] += sizeof(nds7_ipc.sync) + sizeof(nds7_ipc.cnt);
+
+	fixed_size[1] = sizeof(nds7_ipc.fifo_latest) + sizeof(nds7_ipc.fifo_incoming);
+	fixed_size[1] += sizeof(nds9_ipc.sync) + sizeof(nds9_ipc.cnt);
+
+	fixed_size[2] = sizeof(nds9_ipc.fifo_latest) + sizeof(nds9_ipc.fifo_incoming);
+	fixed_size[2] += sizeof(nds7_spi) + sizeof(nds_aux_spi) + sizeof(nds_card) + sizeof(nds7_rtc) + sizeof(nds9_math) + sizeof(touchscreen);
+
+	//Everything between the GX FIFO and save data is whatever remains of the current size
+	fixed_size[3] = size() - fixed_size[0] - fixed_size[1] - fixed_size[2] - 16;
+	fixed_size[3] -= ((nds7_ipc.fifo.size() + nds9_ipc.fifo.size() + nds9_gx_fifo.size()) * 4) + save_data.size();
+
+	u64 offset = 0;
+
+	for(u32 x = 0; x < 4; x++)
+	{
+		offset += fixed_size[x];
+		if((offset + 4) > length) { return 0; }
+
+		u32 block_size = 0;
+		memcpy(&block_size, (buffer + offset), sizeof(block_size));
+		offset += 4;
+
+		//FIFOs hold 32-bit entries, save data is stored as bytes
+		offset += (x < 3) ? (u64(block_size) * 4) : block_size;
+	}
+
+	if(offset > length) { return 0; }
+
+	return offset;
+}
+
+/****** Writes a FIFO's length and contents to save state ******/
+void NTR_MMU::serialize_fifo(util::state_writer &state, const std::queue<u32> &fifo)
+{
+	u32 fifo_size = fifo.size();
+	state.write(&fifo_size, sizeof(fifo_size));
+
+	if(fifo.empty()) { return; }
+
+	//std::queue can't be iterated, so walk a copy of it
+	std::queue<u32> entries = fifo;
+
+	while(!entries.empty())
+	{
+		u32 value = entries.front();
+		state.write(&value, sizeof(value));
+		entries.pop();
+	}
+}
+
+/****** Reads a FIFO's length and contents from save state ******/
+void NTR_MMU::deserialize_fifo(util::state_reader &state, std::queue<u32> &fifo)
+{
+	u32 fifo_size = 0;
+	state.read(&fifo_size, sizeof(fifo_size));
+
+	//Reject lengths that can't fit in the remaining data
+	if(fifo_size > ((state.state_length - state.state_offset) >> 2)) { state.state_error = true; }
+	if(!state.good()) { return; }
+
+	while(!fifo.empty()) { fifo.pop(); }
+
+	for(u32 x = 0; x < fifo_size; x++)
+	{
+		u32 value = 0;
+		state.read(&value, sizeof(value));
+		fifo.push(value);
+	}
+}
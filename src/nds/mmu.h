@@ -21,6 +21,7 @@
 #include "gamepad.h"
 #include "timer.h"
 #include "common/config.h"
+#include "common/util.h"
 #include "lcd_data.h"
 #include "apu_data.h"
 
@@ -75,8 +76,13 @@ class NTR_MMU
 	slot1_types current_slot1_device;
 	slot2_types current_slot2_device;
 
-	std::vector <u8> memory_map;
-	std::vector <u8> cart_data;
+	std::vector <u8, util::zero_page_allocator<u8> > memory_map;
+
+	//ROM is mapped read-only straight from the file, pages are only read in when accessed
+	util::mapped_file cart_file;
+	const u8* cart_data;
+	u32 cart_size;
+
 	std::vector <u8> nds7_bios;
 	std::vector <u8> nds9_bios;
 	std::vector <u8> firmware;
@@ -425,6 +431,7 @@ class NTR_MMU
 	bool read_firmware(std::string filename);
 	bool save_backup(std::string filename);
 	bool load_backup(std::string filename);
+	bool get_save_image(std::vector<u8> &image);
 
 	void process_spi_bus();
 	void process_aux_spi_bus();
@@ -471,9 +478,13 @@ class NTR_MMU
 	std::vector<nds_timer>* nds9_timer;
 
 	//Serialize data for save state loading/saving
-	bool mmu_read(u32 offset, std::string filename);
-	bool mmu_write(std::string filename);
+	bool deserialize(const u8* buffer, u32 length);
+	bool serialize(std::vector<u8> &buffer);
 	u32 size();
+	u32 state_size(const u8* buffer, u32 length);
+
+	void serialize_fifo(util::state_writer &state, const std::queue<u32> &fifo);
+	void deserialize_fifo(util::state_reader &state, std::queue<u32> &fifo);
 
 	private:
 
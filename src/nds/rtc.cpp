@@ -12,6 +12,7 @@
 
 #include "mmu.h"
 #include "common/util.h"
+#include "common/rtc_time.h"
 
 /****** Writes to NDS RTC ******/
 void NTR_MMU::write_rtc()
@@ -125,53 +126,34 @@ void NTR_MMU::write_rtc()
 									nds7_rtc.read_stat = 1;
 									u8 raw_hours = 0;
 
-									//Grab local time
-									time_t system_time = time(0);
-									tm* current_time = localtime(&system_time);
+									//Grab local time with RTC offsets
+									rtc_date current_time = get_rtc_date();
 
 									//Year
-									nds7_rtc.serial_data[0] = current_time->tm_year;
-									nds7_rtc.serial_data[0] += config::rtc_offset[5];
-									nds7_rtc.serial_data[0] = (nds7_rtc.serial_data[0] % 100);
-									nds7_rtc.serial_data[0] = util::get_bcd(nds7_rtc.serial_data[0]);
+									nds7_rtc.serial_data[0] = util::get_bcd(current_time.year % 100);
 
 									//Month
-									nds7_rtc.serial_data[1] = current_time->tm_mon;
-									nds7_rtc.serial_data[1] += config::rtc_offset[4];
-									nds7_rtc.serial_data[1] = (nds7_rtc.serial_data[1] % 12) + 1;
-									nds7_rtc.serial_data[1] = util::get_bcd(nds7_rtc.serial_data[1]);
+									nds7_rtc.serial_data[1] = util::get_bcd(current_time.month);
 
 									//Day of month
-									nds7_rtc.serial_data[2] = current_time->tm_mday;
-									nds7_rtc.serial_data[2] = util::get_bcd(nds7_rtc.serial_data[2]);
+									nds7_rtc.serial_data[2] = util::get_bcd(current_time.day);
 									
 									//Day of week
-									nds7_rtc.serial_data[3] = current_time->tm_wday;
-									nds7_rtc.serial_data[3] = util::get_bcd(nds7_rtc.serial_data[3]);
+									nds7_rtc.serial_data[3] = util::get_bcd(current_time.weekday);
 
 									//Hours
-									nds7_rtc.serial_data[4] = current_time->tm_hour;
-									nds7_rtc.serial_data[4] += config::rtc_offset[2];
-									nds7_rtc.serial_data[4] = (nds7_rtc.regs[0] & 0x2) ? (nds7_rtc.serial_data[4] % 24) : (nds7_rtc.serial_data[4] % 12);
+									nds7_rtc.serial_data[4] = (nds7_rtc.regs[0] & 0x2) ? (current_time.hour % 24) : (current_time.hour % 12);
 									raw_hours = nds7_rtc.serial_data[4];
 									nds7_rtc.serial_data[4] = util::get_bcd(nds7_rtc.serial_data[4]);
 
 									//AM-PM flag
-									if(current_time->tm_hour >= 12) { nds7_rtc.serial_data[4] |= 0x40; }
+									if(current_time.hour >= 12) { nds7_rtc.serial_data[4] |= 0x40; }
 									
 									//Minutes
-									nds7_rtc.serial_data[5] = current_time->tm_min;
-									nds7_rtc.serial_data[5] += config::rtc_offset[1];
-									nds7_rtc.serial_data[5] = (nds7_rtc.serial_data[5] % 60);
-									nds7_rtc.serial_data[5] = util::get_bcd(nds7_rtc.serial_data[5]);
-
-									//Seconds - Disregard tm_sec's 60 or 61 seconds
-									nds7_rtc.serial_data[6] = current_time->tm_sec;
-									if(nds7_rtc.serial_data[6] > 59) { nds7_rtc.serial_data[6] = 59; }
-
-									nds7_rtc.serial_data[6] += config::rtc_offset[0];
-									nds7_rtc.serial_data[6] = (nds7_rtc.serial_data[6] % 60);
-									nds7_rtc.serial_data[6] = util::get_bcd(nds7_rtc.serial_data[6]);
+									nds7_rtc.serial_data[5] = util::get_bcd(current_time.minute);
+
+									//Seconds
+									nds7_rtc.serial_data[6] = util::get_bcd(current_time.second);
 								}
 
 								//Receive 7 bytes for date+time
@@ -191,33 +173,22 @@ void NTR_MMU::write_rtc()
 									nds7_rtc.read_stat = 1;
 									u8 raw_hours = 0;
 
-									//Grab local time
-									time_t system_time = time(0);
-									tm* current_time = localtime(&system_time);
+									//Grab local time with RTC offsets
+									rtc_date current_time = get_rtc_date();
 
 									//Hours
-									nds7_rtc.serial_data[0] = current_time->tm_hour;
-									nds7_rtc.serial_data[0] += config::rtc_offset[2];
-									nds7_rtc.serial_data[0] = (nds7_rtc.regs[0] & 0x40) ? (nds7_rtc.serial_data[0] % 24) : (nds7_rtc.serial_data[0] % 12);
+									nds7_rtc.serial_data[0] = (nds7_rtc.regs[0] & 0x40) ? (current_time.hour % 24) : (current_time.hour % 12);
 									raw_hours = nds7_rtc.serial_data[0];
 									nds7_rtc.serial_data[0] = util::get_bcd(nds7_rtc.serial_data[0]);
 
 									//AM-PM flag
-									if(current_time->tm_hour >= 12) { nds7_rtc.serial_data[0] |= 0x40; }
-	
+									if(current_time.hour >= 12) { nds7_rtc.serial_data[0] |= 0x40; }
+
 									//Minutes
-									nds7_rtc.serial_data[1] = current_time->tm_min;
-									nds7_rtc.serial_data[1] += config::rtc_offset[1];
-									nds7_rtc.serial_data[1] = (nds7_rtc.serial_data[1] % 60);
-									nds7_rtc.serial_data[1] = util::get_bcd(nds7_rtc.serial_data[1]);
-
-									//Seconds - Disregard tm_sec's 60 or 61 seconds
-									nds7_rtc.serial_data[2] = current_time->tm_sec;
-									if(nds7_rtc.serial_data[2] > 59) { nds7_rtc.serial_data[2] = 59; }
-
-									nds7_rtc.serial_data[2] += config::rtc_offset[0];
-									nds7_rtc.serial_data[2] = (nds7_rtc.serial_data[2] % 60);
-									nds7_rtc.serial_data[2] = util::get_bcd(nds7_rtc.serial_data[2]);
+									nds7_rtc.serial_data[1] = util::get_bcd(current_time.minute);
+
+									//Seconds
+									nds7_rtc.serial_data[2] = util::get_bcd(current_time.second);
 								}
 
 								//Write 3 bytes for time
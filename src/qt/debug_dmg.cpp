@@ -1228,6 +1228,8 @@ void dmg_debug::close_debug()
 
 	qt_gui::draw_surface->findChild<QAction*>("pause_action")->setEnabled(true);
 
+	qt_gui::core_thread->hold_core();
+
 	if(main_menu::gbe_plus->db_unit.last_command != "c")
 	{
 		main_menu::gbe_plus->db_unit.debug_mode = false;
@@ -1248,6 +1250,8 @@ void dmg_debug::close_debug()
 	main_menu::dmg_debugger->dasm->setText(main_menu::dmg_debugger->dasm_text);
 	main_menu::gbe_plus->db_unit.breakpoints.clear();
 
+	qt_gui::core_thread->release_core();
+
 	//Clear format manually
 	QTextCursor cursor(dasm->textCursor());
 	cursor.setPosition(QTextCursor::Start, QTextCursor::MoveAnchor);
@@ -1624,7 +1628,11 @@ void dmg_debug::refresh()
 void dmg_debug::click_refresh()
 {
 	if(tabs->currentIndex() == 3) { debug_reset = true; }
+
+	//Read a consistent snapshot of the core
+	qt_gui::core_thread->hold_core();
 	refresh();
+	qt_gui::core_thread->release_core();
 
 	//Restore highlighting in the disassembly if necessary
 	if(tabs->currentIndex() == 3)
@@ -1890,33 +1898,56 @@ void dmg_debug::clear_format()
 }
 
 /****** Moves the debugger one instruction in disassembly ******/
-void dmg_debug::db_next() { main_menu::gbe_plus->db_unit.last_command = "n"; }
+void dmg_debug::db_next()
+{
+	qt_gui::core_thread->hold_core();
+	main_menu::gbe_plus->db_unit.last_command = "n";
+	qt_gui::core_thread->release_core();
+}
 
 /****** Continues emulation until debugger hits breakpoint ******/
-void dmg_debug::db_continue() { main_menu::gbe_plus->db_unit.last_command = "c"; }
+void dmg_debug::db_continue()
+{
+	qt_gui::core_thread->hold_core();
+	main_menu::gbe_plus->db_unit.last_command = "c";
+	qt_gui::core_thread->release_core();
+}
 
 /****** Sets breakpoint at current PC ******/
 void dmg_debug::db_set_bp() 
 {
+	qt_gui::core_thread->hold_core();
 	if(main_menu::gbe_plus->db_unit.last_command != "c") { main_menu::gbe_plus->db_unit.last_command = "bp"; }
+	qt_gui::core_thread->release_core();
 }
 
 /****** Clears all breakpoints ******/
 void dmg_debug::db_clear_bp()
 {
+	qt_gui::core_thread->hold_core();
 	if(main_menu::gbe_plus->db_unit.last_command != "c") { main_menu::gbe_plus->db_unit.last_command = "cbp"; }
+	qt_gui::core_thread->release_core();
 }
 
 /****** Resets emulation then stops ******/
-void dmg_debug::db_reset() { main_menu::gbe_plus->db_unit.last_command = "rs"; }
+void dmg_debug::db_reset()
+{
+	qt_gui::core_thread->hold_core();
+	main_menu::gbe_plus->db_unit.last_command = "rs";
+	qt_gui::core_thread->release_core();
+}
 
 /****** Resets emulation and runs in continue mode ******/
-void dmg_debug::db_reset_run() { main_menu::gbe_plus->db_unit.last_command = "rsr"; }
+void dmg_debug::db_reset_run()
+{
+	qt_gui::core_thread->hold_core();
+	main_menu::gbe_plus->db_unit.last_command = "rsr";
+	qt_gui::core_thread->release_core();
+}
 
 /****** Steps through the debugger via the GUI ******/
 void dmg_debug_step()
 {
-	bool halt = true;
 	bool bp_continue = true;
 
 	//Continue until breakpoint
@@ -1938,6 +1969,22 @@ void dmg_debug_step()
 		if(bp_continue) { return; }
 	}
 
+	//The core runs on the emulation thread, so wait for debugger input on the GUI thread instead
+	if(QThread::currentThread() != main_menu::dmg_debugger->thread())
+	{
+		qt_gui::core_thread->held = true;
+		QMetaObject::invokeMethod(main_menu::dmg_debugger, "wait_for_command", Qt::BlockingQueuedConnection);
+		qt_gui::core_thread->held = false;
+	}
+
+	else { main_menu::dmg_debugger->wait_for_command(); }
+}
+
+/****** Waits for the next debugging command from the GUI ******/
+void dmg_debug::wait_for_command()
+{
+	bool halt = true;
+
 	main_menu::dmg_debugger->auto_refresh();
 
 	//Wait for GUI action
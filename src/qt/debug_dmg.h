@@ -39,6 +39,9 @@ class dmg_debug : public QDialog
 	void auto_refresh();
 	void clear_format();
 
+	public slots:
+	void wait_for_command();
+
 	private:
 	//MMIO registers
 	QLineEdit* mmio_lcdc;
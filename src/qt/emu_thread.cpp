@@ -0,0 +1,272 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : emu_thread.cpp
+// Date : October 17, 2026
+// Description : Emulation thread
+//
+// Runs the core away from the GUI thread
+// Finished frames go out through a triple buffer, input and menu commands come in through a lock-free queue
+
+#include "emu_thread.h"
+#include "main_menu.h"
+
+#include "common/config.h"
+#include "common/frame_pacer.h"
+
+/****** Command queue constructor ******/
+command_queue::command_queue()
+{
+	head = 0;
+	tail = 0;
+}
+
+/****** Adds a command to the queue - GUI thread only ******/
+bool command_queue::push(emu_command cmd)
+{
+	u32 current_tail = tail.load(std::memory_order_relaxed);
+	u32 next_tail = (current_tail + 1) % QUEUE_SIZE;
+
+	//Queue is full
+	if(next_tail == head.load(std::memory_order_acquire)) { return false; }
+
+	commands[current_tail] = cmd;
+	tail.store(next_tail, std::memory_order_release);
+
+	return true;
+}
+
+/****** Takes the oldest command from the queue - Emulation thread only ******/
+bool command_queue::pop(emu_command &cmd)
+{
+	u32 current_head = head.load(std::memory_order_relaxed);
+
+	//Queue is empty
+	if(current_head == tail.load(std::memory_order_acquire)) { return false; }
+
+	cmd = commands[current_head];
+	head.store(((current_head + 1) % QUEUE_SIZE), std::memory_order_release);
+
+	return true;
+}
+
+/****** Frame buffer constructor ******/
+frame_buffer::frame_buffer()
+{
+	for(u32 x = 0; x < 3; x++)
+	{
+		frames[x].width = 0;
+		frames[x].height = 0;
+	}
+
+	back = 0;
+	middle = 1;
+	front = 2;
+}
+
+/****** Returns the back buffer, sized for the next frame - Emulation thread only ******/
+u32* frame_buffer::get_back(u32 width, u32 height)
+{
+	frame& current_frame = frames[back];
+
+	if((current_frame.width != width) || (current_frame.height != height))
+	{
+		current_frame.pixels.resize(width * height, 0);
+		current_frame.width = width;
+		current_frame.height = height;
+	}
+
+	return current_frame.pixels.data();
+}
+
+/****** Swaps the finished back buffer into the middle - Emulation thread only ******/
+void frame_buffer::publish()
+{
+	back = middle.exchange(back | 0x80, std::memory_order_acq_rel) & 0x7F;
+}
+
+/****** Swaps the newest frame into the front buffer, if there is one - GUI thread only ******/
+bool frame_buffer::acquire()
+{
+	if((middle.load(std::memory_order_acquire) & 0x80) == 0) { return false; }
+
+	front = middle.exchange(front, std::memory_order_acq_rel) & 0x7F;
+	return true;
+}
+
+/****** Returns the pixels of the front buffer - GUI thread only ******/
+u32* frame_buffer::front_pixels() { return frames[front].pixels.data(); }
+
+/****** Returns the width of the front buffer - GUI thread only ******/
+u32 frame_buffer::front_width() { return frames[front].width; }
+
+/****** Returns the height of the front buffer - GUI thread only ******/
+u32 frame_buffer::front_height() { return frames[front].height; }
+
+/****** Emulation thread constructor ******/
+emu_thread::emu_thread(QObject* parent) : QThread(parent)
+{
+	held = false;
+	stop_request = false;
+	hold_request = false;
+	frame_pending = false;
+}
+
+/****** Runs the core until it stops ******/
+void emu_thread::run()
+{
+	main_menu::gbe_plus->run_core();
+}
+
+/****** Queues a command for the core - GUI thread only ******/
+void emu_thread::send_command(emu_command_type type, int value, bool pressed)
+{
+	if(!isRunning()) { return; }
+
+	emu_command cmd;
+	cmd.type = type;
+	cmd.value = value;
+	cmd.pressed = pressed;
+
+	//Never drop input, a lost key release would leave a button stuck
+	while((!commands.push(cmd)) && (isRunning())) { QThread::yieldCurrentThread(); }
+}
+
+/****** Stops the core and waits for the emulation thread to finish - GUI thread only ******/
+//run_core() calls shutdown() on its way out, so the GUI must not shut the core down again
+void emu_thread::stop_core()
+{
+	if(!isRunning()) { return; }
+
+	{
+		std::lock_guard<std::mutex> lock(hold_lock);
+		stop_request = true;
+	}
+
+	hold_signal.notify_all();
+
+	//A core that stopped presenting frames never reaches a frame boundary, so stop it directly
+	if(!wait(1000))
+	{
+		main_menu::gbe_plus->running = false;
+		wait();
+	}
+
+	stop_request = false;
+	hold_request = false;
+	held = false;
+
+	//Drop anything meant for the old core
+	emu_command cmd;
+	while(commands.pop(cmd)) { }
+}
+
+/****** Parks the emulation thread so the GUI can work with the core directly - GUI thread only ******/
+void emu_thread::hold_core()
+{
+	if(!isRunning()) { return; }
+
+	std::unique_lock<std::mutex> lock(hold_lock);
+	hold_request = true;
+
+	//Time out now and then in case the emulation thread exits instead of parking
+	while((!held) && (isRunning())) { hold_signal.wait_for(lock, std::chrono::milliseconds(10)); }
+}
+
+/****** Lets the emulation thread continue - GUI thread only ******/
+void emu_thread::release_core()
+{
+	{
+		std::lock_guard<std::mutex> lock(hold_lock);
+		hold_request = false;
+	}
+
+	hold_signal.notify_all();
+}
+
+/****** Swaps in the newest frame for the screens - GUI thread only ******/
+bool emu_thread::acquire_frame()
+{
+	frame_pending = false;
+	return frames.acquire();
+}
+
+/****** Publishes the back buffer and tells the GUI about it - Emulation thread only ******/
+void emu_thread::present_frame()
+{
+	frames.publish();
+
+	//Only one notification waits in the GUI's event queue at a time, no matter how busy it is
+	if(!frame_pending.exchange(true)) { emit frame_ready(); }
+}
+
+/****** Handles commands, pausing, and stop requests once per frame - Emulation thread only ******/
+void emu_thread::frame_boundary()
+{
+	bool parked = false;
+
+	while(!stop_request)
+	{
+		//Stay parked while the GUI works with the core
+		if(hold_request)
+		{
+			parked = true;
+
+			std::unique_lock<std::mutex> lock(hold_lock);
+			held = true;
+			hold_signal.notify_all();
+			hold_signal.wait(lock, [this] { return ((!hold_request) || (stop_request)); });
+			continue;
+		}
+
+		held = false;
+		process_commands();
+
+		//Stay parked while paused, but keep handling commands
+		if(!config::pause_emu) { break; }
+
+		parked = true;
+		QThread::msleep(16);
+	}
+
+	held = false;
+
+	//Don't let the time spent parked count against the frame pacing
+	if(parked) { frame_pacer::notify_resume(); }
+
+	if(stop_request) { main_menu::gbe_plus->running = false; }
+}
+
+/****** Runs every queued command against the core - Emulation thread only ******/
+void emu_thread::process_commands()
+{
+	emu_command cmd;
+
+	while(commands.pop(cmd))
+	{
+		switch(cmd.type)
+		{
+			case EMU_KEY_INPUT:
+				main_menu::gbe_plus->feed_key_input(cmd.value, cmd.pressed);
+				break;
+
+			case EMU_SAVE_STATE:
+				main_menu::gbe_plus->save_state(cmd.value);
+				break;
+
+			case EMU_LOAD_STATE:
+				main_menu::gbe_plus->load_state(cmd.value);
+				emit state_loaded();
+				break;
+
+			case EMU_START_NETPLAY:
+				main_menu::gbe_plus->start_netplay();
+				break;
+
+			case EMU_STOP_NETPLAY:
+				main_menu::gbe_plus->stop_netplay();
+				break;
+		}
+	}
+}
@@ -0,0 +1,130 @@
+// GB Enhanced+ Copyright Daniel Baxter 2026
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : emu_thread.h
+// Date : October 17, 2026
+// Description : Emulation thread
+//
+// Runs the core away from the GUI thread
+// Finished frames go out through a triple buffer, input and menu commands come in through a lock-free queue
+
+#ifndef EMU_THREAD_GBE_QT
+#define EMU_THREAD_GBE_QT
+
+#include <QThread>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "common/common.h"
+
+//Commands the GUI thread hands to the emulation thread
+enum emu_command_type
+{
+	EMU_KEY_INPUT,
+	EMU_SAVE_STATE,
+	EMU_LOAD_STATE,
+	EMU_START_NETPLAY,
+	EMU_STOP_NETPLAY,
+};
+
+struct emu_command
+{
+	emu_command_type type;
+	int value;
+	bool pressed;
+};
+
+//Single producer, single consumer ring - Only the GUI thread pushes, only the emulation thread pops
+class command_queue
+{
+	public:
+	command_queue();
+
+	bool push(emu_command cmd);
+	bool pop(emu_command &cmd);
+
+	private:
+	static const u32 QUEUE_SIZE = 256;
+
+	emu_command commands[QUEUE_SIZE];
+	std::atomic<u32> head;
+	std::atomic<u32> tail;
+};
+
+//Triple buffer for finished frames
+//The core fills the back buffer, the screen draws the front buffer, the middle one always holds the newest frame
+class frame_buffer
+{
+	public:
+	frame_buffer();
+
+	u32* get_back(u32 width, u32 height);
+	void publish();
+	bool acquire();
+
+	u32* front_pixels();
+	u32 front_width();
+	u32 front_height();
+
+	private:
+	struct frame
+	{
+		std::vector<u32> pixels;
+		u32 width;
+		u32 height;
+	};
+
+	frame frames[3];
+	u8 back;
+	u8 front;
+
+	//Index of the middle buffer, bit 7 is set while it holds a frame the screen has not seen yet
+	std::atomic<u8> middle;
+};
+
+class emu_thread : public QThread
+{
+	Q_OBJECT
+
+	public:
+	emu_thread(QObject* parent = 0);
+
+	command_queue commands;
+	frame_buffer frames;
+
+	//Set while the emulation thread is parked and not touching the core
+	std::atomic<bool> held;
+
+	void send_command(emu_command_type type, int value, bool pressed);
+	void stop_core();
+	void hold_core();
+	void release_core();
+	bool acquire_frame();
+
+	void present_frame();
+	void frame_boundary();
+
+	signals:
+	void frame_ready();
+	void state_loaded();
+
+	protected:
+	void run();
+
+	private:
+	std::atomic<bool> stop_request;
+	std::atomic<bool> hold_request;
+	std::atomic<bool> frame_pending;
+
+	//Wakes the parked emulation thread and the GUI waiting for it to park
+	std::mutex hold_lock;
+	std::condition_variable hold_signal;
+
+	void process_commands();
+};
+
+#endif //EMU_THREAD_GBE_QT
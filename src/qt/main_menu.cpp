@@ -162,6 +162,12 @@ main_menu::main_menu(QWidget *parent) : QWidget(parent)
 	sw_screen = new soft_screen();
 	hw_screen = new hard_screen();
 
+	//Setup the emulation thread
+	//Frames and loaded states come back to the GUI thread as queued signals
+	qt_gui::core_thread = new emu_thread(this);
+	connect(qt_gui::core_thread, SIGNAL(frame_ready()), this, SLOT(refresh_screen()), Qt::QueuedConnection);
+	connect(qt_gui::core_thread, SIGNAL(state_loaded()), this, SLOT(refresh_volume()), Qt::QueuedConnection);
+
 	//Setup mouse tracking on the screens, for NDS touch support
 	sw_screen->setMouseTracking(true);
 	sw_screen->installEventFilter(this);
@@ -184,9 +190,6 @@ main_menu::main_menu(QWidget *parent) : QWidget(parent)
 	//Parse .ini options
 	parse_ini_file();
 
-	//Load OSD font
-	load_osd_font();
-
 	//Parse cheats file
 	if(config::use_cheats) { parse_cheats_file(false); }
 
@@ -368,8 +371,9 @@ void main_menu::open_file()
 	//Close the core
 	if(main_menu::gbe_plus != NULL) 
 	{
-		main_menu::gbe_plus->shutdown();
-		main_menu::gbe_plus->core_emu::~core_emu();
+		qt_gui::core_thread->stop_core();
+		delete main_menu::gbe_plus;
+		main_menu::gbe_plus = NULL;
 	}
 
 	if(use_next_files)
@@ -429,8 +433,9 @@ void main_menu::open_am3_fldr()
 	//Close the core
 	if(main_menu::gbe_plus != NULL) 
 	{
-		main_menu::gbe_plus->shutdown();
-		main_menu::gbe_plus->core_emu::~core_emu();
+		qt_gui::core_thread->stop_core();
+		delete main_menu::gbe_plus;
+		main_menu::gbe_plus = NULL;
 	}
 
 	config::sdl_render = false;
@@ -459,8 +464,9 @@ void main_menu::open_no_cart()
 	//Close the core
 	if(main_menu::gbe_plus != NULL) 
 	{
-		main_menu::gbe_plus->shutdown();
-		main_menu::gbe_plus->core_emu::~core_emu();
+		qt_gui::core_thread->stop_core();
+		delete main_menu::gbe_plus;
+		main_menu::gbe_plus = NULL;
 	}
 
 	config::sdl_render = false;
@@ -487,6 +493,8 @@ bool main_menu::check_firmware_hashes(u8 system_type)
 {
 	bool result = false;
 
+	get_firmware_hashes();
+
 	for(u32 x = 0; x < config::bin_hashes.size(); x++)
 	{
 		u32 hash = config::bin_hashes[x];
@@ -553,7 +561,11 @@ void main_menu::select_card_file()
 	//Tell DMG-GBC core to update data
 	if((config::gb_type >= 0) && (config::gb_type <= 2) && (main_menu::gbe_plus != NULL))
 	{
-		if(main_menu::gbe_plus->get_core_data(1) == 0)
+		qt_gui::core_thread->hold_core();
+		u32 card_loaded = main_menu::gbe_plus->get_core_data(1);
+		qt_gui::core_thread->release_core();
+
+		if(card_loaded == 0)
 		{
 			std::string mesg_text = "The card file: '" + config::external_card_file + "' could not be loaded"; 
 			warning_box->setText(QString::fromStdString(mesg_text));
@@ -598,6 +610,8 @@ void main_menu::select_data_file()
 	QString filename = QFileDialog::getOpenFileName(this, tr("Open"), "", tr("Binary File(*.bin)"));
 	if(filename.isNull()) { SDL_PauseAudio(0); return; }
 
+	qt_gui::core_thread->hold_core();
+
 	//Automatically save Soul Doll data when switching
 	if((main_menu::gbe_plus != NULL) && (config::gb_type == 3) && (config::sio_device == 9)) { gbe_plus->get_core_data(1); }
 
@@ -606,6 +620,8 @@ void main_menu::select_data_file()
 	//Automatically load Soul Doll data when switching
 	if((main_menu::gbe_plus != NULL) && (config::gb_type == 3) && (config::sio_device == 9)) { gbe_plus->get_core_data(2); }
 
+	qt_gui::core_thread->release_core();
+
 	SDL_PauseAudio(0);
 }
 
@@ -615,8 +631,9 @@ void main_menu::quit()
 	//Close the core
 	if(main_menu::gbe_plus != NULL) 
 	{
-		main_menu::gbe_plus->shutdown();
-		main_menu::gbe_plus->core_emu::~core_emu();
+		qt_gui::core_thread->stop_core();
+		delete main_menu::gbe_plus;
+		main_menu::gbe_plus = NULL;
 	}
 
 	//Save .ini options
@@ -982,10 +999,35 @@ void main_menu::boot_game()
 
 	if(main_menu::gbe_plus->db_unit.debug_mode) { SDL_CloseAudio(); }
 
-	//Actually run the core
-	main_menu::gbe_plus->run_core();
+	//Actually run the core, on its own thread
+	qt_gui::core_thread->start();
+}
+
+/****** Shows the newest frame from the emulation thread ******/
+void main_menu::refresh_screen()
+{
+	if(!qt_gui::core_thread->acquire_frame()) { return; }
+
+	frame_buffer& frames = qt_gui::core_thread->frames;
+
+	//Draw straight from the front buffer, the core never writes to it
+	QImage front_image((uchar*)frames.front_pixels(), frames.front_width(), frames.front_height(), QImage::Format_ARGB32);
+
+	if(qt_gui::screen != NULL) { *qt_gui::screen = front_image; }
+	else { qt_gui::screen = new QImage(front_image); }
+
+	if(config::use_opengl)
+	{
+		if(config::request_resize) { update(); }
+		hw_screen->updateGL();
+	}
+
+	else { update(); }
 }
 
+/****** Applies current volume settings after loading a save state ******/
+void main_menu::refresh_volume() { settings->update_volume(); }
+
 /****** Updates the main window ******/
 void main_menu::paintEvent(QPaintEvent* event)
 {
@@ -1028,8 +1070,9 @@ void main_menu::closeEvent(QCloseEvent* event)
 	//Close the core
 	if(main_menu::gbe_plus != NULL) 
 	{
-		main_menu::gbe_plus->shutdown();
-		main_menu::gbe_plus->core_emu::~core_emu();
+		qt_gui::core_thread->stop_core();
+		delete main_menu::gbe_plus;
+		main_menu::gbe_plus = NULL;
 	}
 
 	//Save .ini options
@@ -1083,7 +1126,7 @@ void main_menu::keyPressEvent(QKeyEvent* event)
 	//Force input processing in the core
 	if(main_menu::gbe_plus != NULL)
 	{
-		gbe_plus->feed_key_input(sdl_key, true);
+		qt_gui::core_thread->send_command(EMU_KEY_INPUT, sdl_key, true);
 
 		//Handle fullscreen hotkeys if necessary
 		if(findChild<QAction*>("fullscreen_action")->isChecked())
@@ -1150,7 +1193,7 @@ void main_menu::keyReleaseEvent(QKeyEvent* event)
 	//Force input processing in the core
 	if(main_menu::gbe_plus != NULL)
 	{
-		gbe_plus->feed_key_input(sdl_key, false);
+		qt_gui::core_thread->send_command(EMU_KEY_INPUT, sdl_key, false);
 	}
 }
 
@@ -1220,7 +1263,7 @@ bool main_menu::eventFilter(QObject* target, QEvent* event)
 
 				u32 pack = (pad << 16) | (y << 8) | (x);
 
-				main_menu::gbe_plus->feed_key_input(pack, true);
+				qt_gui::core_thread->send_command(EMU_KEY_INPUT, pack, true);
 			}
 		}
 	}
@@ -1285,7 +1328,7 @@ bool main_menu::eventFilter(QObject* target, QEvent* event)
 
 				u32 pack = (pad << 16) | (y << 8) | (x);
 
-				main_menu::gbe_plus->feed_key_input(pack, false);
+				qt_gui::core_thread->send_command(EMU_KEY_INPUT, pack, false);
 			}
 		}
 	}
@@ -1348,7 +1391,7 @@ bool main_menu::eventFilter(QObject* target, QEvent* event)
 				u8 pad = 4;
 				u32 pack = (pad << 16) | (y << 8) | (x);
 
-				main_menu::gbe_plus->feed_key_input(pack, true);
+				qt_gui::core_thread->send_command(EMU_KEY_INPUT, pack, true);
 			}
 		}
 	}
@@ -1365,6 +1408,7 @@ void main_menu::pause()
 		if(config::pause_emu) 
 		{
 			config::pause_emu = false; 
+			pause_emu();
 		}
 
 		//Pause
@@ -1377,14 +1421,13 @@ void main_menu::pause()
 }
 
 /****** Pauses the emulator ******/
+//The emulation thread parks itself at the next frame boundary while config::pause_emu is set
 void main_menu::pause_emu()
 {
-	SDL_PauseAudio(1);
-
-	while(config::pause_emu) 
+	if(config::pause_emu)
 	{
-		SDL_Delay(16);
-		QApplication::processEvents();
+		SDL_PauseAudio(1);
+		return;
 	}
 
 	SDL_PauseAudio(0);
@@ -1392,7 +1435,11 @@ void main_menu::pause_emu()
 	if(dmg_debugger->pause) { return; }
 
 	//Continue pause if GUI option is still selected - Check this when closing debugger
-	if(findChild<QAction*>("pause_action")->isChecked()) { pause(); }
+	if(findChild<QAction*>("pause_action")->isChecked())
+	{
+		config::pause_emu = true;
+		SDL_PauseAudio(1);
+	}
 }
 
 /****** Resets emulation ******/
@@ -1403,12 +1450,13 @@ void main_menu::reset()
 		//When emulating the GB Memory Cartridge, let the DMG-GBC or SGB cores handle resetting
 		if((config::cart_type == DMG_GBMEM) && (config::gb_type != 3) && (config::gb_type != 4) && (config::gb_type != 7))
 		{
-			gbe_plus->feed_key_input(SDLK_F8, true);
+			qt_gui::core_thread->send_command(EMU_KEY_INPUT, SDLK_F8, true);
 			return;
 		}
 
-		main_menu::gbe_plus->shutdown();
-		main_menu::gbe_plus->core_emu::~core_emu();
+		qt_gui::core_thread->stop_core();
+		delete main_menu::gbe_plus;
+		main_menu::gbe_plus = NULL;
 
 		QFile test_file;
 		std::string test_bios_path = "";
@@ -1594,6 +1642,7 @@ void main_menu::show_debugger()
 		if((config::gb_type <= 2) && (!is_sgb_core)) 
 		{
 			findChild<QAction*>("pause_action")->setEnabled(false);
+			qt_gui::core_thread->hold_core();
 
 			SDL_PauseAudio(1);
 			main_menu::dmg_debugger->old_pause = config::pause_emu;
@@ -1604,6 +1653,8 @@ void main_menu::show_debugger()
 			main_menu::dmg_debugger->auto_refresh();
 			main_menu::dmg_debugger->show();
 			main_menu::gbe_plus->db_unit.debug_mode = true;
+
+			qt_gui::core_thread->release_core();
 		}
 	}
 }
@@ -1692,8 +1743,9 @@ void main_menu::load_recent(int file_id)
 	//Close the core
 	if(main_menu::gbe_plus != NULL) 
 	{
-		main_menu::gbe_plus->shutdown();
-		main_menu::gbe_plus->core_emu::~core_emu();
+		qt_gui::core_thread->stop_core();
+		delete main_menu::gbe_plus;
+		main_menu::gbe_plus = NULL;
 	}
 
 	config::rom_file = config::recent_files[file_id];
@@ -1736,19 +1788,14 @@ void main_menu::load_recent(int file_id)
 /****** Saves a save state ******/
 void main_menu::save_state(int slot)
 {
-	if(main_menu::gbe_plus != NULL)  { main_menu::gbe_plus->save_state(slot); }
+	if(main_menu::gbe_plus != NULL)  { qt_gui::core_thread->send_command(EMU_SAVE_STATE, slot, true); }
 }
 
 /****** Loads a save state ******/
 void main_menu::load_state(int slot)
 {
-	if(main_menu::gbe_plus != NULL)
-	{
-		main_menu::gbe_plus->load_state(slot);
-
-		//Apply current volume settings
-		settings->update_volume();
-	}
+	//Current volume settings are applied once the emulation thread reports the state as loaded
+	if(main_menu::gbe_plus != NULL) { qt_gui::core_thread->send_command(EMU_LOAD_STATE, slot, true); }
 }
 
 /****** Starts the core's netplay features ******/
@@ -1756,7 +1803,7 @@ void main_menu::start_netplay()
 {
 	if(main_menu::gbe_plus != NULL)
 	{
-		main_menu::gbe_plus->start_netplay();
+		qt_gui::core_thread->send_command(EMU_START_NETPLAY, 0, true);
 	}
 }
 
@@ -1765,7 +1812,7 @@ void main_menu::stop_netplay()
 {
 	if(main_menu::gbe_plus != NULL)
 	{
-		main_menu::gbe_plus->stop_netplay();
+		qt_gui::core_thread->send_command(EMU_STOP_NETPLAY, 0, true);
 	}
 }
 
@@ -1775,7 +1822,7 @@ void main_menu::start_special_comm()
 	if(main_menu::gbe_plus != NULL)
 	{
 		//This just feeds a simulated F3 keypress to the core
-		gbe_plus->feed_key_input(SDLK_F3, true);
+		qt_gui::core_thread->send_command(EMU_KEY_INPUT, SDLK_F3, true);
 	}
 }
 
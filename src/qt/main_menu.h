@@ -91,6 +91,8 @@ class main_menu : public QWidget
 	void start_netplay();
 	void stop_netplay();
 	void start_special_comm();
+	void refresh_screen();
+	void refresh_volume();
 
 	private:
 	QWidget* about_box;
@@ -8,6 +8,8 @@
 //
 // Renders the screen for an emulated system using Qt
 
+#include <cstring>
+
 #include "render.h"
 
 #include "common/config.h"
@@ -16,48 +18,34 @@ namespace qt_gui
 {
 	QImage* screen = NULL;
 	main_menu* draw_surface = NULL;
-	SDL_Surface* final_screen = NULL;
+	emu_thread* core_thread = NULL;
 }
 
-/****** Renders an LCD's screen buffer to a QImage ******/
+/****** Hands an LCD's screen buffer to the GUI thread ******/
 void render_screen_sw(std::vector<u32>& image) 
 {
-	//Manually request screen size before PaintEvent takes effect
-	//Used for DMG/GBC games on GBA
-	if(config::request_resize)
-	{
-		if(qt_gui::screen != NULL) { delete qt_gui::screen; }
-		qt_gui::screen = new QImage(config::sys_width, config::sys_height, QImage::Format_ARGB32);
-	}
-
-	int width, height = 0;
-
 	//Determine the dimensions of the source image
 	//GBA = 240x160, GB-GBC = 160x144, NDS = 256x384, SGB = 256x224, MIN = 96x64
-	width = config::sys_width;
-	height = config::sys_height;
+	u32 width = config::sys_width;
+	u32 height = config::sys_height;
+	u32 size = (width * height) < image.size() ? (width * height) : image.size();
 
-	//Fill in image with pixels from the emulated LCD
-	for(int y = 0; y < height; y++)
-	{
-		u32* pixel_data = (u32*)qt_gui::screen->scanLine(y);
+	u32* pixel_data = qt_gui::core_thread->frames.get_back(width, height);
+	memcpy(pixel_data, image.data(), size * 4);
 
-		for(int x = 0; x < width; x++) { pixel_data[x] = image[x + (y*width)]; }
-	}
-
-	if(qt_gui::draw_surface != NULL) { qt_gui::draw_surface->update(); }
-
-	QApplication::processEvents();
+	qt_gui::core_thread->present_frame();
+	qt_gui::core_thread->frame_boundary();
 }
 
-/****** Renders an LCD's screen buffer to an SDL Surface ******/
+/****** Hands an LCD's SDL Surface to the GUI thread ******/
 void render_screen_hw(SDL_Surface* image) 
 {
-	if(config::request_resize) { qt_gui::draw_surface->update(); }
-
-	qt_gui::final_screen = image;
+	u32 width = config::sys_width;
+	u32 height = config::sys_height;
 
-	if(qt_gui::draw_surface != NULL) { qt_gui::draw_surface->hw_screen->updateGL(); }
+	u32* pixel_data = qt_gui::core_thread->frames.get_back(width, height);
+	memcpy(pixel_data, image->pixels, width * height * 4);
 
-	QApplication::processEvents();
+	qt_gui::core_thread->present_frame();
+	qt_gui::core_thread->frame_boundary();
 }
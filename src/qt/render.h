@@ -12,6 +12,7 @@
 #define QT_RENDER
 
 #include "main_menu.h"
+#include "emu_thread.h"
 
 #include <vector>
 
@@ -24,7 +25,7 @@ namespace qt_gui
 {
 	extern QImage* screen;
 	extern main_menu* draw_surface;
-	extern SDL_Surface* final_screen;
+	extern emu_thread* core_thread;
 }
 
 #endif // QT_RENDER 
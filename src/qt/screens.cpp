@@ -165,7 +165,12 @@ void hard_screen::paintGL()
 			default: break;
 		}
 
-		gwin.pixel_data = qt_gui::final_screen->pixels;
+		frame_buffer& frames = qt_gui::core_thread->frames;
+
+		//Skip frames drawn at the old size while the core switches resolutions
+		if((frames.front_width() != config::sys_width) || (frames.front_height() != config::sys_height)) { return; }
+
+		gwin.pixel_data = frames.front_pixels();
 		gwin.paint();
 	}
 }
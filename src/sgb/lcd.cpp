@@ -10,13 +10,19 @@
 // Responsible for blitting pixel data and limiting frame rate
 
 #include <cmath>
+#include <cstring>
 
 #include "lcd.h"
 #include "common/util.h"
+#include "common/profiler.h"
 
 /****** LCD Constructor ******/
 SGB_LCD::SGB_LCD()
 {
+	//Save states copy these out byte for byte, so start from all zeroes
+	memset(&lcd_stat, 0, sizeof(lcd_stat));
+	memset(obj, 0, sizeof(obj));
+
 	window = NULL;
 	reset();
 }
@@ -33,6 +39,7 @@ void SGB_LCD::reset()
 {
 	final_screen = NULL;
 	mem = NULL;
+	audio_output = NULL;
 
 	if((window != NULL) && (config::sdl_render)) { SDL_DestroyWindow(window); }
 	window = NULL;
@@ -48,18 +55,14 @@ void SGB_LCD::reset()
 	scanline_raw.resize(0x100, 0);
 	scanline_priority.resize(0x100, 0);
 
-	frame_start_time = 0;
-	frame_current_time = 0;
 	fps_count = 0;
+	frame_count = 0;
+	present_frame = true;
+	realtime_frame = true;
+	skip_frame = false;
 	fps_time = 0;
 
-	for(u32 x = 0; x < 60; x++)
-	{
-		u16 max = (config::max_fps) ? config::max_fps : 60;
-		double frame_1 = ((1000.0 / max) * x);
-		double frame_2 = ((1000.0 / max) * (x + 1));
-		frame_delay[x] = (std::round(frame_2) - std::round(frame_1));
-	}
+	pacer.reset((config::max_fps) ? config::max_fps : 60);
 
 	//Initialize various LCD status variables
 	lcd_stat.lcd_control = 0;
@@ -240,22 +243,17 @@ bool SGB_LCD::init()
 }
 
 /****** Read LCD data from save state ******/
-bool SGB_LCD::lcd_read(u32 offset, std::string filename)
+bool SGB_LCD::deserialize(const u8* buffer, u32 length)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	util::state_reader state(buffer, length);
 
 	//Serialize LCD data from file stream
-	file.read((char*)&lcd_stat, sizeof(lcd_stat));
+	state.read(&lcd_stat, sizeof(lcd_stat));
 
 	//Serialize OBJ data from file stream
 	for(int x = 0; x < 40; x++)
 	{
-		file.read((char*)&obj[x], sizeof(obj[x]));
+		state.read(&obj[x], sizeof(obj[x]));
 	}
 
 	//Sanitize LCD data
@@ -266,30 +264,37 @@ bool SGB_LCD::lcd_read(u32 offset, std::string filename)
 	lcd_stat.lcd_mode &= 0x3;
 	lcd_stat.hdma_type &= 0x1;
 	
-	file.close();
-	return true;
+	return state.good();
 }
 
 /****** Read LCD data from save state ******/
-bool SGB_LCD::lcd_write(std::string filename)
+bool SGB_LCD::serialize(std::vector<u8> &buffer)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	util::state_writer state(buffer);
 
 	//Serialize LCD data to file stream
-	file.write((char*)&lcd_stat, sizeof(lcd_stat));
+	state.write(&lcd_stat, sizeof(lcd_stat));
 
 	//Serialize OBJ data to file stream
 	for(int x = 0; x < 40; x++)
 	{
-		file.write((char*)&obj[x], sizeof(obj[x]));
+		state.write(&obj[x], sizeof(obj[x]));
 	}
 
-	file.close();
 	return true;
 }
 
+/****** Gets the size of LCD data for serialization ******/
+u32 SGB_LCD::size()
+{
+	u32 lcd_size = 0;
+
+	lcd_size += sizeof(lcd_stat);
+	lcd_size += (sizeof(obj[0]) * 40);
+
+	return lcd_size;
+}
+
 /****** Compares LY and LYC - Generates STAT interrupt ******/
 void SGB_LCD::scanline_compare()
 {
@@ -880,8 +885,8 @@ void SGB_LCD::step(int cpu_clock)
 					if(lcd_stat.oam_update) { update_oam(); }
 					else { update_obj_render_list(); }
 					
-					//Render scanline when first entering Mode 0
-					render_sgb_scanline();
+					//Render scanline when first entering Mode 0, unless the frame won't be shown
+					if((present_frame) && (!skip_frame)) { render_sgb_scanline(); }
 
 					//HBlank STAT INT
 					if(mem->memory_map[REG_STAT] & 0x08) { mem->memory_map[IF_FLAG] |= 2; }
@@ -959,8 +964,14 @@ void SGB_LCD::step(int cpu_clock)
 					draw_osd_msg(config::osd_message, screen_buffer, 0, 0);
 				}
 
-				//Render final screen buffer
-				if(lcd_stat.lcd_enable)
+				//Display profiler counters
+				PROFILER_DRAW_OSD(screen_buffer);
+
+				//Display frame time statistics
+				pacer.draw_osd(screen_buffer);
+
+				//Render final screen buffer, unless the frame is hidden (e.g. run-ahead) or skipped
+				if((lcd_stat.lcd_enable) && (present_frame) && (!skip_frame))
 				{
 					//Use SDL
 					if(config::sdl_render)
@@ -1059,16 +1070,29 @@ void SGB_LCD::step(int cpu_clock)
 				}
 
 				//Limit framerate
-				if(!config::turbo)
+				if((!config::turbo) && (realtime_frame))
+				{
+					PROFILER_ENTER(PROF_IDLE);
+
+					//Pace on the audio device's clock when syncing to audio, otherwise wait for the frame's deadline
+					pacer.limit(audio_output);
+
+					PROFILER_LEAVE();
+				}
+
+				PROFILER_END_FRAME();
+
+				//Update FPS counter + title, frame time and health statistics
+				if(realtime_frame)
 				{
-					frame_current_time = SDL_GetTicks();
-					int delay = frame_delay[fps_count % 60];
-					if((frame_current_time - frame_start_time) < delay) { SDL_Delay(delay - (frame_current_time - frame_start_time));}
-					frame_start_time = SDL_GetTicks();
+					fps_count++;
+					pacer.record(audio_output);
 				}
 
-				//Update FPS counter + title
-				fps_count++;
+				frame_count++;
+
+				//While in turbo, only render 1 out of every N+1 frames
+				skip_frame = (config::turbo) && (config::turbo_frameskip) && ((frame_count % (config::turbo_frameskip + 1)) != 0);
 				if(((SDL_GetTicks() - fps_time) >= 1000) && (config::sdl_render)) 
 				{ 
 					fps_time = SDL_GetTicks();